@@ -11,9 +11,9 @@
  */
 #include "iamf/cli/audio_frame_decoder.h"
 
+#include <iterator>
 #include <list>
 #include <memory>
-#include <utility>
 #include <vector>
 
 #include "absl/container/node_hash_map.h"
@@ -25,6 +25,7 @@
 #include "iamf/cli/audio_frame_with_data.h"
 #include "iamf/cli/codec/aac_decoder.h"
 #include "iamf/cli/codec/decoder_base.h"
+#include "iamf/cli/codec/flac_decoder.h"
 #include "iamf/cli/codec/lpcm_decoder.h"
 #include "iamf/cli/codec/opus_decoder.h"
 #include "iamf/common/macros.h"
@@ -49,19 +50,14 @@ absl::Status InitializeDecoder(const CodecConfigObu& codec_config,
       decoder = std::make_unique<AacDecoder>(codec_config, num_channels);
       break;
     case kCodecIdFlac:
-      // TODO(b/280490947): Support FLAC fully by decoding with `libflac`.
-      //                    Although since it is lossless it *should* be
-      //                    equivalent.
+      decoder = std::make_unique<FlacDecoder>(codec_config, num_channels);
       break;
     default:
       return absl::InvalidArgumentError(absl::StrCat(
           "Unrecognized codec_id= ", codec_config.GetCodecConfig().codec_id));
   }
 
-  if (decoder) {
-    RETURN_IF_NOT_OK(decoder->Initialize());
-  }
-  return absl::OkStatus();
+  return decoder->Initialize();
 }
 
 absl::Status DecodeAudioFrame(const AudioFrameWithData& encoded_frame,
@@ -80,20 +76,14 @@ absl::Status DecodeAudioFrame(const AudioFrameWithData& encoded_frame,
       encoded_frame.audio_element_with_data;
 
   // Decode the samples with the specific decoder associated with this
-  // substream.
-  if (decoder != nullptr) {
-    RETURN_IF_NOT_OK(decoder->DecodeAudioFrame(
-        encoded_frame.obu.audio_frame_, decoded_audio_frame.decoded_samples));
-  } else {
-    // Currently `decoder` remains `nullptr` for FLAC, which is a lossless
-    // codec and the decoding is skipped.
-    // TODO(b/280490947): Support FLAC fully by decoding with `libflac`.
-    //                    Although since it is lossless it *should* be
-    //                    equivalent.
-    decoded_audio_frame.decoded_samples = encoded_frame.raw_samples;
+  // substream. The frame may be recycled; the decoder overwrites its samples in
+  // place, reusing the storage of every time tick.
+  if (decoder == nullptr) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "No decoder for substream ID: ", encoded_frame.obu.GetSubstreamId()));
   }
-
-  return absl::OkStatus();
+  return decoder->DecodeAudioFrame(encoded_frame.obu.audio_frame_,
+                                   decoded_audio_frame.decoded_samples);
 }
 
 }  // namespace
@@ -134,13 +124,33 @@ absl::Status AudioFrameDecoder::Decode(
                        audio_frame.obu.GetSubstreamId()));
     }
 
-    DecodedAudioFrame decoded_audio_frame;
-    RETURN_IF_NOT_OK(DecodeAudioFrame(audio_frame, decoder_iter->second.get(),
-                                      decoded_audio_frame));
-    decoded_audio_frames.push_back(std::move(decoded_audio_frame));
+    // Prefer reusing a recycled frame over allocating a new one.
+    if (recycled_decoded_audio_frames_.empty()) {
+      decoded_audio_frames.emplace_back();
+    } else {
+      decoded_audio_frames.splice(decoded_audio_frames.end(),
+                                  recycled_decoded_audio_frames_,
+                                  recycled_decoded_audio_frames_.begin());
+    }
+    const auto status =
+        DecodeAudioFrame(audio_frame, decoder_iter->second.get(),
+                         decoded_audio_frames.back());
+    if (!status.ok()) {
+      // Do not leave a partially decoded frame in the output.
+      recycled_decoded_audio_frames_.splice(
+          recycled_decoded_audio_frames_.end(), decoded_audio_frames,
+          std::prev(decoded_audio_frames.end()));
+      return status;
+    }
   }
 
   return absl::OkStatus();
 }
 
+void AudioFrameDecoder::Recycle(
+    std::list<DecodedAudioFrame>& decoded_audio_frames) {
+  recycled_decoded_audio_frames_.splice(recycled_decoded_audio_frames_.end(),
+                                        decoded_audio_frames);
+}
+
 }  // namespace iamf_tools
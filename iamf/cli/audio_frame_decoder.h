@@ -67,6 +67,10 @@ struct DecodedAudioFrame {
  * be multiple `AudioFrameWithData`s in a single call to this function. Each
  * substream in the list is assumed to be self-consistent in temporal order. It
  * is permitted in any order relative to other substreams.
+ *
+ * Decoded frames which are no longer needed may be handed back with `Recycle`.
+ * Later calls to `Decode` reuse their list nodes and `decoded_samples`,
+ * including the inner vector of each time tick.
  */
 class AudioFrameDecoder {
  public:
@@ -94,11 +98,22 @@ class AudioFrameDecoder {
   absl::Status Decode(const std::list<AudioFrameWithData>& encoded_audio_frames,
                       std::list<DecodedAudioFrame>& decoded_audio_frames);
 
+  /*!\brief Returns decoded audio frames so their storage can be reused.
+   *
+   * \param decoded_audio_frames Frames which are no longer needed. The list is
+   *     empty after this call.
+   */
+  void Recycle(std::list<DecodedAudioFrame>& decoded_audio_frames);
+
  private:
   // A map of substream IDs to the relevant decoder and codec config. This is
   // necessary to process streams with stateful decoders correctly.
   absl::node_hash_map<uint32_t, std::unique_ptr<DecoderBase>>
       substream_id_to_decoder_;
+
+  // Previously decoded frames whose list nodes and outer sample vectors are
+  // reused by `Decode`.
+  std::list<DecodedAudioFrame> recycled_decoded_audio_frames_;
 };
 
 }  // namespace iamf_tools
@@ -14,6 +14,7 @@
 #define CLI_AUDIO_FRAME_WITH_DATA_H_
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "iamf/cli/audio_element_with_data.h"
@@ -32,7 +33,14 @@ struct AudioFrameWithData {
   int32_t end_timestamp;  // End time of this frame. Measured in ticks from the
                           // Global Timing Module.
 
-  std::vector<std::vector<int32_t>> raw_samples;
+  // Samples which were encoded into this frame, arranged in (time, channel)
+  // axes. Variants of a frame share the same samples. They are released once
+  // the frame has been demixed and its recon gains have been computed.
+  std::shared_ptr<const std::vector<std::vector<int32_t>>> raw_samples;
+
+  // Number of ticks in this frame, including any samples to trim. It remains
+  // valid after `raw_samples` has been released.
+  uint32_t num_ticks = 0;
 
   // Down-mixing parameters used to create this audio frame.
   DownMixingParams down_mixing_params;
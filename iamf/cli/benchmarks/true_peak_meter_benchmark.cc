@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+// Compares the true-peak measurement of `TruePeakMeter` with the per-tick
+// scalar interpolator which `LoudnessCalculatorItuRBs1770` used before it.
+// The input is one frame of 24-bit 9.1.6 audio at 48 kHz, like a rendered
+// layout of a large channel-based mix.
+//
+// Run with:
+//   bazel run -c opt //iamf/cli/benchmarks:true_peak_meter_benchmark
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "iamf/cli/true_peak_meter.h"
+
+namespace iamf_tools {
+namespace {
+
+// 9.1.6 has ten surround channels, one LFE and six height channels.
+constexpr int kNumChannels = 16;
+constexpr int kBitDepth = 24;
+constexpr double kSampleScale = 1.0 / 2147483648.0;
+
+// The interpolator which `LoudnessCalculatorItuRBs1770` used before
+// `TruePeakMeter`. Each tick shifts the history of every channel and
+// evaluates all four phases of the filter in double precision.
+class ScalarTruePeakInterpolator {
+ public:
+  explicit ScalarTruePeakInterpolator(int num_channels)
+      : num_channels_(num_channels),
+        history_(num_channels * kNumTaps, 0.0) {}
+
+  void AccumulateSamples(absl::Span<const int32_t> rendered_samples) {
+    for (size_t i = 0; i < rendered_samples.size(); i += num_channels_) {
+      AccumulateTick(&rendered_samples[i]);
+    }
+  }
+
+  double GetTruePeak() const { return max_true_peak_; }
+
+ private:
+  static constexpr int kNumTaps = 12;
+  static constexpr double kFilter[4][kNumTaps] = {
+      {0.0017089843750, 0.0109863281250, -0.0196533203125, 0.0332031250000,
+       -0.0594482421875, 0.1373291015625, 0.9721679687500, -0.1022949218750,
+       0.0476074218750, -0.0266113281250, 0.0148925781250, -0.0083007812500},
+      {-0.0291748046875, 0.0292968750000, -0.0517578125000, 0.0891113281250,
+       -0.1665039062500, 0.4650878906250, 0.7797851562500, -0.2003173828125,
+       0.1015625000000, -0.0582275390625, 0.0330810546875, -0.0189208984375},
+      {-0.0189208984375, 0.0330810546875, -0.0582275390625, 0.1015625000000,
+       -0.2003173828125, 0.7797851562500, 0.4650878906250, -0.1665039062500,
+       0.0891113281250, -0.0517578125000, 0.0292968750000, -0.0291748046875},
+      {-0.0083007812500, 0.0148925781250, -0.0266113281250, 0.0476074218750,
+       -0.1022949218750, 0.9721679687500, 0.1373291015625, -0.0594482421875,
+       0.0332031250000, -0.0196533203125, 0.0109863281250, 0.0017089843750}};
+
+  void AccumulateTick(const int32_t* tick) {
+    for (int c = 0; c < num_channels_; ++c) {
+      double* const history = history_.data() + c * kNumTaps;
+      std::copy_backward(history, history + kNumTaps - 1,
+                         history + kNumTaps);
+      history[0] = tick[c] * kSampleScale;
+      for (const auto& phase : kFilter) {
+        double interpolated = 0.0;
+        for (int k = 0; k < kNumTaps; ++k) {
+          interpolated += phase[k] * history[k];
+        }
+        max_true_peak_ = std::max(max_true_peak_, std::abs(interpolated));
+      }
+    }
+  }
+
+  const int num_channels_;
+  // Most recent samples of each channel, newest first.
+  std::vector<double> history_;
+  double max_true_peak_ = 0.0;
+};
+
+// Makes one frame of interleaved noise at full 24-bit scale, left-justified
+// in `int32_t` as the renderers output it.
+std::vector<int32_t> MakeFrame(int num_ticks) {
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<int32_t> distribution(
+      -(1 << (kBitDepth - 1)), (1 << (kBitDepth - 1)) - 1);
+  std::vector<int32_t> samples(num_ticks * kNumChannels);
+  for (auto& sample : samples) {
+    sample = distribution(generator) * (1 << (32 - kBitDepth));
+  }
+  return samples;
+}
+
+void BM_ScalarTruePeakInterpolator(benchmark::State& state) {
+  const int num_ticks = static_cast<int>(state.range(0));
+  const std::vector<int32_t> samples = MakeFrame(num_ticks);
+  ScalarTruePeakInterpolator interpolator(kNumChannels);
+  for (auto _ : state) {
+    interpolator.AccumulateSamples(samples);
+    benchmark::DoNotOptimize(interpolator.GetTruePeak());
+  }
+  state.SetItemsProcessed(state.iterations() * num_ticks);
+}
+
+void BM_TruePeakMeter(benchmark::State& state) {
+  const int num_ticks = static_cast<int>(state.range(0));
+  const std::vector<int32_t> samples = MakeFrame(num_ticks);
+  TruePeakMeter meter(kNumChannels);
+  for (auto _ : state) {
+    CHECK_OK(meter.AccumulateSamples(samples));
+    benchmark::DoNotOptimize(meter.GetTruePeak());
+  }
+  state.SetItemsProcessed(state.iterations() * num_ticks);
+}
+
+// Frame sizes of 20 ms Opus and of AAC at 48 kHz.
+BENCHMARK(BM_ScalarTruePeakInterpolator)->Arg(960)->Arg(1024);
+BENCHMARK(BM_TruePeakMeter)->Arg(960)->Arg(1024);
+
+}  // namespace
+}  // namespace iamf_tools
@@ -34,6 +34,7 @@
 #include "iamf/cli/proto/user_metadata.pb.h"
 #include "iamf/common/macros.h"
 #include "iamf/common/obu_util.h"
+#include "iamf/common/pcm_conversion.h"
 #include "iamf/obu/audio_element.h"
 #include "iamf/obu/codec_config.h"
 #include "iamf/obu/demixing_info_param_data.h"
@@ -301,22 +302,29 @@ absl::Status WritePcmFrameToBuffer(
     return absl::InvalidArgumentError(
         "This function only supports an integer number of bytes.");
   }
-  const size_t num_samples =
-      (frame.size() - samples_to_trim_at_start - samples_to_trim_at_end) *
-      frame[0].size();
+  // Select the packing function for this format once for the whole frame.
+  const auto pack_pcm_samples = GetPcmPacker(bit_depth, big_endian);
+  if (!pack_pcm_samples.ok()) {
+    return pack_pcm_samples.status();
+  }
 
-  buffer.resize(num_samples * (bit_depth / 8));
+  const size_t num_channels = frame[0].size();
+  const size_t bytes_per_time_tick = num_channels * (bit_depth / 8);
+  buffer.resize(
+      (frame.size() - samples_to_trim_at_start - samples_to_trim_at_end) *
+      bytes_per_time_tick);
 
   // The input frame is arranged in (time, channel) axes. Interlace these in the
   // output PCM and skip over any trimmed samples.
-  int write_position = 0;
+  uint8_t* write_position = buffer.data();
   for (int t = samples_to_trim_at_start;
        t < frame.size() - samples_to_trim_at_end; t++) {
-    for (int c = 0; c < frame[0].size(); ++c) {
-      const uint32_t sample = static_cast<uint32_t>(frame[t][c]);
-      RETURN_IF_NOT_OK(WritePcmSample(sample, bit_depth, big_endian,
-                                      buffer.data(), write_position));
+    if (frame[t].size() != num_channels) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected ", num_channels, " channels. Got: ", frame[t].size()));
     }
+    (*pack_pcm_samples)(frame[t], write_position);
+    write_position += bytes_per_time_tick;
   }
 
   return absl::OkStatus();
@@ -137,7 +137,7 @@ absl::Status CompareTimestamps(int32_t expected_timestamp,
  * \param frame Input frames arranged in (time, channel) axes.
  * \param samples_to_trim_at_start Samples to trim at the beginning.
  * \param samples_to_trim_at_end Samples to trim at the end.
- * \param bit_depth Sample size in bits.
+ * \param bit_depth Sample size in bits. One of 16, 24 or 32.
  * \param big_endian Whether the sample should be written as big or little
  *     endian.
  * \param buffer Buffer to resize and write to.
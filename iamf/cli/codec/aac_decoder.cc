@@ -26,10 +26,12 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "iamf/cli/codec/aac_utils.h"
 #include "iamf/cli/codec/decoder_base.h"
 #include "iamf/cli/proto/codec_config.pb.h"
 #include "iamf/common/macros.h"
+#include "iamf/common/pcm_conversion.h"
 #include "iamf/common/write_bit_buffer.h"
 #include "iamf/obu/codec_config.h"
 #include "iamf/obu/decoder_config/aac_decoder_config.h"
@@ -162,18 +164,19 @@ absl::Status AacDecoder::Initialize() {
   LOG_FIRST_N(INFO, 1) << "Created an AAC encoder with "
                        << stream_info->numChannels << " channels.";
 
+  // Allocate buffers for a full frame once, so decoding does not allocate.
+  output_pcm_.resize(num_samples_per_channel_ * num_channels_);
+  output_pcm_int32_.resize(num_samples_per_channel_ * num_channels_);
+
   return absl::OkStatus();
 }
 
 absl::Status AacDecoder::DecodeAudioFrame(
     const std::vector<uint8_t>& encoded_frame,
     std::vector<std::vector<int32_t>>& decoded_samples) {
-  // Transform the data and feed it to the decoder.
-  std::vector<UCHAR> input_data(encoded_frame.size());
-  std::transform(encoded_frame.begin(), encoded_frame.end(), input_data.begin(),
-                 [](uint8_t c) { return static_cast<UCHAR>(c); });
-
-  UCHAR* in_buffer[] = {input_data.data()};
+  // Feed the data to the decoder. `aacDecoder_Fill` copies from the buffer
+  // without modifying it, despite taking a non-const pointer.
+  UCHAR* in_buffer[] = {const_cast<UCHAR*>(encoded_frame.data())};
   const UINT buffer_size[] = {static_cast<UINT>(encoded_frame.size())};
   UINT bytes_valid = static_cast<UINT>(encoded_frame.size());
   RETURN_IF_NOT_OK(AacDecoderErrorToAbslStatus(
@@ -187,30 +190,19 @@ absl::Status AacDecoder::DecodeAudioFrame(
 
   // Retrieve the decoded frame. `fdk_aac` decodes to INT_PCM (usually 16-bits)
   // samples with channels interlaced.
-  std::vector<INT_PCM> output_pcm;
-  output_pcm.resize(num_samples_per_channel_ * num_channels_);
   RETURN_IF_NOT_OK(AacDecoderErrorToAbslStatus(
-      aacDecoder_DecodeFrame(decoder_, output_pcm.data(), output_pcm.size(),
+      aacDecoder_DecodeFrame(decoder_, output_pcm_.data(), output_pcm_.size(),
                              /*flags=*/0),
       "Failed on `aacDecoder_DecodeFrame`: "));
 
   // Transform the data to channels arranged in (time, channel) axes with
   // samples stored in the upper bytes of an `int32_t`. There can only be one or
   // two channels.
-  decoded_samples.reserve(decoded_samples.size() +
-                          output_pcm.size() / num_channels_);
-  for (int i = 0; i < output_pcm.size(); i += num_channels_) {
-    // Grab samples in all channels associated with this time instant and store
-    // it in the upper bytes.
-    std::vector<int32_t> time_sample(num_channels_, 0);
-    for (int j = 0; j < num_channels_; ++j) {
-      time_sample[j] = static_cast<int32_t>(output_pcm[i + j])
-                       << (32 - GetFdkAacBitDepth());
-    }
-    decoded_samples.push_back(time_sample);
-  }
-
-  return absl::OkStatus();
+  RETURN_IF_NOT_OK(LeftJustifyToInt32(absl::MakeConstSpan(output_pcm_),
+                                      GetFdkAacBitDepth(),
+                                      absl::MakeSpan(output_pcm_int32_)));
+  return DeinterleaveSamples(output_pcm_int32_, num_channels_,
+                             decoded_samples);
 }
 
 }  // namespace iamf_tools
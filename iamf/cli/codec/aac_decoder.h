@@ -63,6 +63,10 @@ class AacDecoder : public DecoderBase {
  private:
   const AacDecoderConfig& aac_decoder_config_;
   AAC_DECODER_INSTANCE* decoder_ = nullptr;
+
+  // Scratch buffers reused by every call to `DecodeAudioFrame()`.
+  std::vector<INT_PCM> output_pcm_;
+  std::vector<int32_t> output_pcm_int32_;
 };
 
 }  // namespace iamf_tools
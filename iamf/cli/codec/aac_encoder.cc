@@ -20,12 +20,13 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
-#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "iamf/cli/audio_frame_with_data.h"
 #include "iamf/cli/codec/aac_utils.h"
 #include "iamf/cli/proto/codec_config.pb.h"
 #include "iamf/common/macros.h"
 #include "iamf/common/obu_util.h"
+#include "iamf/common/pcm_conversion.h"
 #include "libAACenc/include/aacenc_lib.h"
 #include "libSYS/include/FDK_audio.h"
 #include "libSYS/include/machine_type.h"
@@ -195,6 +196,10 @@ absl::Status AacEncoder::InitializeEncoder() {
   RETURN_IF_NOT_OK(
       ValidateEncoderInfo(num_channels_, num_samples_per_frame_, encoder_));
 
+  // Allocate the buffers for a full frame once, so encoding does not allocate.
+  interleaved_pcm_.resize(num_samples_per_frame_ * num_channels_);
+  encoder_input_pcm_.resize(num_samples_per_frame_ * num_channels_);
+
   return absl::OkStatus();
 }
 
@@ -222,28 +227,21 @@ absl::Status AacEncoder::EncodeAudioFrame(
     return absl::InvalidArgumentError(error_message);
   }
 
-  // `fdk_aac` requires the native system endianness as input.
-  const bool big_endian = IsNativeBigEndian();
-  std::vector<INT_PCM> encoder_input_pcm(
-      num_samples_per_channel * num_channels_, 0);
-  int write_position = 0;
-  for (int t = 0; t < samples.size(); t++) {
-    for (int c = 0; c < samples[0].size(); ++c) {
-      // Convert all frames to INT_PCM samples for input for `fdk_aac` (usually
-      // 16-bit).
-      RETURN_IF_NOT_OK(WritePcmSample(
-          static_cast<uint32_t>(samples[t][c]), input_bit_depth, big_endian,
-          reinterpret_cast<uint8_t*>(encoder_input_pcm.data()),
-          write_position));
-    }
-  }
+  // Convert all samples to INT_PCM samples for input for `fdk_aac` (usually
+  // 16-bit). `fdk_aac` requires the native system endianness as input, which
+  // is what the conversion produces. Partial frames are padded with zeros.
+  RETURN_IF_NOT_OK(
+      InterleaveSamples(samples, absl::MakeSpan(interleaved_pcm_)));
+  RETURN_IF_NOT_OK(
+      RightJustifyFromInt32(absl::MakeConstSpan(interleaved_pcm_),
+                            absl::MakeSpan(encoder_input_pcm_)));
 
   // The `fdk_aac` interface supports multiple input buffers. Although IAMF only
   // uses one buffer without metadata or ancillary data.
-  void* in_buffers[1] = {encoder_input_pcm.data()};
+  void* in_buffers[1] = {encoder_input_pcm_.data()};
   INT in_buffer_identifiers[1] = {IN_AUDIO_DATA};
   INT in_buffer_sizes[1] = {
-      static_cast<INT>(encoder_input_pcm.size() * GetFdkAacBytesPerSample())};
+      static_cast<INT>(encoder_input_pcm_.size() * GetFdkAacBytesPerSample())};
   INT in_buffer_element_sizes[1] = {GetFdkAacBytesPerSample()};
   AACENC_BufDesc inBufDesc = {.numBufs = 1,
                               .bufs = in_buffers,
@@ -285,9 +283,7 @@ absl::Status AacEncoder::EncodeAudioFrame(
 
   // Resize the buffer to the actual size and finalize it.
   audio_frame.resize(out_args.numOutBytes);
-  absl::MutexLock lock(&mutex_);
-  finalized_audio_frames_.emplace_back(
-      std::move(*partial_audio_frame_with_data));
+  PushFinalizedAudioFrame(std::move(*partial_audio_frame_with_data));
 
   LOG_FIRST_N(INFO, 3) << "Encoded " << num_samples_per_channel << " samples * "
                        << num_channels_ << " channels using "
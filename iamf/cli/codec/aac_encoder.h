@@ -78,6 +78,10 @@ class AacEncoder : public EncoderBase {
 
   // A pointer to the `fdk_aac` encoder.
   AACENCODER* encoder_ = nullptr;
+
+  // Scratch buffers reused by every call to `EncodeAudioFrame()`.
+  std::vector<int32_t> interleaved_pcm_;
+  std::vector<INT_PCM> encoder_input_pcm_;
 };
 
 }  // namespace iamf_tools
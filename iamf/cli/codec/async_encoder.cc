@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/codec/async_encoder.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "iamf/cli/audio_frame_with_data.h"
+#include "iamf/common/macros.h"
+
+namespace iamf_tools {
+
+AsyncEncoder::~AsyncEncoder() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutting_down_ = true;
+  }
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+absl::Status AsyncEncoder::InitializeEncoder() {
+  RETURN_IF_NOT_OK(encoder_->Initialize());
+  worker_ = std::thread(&AsyncEncoder::WorkerLoop, this);
+  return absl::OkStatus();
+}
+
+absl::Status AsyncEncoder::EncodeAudioFrame(
+    int input_bit_depth, const std::vector<std::vector<int32_t>>& samples,
+    std::unique_ptr<AudioFrameWithData> partial_audio_frame_with_data) {
+  if (partial_audio_frame_with_data == nullptr) {
+    return absl::InvalidArgumentError(
+        "`partial_audio_frame_with_data` must not be null.");
+  }
+
+  absl::MutexLock lock(&mutex_);
+  RETURN_IF_NOT_OK(worker_status_);
+  if (finalize_requested_) {
+    return absl::InvalidArgumentError(
+        "Encoding is disallowed after `Finalize()` has been called");
+  }
+  pending_frames_.push_back({.input_bit_depth = input_bit_depth,
+                             .samples = samples,
+                             .partial_audio_frame_with_data =
+                                 std::move(partial_audio_frame_with_data)});
+  num_unprocessed_frames_++;
+  return absl::OkStatus();
+}
+
+absl::Status AsyncEncoder::Finalize() {
+  absl::MutexLock lock(&mutex_);
+  RETURN_IF_NOT_OK(worker_status_);
+  if (finalize_requested_) {
+    return absl::InvalidArgumentError("`Finalize()` was already called.");
+  }
+  finalize_requested_ = true;
+  pending_frames_.push_back({});
+  num_unprocessed_frames_++;
+  return absl::OkStatus();
+}
+
+absl::Status AsyncEncoder::WaitUntilIdle() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(this, &AsyncEncoder::IsIdle));
+  return worker_status_;
+}
+
+void AsyncEncoder::WorkerLoop() {
+  while (true) {
+    PendingFrame pending_frame;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(
+          absl::Condition(this, &AsyncEncoder::HasWorkOrIsShuttingDown));
+      if (shutting_down_) {
+        return;
+      }
+      pending_frame = std::move(pending_frames_.front());
+      pending_frames_.pop_front();
+    }
+
+    const absl::Status status = ProcessPendingFrame(pending_frame);
+
+    absl::MutexLock lock(&mutex_);
+    if (worker_status_.ok()) {
+      worker_status_ = status;
+    }
+    num_unprocessed_frames_--;
+  }
+}
+
+absl::Status AsyncEncoder::ProcessPendingFrame(PendingFrame& pending_frame) {
+  // Once anything has failed the remaining work is skipped.
+  {
+    absl::MutexLock lock(&mutex_);
+    RETURN_IF_NOT_OK(worker_status_);
+  }
+
+  if (pending_frame.partial_audio_frame_with_data == nullptr) {
+    RETURN_IF_NOT_OK(encoder_->Finalize());
+    RETURN_IF_NOT_OK(TransferFinishedFrames());
+    // Mark this encoder as closed once the wrapped encoder's frames are all
+    // handed over.
+    return EncoderBase::Finalize();
+  }
+
+  RETURN_IF_NOT_OK(encoder_->EncodeAudioFrame(
+      pending_frame.input_bit_depth, pending_frame.samples,
+      std::move(pending_frame.partial_audio_frame_with_data)));
+  return TransferFinishedFrames();
+}
+
+absl::Status AsyncEncoder::TransferFinishedFrames() {
+  std::list<AudioFrameWithData> audio_frames;
+  while (encoder_->FramesAvailable()) {
+    RETURN_IF_NOT_OK(encoder_->Pop(audio_frames));
+  }
+  for (auto& audio_frame : audio_frames) {
+    PushFinalizedAudioFrame(std::move(audio_frame));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace iamf_tools
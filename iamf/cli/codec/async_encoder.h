@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#ifndef CLI_ASYNC_ENCODER_H_
+#define CLI_ASYNC_ENCODER_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "iamf/cli/audio_frame_with_data.h"
+#include "iamf/cli/codec/encoder_base.h"
+#include "iamf/obu/codec_config.h"
+
+namespace iamf_tools {
+
+/*!\brief Adaptor which runs another encoder on its own worker thread.
+ *
+ * `EncodeAudioFrame()` and `Finalize()` copy their input onto a queue and
+ * return immediately. The worker thread drains the queue through the wrapped
+ * encoder and hands the finished frames over through the usual
+ * `FramesAvailable()`/`Pop()` interface, in the order they were received.
+ *
+ * Errors from the wrapped encoder are reported by the next call to
+ * `EncodeAudioFrame()`, `Finalize()` or `WaitUntilIdle()`. Call
+ * `WaitUntilIdle()` before popping when every frame sent so far must have
+ * been processed.
+ */
+class AsyncEncoder : public EncoderBase {
+ public:
+  /*!\brief Constructor.
+   *
+   * \param codec_config Codec Config OBU for the encoder.
+   * \param encoder Uninitialized encoder to wrap. It is initialized by
+   *     `Initialize()`.
+   */
+  AsyncEncoder(const CodecConfigObu& codec_config,
+               std::unique_ptr<EncoderBase> encoder)
+      : EncoderBase(encoder->supports_partial_frames_, codec_config,
+                    encoder->num_channels_),
+        encoder_(std::move(encoder)) {}
+
+  /*!\brief Destructor.
+   *
+   * Drops any work which has not started and joins the worker thread.
+   */
+  ~AsyncEncoder() override;
+
+  /*!\brief Queues an audio frame to be encoded by the worker thread.
+   *
+   * \param input_bit_depth Bit-depth of the input data.
+   * \param samples Samples arranged in (time x channel) axes. The samples are
+   *     left-justified and stored in the upper `input_bit_depth` bits.
+   * \param partial_audio_frame_with_data Unique pointer to take ownership of.
+   *     The underlying `audio_frame_` is modifed. All other fields are blindly
+   *     passed along.
+   * \return `absl::OkStatus()` on success. A specific status on failure or if
+   *     any earlier work failed.
+   */
+  absl::Status EncodeAudioFrame(
+      int input_bit_depth, const std::vector<std::vector<int32_t>>& samples,
+      std::unique_ptr<AudioFrameWithData> partial_audio_frame_with_data)
+      override;
+
+  /*!\brief Queues finalizing the wrapped encoder.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure or if
+   *     any earlier work failed.
+   */
+  absl::Status Finalize() override;
+
+  /*!\brief Blocks until the worker thread has processed all queued work.
+   *
+   * \return `absl::OkStatus()` on success. A specific status if any of the
+   *     queued work failed.
+   */
+  absl::Status WaitUntilIdle() override;
+
+ private:
+  // Work item for the worker thread. Items without a
+  // `partial_audio_frame_with_data` request finalizing the wrapped encoder.
+  struct PendingFrame {
+    int input_bit_depth;
+    std::vector<std::vector<int32_t>> samples;
+    std::unique_ptr<AudioFrameWithData> partial_audio_frame_with_data;
+  };
+
+  /*!\brief Initializes the wrapped encoder and starts the worker thread.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status InitializeEncoder() override;
+
+  /*!\brief Copies the delay from the wrapped encoder.
+   *
+   * \return `absl::OkStatus()` always.
+   */
+  absl::Status SetNumberOfSamplesToDelayAtStart() override {
+    required_samples_to_delay_at_start_ =
+        encoder_->GetNumberOfSamplesToDelayAtStart();
+    return absl::OkStatus();
+  }
+
+  /*!\brief Processes queued work until the encoder is destroyed. */
+  void WorkerLoop();
+
+  /*!\brief Processes one queued frame on the worker thread.
+   *
+   * \param pending_frame Frame to encode or request to finalize.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status ProcessPendingFrame(PendingFrame& pending_frame);
+
+  /*!\brief Moves finished frames from the wrapped encoder to this one.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status TransferFinishedFrames();
+
+  bool HasWorkOrIsShuttingDown() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !pending_frames_.empty() || shutting_down_;
+  }
+
+  bool IsIdle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return num_unprocessed_frames_ == 0;
+  }
+
+  // Only accessed from the worker thread after initialization.
+  const std::unique_ptr<EncoderBase> encoder_;
+
+  // Mutex to guard the state shared with the worker thread.
+  mutable absl::Mutex mutex_;
+
+  std::deque<PendingFrame> pending_frames_ ABSL_GUARDED_BY(mutex_);
+
+  // Number of frames which are queued or are being processed.
+  int num_unprocessed_frames_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // First error reported by the worker thread.
+  absl::Status worker_status_ ABSL_GUARDED_BY(mutex_);
+
+  bool finalize_requested_ ABSL_GUARDED_BY(mutex_) = false;
+  bool shutting_down_ ABSL_GUARDED_BY(mutex_) = false;
+
+  std::thread worker_;
+};
+
+}  // namespace iamf_tools
+
+#endif  // CLI_ASYNC_ENCODER_H_
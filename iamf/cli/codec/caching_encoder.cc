@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/codec/caching_encoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "iamf/cli/audio_frame_with_data.h"
+#include "iamf/cli/codec/encoded_frame_cache.h"
+#include "iamf/common/macros.h"
+#include "iamf/obu/audio_frame.h"
+#include "iamf/obu/obu_header.h"
+
+namespace iamf_tools {
+
+absl::Status CachingEncoder::EncodeAudioFrame(
+    int input_bit_depth, const std::vector<std::vector<int32_t>>& samples,
+    std::unique_ptr<AudioFrameWithData> partial_audio_frame_with_data) {
+  if (partial_audio_frame_with_data == nullptr) {
+    return absl::InvalidArgumentError(
+        "`partial_audio_frame_with_data` must not be null.");
+  }
+  absl::MutexLock lock(&mutex_);
+  if (finalize_requested_) {
+    return absl::InvalidArgumentError(
+        "Encoding is disallowed after `Finalize()` has been called");
+  }
+
+  CacheKeyBuilder key_builder;
+  key_builder.Add(stream_key_)
+      .Add(frame_index_++)
+      .Add(static_cast<uint64_t>(input_bit_depth))
+      .Add(samples);
+  if (!frames_are_independent_) {
+    key_builder.Add(previous_key_);
+  }
+  const uint64_t key = key_builder.Build();
+  previous_key_ = key;
+
+  if (lookups_enabled_ &&
+      cache_.Lookup(key, partial_audio_frame_with_data->obu.audio_frame_)) {
+    num_cache_hits_++;
+    if (!frames_are_independent_) {
+      reused_frame_inputs_.push_back(
+          {.input_bit_depth = input_bit_depth, .samples = samples});
+    }
+    in_flight_frames_.push_back(
+        {.key = key,
+         .from_cache = true,
+         .audio_frame = std::move(*partial_audio_frame_with_data)});
+    return TransferFinishedFrames();
+  }
+
+  if (!frames_are_independent_) {
+    // Every later key covers this frame, so none of them can be found either.
+    lookups_enabled_ = false;
+    RETURN_IF_NOT_OK(ReplayReusedFrames());
+  }
+
+  in_flight_frames_.push_back({.key = key, .from_cache = false});
+  RETURN_IF_NOT_OK(encoder_->EncodeAudioFrame(
+      input_bit_depth, samples, std::move(partial_audio_frame_with_data)));
+  return TransferFinishedFrames();
+}
+
+absl::Status CachingEncoder::Finalize() {
+  absl::MutexLock lock(&mutex_);
+  if (finalize_requested_) {
+    return absl::InvalidArgumentError("`Finalize()` was already called.");
+  }
+  finalize_requested_ = true;
+  RETURN_IF_NOT_OK(encoder_->Finalize());
+  return TransferFinishedFrames();
+}
+
+absl::Status CachingEncoder::WaitUntilIdle() {
+  absl::MutexLock lock(&mutex_);
+  RETURN_IF_NOT_OK(encoder_->WaitUntilIdle());
+  return TransferFinishedFrames();
+}
+
+absl::Status CachingEncoder::ReplayReusedFrames() {
+  for (const auto& reused_frame_input : reused_frame_inputs_) {
+    // Only the codec state matters. The output is dropped.
+    auto discarded_audio_frame = std::make_unique<AudioFrameWithData>(
+        AudioFrameWithData{.obu = AudioFrameObu(ObuHeader(), 0, {}),
+                           .start_timestamp = 0,
+                           .end_timestamp = 0,
+                           .audio_element_with_data = nullptr});
+    RETURN_IF_NOT_OK(encoder_->EncodeAudioFrame(
+        reused_frame_input.input_bit_depth, reused_frame_input.samples,
+        std::move(discarded_audio_frame)));
+    num_frames_to_discard_++;
+
+    // Drain as we go so the wrapped encoder never holds too many frames.
+    RETURN_IF_NOT_OK(encoder_->WaitUntilIdle());
+    RETURN_IF_NOT_OK(TransferFinishedFrames());
+  }
+
+  // Release the memory; the inputs are never needed again.
+  std::vector<ReusedFrameInput>().swap(reused_frame_inputs_);
+  return absl::OkStatus();
+}
+
+absl::Status CachingEncoder::TransferFinishedFrames() {
+  std::list<AudioFrameWithData> audio_frames;
+  while (encoder_->FramesAvailable()) {
+    RETURN_IF_NOT_OK(encoder_->Pop(audio_frames));
+  }
+
+  for (auto& audio_frame : audio_frames) {
+    if (num_frames_to_discard_ > 0) {
+      num_frames_to_discard_--;
+      continue;
+    }
+
+    // Frames from the wrapped encoder finish in the order they were sent.
+    auto in_flight_frame_iter = std::find_if(
+        in_flight_frames_.begin(), in_flight_frames_.end(),
+        [](const InFlightFrame& in_flight_frame) {
+          return !in_flight_frame.from_cache &&
+                 !in_flight_frame.audio_frame.has_value();
+        });
+    if (in_flight_frame_iter == in_flight_frames_.end()) {
+      return absl::InternalError(
+          "The wrapped encoder output more frames than it received.");
+    }
+
+    // The cache is only an optimization. Keep going if it cannot be written.
+    const absl::Status store_status =
+        cache_.Store(in_flight_frame_iter->key, audio_frame.obu.audio_frame_);
+    if (!store_status.ok()) {
+      LOG_FIRST_N(WARNING, 1)
+          << "Failed to store an encoded frame: " << store_status;
+    }
+    in_flight_frame_iter->audio_frame.emplace(std::move(audio_frame));
+  }
+
+  while (!in_flight_frames_.empty() &&
+         in_flight_frames_.front().audio_frame.has_value()) {
+    PushFinalizedAudioFrame(std::move(*in_flight_frames_.front().audio_frame));
+    in_flight_frames_.pop_front();
+  }
+
+  if (finalize_requested_ && in_flight_frames_.empty() &&
+      encoder_->Finished()) {
+    finished_.store(true, std::memory_order_release);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#ifndef CLI_CODEC_CACHING_ENCODER_H_
+#define CLI_CODEC_CACHING_ENCODER_H_
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "iamf/cli/audio_frame_with_data.h"
+#include "iamf/cli/codec/encoded_frame_cache.h"
+#include "iamf/cli/codec/encoder_base.h"
+#include "iamf/obu/codec_config.h"
+
+namespace iamf_tools {
+
+/*!\brief Adaptor which reuses encoded frames from an on-disk cache.
+ *
+ * Each frame is keyed by `stream_key`, its index in the substream, its input
+ * bit-depth and a hash of its input samples. Frames which are found in the
+ * cache are output without calling the wrapped encoder. Other frames are
+ * encoded by the wrapped encoder and stored in the cache.
+ *
+ * The wrapped encoder must output exactly one frame per input frame, in order.
+ *
+ * When `frames_are_independent` is `false` the output of a frame may depend on
+ * the codec state left by earlier frames. The key of each frame then also
+ * covers every earlier frame, so only a prefix of the substream can be reused.
+ * The input of reused frames is kept. On the first miss it is replayed through
+ * the wrapped encoder, discarding the output, so the codec state matches a
+ * full encode.
+ *
+ * `WaitUntilIdle()` may be called while another thread encodes frames.
+ */
+class CachingEncoder : public EncoderBase {
+ public:
+  /*!\brief Constructor.
+   *
+   * \param codec_config Codec Config OBU for the encoder.
+   * \param encoder Uninitialized encoder to wrap. It is initialized by
+   *     `Initialize()`.
+   * \param cache_directory Directory to store the cached frames in.
+   * \param stream_key Key of all settings which affect the encoded frames.
+   * \param frames_are_independent `true` when the encoded frames only depend on
+   *     their own input samples. `false` otherwise.
+   */
+  CachingEncoder(const CodecConfigObu& codec_config,
+                 std::unique_ptr<EncoderBase> encoder,
+                 const std::filesystem::path& cache_directory,
+                 uint64_t stream_key, bool frames_are_independent)
+      : EncoderBase(encoder->supports_partial_frames_, codec_config,
+                    encoder->num_channels_),
+        encoder_(std::move(encoder)),
+        cache_(cache_directory),
+        stream_key_(stream_key),
+        frames_are_independent_(frames_are_independent) {}
+
+  /*!\brief Destructor. */
+  ~CachingEncoder() override = default;
+
+  /*!\brief Outputs a cached audio frame or encodes it.
+   *
+   * \param input_bit_depth Bit-depth of the input data.
+   * \param samples Samples arranged in (time x channel) axes. The samples are
+   *     left-justified and stored in the upper `input_bit_depth` bits.
+   * \param partial_audio_frame_with_data Unique pointer to take ownership of.
+   *     The underlying `audio_frame_` is modifed. All other fields are blindly
+   *     passed along.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status EncodeAudioFrame(
+      int input_bit_depth, const std::vector<std::vector<int32_t>>& samples,
+      std::unique_ptr<AudioFrameWithData> partial_audio_frame_with_data)
+      override;
+
+  /*!\brief Finalizes the wrapped encoder.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status Finalize() override;
+
+  /*!\brief Waits for the wrapped encoder and collects its finished frames.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status WaitUntilIdle() override;
+
+  /*!\brief Gets the number of frames which were reused from the cache.
+   *
+   * \return Number of frames which were reused from the cache.
+   */
+  int GetNumCacheHits() const {
+    absl::MutexLock lock(&mutex_);
+    return num_cache_hits_;
+  }
+
+ private:
+  // A frame which has not yet been output, in the order it was received.
+  struct InFlightFrame {
+    uint64_t key;
+    // `true` when the frame was found in the cache.
+    bool from_cache;
+    // Set once the frame is finished.
+    std::optional<AudioFrameWithData> audio_frame;
+  };
+
+  // Input of a frame which was reused from the cache. Only kept when frames
+  // are not independent.
+  struct ReusedFrameInput {
+    int input_bit_depth;
+    std::vector<std::vector<int32_t>> samples;
+  };
+
+  /*!\brief Initializes the wrapped encoder.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status InitializeEncoder() override {
+    return encoder_->Initialize();
+  }
+
+  /*!\brief Copies the delay from the wrapped encoder.
+   *
+   * \return `absl::OkStatus()` always.
+   */
+  absl::Status SetNumberOfSamplesToDelayAtStart() override {
+    required_samples_to_delay_at_start_ =
+        encoder_->GetNumberOfSamplesToDelayAtStart();
+    return absl::OkStatus();
+  }
+
+  /*!\brief Feeds the reused frames through the wrapped encoder.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status ReplayReusedFrames() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /*!\brief Collects finished frames from the wrapped encoder.
+   *
+   * Frames are stored in the cache and then output in the order they were
+   * received.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status TransferFinishedFrames() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::unique_ptr<EncoderBase> encoder_;
+  const EncodedFrameCache cache_;
+  const uint64_t stream_key_;
+  const bool frames_are_independent_;
+
+  // Mutex to guard the state shared by encoding and `WaitUntilIdle()`.
+  mutable absl::Mutex mutex_;
+
+  // Key of the previous frame. Folded into the next key when frames are not
+  // independent.
+  uint64_t previous_key_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t frame_index_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // Whether the cache may still be consulted.
+  bool lookups_enabled_ ABSL_GUARDED_BY(mutex_) = true;
+  int num_cache_hits_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  std::deque<InFlightFrame> in_flight_frames_ ABSL_GUARDED_BY(mutex_);
+  std::vector<ReusedFrameInput> reused_frame_inputs_ ABSL_GUARDED_BY(mutex_);
+
+  // Number of upcoming frames from the wrapped encoder which were replayed
+  // and must be dropped.
+  int64_t num_frames_to_discard_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  bool finalize_requested_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace iamf_tools
+
+#endif  // CLI_CODEC_CACHING_ENCODER_H_
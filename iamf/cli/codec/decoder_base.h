@@ -52,6 +52,8 @@ class DecoderBase {
    * \param decoded_samples Output decoded frames arranged in (time, sample)
    *     axes.  That is to say, each inner vector has one sample for per channel
    *     and the outer vector contains one inner vector for each time tick.
+   *     Overwritten with the decoded frame; implementations should reuse the
+   *     existing inner vectors rather than reallocating them.
    * \return `absl::OkStatus()` on success. A specific status on failure.
    */
   virtual absl::Status DecodeAudioFrame(
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/codec/encoded_frame_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+namespace iamf_tools {
+
+namespace {
+
+// Every file starts with a magic string, the key and the size of the payload.
+// Bump the version whenever the layout or the meaning of the key changes.
+constexpr absl::string_view kMagic = "IAMFFRM1";
+constexpr size_t kHeaderSize = 24;
+
+void AppendUint64(uint64_t value, std::string& buffer) {
+  for (int i = 0; i < 8; ++i) {
+    buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+uint64_t ReadUint64(const char* buffer) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(buffer[i])) << (8 * i);
+  }
+  return value;
+}
+
+// Gets a suffix which is unlikely to be used by any other thread or process
+// writing to the same directory.
+std::string GetTemporarySuffix() {
+  thread_local std::mt19937_64 generator(std::random_device{}());
+  return absl::StrCat(".tmp", absl::Hex(generator()));
+}
+
+}  // namespace
+
+CacheKeyBuilder& CacheKeyBuilder::Add(absl::string_view bytes) {
+  for (const char byte : bytes) {
+    hash_ ^= static_cast<uint8_t>(byte);
+    hash_ *= kFnvPrime;
+  }
+  return *this;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::Add(uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    hash_ ^= (value >> (8 * i)) & 0xff;
+    hash_ *= kFnvPrime;
+  }
+  return *this;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::Add(
+    const std::vector<std::vector<int32_t>>& samples) {
+  Add(static_cast<uint64_t>(samples.size()));
+  for (const auto& time_sample : samples) {
+    Add(static_cast<uint64_t>(time_sample.size()));
+    for (const int32_t sample : time_sample) {
+      const auto value = static_cast<uint32_t>(sample);
+      for (int i = 0; i < 4; ++i) {
+        hash_ ^= (value >> (8 * i)) & 0xff;
+        hash_ *= kFnvPrime;
+      }
+    }
+  }
+  return *this;
+}
+
+bool EncodedFrameCache::Lookup(uint64_t key,
+                               std::vector<uint8_t>& encoded_frame) const {
+  const std::filesystem::path path = GetPath(key);
+  std::error_code error_code;
+  const uintmax_t file_size = std::filesystem::file_size(path, error_code);
+  if (error_code || file_size < kHeaderSize) {
+    return false;
+  }
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    return false;
+  }
+
+  std::array<char, kHeaderSize> header;
+  if (!ifs.read(header.data(), header.size()) ||
+      absl::string_view(header.data(), kMagic.size()) != kMagic ||
+      ReadUint64(header.data() + 8) != key) {
+    return false;
+  }
+  // Check the size against the file before allocating, so a corrupt header
+  // cannot request an arbitrarily large buffer.
+  const uint64_t payload_size = ReadUint64(header.data() + 16);
+  if (payload_size != file_size - kHeaderSize) {
+    return false;
+  }
+
+  std::vector<uint8_t> payload(payload_size);
+  if (!ifs.read(reinterpret_cast<char*>(payload.data()), payload.size()) ||
+      ifs.peek() != std::ifstream::traits_type::eof()) {
+    return false;
+  }
+
+  encoded_frame = std::move(payload);
+  return true;
+}
+
+absl::Status EncodedFrameCache::Store(
+    uint64_t key, const std::vector<uint8_t>& encoded_frame) const {
+  std::error_code error_code;
+  std::filesystem::create_directories(directory_, error_code);
+  if (error_code) {
+    return absl::UnknownError(absl::StrCat("Failed to create ",
+                                           directory_.string(), ": ",
+                                           error_code.message()));
+  }
+
+  std::string header(kMagic);
+  AppendUint64(key, header);
+  AppendUint64(encoded_frame.size(), header);
+
+  const std::filesystem::path path = GetPath(key);
+  std::filesystem::path temporary_path = path;
+  temporary_path += GetTemporarySuffix();
+  {
+    std::ofstream ofs(temporary_path, std::ios::binary | std::ios::trunc);
+    ofs.write(header.data(), header.size());
+    ofs.write(reinterpret_cast<const char*>(encoded_frame.data()),
+              encoded_frame.size());
+    ofs.close();
+    if (!ofs) {
+      std::filesystem::remove(temporary_path, error_code);
+      return absl::UnknownError(
+          absl::StrCat("Failed to write ", temporary_path.string()));
+    }
+  }
+
+  std::filesystem::rename(temporary_path, path, error_code);
+  if (error_code) {
+    std::filesystem::remove(temporary_path, error_code);
+    return absl::UnknownError(
+        absl::StrCat("Failed to rename to ", path.string()));
+  }
+  return absl::OkStatus();
+}
+
+std::filesystem::path EncodedFrameCache::GetPath(uint64_t key) const {
+  return directory_ / absl::StrCat(absl::Hex(key, absl::kZeroPad16), ".frame");
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#ifndef CLI_CODEC_ENCODED_FRAME_CACHE_H_
+#define CLI_CODEC_ENCODED_FRAME_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace iamf_tools {
+
+/*!\brief Builds keys for `EncodedFrameCache`.
+ *
+ * Keys are 64-bit FNV-1a hashes. Unlike `absl::Hash` the result is stable
+ * across processes and builds, so keys computed by one run can be looked up by
+ * a later run.
+ */
+class CacheKeyBuilder {
+ public:
+  /*!\brief Mixes raw bytes into the key.
+   *
+   * \param bytes Bytes to mix in.
+   * \return Reference to this builder.
+   */
+  CacheKeyBuilder& Add(absl::string_view bytes);
+
+  /*!\brief Mixes an integer into the key.
+   *
+   * \param value Value to mix in. It is mixed in as 8 little-endian bytes.
+   * \return Reference to this builder.
+   */
+  CacheKeyBuilder& Add(uint64_t value);
+
+  /*!\brief Mixes samples into the key.
+   *
+   * \param samples Samples arranged in (time, channel) axes. The shape is mixed
+   *     in as well as the values.
+   * \return Reference to this builder.
+   */
+  CacheKeyBuilder& Add(const std::vector<std::vector<int32_t>>& samples);
+
+  /*!\brief Gets the key of everything added so far.
+   *
+   * \return Key of everything added so far.
+   */
+  uint64_t Build() const { return hash_; }
+
+ private:
+  static constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325;
+  static constexpr uint64_t kFnvPrime = 0x100000001b3;
+
+  uint64_t hash_ = kFnvOffsetBasis;
+};
+
+/*!\brief Content-addressed store of encoded audio frames on disk.
+ *
+ * Each frame is stored in its own file, named after its key, under the cache
+ * directory. The directory is created on the first call to `Store()`. Files are
+ * written to a temporary name and renamed into place, so concurrent runs
+ * sharing a directory never observe partially written frames.
+ *
+ * The cache never evicts. Delete the directory to reclaim space.
+ */
+class EncodedFrameCache {
+ public:
+  /*!\brief Constructor.
+   *
+   * \param directory Directory to store the cached frames in.
+   */
+  explicit EncodedFrameCache(const std::filesystem::path& directory)
+      : directory_(directory) {}
+
+  /*!\brief Looks up a frame.
+   *
+   * Missing, unreadable or corrupt files are treated as misses.
+   *
+   * \param key Key of the frame.
+   * \param encoded_frame Output encoded frame. Only modified on a hit.
+   * \return `true` on a hit. `false` otherwise.
+   */
+  bool Lookup(uint64_t key, std::vector<uint8_t>& encoded_frame) const;
+
+  /*!\brief Stores a frame.
+   *
+   * \param key Key of the frame.
+   * \param encoded_frame Encoded frame to store.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status Store(uint64_t key,
+                     const std::vector<uint8_t>& encoded_frame) const;
+
+ private:
+  std::filesystem::path GetPath(uint64_t key) const;
+
+  const std::filesystem::path directory_;
+};
+
+}  // namespace iamf_tools
+
+#endif  // CLI_CODEC_ENCODED_FRAME_CACHE_H_
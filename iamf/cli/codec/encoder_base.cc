@@ -12,6 +12,7 @@
 #include "iamf/cli/codec/encoder_base.h"
 
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 #include "absl/log/log.h"
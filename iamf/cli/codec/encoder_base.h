@@ -13,15 +13,17 @@
 #ifndef CLI_ENCODER_BASE_H_
 #define CLI_ENCODER_BASE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
-#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
-#include "absl/synchronization/mutex.h"
 #include "iamf/cli/audio_frame_with_data.h"
+#include "iamf/common/spsc_queue.h"
 #include "iamf/obu/codec_config.h"
 
 namespace iamf_tools {
@@ -34,7 +36,7 @@ class EncoderBase {
    * before using most functionality of the encoder.
    *
    * - Call `EncodeAudioFrame()` to encode an audio frame. The encoding may
-   *   happen asynchronously.
+   *   happen asynchronously; call `WaitUntilIdle()` to wait for it.
    * - Call `FramesAvailable()` to see if there is any finished frame.
    * - Call `Pop()` to retrieve finished frames one at a time, in the order
    *   they were received by `EncodeAudioFrame()`.
@@ -43,6 +45,10 @@ class EncoderBase {
    *   After calling `Finalize()`, any subsequent call to `EncodeAudioFrame()`
    *   will fail.
    *
+   * Finished frames are handed from the encoder to the caller of `Pop()`
+   * through a lock-free single-producer/single-consumer queue. At most one
+   * thread may be encoding and at most one thread may be popping at any time.
+   *
    * \param supports_partial_frames `true` for encoders that support encoding
    *     frames shorter than `num_samples_per_frame_`. `false` otherwise.
    * \param codec_config Codec Config OBU for the encoder.
@@ -87,10 +93,7 @@ class EncoderBase {
    *
    * \return True if there is any finished audio frame.
    */
-  bool FramesAvailable() const {
-    absl::MutexLock lock(&mutex_);
-    return !finalized_audio_frames_.empty();
-  }
+  bool FramesAvailable() const { return !finalized_audio_frames_.Empty(); }
 
   /*!\brief Pop the first finished audio frame (if any).
    *
@@ -98,10 +101,10 @@ class EncoderBase {
    * \return `absl::OkStatus()` on success. A specific status on failure.
    */
   absl::Status Pop(std::list<AudioFrameWithData>& audio_frames) {
-    absl::MutexLock lock(&mutex_);
-    if (!finalized_audio_frames_.empty()) {
-      audio_frames.splice(audio_frames.end(), finalized_audio_frames_,
-                          finalized_audio_frames_.begin());
+    std::optional<AudioFrameWithData> audio_frame =
+        finalized_audio_frames_.TryPop();
+    if (audio_frame.has_value()) {
+      audio_frames.push_back(std::move(*audio_frame));
     }
     return absl::OkStatus();
   }
@@ -114,18 +117,29 @@ class EncoderBase {
    * \return `absl::OkStatus()` on success. A specific status on failure.
    */
   virtual absl::Status Finalize() {
-    absl::MutexLock lock(&mutex_);
-    finished_ = true;
+    finished_.store(true, std::memory_order_release);
     return absl::OkStatus();
   }
 
+  /*!\brief Blocks until all previous calls have been processed.
+   *
+   * After this returns, every frame passed to `EncodeAudioFrame()` and any
+   * earlier call to `Finalize()` has been handed to the underlying codec.
+   * Frames which are finished by that point are available to `Pop()`. Encoders
+   * which encode synchronously have nothing to wait for.
+   *
+   * \return `absl::OkStatus()` on success. A specific status if any of the
+   *     pending work failed.
+   */
+  virtual absl::Status WaitUntilIdle() { return absl::OkStatus(); }
+
   /*!\brief Gets whether the encoder has been closed.
    *
    * \return True if the encoder has been closed.
    */
   bool Finished() const {
-    absl::MutexLock lock(&mutex_);
-    return finished_ && finalized_audio_frames_.empty();
+    return finished_.load(std::memory_order_acquire) &&
+           finalized_audio_frames_.Empty();
   }
 
   /*!\brief Gets the required number of samples to delay at the start.
@@ -179,16 +193,26 @@ class EncoderBase {
   absl::Status ValidateInputSamples(
       const std::vector<std::vector<int32_t>>& samples) const;
 
-  uint32_t required_samples_to_delay_at_start_ = 0;
+  /*!\brief Hands a finished frame over to be popped.
+   *
+   * Must only be called from the thread which is encoding. The queue of
+   * finished frames grows as needed, so an encoder may run ahead of the caller
+   * of `Pop()`.
+   *
+   * \param audio_frame Finished frame to take ownership of.
+   */
+  void PushFinalizedAudioFrame(AudioFrameWithData&& audio_frame) {
+    finalized_audio_frames_.Push(std::move(audio_frame));
+  }
 
-  // Mutex to guard simultaneous access to data members.
-  mutable absl::Mutex mutex_;
+  uint32_t required_samples_to_delay_at_start_ = 0;
 
-  std::list<AudioFrameWithData> finalized_audio_frames_
-      ABSL_GUARDED_BY(mutex_) = {};
+  // Finished frames waiting to be popped. Pushed to by the encoding thread and
+  // popped from by the caller of `Pop()`.
+  SpscQueue<AudioFrameWithData> finalized_audio_frames_;
 
   // Whether the encoding has been closed.
-  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+  std::atomic<bool> finished_ = false;
 };
 
 }  // namespace iamf_tools
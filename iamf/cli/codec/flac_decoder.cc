@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/codec/flac_decoder.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <variant>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "iamf/cli/codec/decoder_base.h"
+#include "iamf/common/macros.h"
+#include "iamf/common/write_bit_buffer.h"
+#include "iamf/obu/codec_config.h"
+#include "iamf/obu/decoder_config/flac_decoder_config.h"
+#include "include/FLAC/format.h"
+#include "include/FLAC/ordinals.h"
+#include "include/FLAC/stream_decoder.h"
+
+namespace iamf_tools {
+
+namespace {
+
+// IAMF requires `audio_roll_distance` to be 0 for FLAC.
+constexpr int16_t kFlacAudioRollDistance = 0;
+
+// Gets a copy of the decoder config suitable to prime `libflac` with.
+FlacDecoderConfig GetDecoderConfigForLibFlac(
+    const FlacDecoderConfig& decoder_config) {
+  FlacDecoderConfig result = decoder_config;
+  for (auto& metadata_block : result.metadata_blocks_) {
+    auto* stream_info =
+        std::get_if<FlacMetaBlockStreamInfo>(&metadata_block.payload);
+    if (stream_info != nullptr) {
+      // IAMF does not require the total number of samples to be accurate. Mark
+      // it as unknown so `libflac` does not reject frames which are beyond it.
+      stream_info->total_samples_in_stream = 0;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+FLAC__StreamDecoderReadStatus LibFlacReadCallback(
+    const FLAC__StreamDecoder* /*decoder*/, FLAC__byte buffer[], size_t* bytes,
+    void* client_data) {
+  auto flac_decoder = static_cast<FlacDecoder*>(client_data);
+  const size_t num_bytes_available =
+      flac_decoder->encoded_bytes_.size() - flac_decoder->read_position_;
+  if (num_bytes_available == 0) {
+    // Each call to `DecodeAudioFrame()` provides a whole frame. Running out of
+    // data means the frame was truncated.
+    *bytes = 0;
+    return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+  }
+
+  *bytes = std::min(*bytes, num_bytes_available);
+  const uint8_t* const read_start =
+      flac_decoder->encoded_bytes_.data() + flac_decoder->read_position_;
+  std::memcpy(buffer, read_start, *bytes);
+  flac_decoder->read_position_ += *bytes;
+  return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+}
+
+FLAC__StreamDecoderWriteStatus LibFlacDecoderWriteCallback(
+    const FLAC__StreamDecoder* /*decoder*/, const FLAC__Frame* frame,
+    const FLAC__int32* const buffer[], void* client_data) {
+  auto flac_decoder = static_cast<FlacDecoder*>(client_data);
+  const auto& header = frame->header;
+  if (flac_decoder->decoded_samples_ == nullptr ||
+      header.channels != flac_decoder->num_channels_ ||
+      header.bits_per_sample == 0 || header.bits_per_sample > 32) {
+    flac_decoder->callback_status_ = absl::InvalidArgumentError(absl::StrCat(
+        "Unexpected FLAC frame with channels= ", header.channels,
+        " and bits_per_sample= ", header.bits_per_sample));
+    return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+  }
+
+  // `libflac` outputs right-justified samples arranged in (channel, time)
+  // axes. Convert them to left-justified samples in (time, channel) axes.
+  const int shift = 32 - static_cast<int>(header.bits_per_sample);
+  auto& decoded_samples = *flac_decoder->decoded_samples_;
+  // Overwrite the output in place, reusing any existing time ticks.
+  decoded_samples.resize(header.blocksize);
+  for (unsigned int t = 0; t < header.blocksize; ++t) {
+    std::vector<int32_t>& time_sample = decoded_samples[t];
+    time_sample.resize(flac_decoder->num_channels_);
+    for (int c = 0; c < flac_decoder->num_channels_; ++c) {
+      time_sample[c] = static_cast<int32_t>(static_cast<uint32_t>(buffer[c][t])
+                                            << shift);
+    }
+  }
+  flac_decoder->frame_decoded_ = true;
+  return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+}
+
+void LibFlacErrorCallback(const FLAC__StreamDecoder* /*decoder*/,
+                          FLAC__StreamDecoderErrorStatus status,
+                          void* client_data) {
+  auto flac_decoder = static_cast<FlacDecoder*>(client_data);
+  if (flac_decoder->callback_status_.ok()) {
+    flac_decoder->callback_status_ = absl::InvalidArgumentError(
+        absl::StrCat("Failed to decode FLAC frame: ",
+                     FLAC__StreamDecoderErrorStatusString[status]));
+  }
+}
+
+FlacDecoder::FlacDecoder(const CodecConfigObu& codec_config_obu,
+                         int num_channels)
+    : FlacDecoder(std::get<FlacDecoderConfig>(
+                      codec_config_obu.GetCodecConfig().decoder_config),
+                  codec_config_obu.GetNumSamplesPerFrame(), num_channels) {}
+
+FlacDecoder::FlacDecoder(const FlacDecoderConfig& decoder_config,
+                         uint32_t num_samples_per_frame, int num_channels)
+    : DecoderBase(num_channels, static_cast<int>(num_samples_per_frame)),
+      decoder_config_(GetDecoderConfigForLibFlac(decoder_config)) {}
+
+FlacDecoder::~FlacDecoder() {
+  if (decoder_ != nullptr) {
+    FLAC__stream_decoder_delete(decoder_);
+  }
+}
+
+absl::Status FlacDecoder::Initialize() {
+  decoder_ = FLAC__stream_decoder_new();
+  if (decoder_ == nullptr) {
+    return absl::UnknownError("Failed to initialize Flac decoder.");
+  }
+
+  const FLAC__StreamDecoderInitStatus init_status =
+      FLAC__stream_decoder_init_stream(
+          decoder_, LibFlacReadCallback, /*seek_callback=*/nullptr,
+          /*tell_callback=*/nullptr, /*length_callback=*/nullptr,
+          /*eof_callback=*/nullptr, LibFlacDecoderWriteCallback,
+          /*metadata_callback=*/nullptr, LibFlacErrorCallback,
+          static_cast<void*>(this));
+  if (init_status != FLAC__STREAM_DECODER_INIT_STATUS_OK) {
+    return absl::UnknownError(
+        absl::StrCat("Failed to initialize Flac stream: ", init_status));
+  }
+
+  // Prime the decoder with a stream marker and the metadata blocks. They will
+  // be consumed before the first frame.
+  const uint8_t kStreamMarker[] = {'f', 'L', 'a', 'C'};
+  WriteBitBuffer wb(128);
+  RETURN_IF_NOT_OK(decoder_config_.ValidateAndWrite(
+      static_cast<uint32_t>(num_samples_per_channel_), kFlacAudioRollDistance,
+      wb));
+  encoded_bytes_.assign(std::begin(kStreamMarker), std::end(kStreamMarker));
+  encoded_bytes_.insert(encoded_bytes_.end(), wb.bit_buffer().begin(),
+                        wb.bit_buffer().end());
+  read_position_ = 0;
+
+  return absl::OkStatus();
+}
+
+absl::Status FlacDecoder::DecodeAudioFrame(
+    const std::vector<uint8_t>& encoded_frame,
+    std::vector<std::vector<int32_t>>& decoded_samples) {
+  // Drop any bytes which were consumed by earlier frames.
+  encoded_bytes_.erase(encoded_bytes_.begin(),
+                       encoded_bytes_.begin() + read_position_);
+  read_position_ = 0;
+  encoded_bytes_.insert(encoded_bytes_.end(), encoded_frame.begin(),
+                        encoded_frame.end());
+
+  decoded_samples_ = &decoded_samples;
+  frame_decoded_ = false;
+  callback_status_ = absl::OkStatus();
+  absl::Status status = absl::OkStatus();
+  while (!frame_decoded_ && callback_status_.ok()) {
+    // Each call processes one metadata block or one frame.
+    if (!FLAC__stream_decoder_process_single(decoder_) ||
+        FLAC__stream_decoder_get_state(decoder_) ==
+            FLAC__STREAM_DECODER_END_OF_STREAM) {
+      status = absl::InvalidArgumentError(absl::StrCat(
+          "Failed to decode FLAC frame. Decoder state: ",
+          FLAC__StreamDecoderStateString[FLAC__stream_decoder_get_state(
+              decoder_)]));
+      break;
+    }
+  }
+  decoded_samples_ = nullptr;
+
+  // Errors reported by the callbacks are more specific.
+  if (!callback_status_.ok()) {
+    status = callback_status_;
+  }
+  if (!status.ok()) {
+    // Drop what is left of the bad frame, both here and in `libflac`, so the
+    // next frame is decoded from a clean state.
+    FLAC__stream_decoder_flush(decoder_);
+    encoded_bytes_.clear();
+    read_position_ = 0;
+  }
+  return status;
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#ifndef CLI_CODEC_FLAC_DECODER_H_
+#define CLI_CODEC_FLAC_DECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "iamf/cli/codec/decoder_base.h"
+#include "iamf/obu/codec_config.h"
+#include "iamf/obu/decoder_config/flac_decoder_config.h"
+#include "include/FLAC/format.h"
+#include "include/FLAC/ordinals.h"
+#include "include/FLAC/stream_decoder.h"
+
+namespace iamf_tools {
+
+/*!\brief Decoder for FLAC audio streams.
+ *
+ * Class designed to decode one audio substream per instance when the
+ * `codec_config_id` is "fLaC" and formatted as per IAMF Spec §3.5 and §3.11.3.
+ * See https://aomediacodec.github.io/iamf/#flac-specific.
+ *
+ * The `libflac` stream decoder is fed the metadata blocks from the decoder
+ * config, followed by one frame per call to `DecodeAudioFrame()`.
+ */
+class FlacDecoder : public DecoderBase {
+ public:
+  /*!\brief Constructor.
+   *
+   * \param codec_config_obu Codec Config OBU with initialization settings.
+   * \param num_channels Number of channels for this stream.
+   */
+  FlacDecoder(const CodecConfigObu& codec_config_obu, int num_channels);
+
+  /*!\brief Constructor.
+   *
+   * \param decoder_config Decoder config with the FLAC metadata blocks.
+   * \param num_samples_per_frame Number of samples per frame.
+   * \param num_channels Number of channels for this stream.
+   */
+  FlacDecoder(const FlacDecoderConfig& decoder_config,
+              uint32_t num_samples_per_frame, int num_channels);
+
+  /*!\brief Destructor. */
+  ~FlacDecoder() override;
+
+  /*!\brief Initializes the underlying decoder.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status Initialize() override;
+
+  /*!\brief Decodes a FLAC audio frame.
+   *
+   * \param encoded_frame Frame to decode.
+   * \param decoded_samples Output decoded frames arranged in (time, sample)
+   *     axes. The samples are left-justified.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status DecodeAudioFrame(
+      const std::vector<uint8_t>& encoded_frame,
+      std::vector<std::vector<int32_t>>& decoded_samples) override;
+
+ private:
+  // `libflac` uses callbacks to read input and write output. Let the callback
+  // functions be friends so they can access the buffers of this class.
+  friend FLAC__StreamDecoderReadStatus LibFlacReadCallback(
+      const FLAC__StreamDecoder* decoder, FLAC__byte buffer[], size_t* bytes,
+      void* client_data);
+  friend FLAC__StreamDecoderWriteStatus LibFlacDecoderWriteCallback(
+      const FLAC__StreamDecoder* decoder, const FLAC__Frame* frame,
+      const FLAC__int32* const buffer[], void* client_data);
+  friend void LibFlacErrorCallback(const FLAC__StreamDecoder* decoder,
+                                   FLAC__StreamDecoderErrorStatus status,
+                                   void* client_data);
+
+  const FlacDecoderConfig decoder_config_;
+
+  // A pointer to the `libflac` decoder.
+  FLAC__StreamDecoder* decoder_ = nullptr;
+
+  // Bytes which have not yet been consumed by `libflac`, starting at
+  // `read_position_`.
+  std::vector<uint8_t> encoded_bytes_;
+  size_t read_position_ = 0;
+
+  // Output of the frame currently being decoded. Only set during
+  // `DecodeAudioFrame()`.
+  std::vector<std::vector<int32_t>>* decoded_samples_ = nullptr;
+  bool frame_decoded_ = false;
+
+  // Error reported by the callbacks while decoding the current frame.
+  absl::Status callback_status_;
+};
+
+}  // namespace iamf_tools
+
+#endif  // CLI_CODEC_FLAC_DECODER_H_
@@ -11,19 +11,26 @@
  */
 #include "iamf/cli/codec/flac_encoder.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <list>
 #include <memory>
+#include <optional>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "iamf/cli/audio_frame_with_data.h"
+#include "iamf/cli/codec/flac_decoder.h"
 #include "iamf/cli/proto/codec_config.pb.h"
 #include "iamf/common/macros.h"
 #include "iamf/common/obu_util.h"
@@ -65,14 +72,156 @@ absl::Status Configure(
   ok &= FLAC__stream_encoder_set_compression_level(
       encoder, encoder_metadata.compression_level());
 
-  ok &= FLAC__stream_encoder_set_verify(encoder, true);
-
   if (!ok) {
     return absl::UnknownError("Failed to configure Flac encoder.");
   }
 
   return absl::OkStatus();
 }
+
+// Callback to collect a frame encoded by a worker thread in parallel mode.
+FLAC__StreamEncoderWriteStatus LibFlacParallelWriteCallback(
+    const FLAC__StreamEncoder* /*encoder*/, const FLAC__byte buffer[],
+    size_t bytes, unsigned int samples, unsigned int /*current_frame*/,
+    void* client_data) {
+  // Skip the stream marker and metadata, which are flagged with `0` samples.
+  if (samples != 0) {
+    auto* encoded_frame = static_cast<std::vector<uint8_t>*>(client_data);
+    encoded_frame->insert(encoded_frame->end(), buffer, buffer + bytes);
+  }
+  return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+}
+
+// CRC-8 with polynomial x^8 + x^2 + x^1 + x^0, as used in FLAC frame headers.
+uint8_t FlacCrc8(absl::Span<const uint8_t> data) {
+  uint8_t crc = 0;
+  for (const uint8_t byte : data) {
+    crc ^= byte;
+    for (int i = 0; i < 8; ++i) {
+      crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07)
+                         : static_cast<uint8_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// CRC-16 with polynomial x^16 + x^15 + x^2 + x^0, as used in FLAC frame
+// footers.
+uint16_t FlacCrc16(absl::Span<const uint8_t> data) {
+  uint16_t crc = 0;
+  for (const uint8_t byte : data) {
+    crc ^= static_cast<uint16_t>(byte) << 8;
+    for (int i = 0; i < 8; ++i) {
+      crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x8005)
+                           : static_cast<uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// Gets the number of bytes in the UTF-8-like coded number starting with
+// `first_byte`.
+absl::StatusOr<size_t> GetCodedNumberSize(uint8_t first_byte) {
+  if ((first_byte & 0x80) == 0) {
+    return 1;
+  }
+  for (size_t size = 2; size <= 7; ++size) {
+    const uint8_t prefix_mask = static_cast<uint8_t>(0xff00 >> (size + 1));
+    const uint8_t prefix = static_cast<uint8_t>(0xff00 >> size);
+    if ((first_byte & prefix_mask) == prefix) {
+      return size;
+    }
+  }
+  return absl::InvalidArgumentError(
+      absl::StrCat("Invalid coded number in FLAC frame header: ", first_byte));
+}
+
+// Appends `frame_number` using the UTF-8-like coding of FLAC frame headers.
+void AppendCodedFrameNumber(uint32_t frame_number,
+                            std::vector<uint8_t>& output) {
+  if (frame_number < 0x80) {
+    output.push_back(static_cast<uint8_t>(frame_number));
+    return;
+  }
+  // Each continuation byte holds 6 bits. The first byte holds the rest,
+  // prefixed by one `1` bit per byte in the coded number.
+  size_t num_continuation_bytes = 1;
+  while (frame_number >> (6 * num_continuation_bytes) >=
+         (1u << (6 - num_continuation_bytes))) {
+    ++num_continuation_bytes;
+  }
+  const uint8_t prefix =
+      static_cast<uint8_t>(0xff00 >> (num_continuation_bytes + 1));
+  output.push_back(prefix | static_cast<uint8_t>(frame_number >>
+                                                 (6 * num_continuation_bytes)));
+  for (size_t i = num_continuation_bytes; i > 0; --i) {
+    output.push_back(0x80 | ((frame_number >> (6 * (i - 1))) & 0x3f));
+  }
+}
+
+// Rewrites the frame number in the header of a fixed-blocksize FLAC frame and
+// recomputes both checksums.
+absl::Status SetFlacFrameNumber(uint32_t frame_number,
+                                std::vector<uint8_t>& frame) {
+  // Frame numbers are limited to 31 bits.
+  if (frame_number >= (1u << 31)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid FLAC frame number: ", frame_number));
+  }
+
+  // Sync code, blocking strategy, block size, sample rate, channel assignment
+  // and sample size are in the first four bytes. The coded frame number
+  // follows.
+  constexpr size_t kFixedHeaderSize = 4;
+  if (frame.size() <= kFixedHeaderSize) {
+    return absl::InvalidArgumentError("FLAC frame is too small.");
+  }
+  const auto coded_number_size = GetCodedNumberSize(frame[kFixedHeaderSize]);
+  if (!coded_number_size.ok()) {
+    return coded_number_size.status();
+  }
+
+  // Some block sizes and sample rates are stored after the frame number.
+  const uint8_t block_size_code = frame[2] >> 4;
+  const uint8_t sample_rate_code = frame[2] & 0x0f;
+  const size_t block_size_extra_bytes =
+      block_size_code == 6 ? 1 : (block_size_code == 7 ? 2 : 0);
+  const size_t sample_rate_extra_bytes =
+      sample_rate_code == 12 ? 1
+                             : (sample_rate_code == 13 || sample_rate_code == 14
+                                    ? 2
+                                    : 0);
+  const size_t extra_bytes_start = kFixedHeaderSize + *coded_number_size;
+  const size_t crc8_position =
+      extra_bytes_start + block_size_extra_bytes + sample_rate_extra_bytes;
+  constexpr size_t kCrc16Size = 2;
+  if (frame.size() < crc8_position + 1 + kCrc16Size) {
+    return absl::InvalidArgumentError("FLAC frame is too small.");
+  }
+
+  std::vector<uint8_t> rewritten_frame;
+  rewritten_frame.reserve(frame.size() + 6);
+  rewritten_frame.insert(rewritten_frame.end(), frame.begin(),
+                         frame.begin() + kFixedHeaderSize);
+  AppendCodedFrameNumber(frame_number, rewritten_frame);
+  rewritten_frame.insert(rewritten_frame.end(),
+                         frame.begin() + extra_bytes_start,
+                         frame.begin() + crc8_position);
+  rewritten_frame.push_back(FlacCrc8(rewritten_frame));
+
+  // The subframes start on the byte after the header, so they are unaffected
+  // by the size of the header.
+  rewritten_frame.insert(rewritten_frame.end(),
+                         frame.begin() + crc8_position + 1,
+                         frame.end() - kCrc16Size);
+  const uint16_t crc16 = FlacCrc16(rewritten_frame);
+  rewritten_frame.push_back(static_cast<uint8_t>(crc16 >> 8));
+  rewritten_frame.push_back(static_cast<uint8_t>(crc16 & 0xff));
+
+  frame = std::move(rewritten_frame);
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 FLAC__StreamEncoderWriteStatus LibFlacWriteCallback(
@@ -107,8 +256,18 @@ FLAC__StreamEncoderWriteStatus LibFlacWriteCallback(
   flac_frame.num_samples += samples;
 
   if (flac_frame.num_samples == flac_encoder->num_samples_per_frame_) {
-    // A frame has been completed; move to the finalized frames.
-    flac_encoder->finalized_audio_frames_.emplace_back(
+    if (flac_encoder->verify_frames_) {
+      // A frame has been completed; hold it until a worker thread verifies it.
+      flac_encoder->QueueFrameJob(
+          {.frame_index = current_frame,
+           .encoder_input_pcm = std::move(flac_frame.encoder_input_pcm),
+           .encoded_frame = std::move(
+               flac_frame.audio_frame_with_data->obu.audio_frame_)});
+      return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+    }
+
+    // A frame has been completed; move it to the finalized frames.
+    flac_encoder->PushFinalizedAudioFrame(
         std::move(*flac_frame_iter->second.audio_frame_with_data));
 
     // The frame is fully processed and no longer needed.
@@ -127,16 +286,27 @@ void LibFlacMetadataCallback(const FLAC__StreamEncoder* /*encoder*/,
     LOG(INFO) << "Received `STREAMINFO` metadata.";
     // Just validate we got the `STREAMINFO` metadata at some point. IAMF
     // requires some fields to be set constant and different from what will be
-    // returned by `libflac`.
+    // returned by `libflac`. Frames which are held for verification are
+    // finished later by `Finalize()`.
     auto flac_encoder = static_cast<FlacEncoder*>(client_data);
-
-    absl::MutexLock lock(&flac_encoder->mutex_);
-    flac_encoder->finished_ = true;
+    if (!flac_encoder->verify_frames_) {
+      flac_encoder->finished_.store(true, std::memory_order_release);
+    }
   }
 }
 
 FlacEncoder::~FlacEncoder() {
-  FLAC__stream_encoder_delete(encoder_);
+  {
+    absl::MutexLock lock(&mutex_);
+    shutting_down_ = true;
+    job_available_.SignalAll();
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  if (encoder_ != nullptr) {
+    FLAC__stream_encoder_delete(encoder_);
+  }
 
   absl::MutexLock lock(&mutex_);
   if (!frame_index_to_frame_.empty()) {
@@ -150,6 +320,11 @@ absl::Status FlacEncoder::EncodeAudioFrame(
     std::unique_ptr<AudioFrameWithData> partial_audio_frame_with_data) {
   RETURN_IF_NOT_OK(ValidateNotFinalized());
   RETURN_IF_NOT_OK(ValidateInputSamples(samples));
+  {
+    // Report any earlier failure from the worker threads.
+    absl::MutexLock lock(&mutex_);
+    RETURN_IF_NOT_OK(worker_status_);
+  }
   const int num_samples_per_channel = static_cast<int>(num_samples_per_frame_);
 
   LOG_FIRST_N(INFO, 1) << "num_samples_per_channel: "
@@ -189,25 +364,56 @@ absl::Status FlacEncoder::EncodeAudioFrame(
                        << " bytes representing " << num_samples_per_channel
                        << " x " << num_channels_ << " samples.";
 
-  if (!FLAC__stream_encoder_process_interleaved(
-          encoder_, encoder_input_pcm.data(), num_samples_per_channel)) {
-    return absl::UnknownError("Flac failed to encode.");
-  }
+  if (encode_in_parallel_) {
+    const unsigned int frame_index = next_frame_index_++;
+    {
+      absl::MutexLock lock(&mutex_);
+      FlacFrame& flac_frame = frame_index_to_frame_[frame_index];
+      flac_frame.audio_frame_with_data =
+          std::move(partial_audio_frame_with_data);
+      flac_frame.num_samples = num_samples_per_frame_;
+      QueueFrameJob({.frame_index = frame_index,
+                     .encoder_input_pcm = std::move(encoder_input_pcm)});
+    }
+  } else {
+    if (!FLAC__stream_encoder_process_interleaved(
+            encoder_, encoder_input_pcm.data(), num_samples_per_channel)) {
+      return absl::UnknownError("Flac failed to encode.");
+    }
 
-  absl::MutexLock lock(&mutex_);
+    absl::MutexLock lock(&mutex_);
 
-  // Transfer ownership of the partial audio frame so it can be finalized later.
-  frame_index_to_frame_[next_frame_index_++].audio_frame_with_data =
-      std::move(partial_audio_frame_with_data);
+    // Transfer ownership of the partial audio frame so it can be finalized
+    // later. Keep the input to verify the frame once it is finished.
+    FlacFrame& flac_frame = frame_index_to_frame_[next_frame_index_++];
+    flac_frame.audio_frame_with_data = std::move(partial_audio_frame_with_data);
+    if (verify_frames_) {
+      flac_frame.encoder_input_pcm = std::move(encoder_input_pcm);
+    }
+  }
+
+  // Keep at most one frame per worker in flight. This makes the number of
+  // frames available to be popped independent of thread scheduling.
+  const unsigned int num_frames_in_flight = workers_.size();
+  if (!workers_.empty() && next_frame_index_ > num_frames_in_flight) {
+    return FinalizeWorkerFramesBefore(next_frame_index_ -
+                                      num_frames_in_flight);
+  }
   return absl::OkStatus();
 }
 
 absl::Status FlacEncoder::Finalize() {
   // Signal to `libflac` the encoder is finished.
-  if (!FLAC__stream_encoder_finish(encoder_)) {
+  if (!encode_in_parallel_ && !FLAC__stream_encoder_finish(encoder_)) {
     return absl::UnknownError("Failed to finalize Flac encoder.");
   }
+  if (workers_.empty()) {
+    return absl::OkStatus();
+  }
 
+  // Wait for the remaining frames to be encoded or verified.
+  RETURN_IF_NOT_OK(FinalizeWorkerFramesBefore(next_frame_index_));
+  finished_.store(true, std::memory_order_release);
   return absl::OkStatus();
 }
 
@@ -223,17 +429,179 @@ absl::Status FlacEncoder::InitializeEncoder() {
                              num_samples_per_frame_, output_sample_rate_,
                              input_pcm_bit_depth_, encoder_));
 
-  // Initialize the FLAC encoder.
-  FLAC__StreamEncoderInitStatus init_status = FLAC__stream_encoder_init_stream(
-      encoder_, LibFlacWriteCallback, /*seek_callback=*/nullptr,
-      /*tell_callback=*/nullptr, LibFlacMetadataCallback,
-      static_cast<void*>(this));
+  // Adaptive mid-side stereo depends on previous frames. Frames can only be
+  // encoded independently when it is not in use.
+  const bool frames_are_independent =
+      num_channels_ != 2 ||
+      !FLAC__stream_encoder_get_loose_mid_side_stereo(encoder_);
+  const uint32_t num_threads = std::max(encoder_metadata_.num_threads(), 1u);
+  if (num_threads > 1 && !frames_are_independent) {
+    LOG(WARNING) << "Encoding FLAC frames serially because the compression "
+                    "level uses adaptive mid-side stereo.";
+  }
+  encode_in_parallel_ = num_threads > 1 && frames_are_independent;
+  verify_frames_ = encoder_metadata_.verify_frames();
+
+  if (encode_in_parallel_) {
+    FLAC__stream_encoder_delete(encoder_);
+    encoder_ = nullptr;
+  } else {
+    // Initialize the FLAC encoder.
+    FLAC__StreamEncoderInitStatus init_status =
+        FLAC__stream_encoder_init_stream(
+            encoder_, LibFlacWriteCallback, /*seek_callback=*/nullptr,
+            /*tell_callback=*/nullptr, LibFlacMetadataCallback,
+            static_cast<void*>(this));
+
+    if (init_status != FLAC__STREAM_ENCODER_INIT_STATUS_OK) {
+      return absl::UnknownError(
+          absl::StrCat("Failed to initialize Flac stream: ", init_status));
+    }
+  }
+
+  if (encode_in_parallel_ || verify_frames_) {
+    for (uint32_t i = 0; i < num_threads; ++i) {
+      workers_.emplace_back(&FlacEncoder::WorkerLoop, this);
+    }
+  }
+
+  return absl::OkStatus();
+}
+
+void FlacEncoder::WorkerLoop() {
+  // Each worker owns its own `libflac` instances.
+  FLAC__StreamEncoder* encoder =
+      encode_in_parallel_ ? FLAC__stream_encoder_new() : nullptr;
+  std::optional<FlacDecoder> decoder;
+  absl::Status decoder_status = absl::OkStatus();
+  if (verify_frames_) {
+    decoder.emplace(decoder_config_, num_samples_per_frame_, num_channels_);
+    decoder_status = decoder->Initialize();
+  }
+
+  while (true) {
+    FrameJob job;
+    {
+      absl::MutexLock lock(&mutex_);
+      while (pending_jobs_.empty() && !shutting_down_) {
+        job_available_.Wait(&mutex_);
+      }
+      if (shutting_down_) {
+        break;
+      }
+      job = std::move(pending_jobs_.front());
+      pending_jobs_.pop_front();
+    }
+
+    absl::Status status = decoder_status;
+    if (status.ok() && job.encoded_frame.empty()) {
+      status = EncodeFrameJob(encoder, job);
+    }
+    if (status.ok() && decoder.has_value()) {
+      status = VerifyFrameJob(*decoder, job);
+    }
+
+    absl::MutexLock lock(&mutex_);
+    if (!status.ok()) {
+      if (worker_status_.ok()) {
+        worker_status_ = status;
+      }
+    } else {
+      FlacFrame& flac_frame = frame_index_to_frame_.at(job.frame_index);
+      flac_frame.audio_frame_with_data->obu.audio_frame_ =
+          std::move(job.encoded_frame);
+      flac_frame.is_finished = true;
+    }
+    job_finished_.SignalAll();
+  }
+  if (encoder != nullptr) {
+    FLAC__stream_encoder_delete(encoder);
+  }
+}
 
+absl::Status FlacEncoder::EncodeFrameJob(FLAC__StreamEncoder* encoder,
+                                         FrameJob& job) const {
+  if (encoder == nullptr) {
+    return absl::UnknownError("Failed to initialize Flac encoder.");
+  }
+
+  // `libflac` resets the configuration when an encoder is finished, so it is
+  // configured again for every frame.
+  RETURN_IF_NOT_OK(Configure(encoder_metadata_, decoder_config_, num_channels_,
+                             num_samples_per_frame_, output_sample_rate_,
+                             input_pcm_bit_depth_, encoder));
+  const FLAC__StreamEncoderInitStatus init_status =
+      FLAC__stream_encoder_init_stream(
+          encoder, LibFlacParallelWriteCallback, /*seek_callback=*/nullptr,
+          /*tell_callback=*/nullptr, /*metadata_callback=*/nullptr,
+          static_cast<void*>(&job.encoded_frame));
   if (init_status != FLAC__STREAM_ENCODER_INIT_STATUS_OK) {
     return absl::UnknownError(
         absl::StrCat("Failed to initialize Flac stream: ", init_status));
   }
+  const bool encoded = FLAC__stream_encoder_process_interleaved(
+      encoder, job.encoder_input_pcm.data(), num_samples_per_frame_);
+  if (!FLAC__stream_encoder_finish(encoder) || !encoded) {
+    return absl::UnknownError("Flac failed to encode.");
+  }
+
+  // Every frame was encoded as the first frame of a new stream.
+  return SetFlacFrameNumber(job.frame_index, job.encoded_frame);
+}
+
+absl::Status FlacEncoder::VerifyFrameJob(FlacDecoder& decoder,
+                                         const FrameJob& job) const {
+  std::vector<std::vector<int32_t>> decoded_samples;
+  RETURN_IF_NOT_OK(
+      decoder.DecodeAudioFrame(job.encoded_frame, decoded_samples));
+
+  // The decoder outputs left-justified samples, but `libflac` was given
+  // right-justified samples.
+  const int shift = 32 - static_cast<int>(input_pcm_bit_depth_);
+  bool matches_input = decoded_samples.size() * num_channels_ ==
+                       job.encoder_input_pcm.size();
+  for (size_t t = 0; matches_input && t < decoded_samples.size(); ++t) {
+    for (int c = 0; c < num_channels_; ++c) {
+      if ((decoded_samples[t][c] >> shift) !=
+          job.encoder_input_pcm[t * num_channels_ + c]) {
+        matches_input = false;
+        break;
+      }
+    }
+  }
+  if (!matches_input) {
+    return absl::InternalError(absl::StrCat(
+        "Flac verification failed. Decoded frame ", job.frame_index,
+        " does not match the input."));
+  }
+  return absl::OkStatus();
+}
+
+void FlacEncoder::QueueFrameJob(FrameJob&& job) {
+  pending_jobs_.push_back(std::move(job));
+  job_available_.Signal();
+}
 
+absl::Status FlacEncoder::FinalizeWorkerFramesBefore(
+    unsigned int end_frame_index) {
+  absl::MutexLock lock(&mutex_);
+  while (!frame_index_to_frame_.empty() &&
+         frame_index_to_frame_.begin()->first < end_frame_index) {
+    auto flac_frame_iter = frame_index_to_frame_.begin();
+    if (flac_frame_iter->second.num_samples != num_samples_per_frame_) {
+      // `libflac` has not finished the frame, so no worker has it yet.
+      break;
+    }
+    while (worker_status_.ok() && !flac_frame_iter->second.is_finished) {
+      job_finished_.Wait(&mutex_);
+      flac_frame_iter = frame_index_to_frame_.begin();
+    }
+    RETURN_IF_NOT_OK(worker_status_);
+
+    PushFinalizedAudioFrame(
+        std::move(*flac_frame_iter->second.audio_frame_with_data));
+    frame_index_to_frame_.erase(flac_frame_iter);
+  }
   return absl::OkStatus();
 }
 
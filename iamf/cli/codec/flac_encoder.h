@@ -14,14 +14,18 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/btree_map.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "iamf/cli/audio_frame_with_data.h"
 #include "iamf/cli/codec/encoder_base.h"
+#include "iamf/cli/codec/flac_decoder.h"
 #include "iamf/cli/proto/codec_config.pb.h"
 #include "iamf/obu/codec_config.h"
 #include "iamf/obu/decoder_config/flac_decoder_config.h"
@@ -38,6 +42,12 @@ struct FlacFrame {
 
   // Number of samples represented by raw data.
   unsigned int num_samples = 0;
+
+  // Right-justified interleaved input to `libflac`. Kept to verify the frame.
+  std::vector<FLAC__int32> encoder_input_pcm;
+
+  // Whether the frame is encoded, and verified when requested.
+  bool is_finished = false;
 };
 
 /*!\brief Encodes FLAC frames `FlacEncoder` using `libflac`.
@@ -56,6 +66,19 @@ struct FlacFrame {
  * `Finalize()` function closes the encoder. When the `STREAMINFO` metadata
  * block is produced, the last batch of Audio Frame OBUs are encoded and
  * available to be popped.
+ *
+ * When `FlacEncoderMetadata::num_threads` is greater than one, frames are
+ * instead encoded in parallel. Each worker thread owns a `libflac` encoder
+ * which encodes one whole frame at a time. The frame number in the header is
+ * then patched so the output is identical to that of a single encoder. After
+ * each call to `EncodeAudioFrame()` all but the latest `num_threads` frames
+ * are available to be popped. Configurations where `libflac` carries state
+ * between frames (adaptive mid-side stereo) are always encoded serially.
+ *
+ * When `FlacEncoderMetadata::verify_frames` is true (the default), every
+ * encoded frame is decoded with `FlacDecoder` on a worker thread and compared
+ * against the input. Frames are held until they are verified. A mismatch is
+ * reported by the next call to `EncodeAudioFrame()` or by `Finalize()`.
  */
 class FlacEncoder : public EncoderBase {
  public:
@@ -124,9 +147,81 @@ class FlacEncoder : public EncoderBase {
   const iamf_tools_cli_proto::FlacEncoderMetadata encoder_metadata_;
   const FlacDecoderConfig decoder_config_;
 
-  // A pointer to the `libflac` encoder.
+  // A job for a worker thread. Frames are encoded first when
+  // `encoded_frame` is empty, then verified when requested.
+  struct FrameJob {
+    unsigned int frame_index;
+    std::vector<FLAC__int32> encoder_input_pcm;
+    std::vector<uint8_t> encoded_frame;
+  };
+
+  /*!\brief Processes jobs until the encoder is destroyed. */
+  void WorkerLoop();
+
+  /*!\brief Encodes a single frame with a dedicated `libflac` encoder.
+   *
+   * \param encoder `libflac` encoder owned by the calling worker thread.
+   * \param job Job to encode. Its `encoded_frame` is filled with a FLAC frame
+   *     numbered as `frame_index`.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status EncodeFrameJob(FLAC__StreamEncoder* encoder,
+                              FrameJob& job) const;
+
+  /*!\brief Decodes an encoded frame and compares it against the input.
+   *
+   * \param decoder Decoder owned by the calling worker thread.
+   * \param job Job to verify.
+   * \return `absl::OkStatus()` if the frame decodes to the input. A specific
+   *     status on failure.
+   */
+  absl::Status VerifyFrameJob(FlacDecoder& decoder, const FrameJob& job) const;
+
+  /*!\brief Queues a job for the worker threads.
+   *
+   * \param job Job to queue.
+   */
+  void QueueFrameJob(FrameJob&& job) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /*!\brief Waits for and finalizes frames processed by the worker threads.
+   *
+   * \param end_frame_index Frames with an index lower than this are
+   *     finalized, in order. Stops early at a frame which `libflac` has not
+   *     yet finished.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status FinalizeWorkerFramesBefore(unsigned int end_frame_index);
+
+  // A pointer to the `libflac` encoder. Unused in parallel mode.
   FLAC__StreamEncoder* encoder_ = nullptr;
 
+  // Whether frames are encoded by the worker threads.
+  bool encode_in_parallel_ = false;
+
+  // Whether frames are verified by the worker threads.
+  bool verify_frames_ = false;
+
+  // Worker threads which encode frames in parallel mode and verify frames when
+  // requested. Empty when neither is needed.
+  std::vector<std::thread> workers_;
+
+  // Mutex to guard the state shared with the worker threads.
+  mutable absl::Mutex mutex_;
+
+  // Jobs waiting for a worker thread.
+  std::deque<FrameJob> pending_jobs_ ABSL_GUARDED_BY(mutex_);
+
+  // Signaled when a job is added or the workers should shut down.
+  absl::CondVar job_available_;
+
+  // Signaled when a worker finishes a job.
+  absl::CondVar job_finished_;
+
+  // First error reported by a worker thread.
+  absl::Status worker_status_ ABSL_GUARDED_BY(mutex_);
+
+  bool shutting_down_ ABSL_GUARDED_BY(mutex_) = false;
+
   // Tracks the next frame index to use. This data is associated with the
   // `current_frame` argument to `flac_write_callback`.
   unsigned int next_frame_index_ = 0;
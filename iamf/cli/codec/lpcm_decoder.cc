@@ -14,7 +14,6 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -22,7 +21,7 @@
 #include "absl/types/span.h"
 #include "iamf/cli/codec/decoder_base.h"
 #include "iamf/common/macros.h"
-#include "iamf/common/obu_util.h"
+#include "iamf/common/pcm_conversion.h"
 #include "iamf/obu/codec_config.h"
 #include "iamf/obu/decoder_config/lpcm_decoder_config.h"
 
@@ -39,6 +38,16 @@ LpcmDecoder::LpcmDecoder(const CodecConfigObu& codec_config_obu,
 
 absl::Status LpcmDecoder::Initialize() {
   RETURN_IF_NOT_OK(decoder_config_.Validate(audio_roll_distance_));
+
+  // Select the unpacking function for the input format once.
+  uint8_t bit_depth;
+  RETURN_IF_NOT_OK(decoder_config_.GetBitDepthToMeasureLoudness(bit_depth));
+  const auto unpack_pcm_samples =
+      GetPcmUnpacker(bit_depth, !decoder_config_.IsLittleEndian());
+  if (!unpack_pcm_samples.ok()) {
+    return unpack_pcm_samples.status();
+  }
+  unpack_pcm_samples_ = *unpack_pcm_samples;
   return absl::OkStatus();
 }
 
@@ -68,31 +77,19 @@ absl::Status LpcmDecoder::DecodeAudioFrame(
         " bytes, which is not a multiple of the bytes per sample (",
         bytes_per_sample, ") * number of channels (", num_channels_, ")."));
   }
-  // Each time tick has one sample for each channel.
-  const size_t num_time_ticks =
-      encoded_frame.size() / bytes_per_sample / num_channels_;
-  const bool little_endian = decoder_config_.IsLittleEndian();
-
-  decoded_samples.reserve(decoded_samples.size() + num_time_ticks);
-  int32_t sample_result;
-  for (size_t t = 0; t < num_time_ticks; ++t) {
-    // One sample for each channel in this time tick.
-    std::vector<int32_t> time_tick_samples(num_channels_);
-    for (size_t c = 0; c < num_channels_; ++c) {
-      const size_t offset = (t * num_channels_ + c) * bytes_per_sample;
-      absl::Span<const uint8_t> input_bytes(encoded_frame.data() + offset,
-                                            bytes_per_sample);
-      if (little_endian) {
-        status = LittleEndianBytesToInt32(input_bytes, sample_result);
-      } else {
-        status = BigEndianBytesToInt32(input_bytes, sample_result);
-      }
-      RETURN_IF_NOT_OK(status);
-      time_tick_samples[c] = sample_result;
-    }
-    decoded_samples.push_back(std::move(time_tick_samples));
+  if (unpack_pcm_samples_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "LpcmDecoder::DecodeAudioFrame() failed: `Initialize()` was not "
+        "called.");
   }
-  return absl::OkStatus();
+
+  // Unpack the samples in place into a reusable interleaved buffer, storing
+  // them in the upper bytes of an `int32_t`.
+  decoded_pcm_.resize(encoded_frame.size() / bytes_per_sample);
+  unpack_pcm_samples_(encoded_frame.data(), absl::MakeSpan(decoded_pcm_));
+
+  // Each time tick has one sample for each channel.
+  return DeinterleaveSamples(decoded_pcm_, num_channels_, decoded_samples);
 }
 
 }  // namespace iamf_tools
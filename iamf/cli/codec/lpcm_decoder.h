@@ -19,6 +19,7 @@
 
 #include "absl/status/status.h"
 #include "iamf/cli/codec/decoder_base.h"
+#include "iamf/common/pcm_conversion.h"
 #include "iamf/obu/codec_config.h"
 #include "iamf/obu/decoder_config/lpcm_decoder_config.h"
 
@@ -52,6 +53,12 @@ class LpcmDecoder : public DecoderBase {
   // We don't need the audio_roll_distance_ for decoding, but needed to validate
   // the LpcmDecoderConfig.
   int16_t audio_roll_distance_;
+
+  // Unpacks samples from the input format. Selected by `Initialize()`.
+  PcmUnpacker unpack_pcm_samples_ = nullptr;
+
+  // Scratch buffer reused by every call to `DecodeAudioFrame()`.
+  std::vector<int32_t> decoded_pcm_;
 };
 
 }  // namespace iamf_tools
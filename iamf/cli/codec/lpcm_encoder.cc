@@ -19,10 +19,10 @@
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
-#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "iamf/cli/audio_frame_with_data.h"
-#include "iamf/cli/cli_util.h"
 #include "iamf/common/macros.h"
+#include "iamf/common/pcm_conversion.h"
 #include "iamf/obu/decoder_config/lpcm_decoder_config.h"
 
 namespace iamf_tools {
@@ -47,6 +47,16 @@ absl::Status LpcmEncoder::InitializeEncoder() {
     return absl::InvalidArgumentError("Unrecognized sample_format_flags");
   }
 
+  // Select the packing function for the output format once.
+  const bool big_endian = !(decoder_config_.sample_format_flags_bitmask_ &
+                            LpcmDecoderConfig::kLpcmLittleEndian);
+  const auto pack_pcm_samples =
+      GetPcmPacker(decoder_config_.sample_size_, big_endian);
+  if (!pack_pcm_samples.ok()) {
+    return pack_pcm_samples.status();
+  }
+  pack_pcm_samples_ = *pack_pcm_samples;
+
   LOG_FIRST_N(INFO, 1) << "  Configured LPCM encoder for "
                        << num_samples_per_frame_ << " samples of "
                        << num_channels_ << " channels as "
@@ -68,19 +78,17 @@ absl::Status LpcmEncoder::EncodeAudioFrame(
   RETURN_IF_NOT_OK(ValidateInputSamples(samples));
 
   // Write the entire PCM frame the buffer. Nothing should be trimmed when
-  // encoding the sample.
+  // encoding the sample. The interleaved buffer keeps its capacity between
+  // frames.
+  interleaved_pcm_.resize(samples.size() * num_channels_);
+  RETURN_IF_NOT_OK(
+      InterleaveSamples(samples, absl::MakeSpan(interleaved_pcm_)));
   auto& audio_frame = partial_audio_frame_with_data->obu.audio_frame_;
-  const bool big_endian = !(decoder_config_.sample_format_flags_bitmask_ &
-                            LpcmDecoderConfig::kLpcmLittleEndian);
-  RETURN_IF_NOT_OK(WritePcmFrameToBuffer(
-      samples, /*samples_to_trim_at_start=*/0,
-      /*samples_to_trim_at_end=*/0, decoder_config_.sample_size_, big_endian,
-      audio_frame));
-
-  absl::MutexLock lock(&mutex_);
-  finalized_audio_frames_.emplace_back(
-      std::move(*partial_audio_frame_with_data));
+  audio_frame.resize(interleaved_pcm_.size() *
+                     (decoder_config_.sample_size_ / 8));
+  pack_pcm_samples_(interleaved_pcm_, audio_frame.data());
 
+  PushFinalizedAudioFrame(std::move(*partial_audio_frame_with_data));
   return absl::OkStatus();
 }
 
@@ -19,6 +19,7 @@
 #include "absl/status/status.h"
 #include "iamf/cli/audio_frame_with_data.h"
 #include "iamf/cli/codec/encoder_base.h"
+#include "iamf/common/pcm_conversion.h"
 #include "iamf/obu/codec_config.h"
 #include "iamf/obu/decoder_config/lpcm_decoder_config.h"
 
@@ -66,6 +67,12 @@ class LpcmEncoder : public EncoderBase {
       override;
 
   const LpcmDecoderConfig decoder_config_;
+
+  // Packs samples into the output format. Selected by `InitializeEncoder()`.
+  PcmPacker pack_pcm_samples_ = nullptr;
+
+  // Scratch buffer reused by every call to `EncodeAudioFrame()`.
+  std::vector<int32_t> interleaved_pcm_;
 };
 }  // namespace iamf_tools
 
@@ -11,18 +11,19 @@
  */
 #include "iamf/cli/codec/opus_decoder.h"
 
-#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "iamf/cli/codec/decoder_base.h"
 #include "iamf/cli/codec/opus_utils.h"
 #include "iamf/cli/proto/codec_config.pb.h"
 #include "iamf/common/macros.h"
-#include "iamf/common/obu_util.h"
+#include "iamf/common/pcm_conversion.h"
 #include "iamf/obu/codec_config.h"
 #include "iamf/obu/decoder_config/opus_decoder_config.h"
 #include "include/opus.h"
@@ -76,6 +77,11 @@ absl::Status OpusDecoder::Initialize() {
   RETURN_IF_NOT_OK(OpusErrorCodeToAbslStatus(
       opus_error_code, "Failed to initialize Opus decoder."));
 
+  // Allocate buffers large enough for the largest frame once, so decoding does
+  // not allocate.
+  output_pcm_float_.resize(num_samples_per_channel_ * num_channels_);
+  output_pcm_int32_.resize(num_samples_per_channel_ * num_channels_);
+
   return absl::OkStatus();
 }
 
@@ -85,18 +91,13 @@ absl::Status OpusDecoder::DecodeAudioFrame(
   // `opus_decode_float` decodes to `float` samples with channels interlaced.
   // Typically these values are in the range of [-1, +1] (always for
   // `iamf_tools`-encoded data). Values outside of that range will be clipped in
-  // `NormalizedFloatToInt32`.
-  std::vector<float> output_pcm_float;
-  output_pcm_float.resize(num_samples_per_channel_ * num_channels_);
-
-  // Transform the data and feed it to the decoder.
-  std::vector<unsigned char> input_data(encoded_frame.size());
-  std::transform(encoded_frame.begin(), encoded_frame.end(), input_data.begin(),
-                 [](uint8_t c) { return static_cast<unsigned char>(c); });
-
+  // `NormalizedFloatsToInt32`.
+  //
+  // `uint8_t` and `unsigned char` are the same type, so the payload can be
+  // passed in place.
   const int num_output_samples = opus_decode_float(
-      decoder_, input_data.data(), static_cast<opus_int32>(input_data.size()),
-      output_pcm_float.data(),
+      decoder_, encoded_frame.data(),
+      static_cast<opus_int32>(encoded_frame.size()), output_pcm_float_.data(),
       /*frame_size=*/num_samples_per_channel_,
       /*decode_fec=*/0);
   if (num_output_samples < 0) {
@@ -104,25 +105,19 @@ absl::Status OpusDecoder::DecodeAudioFrame(
     return OpusErrorCodeToAbslStatus(num_output_samples,
                                      "Failed to decode Opus frame.");
   }
-  output_pcm_float.resize(num_output_samples * num_channels_);
   LOG_FIRST_N(INFO, 3) << "Opus decoded " << num_output_samples
                        << " samples per channel. With " << num_channels_
                        << " channels.";
+
   // Convert data to channels arranged in (time, channel) axes. There can only
   // be one or two channels.
-  decoded_samples.reserve(decoded_samples.size() +
-                          output_pcm_float.size() / num_channels_);
-  for (int i = 0; i < output_pcm_float.size(); i += num_channels_) {
-    std::vector<int32_t> time_sample(num_channels_, 0);
-    // Grab samples in all channels associated with this time instant.
-    for (int j = 0; j < num_channels_; ++j) {
-      RETURN_IF_NOT_OK(
-          NormalizedFloatToInt32(output_pcm_float[i + j], time_sample[j]));
-    }
-    decoded_samples.push_back(time_sample);
-  }
-
-  return absl::OkStatus();
+  const size_t num_decoded_samples = num_output_samples * num_channels_;
+  RETURN_IF_NOT_OK(NormalizedFloatsToInt32(
+      absl::MakeConstSpan(output_pcm_float_).first(num_decoded_samples),
+      absl::MakeSpan(output_pcm_int32_).first(num_decoded_samples)));
+  return DeinterleaveSamples(
+      absl::MakeConstSpan(output_pcm_int32_).first(num_decoded_samples),
+      num_channels_, decoded_samples);
 }
 
 }  // namespace iamf_tools
@@ -63,6 +63,10 @@ class OpusDecoder : public DecoderBase {
   const uint32_t output_sample_rate_;
 
   LibOpusDecoder* decoder_ = nullptr;
+
+  // Scratch buffers reused by every call to `DecodeAudioFrame()`.
+  std::vector<float> output_pcm_float_;
+  std::vector<int32_t> output_pcm_int32_;
 };
 
 }  // namespace iamf_tools
@@ -11,6 +11,7 @@
  */
 #include "iamf/cli/codec/opus_encoder.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -19,12 +20,12 @@
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
-#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "iamf/cli/audio_frame_with_data.h"
 #include "iamf/cli/codec/opus_utils.h"
 #include "iamf/cli/proto/codec_config.pb.h"
 #include "iamf/common/macros.h"
-#include "iamf/common/obu_util.h"
+#include "iamf/common/pcm_conversion.h"
 #include "iamf/obu/decoder_config/opus_decoder_config.h"
 #include "include/opus.h"
 #include "include/opus_defines.h"
@@ -52,20 +53,15 @@ absl::Status ValidateDecoderConfig(
   return absl::OkStatus();
 }
 
-absl::StatusOr<int> EncodeFloat(
-    const std::vector<std::vector<int32_t>>& samples,
-    int num_samples_per_channel, int num_channels, ::OpusEncoder* encoder,
-    std::vector<uint8_t>& audio_frame) {
+absl::StatusOr<int> EncodeFloat(absl::Span<const int32_t> interleaved_pcm,
+                                int num_samples_per_channel,
+                                ::OpusEncoder* encoder,
+                                std::vector<float>& encoder_input_pcm,
+                                std::vector<uint8_t>& audio_frame) {
   //  `opus_encode_float` usually recommends the input is normalized to the
   //  range [-1, 1].
-  std::vector<float> encoder_input_pcm(num_samples_per_channel * num_channels,
-                                       0.0);
-  for (int t = 0; t < samples.size(); t++) {
-    for (int c = 0; c < num_channels; ++c) {
-      encoder_input_pcm[t * num_channels + c] =
-          Int32ToNormalizedFloat(samples[t][c]);
-    }
-  }
+  RETURN_IF_NOT_OK(Int32ToNormalizedFloats(
+      interleaved_pcm, absl::MakeSpan(encoder_input_pcm)));
 
   // TODO(b/311655037): Test that samples are passed to `opus_encode_float` in
   //                    the correct order. Maybe also check they are in the
@@ -76,26 +72,16 @@ absl::StatusOr<int> EncodeFloat(
                            static_cast<opus_int32>(audio_frame.size()));
 }
 
-absl::StatusOr<int> EncodeInt16(
-    const std::vector<std::vector<int32_t>>& samples,
-    int num_samples_per_channel, int num_channels, ::OpusEncoder* encoder,
-    std::vector<uint8_t>& audio_frame) {
-  // `libopus` requires the native system endianness as input.
-  const bool big_endian = IsNativeBigEndian();
-  // Convert input to the array that will be passed to `opus_encode`.
-  std::vector<opus_int16> encoder_input_pcm(
-      num_samples_per_channel * num_channels, 0);
-  int write_position = 0;
-  for (int t = 0; t < samples.size(); t++) {
-    for (int c = 0; c < samples[0].size(); ++c) {
-      // Convert all frames to 16-bit samples for input to Opus.
-      // Write the 16-bit samples directly into the pcm vector.
-      RETURN_IF_NOT_OK(
-          WritePcmSample(static_cast<uint32_t>(samples[t][c]), 16, big_endian,
-                         reinterpret_cast<uint8_t*>(encoder_input_pcm.data()),
-                         write_position));
-    }
-  }
+absl::StatusOr<int> EncodeInt16(absl::Span<const int32_t> interleaved_pcm,
+                                int num_samples_per_channel,
+                                ::OpusEncoder* encoder,
+                                std::vector<opus_int16>& encoder_input_pcm,
+                                std::vector<uint8_t>& audio_frame) {
+  // Convert all samples to 16-bit samples for input to Opus. `libopus` requires
+  // the native system endianness as input, which is what the conversion
+  // produces.
+  RETURN_IF_NOT_OK(RightJustifyFromInt32(interleaved_pcm,
+                                         absl::MakeSpan(encoder_input_pcm)));
 
   return opus_encode(encoder, encoder_input_pcm.data(), num_samples_per_channel,
                      audio_frame.data(),
@@ -150,6 +136,15 @@ absl::Status OpusEncoder::InitializeEncoder() {
   RETURN_IF_NOT_OK(OpusErrorCodeToAbslStatus(
       opus_error_code, "Failed to initialize Opus encoder."));
 
+  // Allocate the buffers for a full frame once, so encoding does not allocate.
+  const size_t num_samples_per_frame = num_samples_per_frame_ * num_channels_;
+  interleaved_pcm_.resize(num_samples_per_frame);
+  if (encoder_metadata_.use_float_api()) {
+    encoder_input_pcm_float_.resize(num_samples_per_frame);
+  } else {
+    encoder_input_pcm_int16_.resize(num_samples_per_frame);
+  }
+
   // `OPUS_SET_BITRATE` treats this as the bit-rate for the entire substream.
   // Configure `libopus` so coupled substreams and mono substreams have equally
   // effective bit-rate per channel.
@@ -184,12 +179,15 @@ absl::Status OpusEncoder::EncodeAudioFrame(
   auto& audio_frame = partial_audio_frame_with_data->obu.audio_frame_;
   audio_frame.resize(num_samples_per_channel * num_channels_ * 4, 0);
 
+  // Interleave the samples. Partial frames are padded with zeros.
+  RETURN_IF_NOT_OK(
+      InterleaveSamples(samples, absl::MakeSpan(interleaved_pcm_)));
   const auto encoded_length_bytes =
       encoder_metadata_.use_float_api()
-          ? EncodeFloat(samples, num_samples_per_channel, num_channels_,
-                        encoder_, audio_frame)
-          : EncodeInt16(samples, num_samples_per_channel, num_channels_,
-                        encoder_, audio_frame);
+          ? EncodeFloat(interleaved_pcm_, num_samples_per_channel, encoder_,
+                        encoder_input_pcm_float_, audio_frame)
+          : EncodeInt16(interleaved_pcm_, num_samples_per_channel, encoder_,
+                        encoder_input_pcm_int16_, audio_frame);
 
   if (!encoded_length_bytes.ok()) {
     return encoded_length_bytes.status();
@@ -204,10 +202,7 @@ absl::Status OpusEncoder::EncodeAudioFrame(
   // Shrink output vector to actual size.
   audio_frame.resize(*encoded_length_bytes);
 
-  absl::MutexLock lock(&mutex_);
-  finalized_audio_frames_.emplace_back(
-      std::move(*partial_audio_frame_with_data));
-
+  PushFinalizedAudioFrame(std::move(*partial_audio_frame_with_data));
   return absl::OkStatus();
 }
 
@@ -88,6 +88,11 @@ class OpusEncoder : public EncoderBase {
   const int substream_id_;
 
   LibOpusEncoder* encoder_ = nullptr;
+
+  // Scratch buffers reused by every call to `EncodeAudioFrame()`.
+  std::vector<int32_t> interleaved_pcm_;
+  std::vector<float> encoder_input_pcm_float_;
+  std::vector<opus_int16> encoder_input_pcm_int16_;
 };
 
 }  // namespace iamf_tools
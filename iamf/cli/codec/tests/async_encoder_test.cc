@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/codec/async_encoder.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/cli/audio_frame_with_data.h"
+#include "iamf/cli/codec/lpcm_encoder.h"
+#include "iamf/cli/codec/tests/encoder_test_base.h"
+#include "iamf/obu/audio_frame.h"
+#include "iamf/obu/codec_config.h"
+#include "iamf/obu/decoder_config/lpcm_decoder_config.h"
+#include "iamf/obu/obu_header.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+
+class AsyncEncoderTest : public EncoderTestBase, public testing::Test {
+ public:
+  AsyncEncoderTest() { input_sample_size_ = 32; }
+  ~AsyncEncoderTest() = default;
+
+ protected:
+  void ConstructEncoder() override {
+    const CodecConfig temp = {.codec_id = CodecConfig::kCodecIdLpcm,
+                              .num_samples_per_frame = num_samples_per_frame_,
+                              .audio_roll_distance = 0,
+                              .decoder_config = lpcm_decoder_config_};
+    CodecConfigObu codec_config(ObuHeader(), 0, temp);
+    EXPECT_THAT(codec_config.Initialize(), IsOk());
+
+    encoder_ = std::make_unique<AsyncEncoder>(
+        codec_config,
+        std::make_unique<LpcmEncoder>(codec_config, num_channels_));
+  }
+
+  std::unique_ptr<AudioFrameWithData> MakePartialAudioFrame() {
+    return std::make_unique<AudioFrameWithData>(AudioFrameWithData{
+        .obu = AudioFrameObu(ObuHeader(), 0, {}),
+        .start_timestamp = 0,
+        .end_timestamp = static_cast<int32_t>(num_samples_per_frame_),
+    });
+  }
+
+  LpcmDecoderConfig lpcm_decoder_config_ = {
+      .sample_format_flags_bitmask_ = LpcmDecoderConfig::kLpcmLittleEndian,
+      .sample_size_ = 32,
+      .sample_rate_ = 48000};
+};
+
+TEST_F(AsyncEncoderTest, EncodesOneFrame) {
+  InitExpectOk();
+
+  EncodeAudioFrame({{0x01234567}});
+  expected_audio_frames_.push_back({0x67, 0x45, 0x23, 0x01});
+  FinalizeAndValidate();
+}
+
+TEST_F(AsyncEncoderTest, OutputsFramesInOrder) {
+  InitExpectOk();
+
+  for (int i = 0; i < 100; i++) {
+    EncodeAudioFrame({{i}});
+    expected_audio_frames_.push_back(
+        {static_cast<uint8_t>(i), 0x00, 0x00, 0x00});
+  }
+  FinalizeAndValidate();
+}
+
+TEST_F(AsyncEncoderTest, FramesAreAvailableAfterWaitUntilIdle) {
+  InitExpectOk();
+  EncodeAudioFrame({{0x01234567}});
+
+  EXPECT_THAT(encoder_->WaitUntilIdle(), IsOk());
+
+  EXPECT_TRUE(encoder_->FramesAvailable());
+  EXPECT_FALSE(encoder_->Finished());
+}
+
+TEST_F(AsyncEncoderTest, IsFinishedAfterFinalizingAndPoppingAllFrames) {
+  InitExpectOk();
+  EncodeAudioFrame({{0x01234567}});
+  EXPECT_THAT(encoder_->Finalize(), IsOk());
+  EXPECT_THAT(encoder_->WaitUntilIdle(), IsOk());
+  EXPECT_FALSE(encoder_->Finished());
+
+  std::list<AudioFrameWithData> audio_frames;
+  EXPECT_THAT(encoder_->Pop(audio_frames), IsOk());
+
+  EXPECT_EQ(audio_frames.size(), 1);
+  EXPECT_TRUE(encoder_->Finished());
+}
+
+TEST_F(AsyncEncoderTest, CopiesDelayFromWrappedEncoder) {
+  InitExpectOk();
+
+  EXPECT_EQ(encoder_->GetNumberOfSamplesToDelayAtStart(), 0);
+}
+
+TEST_F(AsyncEncoderTest, EncodeAudioFrameFailsAfterFinalize) {
+  InitExpectOk();
+  EXPECT_THAT(encoder_->Finalize(), IsOk());
+
+  EXPECT_FALSE(encoder_
+                   ->EncodeAudioFrame(input_sample_size_, {{0x01234567}},
+                                      MakePartialAudioFrame())
+                   .ok());
+}
+
+TEST_F(AsyncEncoderTest, WaitUntilIdleReportsErrorsFromTheWrappedEncoder) {
+  InitExpectOk();
+
+  // The wrapped encoder rejects frames with the wrong number of channels, but
+  // the error is only detected on the worker thread.
+  EXPECT_THAT(encoder_->EncodeAudioFrame(input_sample_size_,
+                                         {{0x01234567, 0x01234567}},
+                                         MakePartialAudioFrame()),
+              IsOk());
+
+  EXPECT_FALSE(encoder_->WaitUntilIdle().ok());
+}
+
+TEST_F(AsyncEncoderTest, EncodeAudioFrameFailsAfterAnEarlierFrameFailed) {
+  InitExpectOk();
+  EXPECT_THAT(encoder_->EncodeAudioFrame(input_sample_size_,
+                                         {{0x01234567, 0x01234567}},
+                                         MakePartialAudioFrame()),
+              IsOk());
+  EXPECT_FALSE(encoder_->WaitUntilIdle().ok());
+
+  EXPECT_FALSE(encoder_
+                   ->EncodeAudioFrame(input_sample_size_, {{0x01234567}},
+                                      MakePartialAudioFrame())
+                   .ok());
+}
+
+TEST_F(AsyncEncoderTest, CanBeDestroyedWithPendingFrames) {
+  InitExpectOk();
+  for (int i = 0; i < 10; i++) {
+    EncodeAudioFrame({{i}});
+  }
+
+  encoder_.reset();
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/codec/caching_encoder.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/cli/audio_frame_with_data.h"
+#include "iamf/cli/codec/encoder_base.h"
+#include "iamf/cli/codec/lpcm_encoder.h"
+#include "iamf/cli/codec/tests/encoder_test_base.h"
+#include "iamf/obu/codec_config.h"
+#include "iamf/obu/decoder_config/lpcm_decoder_config.h"
+#include "iamf/obu/obu_header.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+
+constexpr uint64_t kStreamKey = 1234;
+
+// Encoder whose output depends on how many frames it encoded before. Each frame
+// is encoded as the number of earlier frames followed by the lowest byte of the
+// first sample.
+class FrameCountingEncoder : public EncoderBase {
+ public:
+  FrameCountingEncoder(const CodecConfigObu& codec_config,
+                       int& num_encode_calls)
+      : EncoderBase(/*supports_partial_frames=*/false, codec_config,
+                    /*num_channels=*/1),
+        num_encode_calls_(num_encode_calls) {}
+
+  absl::Status EncodeAudioFrame(
+      int /*input_bit_depth*/, const std::vector<std::vector<int32_t>>& samples,
+      std::unique_ptr<AudioFrameWithData> partial_audio_frame_with_data)
+      override {
+    num_encode_calls_++;
+    partial_audio_frame_with_data->obu.audio_frame_ = {
+        static_cast<uint8_t>(num_frames_encoded_++),
+        static_cast<uint8_t>(samples[0][0])};
+    PushFinalizedAudioFrame(std::move(*partial_audio_frame_with_data));
+    return absl::OkStatus();
+  }
+
+ private:
+  absl::Status InitializeEncoder() override { return absl::OkStatus(); }
+  absl::Status SetNumberOfSamplesToDelayAtStart() override {
+    return absl::OkStatus();
+  }
+
+  int& num_encode_calls_;
+  int num_frames_encoded_ = 0;
+};
+
+class CachingEncoderTest : public EncoderTestBase, public testing::Test {
+ public:
+  CachingEncoderTest()
+      : cache_directory_(
+            std::filesystem::path(::testing::TempDir()) /
+            testing::UnitTest::GetInstance()->current_test_info()->name()) {
+    input_sample_size_ = 32;
+    std::filesystem::remove_all(cache_directory_);
+  }
+  ~CachingEncoderTest() = default;
+
+ protected:
+  void ConstructEncoder() override {
+    const CodecConfig temp = {.codec_id = CodecConfig::kCodecIdLpcm,
+                              .num_samples_per_frame = num_samples_per_frame_,
+                              .audio_roll_distance = 0,
+                              .decoder_config = lpcm_decoder_config_};
+    CodecConfigObu codec_config(ObuHeader(), 0, temp);
+    EXPECT_THAT(codec_config.Initialize(), IsOk());
+
+    std::unique_ptr<EncoderBase> wrapped_encoder;
+    if (frames_are_independent_) {
+      wrapped_encoder =
+          std::make_unique<LpcmEncoder>(codec_config, num_channels_);
+    } else {
+      wrapped_encoder = std::make_unique<FrameCountingEncoder>(
+          codec_config, num_encode_calls_);
+    }
+    auto caching_encoder = std::make_unique<CachingEncoder>(
+        codec_config, std::move(wrapped_encoder), cache_directory_, stream_key_,
+        frames_are_independent_);
+    caching_encoder_ = caching_encoder.get();
+    encoder_ = std::move(caching_encoder);
+  }
+
+  // Encodes one frame per sample and validates the output.
+  void EncodeAndValidate(const std::vector<int32_t>& samples,
+                         const std::list<std::vector<uint8_t>>& expected) {
+    ResetTimestamp();
+    num_encode_calls_ = 0;
+    InitExpectOk();
+    for (const int32_t sample : samples) {
+      EncodeAudioFrame({{sample}});
+    }
+    expected_audio_frames_ = expected;
+    FinalizeAndValidate();
+  }
+
+  const std::filesystem::path cache_directory_;
+  uint64_t stream_key_ = kStreamKey;
+  bool frames_are_independent_ = true;
+  int num_encode_calls_ = 0;
+  CachingEncoder* caching_encoder_ = nullptr;
+
+  LpcmDecoderConfig lpcm_decoder_config_ = {
+      .sample_format_flags_bitmask_ = LpcmDecoderConfig::kLpcmLittleEndian,
+      .sample_size_ = 32,
+      .sample_rate_ = 48000};
+};
+
+TEST_F(CachingEncoderTest, EncodesFramesWhenTheCacheIsEmpty) {
+  EncodeAndValidate({0x01234567, 0x02}, {{0x67, 0x45, 0x23, 0x01},
+                                         {0x02, 0x00, 0x00, 0x00}});
+
+  EXPECT_EQ(caching_encoder_->GetNumCacheHits(), 0);
+}
+
+TEST_F(CachingEncoderTest, ReusesFramesFromAnEarlierRun) {
+  const std::list<std::vector<uint8_t>> kExpected = {{0x67, 0x45, 0x23, 0x01},
+                                                     {0x02, 0x00, 0x00, 0x00}};
+  EncodeAndValidate({0x01234567, 0x02}, kExpected);
+
+  EncodeAndValidate({0x01234567, 0x02}, kExpected);
+
+  EXPECT_EQ(caching_encoder_->GetNumCacheHits(), 2);
+}
+
+TEST_F(CachingEncoderTest, ReusesIndependentFramesAroundAChangedFrame) {
+  EncodeAndValidate({1, 2, 3}, {{1, 0, 0, 0}, {2, 0, 0, 0}, {3, 0, 0, 0}});
+
+  EncodeAndValidate({1, 9, 3}, {{1, 0, 0, 0}, {9, 0, 0, 0}, {3, 0, 0, 0}});
+
+  EXPECT_EQ(caching_encoder_->GetNumCacheHits(), 2);
+}
+
+TEST_F(CachingEncoderTest, DoesNotReuseFramesFromADifferentStream) {
+  EncodeAndValidate({1, 2}, {{1, 0, 0, 0}, {2, 0, 0, 0}});
+
+  stream_key_ = kStreamKey + 1;
+  EncodeAndValidate({1, 2}, {{1, 0, 0, 0}, {2, 0, 0, 0}});
+
+  EXPECT_EQ(caching_encoder_->GetNumCacheHits(), 0);
+}
+
+TEST_F(CachingEncoderTest, DoesNotCallTheWrappedEncoderWhenAllFramesAreReused) {
+  frames_are_independent_ = false;
+  EncodeAndValidate({1, 2, 3}, {{0, 1}, {1, 2}, {2, 3}});
+
+  EncodeAndValidate({1, 2, 3}, {{0, 1}, {1, 2}, {2, 3}});
+
+  EXPECT_EQ(caching_encoder_->GetNumCacheHits(), 3);
+  EXPECT_EQ(num_encode_calls_, 0);
+}
+
+TEST_F(CachingEncoderTest, ReplaysReusedFramesBeforeTheFirstMiss) {
+  frames_are_independent_ = false;
+  EncodeAndValidate({1, 2, 3}, {{0, 1}, {1, 2}, {2, 3}});
+
+  // The third frame is encoded with the state left by the first two.
+  EncodeAndValidate({1, 2, 7}, {{0, 1}, {1, 2}, {2, 7}});
+
+  EXPECT_EQ(caching_encoder_->GetNumCacheHits(), 2);
+  EXPECT_EQ(num_encode_calls_, 3);
+}
+
+TEST_F(CachingEncoderTest, DoesNotReuseDependentFramesAfterAChangedFrame) {
+  frames_are_independent_ = false;
+  EncodeAndValidate({1, 2, 3}, {{0, 1}, {1, 2}, {2, 3}});
+
+  EncodeAndValidate({5, 2, 3}, {{0, 5}, {1, 2}, {2, 3}});
+
+  EXPECT_EQ(caching_encoder_->GetNumCacheHits(), 0);
+}
+
+TEST_F(CachingEncoderTest, CopiesDelayFromWrappedEncoder) {
+  InitExpectOk();
+
+  EXPECT_EQ(encoder_->GetNumberOfSamplesToDelayAtStart(), 0);
+}
+
+TEST_F(CachingEncoderTest, EncodeAudioFrameFailsAfterFinalize) {
+  InitExpectOk();
+  EXPECT_THAT(encoder_->Finalize(), IsOk());
+
+  EncodeAudioFrame({{1}}, /*expected_encode_frame_is_ok=*/false);
+}
+
+}  // namespace
+}  // namespace iamf_tools
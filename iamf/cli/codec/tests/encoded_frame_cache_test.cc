@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/codec/encoded_frame_cache.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+
+constexpr uint64_t kKey = 0x0123456789abcdef;
+
+std::filesystem::path GetCleanDirectory() {
+  const auto directory =
+      std::filesystem::path(::testing::TempDir()) /
+      testing::UnitTest::GetInstance()->current_test_info()->name();
+  std::filesystem::remove_all(directory);
+  return directory;
+}
+
+TEST(CacheKeyBuilder, IsStable) {
+  // Keys are shared between runs, so they must never change silently.
+  EXPECT_EQ(CacheKeyBuilder().Build(), 0xcbf29ce484222325);
+  EXPECT_EQ(CacheKeyBuilder().Add("a").Build(), 0xaf63dc4c8601ec8c);
+}
+
+TEST(CacheKeyBuilder, DependsOnTheValueOfSamples) {
+  EXPECT_NE(CacheKeyBuilder().Add({{1, 2}}).Build(),
+            CacheKeyBuilder().Add({{1, 3}}).Build());
+}
+
+TEST(CacheKeyBuilder, DependsOnTheShapeOfSamples) {
+  EXPECT_NE(CacheKeyBuilder().Add({{1, 2}}).Build(),
+            CacheKeyBuilder().Add({{1}, {2}}).Build());
+}
+
+TEST(CacheKeyBuilder, DependsOnTheOrderOfAdds) {
+  EXPECT_NE(CacheKeyBuilder().Add(uint64_t{1}).Add(uint64_t{2}).Build(),
+            CacheKeyBuilder().Add(uint64_t{2}).Add(uint64_t{1}).Build());
+}
+
+TEST(EncodedFrameCache, LookupMissesWhenTheDirectoryDoesNotExist) {
+  const EncodedFrameCache cache(GetCleanDirectory());
+  std::vector<uint8_t> encoded_frame = {1};
+
+  EXPECT_FALSE(cache.Lookup(kKey, encoded_frame));
+  EXPECT_EQ(encoded_frame, std::vector<uint8_t>({1}));
+}
+
+TEST(EncodedFrameCache, LookupFindsStoredFrames) {
+  const EncodedFrameCache cache(GetCleanDirectory());
+  const std::vector<uint8_t> kEncodedFrame = {1, 2, 3, 4, 5};
+  EXPECT_THAT(cache.Store(kKey, kEncodedFrame), IsOk());
+
+  std::vector<uint8_t> encoded_frame;
+  EXPECT_TRUE(cache.Lookup(kKey, encoded_frame));
+  EXPECT_EQ(encoded_frame, kEncodedFrame);
+}
+
+TEST(EncodedFrameCache, LookupFindsEmptyFrames) {
+  const EncodedFrameCache cache(GetCleanDirectory());
+  EXPECT_THAT(cache.Store(kKey, {}), IsOk());
+
+  std::vector<uint8_t> encoded_frame = {1};
+  EXPECT_TRUE(cache.Lookup(kKey, encoded_frame));
+  EXPECT_TRUE(encoded_frame.empty());
+}
+
+TEST(EncodedFrameCache, LookupMissesOtherKeys) {
+  const EncodedFrameCache cache(GetCleanDirectory());
+  EXPECT_THAT(cache.Store(kKey, {1, 2, 3}), IsOk());
+
+  std::vector<uint8_t> encoded_frame;
+  EXPECT_FALSE(cache.Lookup(kKey + 1, encoded_frame));
+}
+
+TEST(EncodedFrameCache, StoreOverwritesFrames) {
+  const EncodedFrameCache cache(GetCleanDirectory());
+  EXPECT_THAT(cache.Store(kKey, {1, 2, 3}), IsOk());
+  EXPECT_THAT(cache.Store(kKey, {4}), IsOk());
+
+  std::vector<uint8_t> encoded_frame;
+  EXPECT_TRUE(cache.Lookup(kKey, encoded_frame));
+  EXPECT_EQ(encoded_frame, std::vector<uint8_t>({4}));
+}
+
+TEST(EncodedFrameCache, LookupMissesTruncatedFiles) {
+  const auto directory = GetCleanDirectory();
+  const EncodedFrameCache cache(directory);
+  EXPECT_THAT(cache.Store(kKey, {1, 2, 3}), IsOk());
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    std::filesystem::resize_file(entry.path(),
+                                 std::filesystem::file_size(entry.path()) - 1);
+  }
+
+  std::vector<uint8_t> encoded_frame;
+  EXPECT_FALSE(cache.Lookup(kKey, encoded_frame));
+}
+
+TEST(EncodedFrameCache, LookupMissesFilesWithTrailingData) {
+  const auto directory = GetCleanDirectory();
+  const EncodedFrameCache cache(directory);
+  EXPECT_THAT(cache.Store(kKey, {1, 2, 3}), IsOk());
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    std::ofstream(entry.path(), std::ios::binary | std::ios::app) << 'x';
+  }
+
+  std::vector<uint8_t> encoded_frame;
+  EXPECT_FALSE(cache.Lookup(kKey, encoded_frame));
+}
+
+TEST(EncodedFrameCache, LookupMissesFilesWithAHugePayloadSize) {
+  const auto directory = GetCleanDirectory();
+  const EncodedFrameCache cache(directory);
+  EXPECT_THAT(cache.Store(kKey, {1, 2, 3}), IsOk());
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    // Overwrite the payload size, which follows the magic string and the key.
+    std::fstream fs(entry.path(),
+                    std::ios::binary | std::ios::in | std::ios::out);
+    fs.seekp(16);
+    const std::string kHugePayloadSize(8, '\xff');
+    fs.write(kHugePayloadSize.data(), kHugePayloadSize.size());
+  }
+
+  std::vector<uint8_t> encoded_frame;
+  EXPECT_FALSE(cache.Lookup(kKey, encoded_frame));
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -51,8 +51,19 @@ class MockEncoder : public EncoderBase {
 
   MOCK_METHOD(absl::Status, InitializeEncoder, (), (override));
   MOCK_METHOD(absl::Status, SetNumberOfSamplesToDelayAtStart, (), (override));
+
+  using EncoderBase::PushFinalizedAudioFrame;
 };
 
+AudioFrameWithData MakeAudioFrame(int32_t start_timestamp) {
+  return AudioFrameWithData{
+      .obu = AudioFrameObu(ObuHeader(), /*substream_id=*/0, {}),
+      .start_timestamp = start_timestamp,
+      .end_timestamp = start_timestamp + 1,
+      .audio_element_with_data = nullptr,
+  };
+}
+
 TEST(EncoderBaseTest, InitializeSucceeds) {
   MockEncoder encoder;
   EXPECT_CALL(encoder, InitializeEncoder()).WillOnce(Return(absl::OkStatus()));
@@ -117,6 +128,50 @@ TEST(EncoderBaseTest, FinalizeAndPopAppendNothingWhenNoFramesAvailable) {
   EXPECT_EQ(only_frame.audio_element_with_data, nullptr);
 }
 
+TEST(EncoderBaseTest, PopsFinalizedFramesInOrder) {
+  MockEncoder encoder;
+  encoder.PushFinalizedAudioFrame(MakeAudioFrame(0));
+  encoder.PushFinalizedAudioFrame(MakeAudioFrame(1));
+
+  std::list<AudioFrameWithData> audio_frames;
+  EXPECT_TRUE(encoder.FramesAvailable());
+  EXPECT_THAT(encoder.Pop(audio_frames), IsOk());
+  EXPECT_TRUE(encoder.FramesAvailable());
+  EXPECT_THAT(encoder.Pop(audio_frames), IsOk());
+  EXPECT_FALSE(encoder.FramesAvailable());
+
+  ASSERT_EQ(audio_frames.size(), 2);
+  EXPECT_EQ(audio_frames.front().start_timestamp, 0);
+  EXPECT_EQ(audio_frames.back().start_timestamp, 1);
+}
+
+TEST(EncoderBaseTest, NotFinishedUntilAllFramesArePopped) {
+  MockEncoder encoder;
+  encoder.PushFinalizedAudioFrame(MakeAudioFrame(0));
+  EXPECT_THAT(encoder.Finalize(), IsOk());
+
+  EXPECT_FALSE(encoder.Finished());
+  std::list<AudioFrameWithData> audio_frames;
+  EXPECT_THAT(encoder.Pop(audio_frames), IsOk());
+  EXPECT_TRUE(encoder.Finished());
+}
+
+TEST(EncoderBaseTest, HoldsManyFinalizedFramesWaitingToBePopped) {
+  constexpr int kNumFrames = 1000;
+  MockEncoder encoder;
+  for (int i = 0; i < kNumFrames; ++i) {
+    encoder.PushFinalizedAudioFrame(MakeAudioFrame(i));
+  }
+
+  std::list<AudioFrameWithData> audio_frames;
+  while (encoder.FramesAvailable()) {
+    EXPECT_THAT(encoder.Pop(audio_frames), IsOk());
+  }
+  ASSERT_EQ(audio_frames.size(), kNumFrames);
+  EXPECT_EQ(audio_frames.front().start_timestamp, 0);
+  EXPECT_EQ(audio_frames.back().start_timestamp, kNumFrames - 1);
+}
+
 TEST(EncoderBaseTest, DefaultZeroNumberOfSamplesToDelayAtStart) {
   MockEncoder encoder;
 
@@ -80,6 +80,7 @@ class EncoderTestBase {
       int expected_num_frames) {
     std::list<AudioFrameWithData> output_audio_frames;
     EXPECT_THAT(encoder_->Finalize(), IsOk());
+    EXPECT_THAT(encoder_->WaitUntilIdle(), IsOk());
 
     // Pop all the frames.
     for (int i = 0; i < expected_num_frames; i++) {
@@ -111,6 +112,9 @@ class EncoderTestBase {
     }
   }
 
+  // Restarts the simulated timestamps, e.g. to encode again with a new encoder.
+  void ResetTimestamp() { cur_timestamp_ = 0; }
+
   int num_channels_ = 1;
   int substream_id_ = 0;
   uint32_t num_samples_per_frame_ = 1;
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/codec/flac_decoder.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/cli/audio_frame_with_data.h"
+#include "iamf/cli/codec/flac_encoder.h"
+#include "iamf/cli/proto/codec_config.pb.h"
+#include "iamf/obu/audio_frame.h"
+#include "iamf/obu/codec_config.h"
+#include "iamf/obu/decoder_config/flac_decoder_config.h"
+#include "iamf/obu/obu_header.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+
+constexpr uint32_t kNumSamplesPerFrame = 16;
+constexpr int kNumChannels = 2;
+
+CodecConfigObu CreateCodecConfigObu() {
+  const CodecConfig codec_config = {
+      .codec_id = CodecConfig::kCodecIdFlac,
+      .num_samples_per_frame = kNumSamplesPerFrame,
+      .audio_roll_distance = 0,
+      .decoder_config = FlacDecoderConfig(
+          {{{.header = {.last_metadata_block_flag = true,
+                        .block_type = FlacMetaBlockHeader::kFlacStreamInfo,
+                        .metadata_data_block_length = 34},
+             .payload =
+                 FlacMetaBlockStreamInfo{.minimum_block_size = 16,
+                                         .maximum_block_size = 16,
+                                         .sample_rate = 48000,
+                                         .bits_per_sample = 31,
+                                         .total_samples_in_stream = 16}}}})};
+
+  CodecConfigObu codec_config_obu(ObuHeader(), 0, codec_config);
+  EXPECT_THAT(codec_config_obu.Initialize(), IsOk());
+  return codec_config_obu;
+}
+
+// Encodes the frames with `FlacEncoder` and returns the encoded frames.
+std::vector<std::vector<uint8_t>> EncodeFrames(
+    const CodecConfigObu& codec_config_obu,
+    const std::vector<std::vector<std::vector<int32_t>>>& frames) {
+  iamf_tools_cli_proto::FlacEncoderMetadata flac_encoder_metadata;
+  flac_encoder_metadata.set_compression_level(0);
+  FlacEncoder encoder(flac_encoder_metadata, codec_config_obu, kNumChannels);
+  EXPECT_THAT(encoder.Initialize(), IsOk());
+  for (const auto& samples : frames) {
+    EXPECT_THAT(
+        encoder.EncodeAudioFrame(
+            32, samples,
+            std::make_unique<AudioFrameWithData>(AudioFrameWithData{
+                .obu = AudioFrameObu(ObuHeader(), 0, {}),
+                .start_timestamp = 0,
+                .end_timestamp = static_cast<int32_t>(kNumSamplesPerFrame)})),
+        IsOk());
+  }
+  EXPECT_THAT(encoder.Finalize(), IsOk());
+
+  std::list<AudioFrameWithData> audio_frames;
+  while (encoder.FramesAvailable()) {
+    EXPECT_THAT(encoder.Pop(audio_frames), IsOk());
+  }
+  std::vector<std::vector<uint8_t>> encoded_frames;
+  for (const auto& audio_frame : audio_frames) {
+    encoded_frames.push_back(audio_frame.obu.audio_frame_);
+  }
+  return encoded_frames;
+}
+
+std::vector<std::vector<int32_t>> MakeFrame(int32_t seed) {
+  std::vector<std::vector<int32_t>> samples(
+      kNumSamplesPerFrame, std::vector<int32_t>(kNumChannels));
+  for (int t = 0; t < kNumSamplesPerFrame; ++t) {
+    for (int c = 0; c < kNumChannels; ++c) {
+      samples[t][c] = (seed * 7919 + t * 104729 + c * 31) << 4;
+    }
+  }
+  return samples;
+}
+
+TEST(FlacDecoderTest, InitializeSucceeds) {
+  FlacDecoder decoder(CreateCodecConfigObu(), kNumChannels);
+
+  EXPECT_THAT(decoder.Initialize(), IsOk());
+}
+
+TEST(FlacDecoderTest, DecodesFramesFromFlacEncoder) {
+  const CodecConfigObu codec_config_obu = CreateCodecConfigObu();
+  const std::vector<std::vector<std::vector<int32_t>>> input_frames = {
+      MakeFrame(0), MakeFrame(1), MakeFrame(2)};
+  const auto encoded_frames = EncodeFrames(codec_config_obu, input_frames);
+  ASSERT_EQ(encoded_frames.size(), input_frames.size());
+  FlacDecoder decoder(codec_config_obu, kNumChannels);
+  ASSERT_THAT(decoder.Initialize(), IsOk());
+
+  for (int i = 0; i < encoded_frames.size(); ++i) {
+    std::vector<std::vector<int32_t>> decoded_samples;
+    EXPECT_THAT(decoder.DecodeAudioFrame(encoded_frames[i], decoded_samples),
+                IsOk());
+
+    EXPECT_EQ(decoded_samples, input_frames[i]);
+  }
+}
+
+TEST(FlacDecoderTest, DecodeAudioFrameFailsForCorruptedFrame) {
+  const CodecConfigObu codec_config_obu = CreateCodecConfigObu();
+  auto encoded_frames = EncodeFrames(codec_config_obu, {MakeFrame(0)});
+  ASSERT_EQ(encoded_frames.size(), 1);
+  encoded_frames[0].back() ^= 0xff;
+  FlacDecoder decoder(codec_config_obu, kNumChannels);
+  ASSERT_THAT(decoder.Initialize(), IsOk());
+
+  std::vector<std::vector<int32_t>> decoded_samples;
+  EXPECT_FALSE(
+      decoder.DecodeAudioFrame(encoded_frames[0], decoded_samples).ok());
+}
+
+TEST(FlacDecoderTest, DecodesValidFrameAfterCorruptedFrame) {
+  const CodecConfigObu codec_config_obu = CreateCodecConfigObu();
+  const std::vector<std::vector<std::vector<int32_t>>> input_frames = {
+      MakeFrame(0), MakeFrame(1)};
+  auto encoded_frames = EncodeFrames(codec_config_obu, input_frames);
+  ASSERT_EQ(encoded_frames.size(), input_frames.size());
+  encoded_frames[0].back() ^= 0xff;
+  FlacDecoder decoder(codec_config_obu, kNumChannels);
+  ASSERT_THAT(decoder.Initialize(), IsOk());
+  std::vector<std::vector<int32_t>> decoded_samples;
+  ASSERT_FALSE(
+      decoder.DecodeAudioFrame(encoded_frames[0], decoded_samples).ok());
+
+  EXPECT_THAT(decoder.DecodeAudioFrame(encoded_frames[1], decoded_samples),
+              IsOk());
+
+  EXPECT_EQ(decoded_samples, input_frames[1]);
+}
+
+TEST(FlacDecoderTest, DecodesValidFrameAfterTruncatedFrame) {
+  const CodecConfigObu codec_config_obu = CreateCodecConfigObu();
+  const std::vector<std::vector<std::vector<int32_t>>> input_frames = {
+      MakeFrame(0), MakeFrame(1)};
+  auto encoded_frames = EncodeFrames(codec_config_obu, input_frames);
+  ASSERT_EQ(encoded_frames.size(), input_frames.size());
+  encoded_frames[0].resize(encoded_frames[0].size() / 2);
+  FlacDecoder decoder(codec_config_obu, kNumChannels);
+  ASSERT_THAT(decoder.Initialize(), IsOk());
+  std::vector<std::vector<int32_t>> decoded_samples;
+  ASSERT_FALSE(
+      decoder.DecodeAudioFrame(encoded_frames[0], decoded_samples).ok());
+
+  EXPECT_THAT(decoder.DecodeAudioFrame(encoded_frames[1], decoded_samples),
+              IsOk());
+
+  EXPECT_EQ(decoded_samples, input_frames[1]);
+}
+
+TEST(FlacDecoderTest, DecodeAudioFrameFailsForTruncatedFrame) {
+  const CodecConfigObu codec_config_obu = CreateCodecConfigObu();
+  auto encoded_frames = EncodeFrames(codec_config_obu, {MakeFrame(0)});
+  ASSERT_EQ(encoded_frames.size(), 1);
+  encoded_frames[0].resize(encoded_frames[0].size() / 2);
+  FlacDecoder decoder(codec_config_obu, kNumChannels);
+  ASSERT_THAT(decoder.Initialize(), IsOk());
+
+  std::vector<std::vector<int32_t>> decoded_samples;
+  EXPECT_FALSE(
+      decoder.DecodeAudioFrame(encoded_frames[0], decoded_samples).ok());
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -56,6 +56,39 @@ class FlacEncoderTest : public EncoderTestBase, public testing::Test {
                                              codec_config, num_channels_);
   }
 
+  // Encodes the same input serially and in parallel and expects identical
+  // frames. Uses enough frames to need multi-byte frame numbers in the headers.
+  void ExpectParallelOutputIsIdenticalToSerialOutput() {
+    const int kNumFrames = 200;
+    std::vector<std::vector<std::vector<int32_t>>> input_frames;
+    for (int i = 0; i < kNumFrames; i++) {
+      std::vector<std::vector<int32_t>> samples(num_samples_per_frame_);
+      for (int t = 0; t < num_samples_per_frame_; t++) {
+        const int32_t sample = i * 7919 + t * 104729;
+        for (int c = 0; c < num_channels_; c++) {
+          samples[t].push_back((sample + c * (t % 5)) << 8);
+        }
+      }
+      input_frames.push_back(samples);
+    }
+
+    InitExpectOk();
+    for (const auto& samples : input_frames) {
+      EncodeAudioFrame(samples);
+    }
+    for (const auto& audio_frame : FinalizeAndValidateOrderOnly(kNumFrames)) {
+      expected_audio_frames_.push_back(audio_frame.obu.audio_frame_);
+    }
+
+    flac_encoder_metadata_.set_num_threads(4);
+    ResetTimestamp();
+    InitExpectOk();
+    for (const auto& samples : input_frames) {
+      EncodeAudioFrame(samples);
+    }
+    FinalizeAndValidate();
+  }
+
   FlacDecoderConfig flac_decoder_config_ = {
       {{.header = {.last_metadata_block_flag = true,
                    .block_type = FlacMetaBlockHeader::kFlacStreamInfo,
@@ -81,6 +114,99 @@ TEST_F(FlacEncoderTest, FramesAreInOrder) {
   FinalizeAndValidateOrderOnly(kNumFrames);
 }
 
+TEST_F(FlacEncoderTest, ParallelFramesAreInOrder) {
+  flac_encoder_metadata_.set_num_threads(4);
+  InitExpectOk();
+
+  const int kNumFrames = 100;
+  for (int i = 0; i < kNumFrames; i++) {
+    EncodeAudioFrame(std::vector<std::vector<int32_t>>(
+        num_samples_per_frame_, std::vector<int32_t>(num_channels_, i)));
+  }
+  FinalizeAndValidateOrderOnly(kNumFrames);
+}
+
+TEST_F(FlacEncoderTest, VerifiedFramesAreInOrder) {
+  flac_encoder_metadata_.set_verify_frames(true);
+  InitExpectOk();
+
+  const int kNumFrames = 100;
+  for (int i = 0; i < kNumFrames; i++) {
+    EncodeAudioFrame(std::vector<std::vector<int32_t>>(
+        num_samples_per_frame_, std::vector<int32_t>(num_channels_, i)));
+  }
+  FinalizeAndValidateOrderOnly(kNumFrames);
+}
+
+TEST_F(FlacEncoderTest, ParallelVerifiedFramesAreInOrder) {
+  flac_encoder_metadata_.set_num_threads(4);
+  flac_encoder_metadata_.set_verify_frames(true);
+  InitExpectOk();
+
+  const int kNumFrames = 100;
+  for (int i = 0; i < kNumFrames; i++) {
+    EncodeAudioFrame(std::vector<std::vector<int32_t>>(
+        num_samples_per_frame_, std::vector<int32_t>(num_channels_, i)));
+  }
+  FinalizeAndValidateOrderOnly(kNumFrames);
+}
+
+TEST_F(FlacEncoderTest, VerifiedOutputIsIdenticalToUnverifiedOutput) {
+  const int kNumFrames = 20;
+  std::vector<std::vector<int32_t>> samples(num_samples_per_frame_);
+  for (int t = 0; t < num_samples_per_frame_; t++) {
+    samples[t].push_back((t * 104729) << 8);
+  }
+  flac_encoder_metadata_.set_verify_frames(false);
+  InitExpectOk();
+  for (int i = 0; i < kNumFrames; i++) {
+    EncodeAudioFrame(samples);
+  }
+  for (const auto& audio_frame : FinalizeAndValidateOrderOnly(kNumFrames)) {
+    expected_audio_frames_.push_back(audio_frame.obu.audio_frame_);
+  }
+
+  flac_encoder_metadata_.set_verify_frames(true);
+  ResetTimestamp();
+  InitExpectOk();
+  for (int i = 0; i < kNumFrames; i++) {
+    EncodeAudioFrame(samples);
+  }
+  FinalizeAndValidate();
+}
+
+TEST_F(FlacEncoderTest, ParallelOutputIsIdenticalToSerialOutput) {
+  ExpectParallelOutputIsIdenticalToSerialOutput();
+}
+
+TEST_F(FlacEncoderTest, ParallelOutputIsIdenticalToSerialOutputForStereo) {
+  // Similar channels let the encoder use inter-channel decorrelation.
+  num_channels_ = 2;
+  ExpectParallelOutputIsIdenticalToSerialOutput();
+}
+
+TEST_F(FlacEncoderTest,
+       ParallelOutputIsIdenticalToSerialOutputForManyChannels) {
+  num_channels_ = 6;
+  ExpectParallelOutputIsIdenticalToSerialOutput();
+}
+
+TEST_F(FlacEncoderTest, ParallelFramesAreAvailableAfterEachWorkerHasAFrame) {
+  const int kNumThreads = 4;
+  flac_encoder_metadata_.set_num_threads(kNumThreads);
+  InitExpectOk();
+  const std::vector<std::vector<int32_t>> kSamples(
+      num_samples_per_frame_, std::vector<int32_t>(num_channels_, 0));
+
+  for (int i = 0; i < kNumThreads; i++) {
+    EncodeAudioFrame(kSamples);
+    EXPECT_FALSE(encoder_->FramesAvailable());
+  }
+
+  EncodeAudioFrame(kSamples);
+  EXPECT_TRUE(encoder_->FramesAvailable());
+}
+
 TEST_F(FlacEncoderTest,
        InitializeFailsWhenNumSamplesPerFrameIsLessThanSixteen) {
   num_samples_per_frame_ = 15;
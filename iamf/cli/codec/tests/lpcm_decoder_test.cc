@@ -158,7 +158,7 @@ TEST(LpcmDecoderTest, DecodeAudioFrame_WillNotDecodeWrongSize) {
   EXPECT_THAT(decoded_samples, ::testing::IsEmpty());
 }
 
-TEST(LpcmDecoderTest, DecodeAudioFrame_AppendsToExistingSamples) {
+TEST(LpcmDecoderTest, DecodeAudioFrame_OverwritesExistingSamples) {
   uint8_t sample_size = 16;
   bool little_endian = true;
   LpcmDecoder lpcm_decoder =
@@ -170,16 +170,13 @@ TEST(LpcmDecoderTest, DecodeAudioFrame_AppendsToExistingSamples) {
 
   EXPECT_THAT(status, IsOk());
   EXPECT_EQ(decoded_samples.size(), 1);
+  const int32_t* const first_tick_storage = decoded_samples[0].data();
 
   status = lpcm_decoder.DecodeAudioFrame(encoded_frame, decoded_samples);
 
   EXPECT_THAT(status, IsOk());
-  EXPECT_EQ(decoded_samples.size(), 2);
-
-  status = lpcm_decoder.DecodeAudioFrame(encoded_frame, decoded_samples);
-
-  EXPECT_THAT(status, IsOk());
-  EXPECT_EQ(decoded_samples.size(), 3);
+  EXPECT_EQ(decoded_samples.size(), 1);
+  EXPECT_EQ(decoded_samples[0].data(), first_tick_storage);
 }
 
 }  // namespace
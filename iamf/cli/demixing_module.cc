@@ -26,6 +26,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "iamf/cli/audio_element_with_data.h"
 #include "iamf/cli/audio_frame_decoder.h"
 #include "iamf/cli/audio_frame_with_data.h"
@@ -33,6 +34,7 @@
 #include "iamf/cli/cli_util.h"
 #include "iamf/cli/proto/audio_frame.pb.h"
 #include "iamf/cli/proto/user_metadata.pb.h"
+#include "iamf/cli/sample_ring_buffer.h"
 #include "iamf/common/macros.h"
 #include "iamf/common/obu_util.h"
 #include "iamf/obu/audio_element.h"
@@ -751,14 +753,15 @@ uint32_t GetSubstreamId(const DecodedAudioFrame& audio_frame_with_data) {
   return audio_frame_with_data.substream_id;
 }
 
-const std::vector<std::vector<int32_t>>& GetSamples(
+// Returns `nullptr` if the samples of the frame have been released.
+const std::vector<std::vector<int32_t>>* GetSamples(
     const AudioFrameWithData& audio_frame_with_data) {
-  return audio_frame_with_data.raw_samples;
+  return audio_frame_with_data.raw_samples.get();
 }
 
-const std::vector<std::vector<int32_t>>& GetSamples(
+const std::vector<std::vector<int32_t>>* GetSamples(
     const DecodedAudioFrame& audio_frame_with_data) {
-  return audio_frame_with_data.decoded_samples;
+  return &audio_frame_with_data.decoded_samples;
 }
 
 // TODO(b/339037792): Unify `AudioFrameWithData` and `DecodedAudioFrame`.
@@ -786,10 +789,17 @@ absl::Status StoreSamplesForAudioElementId(
                                        audio_frame.start_timestamp,
                                        "In StoreSamplesForAudioElementId(): "));
 
+    const auto* input_samples_ptr = GetSamples(audio_frame);
+    if (input_samples_ptr == nullptr) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "Samples of the audio frame for substream ID= ", substream_id,
+          " have already been released."));
+    }
+    const auto& input_samples = *input_samples_ptr;
+
     const auto& labels = substream_id_labels_iter->second;
     int channel_index = 0;
     for (const auto& label : labels) {
-      const auto& input_samples = GetSamples(audio_frame);
       const size_t num_ticks = input_samples.size();
 
       ConfigureLabeledFrame(audio_frame, labeled_frame);
@@ -953,8 +963,7 @@ absl::Status DemixingModule::InitializeForReconstruction(
 absl::Status DemixingModule::DownMixSamplesToSubstreams(
     DecodedUleb128 audio_element_id, const DownMixingParams& down_mixing_params,
     LabelSamplesMap& input_label_to_samples,
-    absl::flat_hash_map<uint32_t, SubstreamData>&
-        substream_id_to_substream_data) const {
+    absl::Span<SubstreamData> substream_data) const {
   const DemxingMetadataForAudioElementId* demixing_metadata = nullptr;
   RETURN_IF_NOT_OK(GetDemixerMetadata(audio_element_id,
                                       audio_element_id_to_demixing_metadata_,
@@ -969,10 +978,9 @@ absl::Status DemixingModule::DownMixSamplesToSubstreams(
 
   for (const auto& [substream_id, output_channel_labels] :
        demixing_metadata->substream_id_to_labels) {
-    std::vector<std::vector<int32_t>> substream_samples(
-        num_time_ticks,
-        // One or two channels.
-        std::vector<int32_t>(output_channel_labels.size(), 0));
+    // One or two channels, interleaved.
+    const size_t num_channels = output_channel_labels.size();
+    std::vector<int32_t> substream_samples(num_time_ticks * num_channels, 0);
     // Output gains to be applied to the (one or two) channels.
     std::vector<double> output_gains_linear(output_channel_labels.size());
     int channel_index = 0;
@@ -983,7 +991,7 @@ absl::Status DemixingModule::DownMixSamplesToSubstreams(
             "Samples do not exist for channel: ", output_channel_label));
       }
       for (int t = 0; t < num_time_ticks; t++) {
-        substream_samples[t][channel_index] = iter->second[t];
+        substream_samples[t * num_channels + channel_index] = iter->second[t];
       }
 
       // Compute and store the linear output gains.
@@ -998,28 +1006,34 @@ absl::Status DemixingModule::DownMixSamplesToSubstreams(
       channel_index++;
     }
 
-    // Find the `SubstreamData` with this `substream_id`.
-    auto substream_data_iter =
-        substream_id_to_substream_data.find(substream_id);
-    if (substream_data_iter == substream_id_to_substream_data.end()) {
+    // Find the `SubstreamData` with this `substream_id`. Audio elements have
+    // few substreams, so a linear search is cheap.
+    auto substream_data_iter = std::find_if(
+        substream_data.begin(), substream_data.end(),
+        [substream_id](const SubstreamData& data) {
+          return data.substream_id == substream_id;
+        });
+    if (substream_data_iter == substream_data.end()) {
       return absl::UnknownError(absl::StrCat(
           "Failed to find substream data for substream ID= ", substream_id));
     }
-    auto& substream_data = substream_data_iter->second;
 
     // Add all down mixed samples to both queues.
-
-    for (const auto& channel_samples : substream_samples) {
-      substream_data.samples_obu.push_back(channel_samples);
+    std::vector<int32_t> attenuated_channel_samples(num_channels);
+    for (size_t t = 0; t < num_time_ticks; ++t) {
+      const auto channel_samples = absl::MakeConstSpan(substream_samples)
+                                       .subspan(t * num_channels, num_channels);
+      RETURN_IF_NOT_OK(
+          substream_data_iter->samples_obu.PushTick(channel_samples));
 
       // Apply output gains to the samples going to the encoder.
-      std::vector<int32_t> attenuated_channel_samples(channel_samples.size());
-      for (int i = 0; i < channel_samples.size(); ++i) {
+      for (int i = 0; i < num_channels; ++i) {
         RETURN_IF_NOT_OK(ClipDoubleToInt32(
             static_cast<double>(channel_samples[i]) / output_gains_linear[i],
             attenuated_channel_samples[i]));
       }
-      substream_data.samples_encode.push_back(attenuated_channel_samples);
+      RETURN_IF_NOT_OK(substream_data_iter->samples_encode.PushTick(
+          attenuated_channel_samples));
     }
   }
 
@@ -14,20 +14,22 @@
 #define CLI_DEMIXING_MODULE_H_
 
 #include <cstdint>
-#include <deque>
 #include <list>
+#include <memory>
 #include <vector>
 
 #include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "iamf/cli/audio_element_with_data.h"
 #include "iamf/cli/audio_frame_decoder.h"
 #include "iamf/cli/audio_frame_with_data.h"
 #include "iamf/cli/channel_label.h"
 #include "iamf/cli/proto/audio_frame.pb.h"
 #include "iamf/cli/proto/user_metadata.pb.h"
+#include "iamf/cli/sample_ring_buffer.h"
 #include "iamf/obu/demixing_info_param_data.h"
 #include "iamf/obu/leb128.h"
 #include "iamf/obu/parameter_block.h"
@@ -37,12 +39,17 @@ namespace iamf_tools {
 struct SubstreamData {
   uint32_t substream_id;
 
-  // Samples arranged in a FIFO queue with a vector of channels. There can only
-  // be one or two channels. Includes "virtual" samples that are output from the
+  // Samples arranged in a FIFO queue of interleaved ticks. There can only be
+  // one or two channels. Includes "virtual" samples that are output from the
   // encoder, but are not passed to the encoder.
-  std::deque<std::vector<int32_t>> samples_obu;
+  SampleRingBuffer samples_obu;
   // Samples to pass to encoder.
-  std::deque<std::vector<int32_t>> samples_encode;
+  SampleRingBuffer samples_encode;
+  // Ticks of the frame being encoded, kept to reuse their allocations.
+  std::vector<std::vector<int32_t>> frame_to_encode;
+  // Ticks of the latest frame, shared with its audio frames. Reused once every
+  // audio frame has released them.
+  std::shared_ptr<std::vector<std::vector<int32_t>>> frame_for_obu;
   // One or two elements; corresponding to the output gain to be applied to
   // each channel.
   std::vector<double> output_gains_linear;
@@ -152,16 +159,15 @@ class DemixingModule {
    *     there is no associated down-mixer.
    * \param input_label_to_samples Samples in input channels organized by the
    *     channel labels.
-   * \param substream_id_to_substream_data Mapping from substream IDs to
-   *     substream data.
+   * \param substream_data Data of the substreams of the audio element, in
+   *     any order.
    * \return `absl::OkStatus()` on success. A specific status on failure.
    */
   absl::Status DownMixSamplesToSubstreams(
       DecodedUleb128 audio_element_id,
       const DownMixingParams& down_mixing_params,
       LabelSamplesMap& input_label_to_samples,
-      absl::flat_hash_map<uint32_t, SubstreamData>&
-          substream_id_to_substream_data) const;
+      absl::Span<SubstreamData> substream_data) const;
 
   /*!\brief Demix audio samples.
    *
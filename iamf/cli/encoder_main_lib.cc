@@ -19,8 +19,11 @@
 #include <optional>
 #include <string>
 #include <system_error>
+#include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
@@ -30,6 +33,7 @@
 #include "iamf/cli/demixing_module.h"
 #include "iamf/cli/iamf_components.h"
 #include "iamf/cli/iamf_encoder.h"
+#include "iamf/cli/mix_presentation_finalizer.h"
 #include "iamf/cli/obu_sequencer.h"
 #include "iamf/cli/parameter_block_partitioner.h"
 #include "iamf/cli/parameter_block_with_data.h"
@@ -53,6 +57,17 @@ namespace {
 using iamf_tools_cli_proto::ParameterBlockObuMetadata;
 using iamf_tools_cli_proto::UserMetadata;
 
+// OBUs which differ between the IA Sequences of encoder variants. The
+// remaining descriptor OBUs are shared with the main IA Sequence.
+struct VariantObus {
+  // User metadata with the file name prefix of the variant.
+  UserMetadata user_metadata;
+  std::list<MixPresentationObu> mix_presentation_obus;
+  std::list<AudioFrameWithData> audio_frames;
+  std::list<ParameterBlockWithData> parameter_blocks;
+  std::unique_ptr<MixPresentationFinalizerBase> mix_presentation_finalizer;
+};
+
 std::unique_ptr<WavWriter> ProduceAllWavWriters(
     DecodedUleb128 mix_presentation_id, int sub_mix_index, int layout_index,
     const Layout&, const std::filesystem::path& prefix, int num_channels,
@@ -140,6 +155,28 @@ void PrintAudioFrames(const std::list<AudioFrameWithData>& audio_frames) {
   }
 }
 
+// Validates that each encoder variant writes to its own files.
+absl::Status ValidateEncoderVariantMetadata(const UserMetadata& user_metadata) {
+  absl::flat_hash_set<std::string> file_name_suffixes;
+  for (const auto& encoder_variant_metadata :
+       user_metadata.encoder_variant_metadata()) {
+    const std::string& file_name_suffix =
+        encoder_variant_metadata.file_name_suffix();
+    if (file_name_suffix.empty()) {
+      return absl::InvalidArgumentError(
+          "Encoder variants must set a `file_name_suffix`.");
+    }
+    if (!file_name_suffixes.insert(file_name_suffix).second) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Encoder variants must have distinct file name "
+                       "suffixes. Duplicate file_name_suffix= ",
+                       file_name_suffix));
+    }
+  }
+
+  return absl::OkStatus();
+}
+
 absl::Status CreateOutputDirectory(const std::string& output_directory) {
   if (output_directory.empty() ||
       std::filesystem::is_directory(output_directory) ||
@@ -156,6 +193,46 @@ absl::Status CreateOutputDirectory(const std::string& output_directory) {
   return absl::OkStatus();
 }
 
+absl::Status CreateAndInitializeMixPresentationFinalizer(
+    const UserMetadata& user_metadata, const std::string& output_iamf_directory,
+    const absl::flat_hash_map<DecodedUleb128, AudioElementWithData>&
+        audio_elements,
+    const std::list<MixPresentationObu>& mix_presentation_obus,
+    std::unique_ptr<MixPresentationFinalizerBase>& mix_presentation_finalizer) {
+  // The mix presentations are finalized as temporal units are generated.
+  // Rendering every submix is required to accurately compute loudness.
+  std::optional<uint8_t> output_wav_file_bit_depth_override;
+  if (user_metadata.test_vector_metadata()
+          .has_output_wav_file_bit_depth_override()) {
+    if (user_metadata.test_vector_metadata()
+            .output_wav_file_bit_depth_override() >
+        std::numeric_limits<uint8_t>::max()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Bit-depth too large. "
+                       "output_wav_file_bit_depth_override= ",
+                       user_metadata.test_vector_metadata()
+                           .output_wav_file_bit_depth_override()));
+    }
+    output_wav_file_bit_depth_override =
+        static_cast<uint8_t>(user_metadata.test_vector_metadata()
+                                 .output_wav_file_bit_depth_override());
+  }
+
+  // TODO(b/349271713): Move the mix presentation finalizer inside
+  //                    `IamfEncoder`.
+  // Write the output audio streams which were used to measure loudness to the
+  // same directory as the IAMF file.
+  const std::string output_wav_file_prefix =
+      std::filesystem::path(output_iamf_directory) /
+      user_metadata.test_vector_metadata().file_name_prefix();
+  LOG(INFO) << "output_wav_file_prefix = " << output_wav_file_prefix;
+  mix_presentation_finalizer = CreateMixPresentationFinalizer(
+      output_wav_file_prefix, output_wav_file_bit_depth_override,
+      user_metadata.test_vector_metadata().validate_user_loudness());
+  return mix_presentation_finalizer->Initialize(
+      audio_elements, ProduceAllWavWriters, mix_presentation_obus);
+}
+
 absl::Status GenerateObus(
     const UserMetadata& user_metadata, const std::string& input_wav_directory,
     const std::string& output_iamf_directory, IamfEncoder& iamf_encoder,
@@ -165,11 +242,34 @@ absl::Status GenerateObus(
     std::list<MixPresentationObu>& mix_presentation_obus,
     std::list<AudioFrameWithData>& audio_frames,
     std::list<ParameterBlockWithData>& parameter_blocks,
-    std::list<ArbitraryObu>& arbitrary_obus) {
+    std::list<ArbitraryObu>& arbitrary_obus,
+    std::vector<VariantObus>& variant_obus) {
   RETURN_IF_NOT_OK(iamf_encoder.GenerateDescriptorObus(
       ia_sequence_header_obu, codec_config_obus, audio_elements,
       mix_presentation_obus));
 
+  // Each variant is written to files with its own suffix.
+  variant_obus.resize(user_metadata.encoder_variant_metadata_size());
+  for (int i = 0; i < user_metadata.encoder_variant_metadata_size(); ++i) {
+    variant_obus[i].user_metadata = user_metadata;
+    variant_obus[i]
+        .user_metadata.mutable_test_vector_metadata()
+        ->mutable_file_name_prefix()
+        ->append(user_metadata.encoder_variant_metadata(i).file_name_suffix());
+    variant_obus[i].mix_presentation_obus =
+        std::list<MixPresentationObu>(mix_presentation_obus);
+  }
+
+  std::unique_ptr<MixPresentationFinalizerBase> mix_presentation_finalizer;
+  RETURN_IF_NOT_OK(CreateAndInitializeMixPresentationFinalizer(
+      user_metadata, output_iamf_directory, audio_elements,
+      mix_presentation_obus, mix_presentation_finalizer));
+  for (auto& variant : variant_obus) {
+    RETURN_IF_NOT_OK(CreateAndInitializeMixPresentationFinalizer(
+        variant.user_metadata, output_iamf_directory, audio_elements,
+        variant.mix_presentation_obus, variant.mix_presentation_finalizer));
+  }
+
   WavSampleProvider wav_sample_provider(user_metadata.audio_frame_metadata());
   RETURN_IF_NOT_OK(
       wav_sample_provider.Initialize(input_wav_directory, audio_elements));
@@ -182,7 +282,6 @@ absl::Status GenerateObus(
   // TODO(b/329375123): Make two while loops that run on two threads: one for
   //                    adding samples and parameter block metadata, and one for
   //                    outputing OBUs.
-  IdTimeLabeledFrameMap id_to_time_to_labeled_frame;
   int data_obus_iteration = 0;  // Just for logging purposes.
   while (iamf_encoder.GeneratingDataObus()) {
     LOG(INFO) << "\n\n============================= Generating Data OBUs Iter #"
@@ -227,6 +326,28 @@ absl::Status GenerateObus(
         temp_audio_frames, temp_parameter_blocks, id_to_labeled_frame,
         output_timestamp));
 
+    for (int i = 0; i < user_metadata.encoder_variant_metadata_size(); ++i) {
+      std::list<AudioFrameWithData> variant_audio_frames;
+      std::list<ParameterBlockWithData> variant_parameter_blocks;
+      IdLabeledFrameMap variant_id_to_labeled_frame;
+      int32_t variant_output_timestamp = 0;
+      RETURN_IF_NOT_OK(iamf_encoder.OutputVariantTemporalUnit(
+          i, variant_audio_frames, variant_parameter_blocks,
+          variant_id_to_labeled_frame, variant_output_timestamp));
+      if (variant_audio_frames.empty()) {
+        continue;
+      }
+
+      RETURN_IF_NOT_OK(
+          variant_obus[i].mix_presentation_finalizer->PushTemporalUnit(
+              variant_id_to_labeled_frame, variant_output_timestamp,
+              variant_parameter_blocks));
+      variant_obus[i].audio_frames.splice(variant_obus[i].audio_frames.end(),
+                                          variant_audio_frames);
+      variant_obus[i].parameter_blocks.splice(
+          variant_obus[i].parameter_blocks.end(), variant_parameter_blocks);
+    }
+
     if (temp_audio_frames.empty()) {
       // Some audio codec will only output an encoded frame after the next
       // frame "pushes" the old one out. So we wait till the next iteration to
@@ -235,13 +356,10 @@ absl::Status GenerateObus(
       continue;
     }
 
-    // TODO(b/349271713): Move `id_to_time_to_labeled_frame` inside
-    //                    `IamfEncoder` once the mix presentation finalizer is
-    //                    inside too.
-    // Collect and organize generated audio frames in time.
-    for (const auto& [id, labeled_frame] : id_to_labeled_frame) {
-      id_to_time_to_labeled_frame[id][output_timestamp] = labeled_frame;
-    }
+    // The frames are only needed by the mix presentation finalizer, which
+    // consumes them immediately.
+    RETURN_IF_NOT_OK(mix_presentation_finalizer->PushTemporalUnit(
+        id_to_labeled_frame, output_timestamp, temp_parameter_blocks));
 
     audio_frames.splice(audio_frames.end(), temp_audio_frames);
     parameter_blocks.splice(parameter_blocks.end(), temp_parameter_blocks);
@@ -255,40 +373,14 @@ absl::Status GenerateObus(
       user_metadata.arbitrary_obu_metadata());
   RETURN_IF_NOT_OK(arbitrary_obu_generator.Generate(arbitrary_obus));
 
-  // Finalize mix presentation. Requires rendering data for every submix to
-  // accurately compute loudness.
-  std::optional<uint8_t> output_wav_file_bit_depth_override;
-  if (user_metadata.test_vector_metadata()
-          .has_output_wav_file_bit_depth_override()) {
-    if (user_metadata.test_vector_metadata()
-            .output_wav_file_bit_depth_override() >
-        std::numeric_limits<uint8_t>::max()) {
-      return absl::InvalidArgumentError(
-          absl::StrCat("Bit-depth too large. "
-                       "output_wav_file_bit_depth_override= ",
-                       user_metadata.test_vector_metadata()
-                           .output_wav_file_bit_depth_override()));
-    }
-    output_wav_file_bit_depth_override =
-        static_cast<uint8_t>(user_metadata.test_vector_metadata()
-                                 .output_wav_file_bit_depth_override());
+  RETURN_IF_NOT_OK(mix_presentation_finalizer->FinalizePushingTemporalUnits(
+      mix_presentation_obus));
+  for (auto& variant : variant_obus) {
+    RETURN_IF_NOT_OK(
+        variant.mix_presentation_finalizer->FinalizePushingTemporalUnits(
+            variant.mix_presentation_obus));
   }
 
-  // TODO(b/349271713): Move the mix presentation finalizer inside
-  //                    `IamfEncoder`.
-  // Write the output audio streams which were used to measure loudness to the
-  // same directory as the IAMF file.
-  const std::string output_wav_file_prefix =
-      std::filesystem::path(output_iamf_directory) /
-      user_metadata.test_vector_metadata().file_name_prefix();
-  LOG(INFO) << "output_wav_file_prefix = " << output_wav_file_prefix;
-  auto mix_presentation_finalizer = CreateMixPresentationFinalizer(
-      output_wav_file_prefix, output_wav_file_bit_depth_override,
-      user_metadata.test_vector_metadata().validate_user_loudness());
-  RETURN_IF_NOT_OK(mix_presentation_finalizer->Finalize(
-      audio_elements, id_to_time_to_labeled_frame, parameter_blocks,
-      ProduceAllWavWriters, mix_presentation_obus));
-
   return absl::OkStatus();
 }
 
@@ -332,6 +424,11 @@ absl::Status TestMain(const UserMetadata& input_user_metadata,
   std::list<AudioFrameWithData> audio_frames;
   std::list<ParameterBlockWithData> parameter_blocks;
   std::list<ArbitraryObu> arbitrary_obus;
+  std::vector<VariantObus> variant_obus;
+
+  // Reject variants which would overwrite other output files before spending
+  // any time encoding.
+  RETURN_IF_NOT_OK(ValidateEncoderVariantMetadata(user_metadata));
 
   // Create output directories.
   RETURN_IF_NOT_OK(CreateOutputDirectory(output_iamf_directory));
@@ -347,12 +444,20 @@ absl::Status TestMain(const UserMetadata& input_user_metadata,
   RETURN_IF_NOT_OK(GenerateObus(
       user_metadata, input_wav_directory, output_iamf_directory, iamf_encoder,
       ia_sequence_header_obu, codec_config_obus, audio_elements,
-      mix_presentation_obus, audio_frames, parameter_blocks, arbitrary_obus));
+      mix_presentation_obus, audio_frames, parameter_blocks, arbitrary_obus,
+      variant_obus));
 
   RETURN_IF_NOT_OK(WriteObus(user_metadata, output_iamf_directory,
                              ia_sequence_header_obu.value(), codec_config_obus,
                              audio_elements, mix_presentation_obus,
                              audio_frames, parameter_blocks, arbitrary_obus));
+  for (const auto& variant : variant_obus) {
+    RETURN_IF_NOT_OK(WriteObus(
+        variant.user_metadata, output_iamf_directory,
+        ia_sequence_header_obu.value(), codec_config_obus, audio_elements,
+        variant.mix_presentation_obus, variant.audio_frames,
+        variant.parameter_blocks, arbitrary_obus));
+  }
 
   return absl::OkStatus();
 }
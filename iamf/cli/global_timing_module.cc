@@ -11,6 +11,7 @@
  */
 #include "iamf/cli/global_timing_module.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 
@@ -18,6 +19,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "iamf/cli/audio_element_with_data.h"
 #include "iamf/cli/cli_util.h"
@@ -70,14 +72,16 @@ absl::Status GlobalTimingModule::Initialize(
       RETURN_IF_NOT_OK(
           ValidateNotEqual(sample_rate, uint32_t{0}, "sample rate"));
 
-      const auto [unused_iter, inserted] = audio_frame_timing_data_.insert(
-          {audio_substream_id, {.rate = sample_rate, .timestamp = 0}});
+      const auto [unused_iter, inserted] = audio_substream_id_to_index_.insert(
+          {audio_substream_id, audio_frame_timing_data_.size()});
 
       if (!inserted) {
         return absl::InvalidArgumentError(
             absl::StrCat("Audio substream ID: ", audio_substream_id,
                          " already exists in the Global Timing Module"));
       }
+      audio_frame_timing_data_.push_back(
+          {.rate = sample_rate, .timestamp = 0});
     }
   }
 
@@ -102,9 +106,43 @@ absl::Status GlobalTimingModule::Initialize(
 absl::Status GlobalTimingModule::GetNextAudioFrameTimestamps(
     const DecodedUleb128 audio_substream_id, const uint32_t duration,
     int32_t& start_timestamp, int32_t& end_timestamp) {
-  return GetTimestampsForId(audio_substream_id, duration,
-                            audio_frame_timing_data_, start_timestamp,
-                            end_timestamp);
+  const auto index_iter = audio_substream_id_to_index_.find(audio_substream_id);
+  if (index_iter == audio_substream_id_to_index_.end()) {
+    // Same as in `GetTimestampsForId()`.
+    start_timestamp = 0;
+    end_timestamp = duration;
+    return absl::InvalidArgumentError(
+        absl::StrCat("Timestamps for ID: ", audio_substream_id, " not found"));
+  }
+  return GetNextAudioFrameTimestampsForIndex(index_iter->second, duration,
+                                             start_timestamp, end_timestamp);
+}
+
+absl::StatusOr<size_t> GlobalTimingModule::GetAudioSubstreamIndex(
+    const DecodedUleb128 audio_substream_id) const {
+  const auto index_iter = audio_substream_id_to_index_.find(audio_substream_id);
+  if (index_iter == audio_substream_id_to_index_.end()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Timestamps for ID: ", audio_substream_id, " not found"));
+  }
+  return index_iter->second;
+}
+
+absl::Status GlobalTimingModule::GetNextAudioFrameTimestampsForIndex(
+    const size_t audio_substream_index, const uint32_t duration,
+    int32_t& start_timestamp, int32_t& end_timestamp) {
+  if (audio_substream_index >= audio_frame_timing_data_.size()) {
+    start_timestamp = 0;
+    end_timestamp = duration;
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unknown audio substream index: ", audio_substream_index));
+  }
+
+  auto& timing_data = audio_frame_timing_data_[audio_substream_index];
+  start_timestamp = timing_data.timestamp;
+  end_timestamp = start_timestamp + duration;
+  timing_data.timestamp += duration;
+  return absl::OkStatus();
 }
 
 absl::Status GlobalTimingModule::GetNextParameterBlockTimestamps(
@@ -125,9 +163,8 @@ absl::Status GlobalTimingModule::GetGlobalAudioFrameTimestamp(
     return absl::InvalidArgumentError("No audio frames to get timestamps for");
   }
 
-  const int32_t common_timestamp =
-      audio_frame_timing_data_.begin()->second.timestamp;
-  for (const auto& [unused_id, timing_data] : audio_frame_timing_data_) {
+  const int32_t common_timestamp = audio_frame_timing_data_.front().timestamp;
+  for (const auto& timing_data : audio_frame_timing_data_) {
     if (common_timestamp != timing_data.timestamp) {
       // Some audio frames have not advance their timestamps yet, return OK
       // but let `global_timestamp` hold no value.
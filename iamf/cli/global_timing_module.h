@@ -13,11 +13,14 @@
 #ifndef CLI_GLOBAL_TIMING_MODULE_H_
 #define CLI_GLOBAL_TIMING_MODULE_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "iamf/cli/audio_element_with_data.h"
 #include "iamf/cli/proto/user_metadata.pb.h"
 #include "iamf/obu/leb128.h"
@@ -60,6 +63,32 @@ class GlobalTimingModule {
                                            int32_t& start_timestamp,
                                            int32_t& end_timestamp);
 
+  /*!\brief Gets the dense index of an audio substream.
+   *
+   * Indices are assigned in `Initialize()`. Callers which request timestamps
+   * for every frame can look up the index once and then use
+   * `GetNextAudioFrameTimestampsForIndex()`.
+   *
+   * \param audio_substream_id Substream ID to look up.
+   * \return Index of the substream on success. A specific status on failure.
+   */
+  absl::StatusOr<size_t> GetAudioSubstreamIndex(
+      DecodedUleb128 audio_substream_id) const;
+
+  /*!\brief Gets the start and end timestamps of the next Audio Frame.
+   *
+   * \param audio_substream_index Index of the substream from
+   *     `GetAudioSubstreamIndex()`.
+   * \param duration Duration of this frame measured in ticks.
+   * \param start_timestamp Output start timestamp.
+   * \param end_timestamp Output end timestamp.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status GetNextAudioFrameTimestampsForIndex(size_t audio_substream_index,
+                                                   uint32_t duration,
+                                                   int32_t& start_timestamp,
+                                                   int32_t& end_timestamp);
+
   /*!\brief Gets the start and end timestamps of the next Parameter Block.
    *
    * \param parameter_id ID of the Parameter Block.
@@ -104,7 +133,10 @@ class GlobalTimingModule {
       absl::flat_hash_map<DecodedUleb128, TimingData>& id_to_timing_data,
       int32_t& start_timestamp, int32_t& end_timestamp);
 
-  absl::flat_hash_map<DecodedUleb128, TimingData> audio_frame_timing_data_;
+  // Mapping from audio substream ID to its index in
+  // `audio_frame_timing_data_`.
+  absl::flat_hash_map<DecodedUleb128, size_t> audio_substream_id_to_index_;
+  std::vector<TimingData> audio_frame_timing_data_;
   absl::flat_hash_map<DecodedUleb128, TimingData> parameter_block_timing_data_;
 };
 
@@ -21,19 +21,28 @@
 #include "absl/log/log.h"
 #include "absl/strings/str_cat.h"
 #include "iamf/cli/leb_generator.h"
+#include "iamf/cli/loudness_calculator_factory.h"
 #include "iamf/cli/mix_presentation_finalizer.h"
 #include "iamf/cli/obu_sequencer.h"
 #include "iamf/cli/proto/test_vector_metadata.pb.h"
 #include "iamf/cli/proto/user_metadata.pb.h"
+#include "iamf/cli/renderer_factory.h"
 
 namespace iamf_tools {
 
 std::unique_ptr<MixPresentationFinalizerBase> CreateMixPresentationFinalizer(
-    const std::string& /*file_name_prefix*/,
-    std::optional<uint8_t> /*output_wav_file_bit_depth_override*/,
-    bool /*validate_loudness*/) {
+    const std::string& file_name_prefix,
+    std::optional<uint8_t> output_wav_file_bit_depth_override,
+    bool validate_loudness) {
+  // Render every layout which can be rendered and measure its loudness. Other
+  // layouts, including binaural layouts without an `HrirSet`, keep the user
+  // provided loudness.
   return std::make_unique<
-      MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer>();
+      MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer>(
+      file_name_prefix, std::make_unique<RendererFactory>(),
+      std::make_unique<LoudnessCalculatorFactoryItuRBs1770>(),
+      /*num_threads=*/0, output_wav_file_bit_depth_override,
+      validate_loudness);
 }
 
 std::vector<std::unique_ptr<ObuSequencerBase>> CreateObuSequencers(
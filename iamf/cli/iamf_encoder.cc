@@ -12,6 +12,7 @@
 #include "iamf/cli/iamf_encoder.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -21,6 +22,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "iamf/cli/audio_element_with_data.h"
 #include "iamf/cli/audio_frame_decoder.h"
 #include "iamf/cli/audio_frame_with_data.h"
@@ -30,6 +32,8 @@
 #include "iamf/cli/global_timing_module.h"
 #include "iamf/cli/parameter_block_with_data.h"
 #include "iamf/cli/parameters_manager.h"
+#include "iamf/cli/proto/codec_config.pb.h"
+#include "iamf/cli/proto/parameter_block.pb.h"
 #include "iamf/cli/proto/test_vector_metadata.pb.h"
 #include "iamf/cli/proto/user_metadata.pb.h"
 #include "iamf/cli/proto_to_obu/audio_element_generator.h"
@@ -43,6 +47,9 @@
 #include "iamf/obu/ia_sequence_header.h"
 #include "iamf/obu/leb128.h"
 #include "iamf/obu/mix_presentation.h"
+#include "iamf/obu/param_definitions.h"
+#include "iamf/obu/parameter_block.h"
+#include "src/google/protobuf/repeated_ptr_field.h"
 
 namespace iamf_tools {
 
@@ -64,6 +71,120 @@ absl::Status InitAudioFrameDecoderForAllAudioElements(
   return absl::OkStatus();
 }
 
+// Validates that an encoder variant results in the same Codec Config OBUs as
+// the main IA Sequence. Variants share the descriptor OBUs, so they may only
+// change settings which are not written to the OBUs.
+absl::Status ValidateEncoderVariant(
+    const google::protobuf::RepeatedPtrField<
+        iamf_tools_cli_proto::CodecConfigObuMetadata>& codec_config_metadata,
+    const iamf_tools_cli_proto::EncoderVariantMetadata&
+        encoder_variant_metadata,
+    const absl::flat_hash_map<uint32_t, CodecConfigObu>& codec_config_obus) {
+  google::protobuf::RepeatedPtrField<
+      iamf_tools_cli_proto::CodecConfigObuMetadata>
+      variant_codec_config_metadata = codec_config_metadata;
+  for (const auto& variant_codec_config_obu_metadata :
+       encoder_variant_metadata.codec_config_metadata()) {
+    auto iter = std::find_if(
+        variant_codec_config_metadata.begin(),
+        variant_codec_config_metadata.end(),
+        [&variant_codec_config_obu_metadata](const auto& metadata) {
+          return metadata.codec_config_id() ==
+                 variant_codec_config_obu_metadata.codec_config_id();
+        });
+    if (iter == variant_codec_config_metadata.end()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Encoder variant has an unknown codec_config_id= ",
+                       variant_codec_config_obu_metadata.codec_config_id()));
+    }
+    *iter->mutable_codec_config() =
+        variant_codec_config_obu_metadata.codec_config();
+  }
+
+  absl::flat_hash_map<uint32_t, CodecConfigObu> variant_codec_config_obus;
+  CodecConfigGenerator codec_config_generator(variant_codec_config_metadata);
+  RETURN_IF_NOT_OK(codec_config_generator.Generate(variant_codec_config_obus));
+  if (variant_codec_config_obus != codec_config_obus) {
+    return absl::InvalidArgumentError(
+        "Encoder variants must result in the same Codec Config OBUs as the "
+        "main IA Sequence.");
+  }
+  return absl::OkStatus();
+}
+
+// Appends copies of the parameter blocks in `source` to `destination`.
+void AppendCopies(const std::list<ParameterBlockWithData>& source,
+                  std::list<ParameterBlockWithData>& destination) {
+  for (const auto& parameter_block : source) {
+    destination.push_back(
+        {.obu = std::make_unique<ParameterBlockObu>(*parameter_block.obu),
+         .start_timestamp = parameter_block.start_timestamp,
+         .end_timestamp = parameter_block.end_timestamp});
+  }
+}
+
+// Decodes and demixes the audio frames of one temporal unit, generates the
+// recon gain parameter blocks and moves the parameter blocks which belong to
+// the temporal unit to the output. The raw samples of the audio frames are
+// released once they are no longer needed.
+absl::Status FinishTemporalUnit(
+    std::list<AudioFrameWithData>& audio_frames,
+    const DemixingModule& demixing_module,
+    AudioFrameDecoder& audio_frame_decoder,
+    ParameterBlockGenerator& parameter_block_generator,
+    GlobalTimingModule& global_timing_module,
+    std::list<ParameterBlockWithData>& temp_mix_gain_parameter_blocks,
+    std::list<ParameterBlockWithData>& temp_demixing_parameter_blocks,
+    std::list<ParameterBlockWithData>& temp_recon_gain_parameter_blocks,
+    std::list<ParameterBlockWithData>& parameter_blocks,
+    IdLabeledFrameMap& id_to_labeled_frame, int32_t& output_timestamp) {
+  // Decode the audio frames. They are required to determine the demixed
+  // frames.
+  std::list<DecodedAudioFrame> decoded_audio_frames;
+  RETURN_IF_NOT_OK(
+      audio_frame_decoder.Decode(audio_frames, decoded_audio_frames));
+
+  // Demix the audio frames.
+  IdLabeledFrameMap id_to_labeled_decoded_frame;
+  RETURN_IF_NOT_OK(demixing_module.DemixAudioSamples(
+      audio_frames, decoded_audio_frames, id_to_labeled_frame,
+      id_to_labeled_decoded_frame));
+
+  // The decoded frames have been consumed by demixing. Hand them back so their
+  // storage is reused for the next temporal unit.
+  audio_frame_decoder.Recycle(decoded_audio_frames);
+
+  // Recon gain parameter blocks are generated based on the original and
+  // demixed audio frames.
+  RETURN_IF_NOT_OK(parameter_block_generator.GenerateReconGain(
+      id_to_labeled_frame, id_to_labeled_decoded_frame, global_timing_module,
+      temp_recon_gain_parameter_blocks));
+
+  // Nothing downstream reads the raw samples. Drop this frame's reference, so
+  // they are freed once the frames of all variants have been demixed.
+  for (auto& audio_frame : audio_frames) {
+    audio_frame.raw_samples.reset();
+  }
+
+  // Move all generated parameter blocks belonging to this temporal unit to
+  // the output.
+  output_timestamp = audio_frames.front().start_timestamp;
+  for (auto* temp_parameter_blocks :
+       {&temp_mix_gain_parameter_blocks, &temp_demixing_parameter_blocks,
+        &temp_recon_gain_parameter_blocks}) {
+    auto last_same_timestamp_iter = std::find_if(
+        temp_parameter_blocks->begin(), temp_parameter_blocks->end(),
+        [output_timestamp](const auto& parameter_block) {
+          return parameter_block.start_timestamp > output_timestamp;
+        });
+    parameter_blocks.splice(parameter_blocks.end(), *temp_parameter_blocks,
+                            temp_parameter_blocks->begin(),
+                            last_same_timestamp_iter);
+  }
+
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 IamfEncoder::IamfEncoder(
@@ -94,6 +215,12 @@ absl::Status IamfEncoder::GenerateDescriptorObus(
   CodecConfigGenerator codec_config_generator(
       user_metadata_.codec_config_metadata());
   RETURN_IF_NOT_OK(codec_config_generator.Generate(codec_config_obus));
+  for (const auto& encoder_variant_metadata :
+       user_metadata_.encoder_variant_metadata()) {
+    RETURN_IF_NOT_OK(ValidateEncoderVariant(
+        user_metadata_.codec_config_metadata(), encoder_variant_metadata,
+        codec_config_obus));
+  }
 
   // Audio Element OBUs.
   AudioElementGenerator audio_element_generator(
@@ -133,7 +260,8 @@ absl::Status IamfEncoder::GenerateDescriptorObus(
   audio_frame_generator_ = std::make_unique<AudioFrameGenerator>(
       user_metadata_.audio_frame_metadata(),
       user_metadata_.codec_config_metadata(), audio_elements, demixing_module_,
-      *parameters_manager_, global_timing_module_);
+      *parameters_manager_, global_timing_module_,
+      user_metadata_.encoder_variant_metadata());
   RETURN_IF_NOT_OK(audio_frame_generator_->Initialize());
 
   // Initialize the audio frame decoder. It is needed to determine the recon
@@ -142,6 +270,23 @@ absl::Status IamfEncoder::GenerateDescriptorObus(
   RETURN_IF_NOT_OK(InitAudioFrameDecoderForAllAudioElements(
       audio_elements, *audio_frame_decoder_));
 
+  // Each variant decodes its own frames and checks its own recon gains.
+  encoder_variants_.resize(user_metadata_.encoder_variant_metadata_size());
+  for (auto& encoder_variant : encoder_variants_) {
+    encoder_variant.audio_frame_decoder = std::make_unique<AudioFrameDecoder>();
+    RETURN_IF_NOT_OK(InitAudioFrameDecoderForAllAudioElements(
+        audio_elements, *encoder_variant.audio_frame_decoder));
+    encoder_variant.parameter_block_generator =
+        std::make_unique<ParameterBlockGenerator>(
+            user_metadata_.test_vector_metadata()
+                .override_computed_recon_gains(),
+            parameter_id_to_metadata_);
+    RETURN_IF_NOT_OK(encoder_variant.parameter_block_generator->Initialize(
+        audio_elements, param_definitions_));
+    RETURN_IF_NOT_OK(encoder_variant.global_timing_module.Initialize(
+        audio_elements, param_definitions_));
+  }
+
   return absl::OkStatus();
 }
 
@@ -182,6 +327,16 @@ absl::Status IamfEncoder::AddParameterBlockMetadata(
         parameter_block_metadata) {
   RETURN_IF_NOT_OK(
       parameter_block_generator_.AddMetadata(parameter_block_metadata));
+
+  // Recon gain parameter blocks are generated separately for each variant.
+  if (parameter_id_to_metadata_.at(parameter_block_metadata.parameter_id())
+          .param_definition_type ==
+      ParamDefinition::kParameterDefinitionReconGain) {
+    for (auto& encoder_variant : encoder_variants_) {
+      RETURN_IF_NOT_OK(encoder_variant.parameter_block_generator->AddMetadata(
+          parameter_block_metadata));
+    }
+  }
   return absl::OkStatus();
 }
 
@@ -193,16 +348,30 @@ absl::Status IamfEncoder::OutputTemporalUnit(
   parameter_blocks.clear();
 
   // Generate mix gain and demixing parameter blocks.
+  std::list<ParameterBlockWithData> demixing_parameter_blocks;
+  std::list<ParameterBlockWithData> mix_gain_parameter_blocks;
   RETURN_IF_NOT_OK(parameter_block_generator_.GenerateDemixing(
-      global_timing_module_, temp_demixing_parameter_blocks_));
+      global_timing_module_, demixing_parameter_blocks));
   RETURN_IF_NOT_OK(parameter_block_generator_.GenerateMixGain(
-      global_timing_module_, temp_mix_gain_parameter_blocks_));
+      global_timing_module_, mix_gain_parameter_blocks));
+
+  // They are the same for all variants.
+  for (auto& encoder_variant : encoder_variants_) {
+    AppendCopies(demixing_parameter_blocks,
+                 encoder_variant.temp_demixing_parameter_blocks);
+    AppendCopies(mix_gain_parameter_blocks,
+                 encoder_variant.temp_mix_gain_parameter_blocks);
+  }
 
   // Add the newly generated demixing parameter blocks to the parameters
   // manager so they can be easily queried by the audio frame generator.
-  for (const auto& demixing_parameter_block : temp_demixing_parameter_blocks_) {
+  for (const auto& demixing_parameter_block : demixing_parameter_blocks) {
     parameters_manager_->AddDemixingParameterBlock(&demixing_parameter_block);
   }
+  temp_demixing_parameter_blocks_.splice(temp_demixing_parameter_blocks_.end(),
+                                         demixing_parameter_blocks);
+  temp_mix_gain_parameter_blocks_.splice(temp_mix_gain_parameter_blocks_.end(),
+                                         mix_gain_parameter_blocks);
 
   for (const auto& [audio_element_id, labeled_samples] :
        id_to_labeled_samples_) {
@@ -220,41 +389,41 @@ absl::Status IamfEncoder::OutputTemporalUnit(
     return absl::OkStatus();
   }
 
-  // Decode the audio frames. They are required to determine the demixed
-  // frames.
-  std::list<DecodedAudioFrame> decoded_audio_frames;
-  RETURN_IF_NOT_OK(
-      audio_frame_decoder_->Decode(audio_frames, decoded_audio_frames));
-
-  // Demix the audio frames.
-  IdLabeledFrameMap id_to_labeled_decoded_frame;
-  RETURN_IF_NOT_OK(demixing_module_.DemixAudioSamples(
-      audio_frames, decoded_audio_frames, id_to_labeled_frame,
-      id_to_labeled_decoded_frame));
+  return FinishTemporalUnit(
+      audio_frames, demixing_module_, *audio_frame_decoder_,
+      parameter_block_generator_, global_timing_module_,
+      temp_mix_gain_parameter_blocks_, temp_demixing_parameter_blocks_,
+      temp_recon_gain_parameter_blocks_, parameter_blocks, id_to_labeled_frame,
+      output_timestamp);
+}
 
-  // Recon gain parameter blocks are generated based on the original and
-  // demixed audio frames.
-  RETURN_IF_NOT_OK(parameter_block_generator_.GenerateReconGain(
-      id_to_labeled_frame, id_to_labeled_decoded_frame, global_timing_module_,
-      temp_recon_gain_parameter_blocks_));
+absl::Status IamfEncoder::OutputVariantTemporalUnit(
+    int variant_index, std::list<AudioFrameWithData>& audio_frames,
+    std::list<ParameterBlockWithData>& parameter_blocks,
+    IdLabeledFrameMap& id_to_labeled_frame, int32_t& output_timestamp) {
+  audio_frames.clear();
+  parameter_blocks.clear();
+  if (audio_frame_generator_ == nullptr || variant_index < 0 ||
+      static_cast<size_t>(variant_index) >= encoder_variants_.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unknown encoder variant index= ", variant_index));
+  }
 
-  // Move all generated parameter blocks belonging to this temporal unit to
-  // the output.
-  output_timestamp = audio_frames.front().start_timestamp;
-  for (auto* temp_parameter_blocks :
-       {&temp_mix_gain_parameter_blocks_, &temp_demixing_parameter_blocks_,
-        &temp_recon_gain_parameter_blocks_}) {
-    auto last_same_timestamp_iter = std::find_if(
-        temp_parameter_blocks->begin(), temp_parameter_blocks->end(),
-        [output_timestamp](const auto& parameter_block) {
-          return parameter_block.start_timestamp > output_timestamp;
-        });
-    parameter_blocks.splice(parameter_blocks.end(), *temp_parameter_blocks,
-                            temp_parameter_blocks->begin(),
-                            last_same_timestamp_iter);
+  RETURN_IF_NOT_OK(
+      audio_frame_generator_->OutputVariantFrames(variant_index, audio_frames));
+  if (audio_frames.empty()) {
+    return absl::OkStatus();
   }
 
-  return absl::OkStatus();
+  auto& encoder_variant = encoder_variants_[variant_index];
+  return FinishTemporalUnit(
+      audio_frames, demixing_module_, *encoder_variant.audio_frame_decoder,
+      *encoder_variant.parameter_block_generator,
+      encoder_variant.global_timing_module,
+      encoder_variant.temp_mix_gain_parameter_blocks,
+      encoder_variant.temp_demixing_parameter_blocks,
+      encoder_variant.temp_recon_gain_parameter_blocks, parameter_blocks,
+      id_to_labeled_frame, output_timestamp);
 }
 
 }  // namespace iamf_tools
@@ -64,6 +64,13 @@ namespace iamf_tools {
  *     encoder.OutputTemporalUnit(...);
  *   }
  *
+ * When the user metadata has `encoder_variant_metadata`, each variant is
+ * encoded from the same samples and parameter block metadata. After each call
+ * to `OutputTemporalUnit()`, call `OutputVariantTemporalUnit()` for every
+ * variant to get its data OBUs. Only the encoders, decoders and recon gain
+ * parameter blocks are separate for each variant. Variants share the
+ * descriptor OBUs of the main IA Sequence.
+ *
  * Note the timestamps corresponding to `AddSamples()` and
  * `AddParameterBlockMetadata()` might be different from that of the output
  * OBUs obtained in `OutputTemporalUnit()`, because some codecs introduce a
@@ -137,7 +144,7 @@ class IamfEncoder {
   /*!\brief Outputs data OBUs corresponding to one temporal unit.
    *
    * \param audio_frames List of generated audio frames corresponding to this
-   *     temporal unit.
+   *     temporal unit. Their `raw_samples` are released before returning.
    * \param parameter_blocks List of generated parameter block corresponding
    *     to this temporal unit.
    * \param id_to_labeled_frame Map of Audio Element IDs to labeld frames;
@@ -150,7 +157,46 @@ class IamfEncoder {
       std::list<ParameterBlockWithData>& parameter_blocks,
       IdLabeledFrameMap& id_to_labeled_frame, int32_t& output_timestamp);
 
+  /*!\brief Outputs data OBUs of an encoder variant for one temporal unit.
+   *
+   * Must be called for every variant after each call to
+   * `OutputTemporalUnit()`. The outputs are the same as in
+   * `OutputTemporalUnit()`, but for the IA Sequence of the variant.
+   *
+   * \param variant_index Index of the variant in `encoder_variant_metadata`.
+   * \param audio_frames List of generated audio frames corresponding to this
+   *     temporal unit.
+   * \param parameter_blocks List of generated parameter block corresponding
+   *     to this temporal unit.
+   * \param id_to_labeled_frame Map of Audio Element IDs to labeld frames;
+   *     which is a data structure storing samples.
+   * \param output_timestamp Output timestamp of this temporal unit.
+   * \return `absl::OkStatus()` if successful. A specific status on failure.
+   */
+  absl::Status OutputVariantTemporalUnit(
+      int variant_index, std::list<AudioFrameWithData>& audio_frames,
+      std::list<ParameterBlockWithData>& parameter_blocks,
+      IdLabeledFrameMap& id_to_labeled_frame, int32_t& output_timestamp);
+
  private:
+  // Generators and parameter blocks which are separate for each encoder
+  // variant.
+  struct EncoderVariantState {
+    std::unique_ptr<AudioFrameDecoder> audio_frame_decoder;
+
+    // Only generates recon gain parameter blocks. The other parameter blocks
+    // are copied from the main IA Sequence.
+    std::unique_ptr<ParameterBlockGenerator> parameter_block_generator;
+
+    // Only tracks the timestamps of recon gain parameter blocks.
+    GlobalTimingModule global_timing_module;
+
+    // Saved parameter blocks generated in one iteration.
+    std::list<ParameterBlockWithData> temp_mix_gain_parameter_blocks;
+    std::list<ParameterBlockWithData> temp_demixing_parameter_blocks;
+    std::list<ParameterBlockWithData> temp_recon_gain_parameter_blocks;
+  };
+
   // Input user metadata describing the IAMF stream.
   iamf_tools_cli_proto::UserMetadata user_metadata_;
 
@@ -181,6 +227,9 @@ class IamfEncoder {
   std::unique_ptr<AudioFrameGenerator> audio_frame_generator_;
   std::unique_ptr<AudioFrameDecoder> audio_frame_decoder_;
   GlobalTimingModule global_timing_module_;
+
+  // State of each encoder variant, in the order of `encoder_variant_metadata`.
+  std::vector<EncoderVariantState> encoder_variants_;
 };
 
 }  // namespace iamf_tools
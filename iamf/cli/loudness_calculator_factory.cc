@@ -15,6 +15,7 @@
 #include <memory>
 
 #include "iamf/cli/loudness_calculator.h"
+#include "iamf/cli/loudness_calculator_itu_r_bs_1770.h"
 #include "iamf/obu/mix_presentation.h"
 
 namespace iamf_tools {
@@ -28,4 +29,17 @@ LoudnessCalculatorFactoryUserProvidedLoudness::CreateLoudnessCalculator(
       layout.loudness);
 }
 
+std::unique_ptr<LoudnessCalculatorBase>
+LoudnessCalculatorFactoryItuRBs1770::CreateLoudnessCalculator(
+    const MixPresentationLayout& layout, int32_t rendered_sample_rate,
+    int32_t) const {
+  auto loudness_calculator =
+      LoudnessCalculatorItuRBs1770::Create(layout, rendered_sample_rate);
+  if (loudness_calculator == nullptr) {
+    return std::make_unique<LoudnessCalculatorUserProvidedLoudness>(
+        layout.loudness);
+  }
+  return loudness_calculator;
+}
+
 }  // namespace iamf_tools
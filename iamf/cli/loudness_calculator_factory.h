@@ -80,6 +80,32 @@ class LoudnessCalculatorFactoryUserProvidedLoudness
   ~LoudnessCalculatorFactoryUserProvidedLoudness() override = default;
 };
 
+/*!\brief Factory which provides ITU-R BS.1770-4 loudness calculators.
+ *
+ * This factory produces calculators which measure the integrated loudness and
+ * the peaks of the rendered samples. When loudness cannot be measured on a
+ * layout, for example because the layout is reserved, it falls back to a
+ * calculator which echoes the user provided loudness.
+ */
+class LoudnessCalculatorFactoryItuRBs1770
+    : public LoudnessCalculatorFactoryBase {
+ public:
+  /*!\brief Creates a loudness calculator.
+   *
+   * \param layout Layout to measure loudness on.
+   * \param rendered_sample_rate Sample rate of the rendered audio.
+   * \param rendered_bit_depth Bit-depth of the rendered audio to ignore.
+   *     Samples are always measured relative to the full scale of `int32_t`.
+   * \return Unique pointer to a loudness calculator.
+   */
+  std::unique_ptr<LoudnessCalculatorBase> CreateLoudnessCalculator(
+      const MixPresentationLayout& layout, int32_t rendered_sample_rate,
+      int32_t /*rendered_bit_depth*/) const override;
+
+  /*!\brief Destructor. */
+  ~LoudnessCalculatorFactoryItuRBs1770() override = default;
+};
+
 }  // namespace iamf_tools
 
 #endif  // CLI_LOUDNESS_CALCULATOR_H_
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/loudness_calculator_itu_r_bs_1770.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numbers>
+#include <variant>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "iamf/cli/true_peak_meter.h"
+#include "iamf/common/macros.h"
+#include "iamf/common/obu_util.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+
+namespace {
+
+// Scale from `int32_t` samples to the range [-1, 1].
+constexpr double kSampleScale = 1.0 / 2147483648.0;
+
+// Channel weights of ITU-R BS.1770-4. Channels below 30 degrees of elevation
+// and between 60 and 120 degrees of azimuth are boosted by 1.5 dB. LFE
+// channels are excluded.
+constexpr double kLfe = 0.0;
+constexpr double kFrt = 1.0;
+constexpr double kSid = 1.41;
+
+// Looks up the channel weights of the playback layout, in the EAR channel order
+// of the layout.
+absl::StatusOr<std::vector<double>> LookupChannelWeights(const Layout& layout) {
+  if (layout.layout_type == Layout::kLayoutTypeBinaural) {
+    return std::vector<double>{kFrt, kFrt};
+  }
+  const auto* ss_layout =
+      std::get_if<LoudspeakersSsConventionLayout>(&layout.specific_layout);
+  if (layout.layout_type != Layout::kLayoutTypeLoudspeakersSsConvention ||
+      ss_layout == nullptr) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported layout_type= ", layout.layout_type));
+  }
+
+  using enum LoudspeakersSsConventionLayout::SoundSystem;
+  switch (ss_layout->sound_system) {
+    case kSoundSystemA_0_2_0:
+      return std::vector<double>{kFrt, kFrt};
+    case kSoundSystemB_0_5_0:
+      return std::vector<double>{kFrt, kFrt, kFrt, kLfe, kSid, kSid};
+    case kSoundSystemC_2_5_0:
+      return std::vector<double>{kFrt, kFrt, kFrt, kLfe,
+                                 kSid, kSid, kFrt, kFrt};
+    case kSoundSystemD_4_5_0:
+      return std::vector<double>{kFrt, kFrt, kFrt, kLfe, kSid,
+                                 kSid, kFrt, kFrt, kFrt, kFrt};
+    case kSoundSystemE_4_5_1:
+      return std::vector<double>{kFrt, kFrt, kFrt, kLfe, kSid, kSid,
+                                 kFrt, kFrt, kFrt, kFrt, kFrt};
+    case kSoundSystemF_3_7_0:
+      return std::vector<double>{kFrt, kFrt, kFrt, kFrt, kFrt, kSid,
+                                 kSid, kFrt, kFrt, kFrt, kLfe, kLfe};
+    case kSoundSystemG_4_9_0:
+      return std::vector<double>{kFrt, kFrt, kFrt, kLfe, kSid, kSid, kFrt,
+                                 kFrt, kFrt, kFrt, kFrt, kFrt, kFrt, kFrt};
+    case kSoundSystemH_9_10_3:
+      return std::vector<double>{kSid, kSid, kFrt, kLfe, kFrt, kFrt,
+                                 kFrt, kFrt, kFrt, kLfe, kSid, kSid,
+                                 kFrt, kFrt, kFrt, kFrt, kFrt, kFrt,
+                                 kFrt, kFrt, kFrt, kFrt, kFrt, kFrt};
+    case kSoundSystemI_0_7_0:
+      return std::vector<double>{kFrt, kFrt, kFrt, kLfe,
+                                 kSid, kSid, kFrt, kFrt};
+    case kSoundSystemJ_4_7_0:
+      return std::vector<double>{kFrt, kFrt, kFrt, kLfe, kSid, kSid,
+                                 kFrt, kFrt, kFrt, kFrt, kFrt, kFrt};
+    case kSoundSystem10_2_7_0:
+      return std::vector<double>{kFrt, kFrt, kFrt, kLfe, kSid,
+                                 kSid, kFrt, kFrt, kFrt, kFrt};
+    case kSoundSystem11_2_3_0:
+      return std::vector<double>{kFrt, kFrt, kFrt, kLfe, kFrt, kFrt};
+    case kSoundSystem12_0_1_0:
+      return std::vector<double>{kFrt};
+    case kSoundSystem13_6_9_0:
+      return std::vector<double>{kSid, kSid, kFrt, kLfe, kFrt, kFrt,
+                                 kFrt, kFrt, kSid, kSid, kFrt, kFrt,
+                                 kFrt, kFrt, kFrt, kFrt};
+    default:
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Unsupported sound_system= ", ss_layout->sound_system));
+  }
+}
+
+double EnergyToLoudness(double mean_square_energy) {
+  return -0.691 + 10.0 * std::log10(mean_square_energy);
+}
+
+// Converts a value in dB to Q7.8, clamping values outside of its range.
+absl::Status DecibelsToQ7_8(double value, int16_t& result) {
+  constexpr double kMinQ7_8 = -128.0;
+  constexpr double kMaxQ7_8 = 128.0 - 1.0 / 256.0;
+  return FloatToQ7_8(static_cast<float>(std::clamp(value, kMinQ7_8, kMaxQ7_8)),
+                     result);
+}
+
+}  // namespace
+
+std::unique_ptr<LoudnessCalculatorItuRBs1770>
+LoudnessCalculatorItuRBs1770::Create(const MixPresentationLayout& layout,
+                                     int32_t rendered_sample_rate) {
+  const auto channel_weights = LookupChannelWeights(layout.loudness_layout);
+  if (!channel_weights.ok()) {
+    LOG(WARNING) << "Unable to measure loudness: "
+                 << channel_weights.status();
+    return nullptr;
+  }
+  if (rendered_sample_rate < 10) {
+    LOG(WARNING) << "Unable to measure loudness at rendered_sample_rate= "
+                 << rendered_sample_rate;
+    return nullptr;
+  }
+  return absl::WrapUnique(new LoudnessCalculatorItuRBs1770(
+      layout.loudness, rendered_sample_rate, *channel_weights));
+}
+
+LoudnessCalculatorItuRBs1770::LoudnessCalculatorItuRBs1770(
+    const LoudnessInfo& user_provided_loudness, int32_t rendered_sample_rate,
+    const std::vector<double>& channel_weights)
+    : user_provided_loudness_(user_provided_loudness),
+      measure_true_peak_(
+          (user_provided_loudness.info_type & LoudnessInfo::kTruePeak) != 0),
+      num_channels_(static_cast<int>(channel_weights.size())),
+      channel_weights_(channel_weights),
+      num_ticks_per_step_(rendered_sample_rate / 10),
+      // K-weighting filters of ITU-R BS.1770-4, derived for any sample rate.
+      // They match the coefficients of the recommendation at 48 kHz.
+      pre_filter_([rendered_sample_rate] {
+        constexpr double kF0 = 1681.974450955533;
+        constexpr double kGainDb = 3.999843853973347;
+        constexpr double kQ = 0.7071752369554196;
+        const double k =
+            std::tan(std::numbers::pi * kF0 / rendered_sample_rate);
+        const double vh = std::pow(10.0, kGainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / kQ + k * k;
+        return Biquad{.b0 = (vh + vb * k / kQ + k * k) / a0,
+                      .b1 = 2.0 * (k * k - vh) / a0,
+                      .b2 = (vh - vb * k / kQ + k * k) / a0,
+                      .a1 = 2.0 * (k * k - 1.0) / a0,
+                      .a2 = (1.0 - k / kQ + k * k) / a0};
+      }()),
+      rlb_filter_([rendered_sample_rate] {
+        constexpr double kF0 = 38.13547087602444;
+        constexpr double kQ = 0.5003270373238773;
+        const double k =
+            std::tan(std::numbers::pi * kF0 / rendered_sample_rate);
+        const double a0 = 1.0 + k / kQ + k * k;
+        return Biquad{.b0 = 1.0,
+                      .b1 = -2.0,
+                      .b2 = 1.0,
+                      .a1 = 2.0 * (k * k - 1.0) / a0,
+                      .a2 = (1.0 - k / kQ + k * k) / a0};
+      }()),
+      pre_filter_z1_(num_channels_, 0.0),
+      pre_filter_z2_(num_channels_, 0.0),
+      rlb_filter_z1_(num_channels_, 0.0),
+      rlb_filter_z2_(num_channels_, 0.0),
+      step_energy_(num_channels_, 0.0),
+      histogram_counts_(kNumBins, 0),
+      histogram_energies_(kNumBins, 0.0),
+      true_peak_meter_(num_channels_) {}
+
+absl::Status LoudnessCalculatorItuRBs1770::AccumulateLoudnessForSamples(
+    const std::vector<int32_t>& rendered_samples) {
+  if (rendered_samples.size() % num_channels_ != 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected a multiple of ", num_channels_, " samples. Got ",
+        rendered_samples.size(), "."));
+  }
+
+  const size_t num_ticks = rendered_samples.size() / num_channels_;
+  const Biquad pre = pre_filter_;
+  const Biquad rlb = rlb_filter_;
+  double* const pre_z1 = pre_filter_z1_.data();
+  double* const pre_z2 = pre_filter_z2_.data();
+  double* const rlb_z1 = rlb_filter_z1_.data();
+  double* const rlb_z2 = rlb_filter_z2_.data();
+  double* const energy = step_energy_.data();
+  double digital_peak = max_digital_peak_;
+  for (size_t t = 0; t < num_ticks; ++t) {
+    const int32_t* const tick = rendered_samples.data() + t * num_channels_;
+    // The channels are independent, so this loop can be vectorized.
+    for (int c = 0; c < num_channels_; ++c) {
+      const double x = tick[c] * kSampleScale;
+      digital_peak = std::max(digital_peak, std::abs(x));
+      const double y = pre.b0 * x + pre_z1[c];
+      pre_z1[c] = pre.b1 * x - pre.a1 * y + pre_z2[c];
+      pre_z2[c] = pre.b2 * x - pre.a2 * y;
+      const double k_weighted = rlb.b0 * y + rlb_z1[c];
+      rlb_z1[c] = rlb.b1 * y - rlb.a1 * k_weighted + rlb_z2[c];
+      rlb_z2[c] = rlb.b2 * y - rlb.a2 * k_weighted;
+      energy[c] += k_weighted * k_weighted;
+    }
+    if (++num_ticks_in_step_ == num_ticks_per_step_) {
+      FinishStep();
+    }
+  }
+  max_digital_peak_ = digital_peak;
+  if (measure_true_peak_) {
+    RETURN_IF_NOT_OK(true_peak_meter_.AccumulateSamples(rendered_samples));
+  }
+  return absl::OkStatus();
+}
+
+void LoudnessCalculatorItuRBs1770::FinishStep() {
+  double weighted_energy = 0.0;
+  for (int c = 0; c < num_channels_; ++c) {
+    weighted_energy += channel_weights_[c] * step_energy_[c];
+  }
+  std::fill(step_energy_.begin(), step_energy_.end(), 0.0);
+  num_ticks_in_step_ = 0;
+
+  recent_step_energies_[num_steps_ % kNumStepsPerBlock] = weighted_energy;
+  ++num_steps_;
+  if (num_steps_ < kNumStepsPerBlock) {
+    // The first gating block is not complete yet.
+    return;
+  }
+
+  double block_energy = 0.0;
+  for (const double step_energy : recent_step_energies_) {
+    block_energy += step_energy;
+  }
+  block_energy /= kNumStepsPerBlock * num_ticks_per_step_;
+  if (block_energy <= 0.0) {
+    return;
+  }
+  const double block_loudness = EnergyToLoudness(block_energy);
+  if (block_loudness <= kAbsoluteGate) {
+    return;
+  }
+  const int bin = std::min(
+      static_cast<int>((block_loudness - kAbsoluteGate) / kBinWidth),
+      kNumBins - 1);
+  ++histogram_counts_[bin];
+  histogram_energies_[bin] += block_energy;
+}
+
+absl::StatusOr<LoudnessInfo> LoudnessCalculatorItuRBs1770::QueryLoudness()
+    const {
+  // Blocks below the absolute gate were never added to the histogram.
+  int64_t num_blocks = 0;
+  double total_energy = 0.0;
+  for (int bin = 0; bin < kNumBins; ++bin) {
+    num_blocks += histogram_counts_[bin];
+    total_energy += histogram_energies_[bin];
+  }
+
+  double integrated_loudness = -HUGE_VAL;
+  if (num_blocks > 0) {
+    const double relative_gate =
+        EnergyToLoudness(total_energy / num_blocks) - 10.0;
+    // The relative gate is resolved to the width of one bin.
+    const int first_bin = std::clamp(
+        static_cast<int>((relative_gate - kAbsoluteGate) / kBinWidth), 0,
+        kNumBins - 1);
+    int64_t num_gated_blocks = 0;
+    double gated_energy = 0.0;
+    for (int bin = first_bin; bin < kNumBins; ++bin) {
+      num_gated_blocks += histogram_counts_[bin];
+      gated_energy += histogram_energies_[bin];
+    }
+    if (num_gated_blocks > 0) {
+      integrated_loudness = EnergyToLoudness(gated_energy / num_gated_blocks);
+    }
+  }
+
+  LoudnessInfo loudness = user_provided_loudness_;
+  RETURN_IF_NOT_OK(
+      DecibelsToQ7_8(integrated_loudness, loudness.integrated_loudness));
+  RETURN_IF_NOT_OK(DecibelsToQ7_8(20.0 * std::log10(max_digital_peak_),
+                                  loudness.digital_peak));
+  if (measure_true_peak_) {
+    RETURN_IF_NOT_OK(true_peak_meter_.QueryTruePeak(loudness.true_peak));
+  }
+  return loudness;
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_LOUDNESS_CALCULATOR_ITU_R_BS_1770_H_
+#define CLI_LOUDNESS_CALCULATOR_ITU_R_BS_1770_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "iamf/cli/loudness_calculator.h"
+#include "iamf/cli/true_peak_meter.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+
+/*!\brief Loudness calculator which measures loudness as in ITU-R BS.1770-4.
+ *
+ * Samples are measured in a single streaming pass:
+ *   - Each channel is K-weighted by two biquads. The filters of all channels
+ *     run in lockstep, so each stage is vectorized across channels.
+ *   - The weighted energy is summed in 100 ms steps. Each 400 ms gating block
+ *     is the sum of the last four steps, which gives the 75% overlap.
+ *   - The loudness of each block is binned in a histogram, which also holds
+ *     the total energy of the blocks in each bin. The absolute and relative
+ *     gates are applied to the histogram when loudness is queried.
+ *
+ * The memory used does not grow with the duration of the input.
+ *
+ * `digital_peak` is the highest absolute sample. `true_peak` is measured by a
+ * `TruePeakMeter` when `kTruePeak` is set in the `info_type` of the layout.
+ * Other fields of `LoudnessInfo` are echoed back from the layout.
+ */
+class LoudnessCalculatorItuRBs1770 : public LoudnessCalculatorBase {
+ public:
+  /*!\brief Creates a loudness calculator.
+   *
+   * \param layout Layout to measure loudness on.
+   * \param rendered_sample_rate Sample rate of the rendered audio.
+   * \return Unique pointer to a loudness calculator or `nullptr` if loudness
+   *     cannot be measured on the layout.
+   */
+  static std::unique_ptr<LoudnessCalculatorItuRBs1770> Create(
+      const MixPresentationLayout& layout, int32_t rendered_sample_rate);
+
+  /*!\brief Destructor. */
+  ~LoudnessCalculatorItuRBs1770() override = default;
+
+  /*!\brief Accumulates samples to be measured.
+   *
+   * \param rendered_samples Samples interleaved in IAMF canonical order to
+   *     measure loudness on.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     the samples do not hold a whole number of ticks.
+   */
+  absl::Status AccumulateLoudnessForSamples(
+      const std::vector<int32_t>& rendered_samples) override;
+
+  /*!\brief Outputs the measured loudness.
+   *
+   * Loudness and peaks below the range of Q7.8, including those of silence,
+   * are clamped to -128 dB.
+   *
+   * \return Measured loudness on success. A specific status on failure.
+   */
+  absl::StatusOr<LoudnessInfo> QueryLoudness() const override;
+
+ private:
+  // Width of the histogram bins, in LU.
+  static constexpr double kBinWidth = 0.01;
+  // Blocks below the absolute gate are discarded. Blocks above the last bin
+  // are counted in it.
+  static constexpr double kAbsoluteGate = -70.0;
+  static constexpr int kNumBins = 10000;
+  // Number of 100 ms steps in each 400 ms gating block.
+  static constexpr int kNumStepsPerBlock = 4;
+
+  /*!\brief Coefficients of a biquad, normalized so `a0` is 1. */
+  struct Biquad {
+    double b0, b1, b2, a1, a2;
+  };
+
+  /*!\brief Constructor. */
+  LoudnessCalculatorItuRBs1770(const LoudnessInfo& user_provided_loudness,
+                               int32_t rendered_sample_rate,
+                               const std::vector<double>& channel_weights);
+
+  /*!\brief Ends a 100 ms step and adds the gating block ending with it. */
+  void FinishStep();
+
+  const LoudnessInfo user_provided_loudness_;
+  const bool measure_true_peak_;
+  const int num_channels_;
+  const std::vector<double> channel_weights_;
+  const int num_ticks_per_step_;
+  const Biquad pre_filter_;
+  const Biquad rlb_filter_;
+
+  // State of the biquads in transposed direct form II, one entry per channel.
+  std::vector<double> pre_filter_z1_;
+  std::vector<double> pre_filter_z2_;
+  std::vector<double> rlb_filter_z1_;
+  std::vector<double> rlb_filter_z2_;
+
+  // Energy of each channel in the current step.
+  std::vector<double> step_energy_;
+  int num_ticks_in_step_ = 0;
+  // Weighted energy of the last four steps, summed over the channels.
+  std::array<double, kNumStepsPerBlock> recent_step_energies_ = {};
+  int num_steps_ = 0;
+
+  // Number of gating blocks and their total mean-square energy in each bin.
+  std::vector<int64_t> histogram_counts_;
+  std::vector<double> histogram_energies_;
+
+  TruePeakMeter true_peak_meter_;
+  double max_digital_peak_ = 0.0;
+};
+
+}  // namespace iamf_tools
+
+#endif  // CLI_LOUDNESS_CALCULATOR_ITU_R_BS_1770_H_
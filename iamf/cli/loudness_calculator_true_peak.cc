@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/loudness_calculator_true_peak.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "iamf/cli/loudness_calculator.h"
+#include "iamf/common/macros.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+
+LoudnessCalculatorTruePeak::LoudnessCalculatorTruePeak(
+    int num_channels,
+    std::unique_ptr<LoudnessCalculatorBase> wrapped_calculator)
+    : wrapped_calculator_(std::move(wrapped_calculator)),
+      true_peak_meter_(num_channels) {
+  CHECK(wrapped_calculator_ != nullptr);
+}
+
+absl::Status LoudnessCalculatorTruePeak::AccumulateLoudnessForSamples(
+    const std::vector<int32_t>& rendered_samples) {
+  RETURN_IF_NOT_OK(true_peak_meter_.AccumulateSamples(rendered_samples));
+  return wrapped_calculator_->AccumulateLoudnessForSamples(rendered_samples);
+}
+
+absl::StatusOr<LoudnessInfo> LoudnessCalculatorTruePeak::QueryLoudness()
+    const {
+  auto loudness = wrapped_calculator_->QueryLoudness();
+  if (!loudness.ok()) {
+    return loudness.status();
+  }
+  if (loudness->info_type & LoudnessInfo::kTruePeak) {
+    RETURN_IF_NOT_OK(true_peak_meter_.QueryTruePeak(loudness->true_peak));
+  }
+  return loudness;
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_LOUDNESS_CALCULATOR_TRUE_PEAK_H_
+#define CLI_LOUDNESS_CALCULATOR_TRUE_PEAK_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "iamf/cli/loudness_calculator.h"
+#include "iamf/cli/true_peak_meter.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+
+/*!\brief Loudness calculator which adds the true peak to another calculator.
+ *
+ * Samples are forwarded to the wrapped calculator and to a `TruePeakMeter`.
+ * When `kTruePeak` is set in the `info_type` output by the wrapped calculator,
+ * its `true_peak` is replaced by the measured one. Any loudness calculator
+ * factory can wrap the calculators it creates to measure the true peak.
+ */
+class LoudnessCalculatorTruePeak : public LoudnessCalculatorBase {
+ public:
+  /*!\brief Constructor.
+   *
+   * \param num_channels Number of channels of the rendered samples.
+   * \param wrapped_calculator Calculator to measure the other fields with.
+   *     Must not be `nullptr`.
+   */
+  LoudnessCalculatorTruePeak(
+      int num_channels,
+      std::unique_ptr<LoudnessCalculatorBase> wrapped_calculator);
+
+  /*!\brief Destructor. */
+  ~LoudnessCalculatorTruePeak() override = default;
+
+  /*!\brief Accumulates samples to be measured.
+   *
+   * \param rendered_samples Samples interleaved in IAMF canonical order to
+   *     measure loudness on.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status AccumulateLoudnessForSamples(
+      const std::vector<int32_t>& rendered_samples) override;
+
+  /*!\brief Outputs the measured loudness.
+   *
+   * \return Measured loudness on success. A specific status on failure.
+   */
+  absl::StatusOr<LoudnessInfo> QueryLoudness() const override;
+
+ private:
+  const std::unique_ptr<LoudnessCalculatorBase> wrapped_calculator_;
+  TruePeakMeter true_peak_meter_;
+};
+
+}  // namespace iamf_tools
+
+#endif  // CLI_LOUDNESS_CALCULATOR_TRUE_PEAK_H_
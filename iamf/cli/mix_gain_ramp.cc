@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/mix_gain_ramp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "iamf/cli/parameter_block_with_data.h"
+#include "iamf/common/macros.h"
+#include "iamf/common/obu_util.h"
+#include "iamf/obu/param_definitions.h"
+#include "iamf/obu/parameter_block.h"
+
+namespace iamf_tools {
+
+namespace {
+
+// `10^(x / 20) = 2^(x * kLog2Of10Over20)`.
+constexpr float kLog2Of10Over20 = 0.166096404744368f;
+
+void ExpandBezier(const AnimationBezierInt16& bezier, int32_t n_2,
+                  float* mix_gains_db) {
+  // Using the definition of `round` in the IAMF spec.
+  const int n_1 = std::floor(
+      (n_2 * Q0_8ToFloat(bezier.control_point_relative_time)) + 0.5);
+  const float p_0 = Q7_8ToFloat(bezier.start_point_value);
+  const float p_1 = Q7_8ToFloat(bezier.control_point_value);
+  const float p_2 = Q7_8ToFloat(bezier.end_point_value);
+
+  // Solve `alpha * a^2 + beta * a - n = 0` for each tick `n`, then evaluate
+  // the quadratic Bezier curve at `a`.
+  const float alpha = n_2 - 2 * n_1;
+  const float beta = 2 * n_1;
+  if (alpha == 0) {
+    const float inverse_beta = 1.0f / beta;
+    for (int32_t n = 0; n < n_2; ++n) {
+      const float a = n * inverse_beta;
+      mix_gains_db[n] =
+          (1 - a) * (1 - a) * p_0 + 2 * (1 - a) * a * p_1 + a * a * p_2;
+    }
+  } else {
+    const float beta_squared = beta * beta;
+    const float four_alpha = 4 * alpha;
+    const float inverse_two_alpha = 1.0f / (2 * alpha);
+    for (int32_t n = 0; n < n_2; ++n) {
+      const float a = (-beta + std::sqrt(beta_squared + four_alpha * n)) *
+                      inverse_two_alpha;
+      mix_gains_db[n] =
+          (1 - a) * (1 - a) * p_0 + 2 * (1 - a) * a * p_1 + a * a * p_2;
+    }
+  }
+}
+
+}  // namespace
+
+absl::Status ExpandMixGainParameterData(
+    const MixGainParameterData& mix_gain_parameter_data,
+    int32_t subblock_duration, std::vector<float>& mix_gains_db) {
+  // TODO(b/283281856): Support resampling parameter blocks.
+  mix_gains_db.resize(subblock_duration);
+  const auto& param_data = mix_gain_parameter_data.param_data;
+  switch (mix_gain_parameter_data.animation_type) {
+    using enum MixGainParameterData::AnimationType;
+    case kAnimateStep:
+      if (const auto* step = std::get_if<AnimationStepInt16>(&param_data)) {
+        std::fill(mix_gains_db.begin(), mix_gains_db.end(),
+                  Q7_8ToFloat(step->start_point_value));
+        return absl::OkStatus();
+      }
+      break;
+    case kAnimateLinear:
+      if (const auto* linear = std::get_if<AnimationLinearInt16>(&param_data)) {
+        const float p_0 = Q7_8ToFloat(linear->start_point_value);
+        const float slope =
+            (Q7_8ToFloat(linear->end_point_value) - p_0) / subblock_duration;
+        for (int32_t n = 0; n < subblock_duration; ++n) {
+          mix_gains_db[n] = p_0 + n * slope;
+        }
+        return absl::OkStatus();
+      }
+      break;
+    case kAnimateBezier:
+      if (const auto* bezier = std::get_if<AnimationBezierInt16>(&param_data)) {
+        ExpandBezier(*bezier, subblock_duration, mix_gains_db.data());
+        return absl::OkStatus();
+      }
+      break;
+    default:
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Unknown animation_type = ", mix_gain_parameter_data.animation_type));
+  }
+  return absl::InvalidArgumentError(
+      absl::StrCat("Mix gain data does not match animation_type = ",
+                   mix_gain_parameter_data.animation_type));
+}
+
+MixGainRamp::MixGainRamp(const MixGainParamDefinition& param_definition)
+    : parameter_id_(param_definition.parameter_id_),
+      default_linear_gain_(std::exp2(
+          Q7_8ToFloat(param_definition.default_mix_gain_) * kLog2Of10Over20)) {}
+
+absl::Status MixGainRamp::AddParameterBlock(
+    const ParameterBlockWithData& parameter_block) {
+  const auto& obu = *parameter_block.obu;
+  if (obu.parameter_id_ != parameter_id_) {
+    return absl::OkStatus();
+  }
+  if (!segments_.empty() &&
+      parameter_block.start_timestamp <
+          segments_.back().start_timestamp +
+              static_cast<int32_t>(segments_.back().linear_gains.size())) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Parameter blocks must not overlap. parameter_id= ", parameter_id_,
+        " start_timestamp= ", parameter_block.start_timestamp));
+  }
+
+  Segment segment = {.start_timestamp = parameter_block.start_timestamp};
+  for (int i = 0; i < obu.GetNumSubblocks(); ++i) {
+    const auto subblock_duration = obu.GetSubblockDuration(i);
+    RETURN_IF_NOT_OK(subblock_duration.status());
+    const auto* mix_gain_parameter_data =
+        std::get_if<MixGainParameterData>(&obu.subblocks_[i].param_data);
+    if (mix_gain_parameter_data == nullptr) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected mix gain data in parameter_id= ", parameter_id_));
+    }
+    RETURN_IF_NOT_OK(ExpandMixGainParameterData(
+        *mix_gain_parameter_data, *subblock_duration, subblock_gains_db_));
+
+    // Convert the whole subblock to linear gains in one pass.
+    const size_t offset = segment.linear_gains.size();
+    segment.linear_gains.resize(offset + subblock_gains_db_.size());
+    float* linear_gains = segment.linear_gains.data() + offset;
+    for (size_t n = 0; n < subblock_gains_db_.size(); ++n) {
+      linear_gains[n] = std::exp2(subblock_gains_db_[n] * kLog2Of10Over20);
+    }
+  }
+  segments_.push_back(std::move(segment));
+  return absl::OkStatus();
+}
+
+void MixGainRamp::GetLinearGains(int32_t start_timestamp,
+                                 absl::Span<float> linear_gains) {
+  const auto segment_end = [](const Segment& segment) {
+    return segment.start_timestamp +
+           static_cast<int32_t>(segment.linear_gains.size());
+  };
+  while (!segments_.empty() &&
+         segment_end(segments_.front()) <= start_timestamp) {
+    segments_.pop_front();
+  }
+
+  const int32_t end_timestamp =
+      start_timestamp + static_cast<int32_t>(linear_gains.size());
+  int32_t timestamp = start_timestamp;
+  for (const auto& segment : segments_) {
+    if (timestamp >= end_timestamp) {
+      break;
+    }
+    // Fill the gap before the segment with the default gain, then copy the
+    // overlapping gains.
+    const int32_t gap_end = std::min(segment.start_timestamp, end_timestamp);
+    if (timestamp < gap_end) {
+      std::fill(linear_gains.begin() + (timestamp - start_timestamp),
+                linear_gains.begin() + (gap_end - start_timestamp),
+                default_linear_gain_);
+      timestamp = gap_end;
+    }
+    const int32_t copy_end = std::min(segment_end(segment), end_timestamp);
+    if (timestamp < copy_end) {
+      std::copy(segment.linear_gains.begin() +
+                    (timestamp - segment.start_timestamp),
+                segment.linear_gains.begin() +
+                    (copy_end - segment.start_timestamp),
+                linear_gains.begin() + (timestamp - start_timestamp));
+      timestamp = copy_end;
+    }
+  }
+  std::fill(linear_gains.begin() + (timestamp - start_timestamp),
+            linear_gains.end(), default_linear_gain_);
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_MIX_GAIN_RAMP_H_
+#define CLI_MIX_GAIN_RAMP_H_
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "iamf/cli/parameter_block_with_data.h"
+#include "iamf/obu/leb128.h"
+#include "iamf/obu/param_definitions.h"
+#include "iamf/obu/parameter_block.h"
+
+namespace iamf_tools {
+
+/*!\brief Expands the animated mix gain of a subblock to one value per tick.
+ *
+ * Evaluates the same curves as `InterpolateMixGainValue()`, without rounding
+ * to Q7.8. Each animation is a single loop over consecutive ticks with its
+ * coefficients hoisted out, which the compiler vectorizes.
+ *
+ * \param mix_gain_parameter_data Mix gain of the subblock.
+ * \param subblock_duration Duration of the subblock.
+ * \param mix_gains_db Output argument with one gain in dB per tick of the
+ *     subblock. Resized to `subblock_duration`.
+ * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+ *     the animation type is unknown or does not match the data.
+ */
+absl::Status ExpandMixGainParameterData(
+    const MixGainParameterData& mix_gain_parameter_data,
+    int32_t subblock_duration, std::vector<float>& mix_gains_db);
+
+/*!\brief Dense linear gains of one mix gain parameter over time.
+ *
+ * Each parameter block is expanded to one linear gain per tick when it is
+ * added. The expanded gains are kept until a later query has passed them, so
+ * blocks spanning several frames are only evaluated once. Ticks which are not
+ * covered by any parameter block have the default mix gain of the parameter
+ * definition.
+ *
+ * Parameter blocks must be added in order, before the ticks they cover are
+ * queried. Queries must be in order.
+ */
+class MixGainRamp {
+ public:
+  /*!\brief Constructor.
+   *
+   * \param param_definition Parameter definition of the mix gain.
+   */
+  explicit MixGainRamp(const MixGainParamDefinition& param_definition);
+
+  /*!\brief Expands and caches a parameter block.
+   *
+   * \param parameter_block Parameter block to add. Blocks of other parameter
+   *     IDs are ignored.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     the block overlaps a previous block or holds other data than mix
+   *     gains. A specific status on other failures.
+   */
+  absl::Status AddParameterBlock(const ParameterBlockWithData& parameter_block);
+
+  /*!\brief Gets the linear gains of consecutive ticks.
+   *
+   * Cached gains before `start_timestamp` are discarded.
+   *
+   * \param start_timestamp Timestamp of the first tick.
+   * \param linear_gains Output argument with one linear gain per tick. Its
+   *     size is the number of ticks to get.
+   */
+  void GetLinearGains(int32_t start_timestamp, absl::Span<float> linear_gains);
+
+  /*!\brief Gets the parameter ID of the mix gain.
+   *
+   * \return Parameter ID of the mix gain.
+   */
+  DecodedUleb128 GetParameterId() const { return parameter_id_; }
+
+ private:
+  /*!\brief Linear gains of a parameter block. */
+  struct Segment {
+    int32_t start_timestamp;
+    std::vector<float> linear_gains;
+  };
+
+  const DecodedUleb128 parameter_id_;
+  const float default_linear_gain_;
+
+  // Expanded parameter blocks, in order.
+  std::deque<Segment> segments_;
+
+  // Scratch buffer, kept to avoid reallocating it for every subblock.
+  std::vector<float> subblock_gains_db_;
+};
+
+}  // namespace iamf_tools
+
+#endif  // CLI_MIX_GAIN_RAMP_H_
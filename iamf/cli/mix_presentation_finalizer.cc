@@ -11,41 +11,575 @@
  */
 #include "iamf/cli/mix_presentation_finalizer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <limits>
 #include <list>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "iamf/cli/audio_element_with_data.h"
 #include "iamf/cli/demixing_module.h"
+#include "iamf/cli/loudness_calculator.h"
+#include "iamf/cli/loudness_calculator_factory.h"
+#include "iamf/cli/mix_gain_ramp.h"
 #include "iamf/cli/parameter_block_with_data.h"
 #include "iamf/cli/proto/mix_presentation.pb.h"
+#include "iamf/cli/renderer/audio_element_renderer_base.h"
+#include "iamf/cli/renderer_factory.h"
+#include "iamf/cli/wav_writer.h"
+#include "iamf/common/macros.h"
+#include "iamf/common/pcm_conversion.h"
 #include "iamf/obu/mix_presentation.h"
 
 namespace iamf_tools {
 
+namespace {
+
+// Gets the sample rate and bit-depth to render the sub-mix at. All audio
+// elements in the sub-mix must share the same output sample rate.
+absl::Status GetSubMixFormat(
+    const absl::flat_hash_map<uint32_t, AudioElementWithData>& audio_elements,
+    const MixPresentationSubMix& sub_mix, uint32_t& sample_rate,
+    uint32_t& bit_depth) {
+  if (sub_mix.audio_elements.empty()) {
+    return absl::InvalidArgumentError("Sub-mixes must have audio elements.");
+  }
+  for (int i = 0; i < sub_mix.audio_elements.size(); ++i) {
+    const auto audio_element_id = sub_mix.audio_elements[i].audio_element_id;
+    const auto audio_element_iter = audio_elements.find(audio_element_id);
+    if (audio_element_iter == audio_elements.end()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Audio element not found. ID= ", audio_element_id));
+    }
+    const auto* codec_config = audio_element_iter->second.codec_config;
+    if (i == 0) {
+      sample_rate = codec_config->GetOutputSampleRate();
+      bit_depth = codec_config->GetBitDepthToMeasureLoudness();
+    } else if (codec_config->GetOutputSampleRate() != sample_rate) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Audio elements in a sub-mix must have the same sample rate. Got ",
+          sample_rate, " and ", codec_config->GetOutputSampleRate()));
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Gets the start timestamps of every frame, in order.
+std::vector<int32_t> GetStartTimestamps(
+    const IdTimeLabeledFrameMap& id_to_time_to_labeled_frame) {
+  std::vector<int32_t> start_timestamps;
+  for (const auto& [unused_id, time_to_labeled_frame] :
+       id_to_time_to_labeled_frame) {
+    for (const auto& [start_timestamp, unused_labeled_frame] :
+         time_to_labeled_frame) {
+      start_timestamps.push_back(start_timestamp);
+    }
+  }
+  std::sort(start_timestamps.begin(), start_timestamps.end());
+  start_timestamps.erase(
+      std::unique(start_timestamps.begin(), start_timestamps.end()),
+      start_timestamps.end());
+  return start_timestamps;
+}
+
+}  // namespace
+
+MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::
+    MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer(
+        const std::filesystem::path& file_name_prefix,
+        std::unique_ptr<RendererFactoryBase> renderer_factory,
+        std::unique_ptr<LoudnessCalculatorFactoryBase>
+            loudness_calculator_factory,
+        int num_threads,
+        std::optional<uint8_t> output_wav_file_bit_depth_override,
+        bool validate_loudness)
+    : MixPresentationFinalizerBase(),
+      file_name_prefix_(file_name_prefix),
+      renderer_factory_(std::move(renderer_factory)),
+      loudness_calculator_factory_(std::move(loudness_calculator_factory)),
+      num_threads_(num_threads > 0
+                       ? num_threads
+                       : std::max(1u, std::thread::hardware_concurrency())),
+      output_wav_file_bit_depth_override_(output_wav_file_bit_depth_override),
+      validate_loudness_(validate_loudness) {}
+
+MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::
+    ~MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer() {
+  StopWorkers();
+}
+
 absl::Status
 MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::Finalize(
-    const absl::flat_hash_map<uint32_t, AudioElementWithData>&,
-    const IdTimeLabeledFrameMap&, const std::list<ParameterBlockWithData>&,
-    const WavWriterFactory&,
+    const absl::flat_hash_map<uint32_t, AudioElementWithData>& audio_elements,
+    const IdTimeLabeledFrameMap& id_to_time_to_labeled_frame,
+    const std::list<ParameterBlockWithData>& parameter_blocks,
+    const WavWriterFactory& wav_writer_factory,
     std::list<MixPresentationObu>& mix_presentation_obus) {
+  RETURN_IF_NOT_OK(
+      Initialize(audio_elements, wav_writer_factory, mix_presentation_obus));
+  if (!tasks_.empty()) {
+    // Regroup the frames by temporal unit. Parameter blocks are cached until
+    // the ticks they cover are mixed, so they are all pushed with the first
+    // temporal unit.
+    const std::list<ParameterBlockWithData> no_parameter_blocks;
+    bool is_first_temporal_unit = true;
+    for (const auto start_timestamp :
+         GetStartTimestamps(id_to_time_to_labeled_frame)) {
+      IdLabeledFrameMap id_to_labeled_frame;
+      for (const auto& [audio_element_id, time_to_labeled_frame] :
+           id_to_time_to_labeled_frame) {
+        const auto labeled_frame_iter =
+            time_to_labeled_frame.find(start_timestamp);
+        if (labeled_frame_iter != time_to_labeled_frame.end()) {
+          id_to_labeled_frame[audio_element_id] = labeled_frame_iter->second;
+        }
+      }
+      RETURN_IF_NOT_OK(PushTemporalUnit(
+          id_to_labeled_frame, start_timestamp,
+          is_first_temporal_unit ? parameter_blocks : no_parameter_blocks));
+      is_first_temporal_unit = false;
+    }
+  }
+  return FinalizePushingTemporalUnits(mix_presentation_obus);
+}
+
+absl::Status
+MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::Initialize(
+    const absl::flat_hash_map<uint32_t, AudioElementWithData>& audio_elements,
+    const WavWriterFactory& wav_writer_factory,
+    const std::list<MixPresentationObu>& mix_presentation_obus) {
+  StopWorkers();
+  tasks_.clear();
+  shared_renderers_.clear();
+  if (renderer_factory_ == nullptr) {
+    return absl::OkStatus();
+  }
+
+  // Gets a live renderer with the same key or creates one.
+  const auto get_shared_renderer =
+      [&](const SubMixAudioElement& sub_mix_audio_element,
+          const Layout& layout) -> std::shared_ptr<SharedRenderer> {
+    for (const auto& weak_shared_renderer : shared_renderers_) {
+      auto shared_renderer = weak_shared_renderer.lock();
+      if (shared_renderer != nullptr &&
+          shared_renderer->audio_element_id ==
+              sub_mix_audio_element.audio_element_id &&
+          shared_renderer->rendering_config ==
+              sub_mix_audio_element.rendering_config &&
+          shared_renderer->layout == layout) {
+        return shared_renderer;
+      }
+    }
+    const auto& audio_element =
+        audio_elements.at(sub_mix_audio_element.audio_element_id);
+    auto renderer = renderer_factory_->CreateRendererForLayout(
+        audio_element.obu.audio_substream_ids_,
+        audio_element.substream_id_to_labels,
+        audio_element.obu.GetAudioElementType(), audio_element.obu.config_,
+        layout);
+    if (renderer == nullptr) {
+      return nullptr;
+    }
+    auto shared_renderer = std::make_shared<SharedRenderer>(SharedRenderer{
+        .audio_element_id = sub_mix_audio_element.audio_element_id,
+        .rendering_config = sub_mix_audio_element.rendering_config,
+        .layout = layout,
+        .renderer = std::move(renderer)});
+    shared_renderers_.push_back(shared_renderer);
+    return shared_renderer;
+  };
+
+  // Plan a task for each layout which can be rendered. The wav writer factory
+  // is only called from this thread, in the order of the layouts.
+  int m = 0;
+  for (const auto& mix_presentation_obu : mix_presentation_obus) {
+    const auto& sub_mixes = mix_presentation_obu.sub_mixes_;
+    for (int s = 0; s < sub_mixes.size(); ++s) {
+      const auto& sub_mix = sub_mixes[s];
+      uint32_t sample_rate;
+      uint32_t bit_depth;
+      RETURN_IF_NOT_OK(
+          GetSubMixFormat(audio_elements, sub_mix, sample_rate, bit_depth));
+      for (int l = 0; l < sub_mix.layouts.size(); ++l) {
+        const auto& layout = sub_mix.layouts[l];
+        RETURN_IF_NOT_OK(renderer_factory_->ValidateSampleRate(
+            layout.loudness_layout, sample_rate));
+        LayoutTask task = {
+            .mix_presentation_index = m,
+            .sub_mix_index = s,
+            .layout_index = l,
+            .output_gain_ramp = MixGainRamp(sub_mix.output_mix_gain)};
+        bool can_render = MixPresentationObu::GetNumChannelsFromLayout(
+                              layout.loudness_layout, task.num_channels)
+                              .ok();
+        for (const auto& sub_mix_audio_element : sub_mix.audio_elements) {
+          if (!can_render) {
+            break;
+          }
+          auto shared_renderer = get_shared_renderer(sub_mix_audio_element,
+                                                     layout.loudness_layout);
+          can_render = shared_renderer != nullptr;
+          task.renderers.push_back(std::move(shared_renderer));
+          task.element_gain_ramps.emplace_back(
+              sub_mix_audio_element.element_mix_gain);
+        }
+        if (!can_render) {
+          LOG(WARNING) << "Unable to render layout " << l << " of sub-mix "
+                       << s << ". Echoing the user provided loudness.";
+          continue;
+        }
+        task.pending_samples.resize(task.renderers.size());
+        task.wav_writer = wav_writer_factory(
+            mix_presentation_obu.GetMixPresentationId(), s, l,
+            layout.loudness_layout, file_name_prefix_, task.num_channels,
+            sample_rate,
+            output_wav_file_bit_depth_override_.value_or(bit_depth));
+        if (loudness_calculator_factory_ != nullptr) {
+          task.loudness_calculator =
+              loudness_calculator_factory_->CreateLoudnessCalculator(
+                  layout, sample_rate, bit_depth);
+        } else {
+          task.loudness_calculator =
+              std::make_unique<LoudnessCalculatorUserProvidedLoudness>(
+                  layout.loudness);
+        }
+        tasks_.push_back(std::move(task));
+      }
+    }
+    ++m;
+  }
+
+  // The calling thread runs jobs too, so one fewer worker is needed.
+  const size_t max_num_jobs = std::max(tasks_.size(), shared_renderers_.size());
+  StartWorkers(std::min(num_threads_, static_cast<int>(max_num_jobs)) - 1);
+  return absl::OkStatus();
+}
+
+absl::Status MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::
+    PushTemporalUnit(
+        const IdLabeledFrameMap& id_to_labeled_frame, int32_t start_timestamp,
+        const std::list<ParameterBlockWithData>& parameter_blocks) {
+  // Render each audio element once for every layout which shares it.
+  RETURN_IF_NOT_OK(RunRenderers([&](SharedRenderer& shared_renderer) {
+    shared_renderer.num_ticks_rendered = 0;
+    shared_renderer.rendered_samples.clear();
+    const auto labeled_frame_iter =
+        id_to_labeled_frame.find(shared_renderer.audio_element_id);
+    if (labeled_frame_iter != id_to_labeled_frame.end()) {
+      const auto num_ticks = shared_renderer.renderer->RenderLabeledFrame(
+          labeled_frame_iter->second);
+      RETURN_IF_NOT_OK(num_ticks.status());
+      shared_renderer.num_ticks_rendered = *num_ticks;
+    }
+    return shared_renderer.renderer->Flush(shared_renderer.rendered_samples);
+  }));
+
+  return RunTasks([&](LayoutTask& task) {
+    for (const auto& parameter_block : parameter_blocks) {
+      for (auto& element_gain_ramp : task.element_gain_ramps) {
+        RETURN_IF_NOT_OK(element_gain_ramp.AddParameterBlock(parameter_block));
+      }
+      RETURN_IF_NOT_OK(
+          task.output_gain_ramp.AddParameterBlock(parameter_block));
+    }
+
+    size_t num_samples_to_mix = std::numeric_limits<size_t>::max();
+    for (int i = 0; i < task.renderers.size(); ++i) {
+      const auto& shared_renderer = *task.renderers[i];
+      // Renderers drop the trimmed samples, so the first rendered tick
+      // follows those trimmed at the start.
+      if (!task.next_timestamp.has_value() &&
+          shared_renderer.num_ticks_rendered > 0) {
+        task.next_timestamp =
+            start_timestamp +
+            id_to_labeled_frame.at(shared_renderer.audio_element_id)
+                .samples_to_trim_at_start;
+      }
+      auto& pending_samples = task.pending_samples[i];
+      pending_samples.insert(pending_samples.end(),
+                             shared_renderer.rendered_samples.begin(),
+                             shared_renderer.rendered_samples.end());
+      num_samples_to_mix = std::min(num_samples_to_mix, pending_samples.size());
+    }
+    // Renderers may lag behind, so only mix whole ticks which every audio
+    // element has finished.
+    return MixAndOutput(
+        num_samples_to_mix - num_samples_to_mix % task.num_channels, task);
+  });
+}
+
+absl::Status MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::
+    FinalizePushingTemporalUnits(
+        std::list<MixPresentationObu>& mix_presentation_obus) {
   LOG(INFO) << "Calling "
                "MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer"
-               "::Finalize():";
+               "::FinalizePushingTemporalUnits():";
   LOG(INFO) << "  Loudness information may be copied from user "
             << "provided values.";
 
-  // TODO(b/332567539): Use `RendererFactory` to render certain layouts.
-  // TODO(b/302273947): Once layouts are rendered and mixed then use a
-  //                    `LoudnessCalculatorFactory` to measure loudness.
+  RETURN_IF_NOT_OK(RunRenderers([](SharedRenderer& shared_renderer) {
+    shared_renderer.num_ticks_rendered = 0;
+    shared_renderer.rendered_samples.clear();
+    RETURN_IF_NOT_OK(shared_renderer.renderer->Finalize());
+    shared_renderer.renderer->WaitUntilFinalized();
+    return shared_renderer.renderer->Flush(shared_renderer.rendered_samples);
+  }));
+
+  RETURN_IF_NOT_OK(RunTasks([](LayoutTask& task) {
+    size_t num_remaining_samples = 0;
+    for (int i = 0; i < task.renderers.size(); ++i) {
+      const auto& rendered_samples = task.renderers[i]->rendered_samples;
+      auto& pending_samples = task.pending_samples[i];
+      pending_samples.insert(pending_samples.end(), rendered_samples.begin(),
+                             rendered_samples.end());
+      num_remaining_samples =
+          std::max(num_remaining_samples, pending_samples.size());
+    }
+    if (num_remaining_samples % task.num_channels != 0) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected a multiple of ", task.num_channels,
+          " rendered samples. Got ", num_remaining_samples, "."));
+    }
+    RETURN_IF_NOT_OK(MixAndOutput(num_remaining_samples, task));
+    // Close the file as soon as it is complete.
+    task.wav_writer.reset();
+    return absl::OkStatus();
+  }));
+  StopWorkers();
+
+  // Update the OBUs in the order of the layouts.
+  std::vector<MixPresentationObu*> indexed_mix_presentation_obus;
+  for (auto& mix_presentation_obu : mix_presentation_obus) {
+    indexed_mix_presentation_obus.push_back(&mix_presentation_obu);
+  }
+  bool loudness_matches_user_data = true;
+  for (const auto& task : tasks_) {
+    const auto loudness = task.loudness_calculator->QueryLoudness();
+    RETURN_IF_NOT_OK(loudness.status());
+    auto& mix_presentation_obu =
+        *indexed_mix_presentation_obus[task.mix_presentation_index];
+    auto& user_loudness = mix_presentation_obu.sub_mixes_[task.sub_mix_index]
+                              .layouts[task.layout_index]
+                              .loudness;
+    if (*loudness != user_loudness) {
+      LOG(WARNING) << "Computed loudness of layout " << task.layout_index
+                   << " of sub-mix " << task.sub_mix_index
+                   << " of mix presentation "
+                   << mix_presentation_obu.GetMixPresentationId()
+                   << " does not match the user provided loudness: "
+                   << "integrated_loudness= " << loudness->integrated_loudness
+                   << " vs " << user_loudness.integrated_loudness
+                   << ", digital_peak= " << loudness->digital_peak << " vs "
+                   << user_loudness.digital_peak
+                   << ", true_peak= " << loudness->true_peak << " vs "
+                   << user_loudness.true_peak << ".";
+      loudness_matches_user_data = false;
+    }
+    user_loudness = *loudness;
+  }
+  // Dropping the tasks releases the renderers.
+  tasks_.clear();
+  shared_renderers_.clear();
 
   // Examine Mix Presentation OBUs.
   for (const auto& mix_presentation_obu : mix_presentation_obus) {
     mix_presentation_obu.PrintObu();
   }
+  if (validate_loudness_ && !loudness_matches_user_data) {
+    return absl::InvalidArgumentError(
+        "Computed loudness does not match the user provided loudness.");
+  }
+  return absl::OkStatus();
+}
+
+absl::Status
+MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::MixAndOutput(
+    size_t num_samples, LayoutTask& task) {
+  if (num_samples == 0) {
+    return absl::OkStatus();
+  }
+
+  // Every channel of a tick shares the gain of the tick.
+  const size_t num_channels = task.num_channels;
+  const size_t num_ticks = num_samples / num_channels;
+  const int32_t start_timestamp = task.next_timestamp.value_or(0);
+  task.tick_gains.resize(num_ticks);
+  task.mixed_samples.assign(num_samples, 0.0);
+  for (int i = 0; i < task.pending_samples.size(); ++i) {
+    auto& pending_samples = task.pending_samples[i];
+    const size_t num_available = std::min(num_samples, pending_samples.size());
+    task.element_gain_ramps[i].GetLinearGains(start_timestamp,
+                                              absl::MakeSpan(task.tick_gains));
+    for (size_t t = 0, j = 0; j < num_available; ++t) {
+      const double element_gain = task.tick_gains[t];
+      for (const size_t tick_end = std::min(j + num_channels, num_available);
+           j < tick_end; ++j) {
+        task.mixed_samples[j] += element_gain * pending_samples[j];
+      }
+    }
+    pending_samples.erase(pending_samples.begin(),
+                          pending_samples.begin() + num_available);
+  }
+
+  task.output_gain_ramp.GetLinearGains(start_timestamp,
+                                       absl::MakeSpan(task.tick_gains));
+  task.output_samples.resize(num_samples);
+  for (size_t t = 0, j = 0; t < num_ticks; ++t) {
+    const double output_gain = task.tick_gains[t];
+    for (size_t c = 0; c < num_channels; ++c, ++j) {
+      task.output_samples[j] = static_cast<int32_t>(std::clamp(
+          std::round(output_gain * task.mixed_samples[j]),
+          static_cast<double>(std::numeric_limits<int32_t>::min()),
+          static_cast<double>(std::numeric_limits<int32_t>::max())));
+    }
+  }
+  task.next_timestamp = start_timestamp + static_cast<int32_t>(num_ticks);
+
+  if (task.wav_writer != nullptr) {
+    const int wav_bit_depth = task.wav_writer->bit_depth();
+    const auto pack_pcm_samples =
+        GetPcmPacker(wav_bit_depth, /*big_endian=*/false);
+    RETURN_IF_NOT_OK(pack_pcm_samples.status());
+    task.wav_buffer.resize(num_samples * wav_bit_depth / 8);
+    (*pack_pcm_samples)(absl::MakeConstSpan(task.output_samples),
+                        task.wav_buffer.data());
+    if (!task.wav_writer->WriteSamples(task.wav_buffer)) {
+      return absl::UnknownError("Failed to write rendered samples.");
+    }
+  }
+  return task.loudness_calculator->AccumulateLoudnessForSamples(
+      task.output_samples);
+}
+
+void MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::
+    StartWorkers(int num_workers) {
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    shutting_down_ = false;
+  }
+  for (int i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(
+        &MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::
+            WorkerLoop,
+        this);
+  }
+}
+
+void MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::
+    StopWorkers() {
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    shutting_down_ = true;
+    job_available_.SignalAll();
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::
+    WorkerLoop() {
+  while (true) {
+    {
+      absl::MutexLock lock(&pool_mutex_);
+      while (next_job_ == num_jobs_ && !shutting_down_) {
+        job_available_.Wait(&pool_mutex_);
+      }
+      if (shutting_down_) {
+        return;
+      }
+    }
+    RunNextJob();
+  }
+}
+
+bool MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::
+    RunNextJob() {
+  size_t job;
+  const absl::FunctionRef<absl::Status(size_t)>* run_job;
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    if (next_job_ == num_jobs_) {
+      return false;
+    }
+    job = next_job_++;
+    run_job = run_job_;
+  }
+
+  absl::Status status = (*run_job)(job);
+
+  absl::MutexLock lock(&pool_mutex_);
+  job_statuses_[job] = std::move(status);
+  if (++num_finished_jobs_ == num_jobs_) {
+    batch_finished_.SignalAll();
+  }
+  return true;
+}
+
+absl::Status
+MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::RunInParallel(
+    size_t num_jobs, absl::FunctionRef<absl::Status(size_t)> run_job) {
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    run_job_ = &run_job;
+    num_jobs_ = num_jobs;
+    next_job_ = 0;
+    num_finished_jobs_ = 0;
+    job_statuses_.assign(num_jobs, absl::OkStatus());
+    job_available_.SignalAll();
+  }
+
+  // Each worker claims the next job which has not started. The calling thread
+  // is one of the workers.
+  while (RunNextJob()) {
+  }
+
+  std::vector<absl::Status> statuses;
+  {
+    absl::MutexLock lock(&pool_mutex_);
+    while (num_finished_jobs_ < num_jobs_) {
+      batch_finished_.Wait(&pool_mutex_);
+    }
+    run_job_ = nullptr;
+    num_jobs_ = 0;
+    next_job_ = 0;
+    statuses.swap(job_statuses_);
+  }
+  for (const auto& status : statuses) {
+    RETURN_IF_NOT_OK(status);
+  }
   return absl::OkStatus();
 }
 
+absl::Status
+MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::RunRenderers(
+    absl::FunctionRef<absl::Status(SharedRenderer&)> run_renderer) {
+  return RunInParallel(shared_renderers_.size(), [&](size_t i) {
+    const auto shared_renderer = shared_renderers_[i].lock();
+    return shared_renderer == nullptr ? absl::OkStatus()
+                                      : run_renderer(*shared_renderer);
+  });
+}
+
+absl::Status
+MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer::RunTasks(
+    absl::FunctionRef<absl::Status(LayoutTask&)> run_task) {
+  return RunInParallel(tasks_.size(),
+                       [&](size_t i) { return run_task(tasks_[i]); });
+}
+
 }  // namespace iamf_tools
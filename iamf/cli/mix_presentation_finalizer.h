@@ -13,18 +13,30 @@
 #ifndef CLI_MIX_PRESENTATION_FINALIZER_H_
 #define CLI_MIX_PRESENTATION_FINALIZER_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <list>
 #include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "iamf/cli/audio_element_with_data.h"
 #include "iamf/cli/demixing_module.h"
+#include "iamf/cli/loudness_calculator.h"
+#include "iamf/cli/loudness_calculator_factory.h"
+#include "iamf/cli/mix_gain_ramp.h"
 #include "iamf/cli/parameter_block_with_data.h"
 #include "iamf/cli/proto/mix_presentation.pb.h"
+#include "iamf/cli/renderer/audio_element_renderer_base.h"
+#include "iamf/cli/renderer_factory.h"
 #include "iamf/cli/wav_writer.h"
 #include "iamf/obu/leb128.h"
 #include "iamf/obu/mix_presentation.h"
@@ -83,26 +95,101 @@ class MixPresentationFinalizerBase {
       const std::list<ParameterBlockWithData>& parameter_blocks,
       const WavWriterFactory& wav_writer_factory,
       std::list<MixPresentationObu>& mix_presentation_obus) = 0;
+
+  /*!\brief Prepares to finalize Mix Presentation OBUs incrementally.
+   *
+   * Instead of calling `Finalize()` with every frame of the IA Sequence, call
+   * this function once, then `PushTemporalUnit()` with each temporal unit as
+   * it is produced, then `FinalizePushingTemporalUnits()` once the IA Sequence
+   * ends.
+   *
+   * \param audio_elements Input Audio Element OBUs with data. They must
+   *     outlive the calls to `PushTemporalUnit()`.
+   * \param wav_writer_factory Factory for creating output rendered wav files.
+   * \param mix_presentation_obus Mix Presentation OBUs to finalize.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  virtual absl::Status Initialize(
+      const absl::flat_hash_map<uint32_t, AudioElementWithData>& audio_elements,
+      const WavWriterFactory& wav_writer_factory,
+      const std::list<MixPresentationObu>& mix_presentation_obus) = 0;
+
+  /*!\brief Processes the frames of one temporal unit.
+   *
+   * \param id_to_labeled_frame Frames of the temporal unit, keyed by audio
+   *     element ID.
+   * \param start_timestamp Start timestamp of the temporal unit.
+   * \param parameter_blocks Parameter Block OBUs of the temporal unit.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  virtual absl::Status PushTemporalUnit(
+      const IdLabeledFrameMap& id_to_labeled_frame, int32_t start_timestamp,
+      const std::list<ParameterBlockWithData>& parameter_blocks) = 0;
+
+  /*!\brief Processes any remaining samples and outputs the loudness.
+   *
+   * \param mix_presentation_obus Mix Presentation OBUs to finalize. Must be
+   *     the same OBUs as passed to `Initialize()`.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  virtual absl::Status FinalizePushingTemporalUnits(
+      std::list<MixPresentationObu>& mix_presentation_obus) = 0;
 };
 
-/*!\brief Finalizer that measures loudness or echoes user provided loudness. */
+/*!\brief Finalizer that measures loudness or echoes user provided loudness.
+ *
+ * Each layout of each sub-mix is mixed, written to a wav file and measured
+ * independently of the others. These tasks are spread over a pool of worker
+ * threads, which is started by `Initialize()` and stopped by
+ * `FinalizePushingTemporalUnits()`. Sub-mixes which render the same audio
+ * element to the same layout with the same rendering config share one
+ * renderer, so each frame is rendered once. Wav writers are created and OBUs
+ * are updated on the calling thread, in the order of the layouts, so the
+ * output does not depend on the scheduling of the tasks.
+ *
+ * Temporal units are rendered, mixed, written and measured as soon as they are
+ * pushed, so only the samples which the renderers have not finished are kept
+ * in memory.
+ */
 class MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer
     : public MixPresentationFinalizerBase {
  public:
-  /*!\brief Constructor. */
-  MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer()
-      : MixPresentationFinalizerBase() {}
+  /*!\brief Constructor.
+   *
+   * \param file_name_prefix Prefix passed to the wav writer factory.
+   * \param renderer_factory Factory to create renderers or `nullptr` to never
+   *     render layouts and echo the user provided loudness.
+   * \param loudness_calculator_factory Factory to create loudness calculators
+   *     or `nullptr` to echo the user provided loudness of rendered layouts.
+   * \param num_threads Maximum number of layouts to finalize concurrently, or
+   *     0 to use one thread per hardware thread.
+   * \param output_wav_file_bit_depth_override Bit-depth of the rendered wav
+   *     files or `std::nullopt` to use the bit-depth loudness is measured at.
+   * \param validate_loudness Whether to fail when the measured loudness does
+   *     not match the user provided loudness.
+   */
+  explicit MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer(
+      const std::filesystem::path& file_name_prefix = "",
+      std::unique_ptr<RendererFactoryBase> renderer_factory = nullptr,
+      std::unique_ptr<LoudnessCalculatorFactoryBase>
+          loudness_calculator_factory = nullptr,
+      int num_threads = 0,
+      std::optional<uint8_t> output_wav_file_bit_depth_override = std::nullopt,
+      bool validate_loudness = false);
 
   /*!\brief Destructor.
+   *
+   * Stops the worker threads if they are still running.
    */
-  ~MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer() override =
-      default;
+  ~MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer() override;
 
   /*!\brief Finalizes the list of Mix Presentation OBUs.
    *
    * Attempt to render the layouts associated with the mix presentation OBU and
    * populate the `LoudnessInfo` accurately. May fall back to simply copying
-   * user provided loudness information for any number of layouts.
+   * user provided loudness information for any number of layouts. Layouts
+   * which cannot be rendered by the renderer factory keep the user provided
+   * loudness and have no wav file written.
    *
    * \param audio_elements Input Audio Element OBUs with data.
    * \param id_to_time_to_labeled_frame Data structure of samples.
@@ -118,6 +205,184 @@ class MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer
       const std::list<ParameterBlockWithData>& parameter_blocks,
       const MixPresentationFinalizerBase::WavWriterFactory& wav_writer_factory,
       std::list<MixPresentationObu>& mix_presentation_obus) override;
+
+  /*!\brief Prepares to finalize Mix Presentation OBUs incrementally.
+   *
+   * Creates the renderers, loudness calculators and wav writers of every
+   * layout which can be rendered. Renderers are shared between sub-mixes when
+   * possible. Starts the worker threads which run them.
+   *
+   * \param audio_elements Input Audio Element OBUs with data. They must
+   *     outlive the calls to `PushTemporalUnit()`.
+   * \param wav_writer_factory Factory for creating output rendered wav files.
+   * \param mix_presentation_obus Mix Presentation OBUs to finalize.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status Initialize(
+      const absl::flat_hash_map<uint32_t, AudioElementWithData>& audio_elements,
+      const WavWriterFactory& wav_writer_factory,
+      const std::list<MixPresentationObu>& mix_presentation_obus) override;
+
+  /*!\brief Renders, mixes, writes and measures one temporal unit.
+   *
+   * \param id_to_labeled_frame Frames of the temporal unit, keyed by audio
+   *     element ID.
+   * \param start_timestamp Start timestamp of the temporal unit.
+   * \param parameter_blocks Parameter Block OBUs of the temporal unit. Mix
+   *     gains are applied when the ticks they cover are mixed.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status PushTemporalUnit(
+      const IdLabeledFrameMap& id_to_labeled_frame, int32_t start_timestamp,
+      const std::list<ParameterBlockWithData>& parameter_blocks) override;
+
+  /*!\brief Finishes rendering and outputs the loudness of every layout.
+   *
+   * Stops the worker threads once every layout is finished.
+   *
+   * \param mix_presentation_obus Mix Presentation OBUs to finalize. Must be
+   *     the same OBUs as passed to `Initialize()`.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     loudness is validated and any measured loudness does not match the
+   *     user provided loudness. A specific status on other failures.
+   */
+  absl::Status FinalizePushingTemporalUnits(
+      std::list<MixPresentationObu>& mix_presentation_obus) override;
+
+ private:
+  // Renderer of one audio element to one layout. It is shared by every
+  // sub-mix which renders the audio element with the same rendering config,
+  // so each frame is rendered once. It lives as long as a task refers to it.
+  struct SharedRenderer {
+    DecodedUleb128 audio_element_id;
+    RenderingConfig rendering_config;
+    Layout layout;
+    std::unique_ptr<AudioElementRendererBase> renderer;
+
+    // Ticks promised by the renderer for the latest temporal unit and the
+    // samples flushed since then. Read by every task which shares the
+    // renderer.
+    int num_ticks_rendered = 0;
+    std::vector<int32_t> rendered_samples;
+  };
+
+  // Streaming state of one layout of one sub-mix. Each task is only accessed
+  // by one thread at a time.
+  struct LayoutTask {
+    int mix_presentation_index;
+    int sub_mix_index;
+    int layout_index;
+    int num_channels;
+
+    // Renderers of the audio elements of the sub-mix, with their mix gains
+    // and rendered samples which have not been mixed yet.
+    std::vector<std::shared_ptr<SharedRenderer>> renderers;
+    std::vector<MixGainRamp> element_gain_ramps;
+    std::vector<std::vector<int32_t>> pending_samples;
+    MixGainRamp output_gain_ramp;
+
+    // Timestamp of the next tick to mix. Unknown until the first tick is
+    // rendered.
+    std::optional<int32_t> next_timestamp;
+
+    std::unique_ptr<WavWriter> wav_writer;
+    std::unique_ptr<LoudnessCalculatorBase> loudness_calculator;
+
+    // Scratch buffers, kept to avoid reallocating them for every temporal
+    // unit.
+    std::vector<float> tick_gains;
+    std::vector<double> mixed_samples;
+    std::vector<int32_t> output_samples;
+    std::vector<uint8_t> wav_buffer;
+  };
+
+  /*!\brief Mixes the oldest pending samples, then writes and measures them.
+   *
+   * \param num_samples Number of pending samples of each audio element to
+   *     mix. Audio elements with fewer pending samples are padded with zeros.
+   * \param task Task to mix the samples of.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  static absl::Status MixAndOutput(size_t num_samples, LayoutTask& task);
+
+  /*!\brief Starts the worker threads.
+   *
+   * \param num_workers Number of threads to start, in addition to the calling
+   *     thread.
+   */
+  void StartWorkers(int num_workers);
+
+  /*!\brief Stops and joins the worker threads. */
+  void StopWorkers();
+
+  /*!\brief Runs jobs of the current batch until the shutdown of the pool. */
+  void WorkerLoop();
+
+  /*!\brief Claims and runs the next job of the current batch.
+   *
+   * \return `true` if a job was run. `false` if every job was claimed.
+   */
+  bool RunNextJob();
+
+  /*!\brief Runs jobs, spread over the worker threads.
+   *
+   * The calling thread runs jobs too and returns once every job is finished.
+   *
+   * \param num_jobs Number of jobs to run.
+   * \param run_job Function to run with the index of each job.
+   * \return `absl::OkStatus()` on success. The first failure in the order of
+   *     the jobs otherwise.
+   */
+  absl::Status RunInParallel(size_t num_jobs,
+                             absl::FunctionRef<absl::Status(size_t)> run_job);
+
+  /*!\brief Runs a function on every live shared renderer, in parallel.
+   *
+   * \param run_renderer Function to run on each renderer.
+   * \return `absl::OkStatus()` on success. The first failure in the order of
+   *     the renderers otherwise.
+   */
+  absl::Status RunRenderers(
+      absl::FunctionRef<absl::Status(SharedRenderer&)> run_renderer);
+
+  /*!\brief Runs a function on every task, in parallel.
+   *
+   * \param run_task Function to run on each task.
+   * \return `absl::OkStatus()` on success. The first failure in the order of
+   *     the tasks otherwise.
+   */
+  absl::Status RunTasks(absl::FunctionRef<absl::Status(LayoutTask&)> run_task);
+
+  const std::filesystem::path file_name_prefix_;
+  const std::unique_ptr<RendererFactoryBase> renderer_factory_;
+  const std::unique_ptr<LoudnessCalculatorFactoryBase>
+      loudness_calculator_factory_;
+  const int num_threads_;
+  const std::optional<uint8_t> output_wav_file_bit_depth_override_;
+  const bool validate_loudness_;
+  // Renderers of the tasks, in the order they were created. Renderers of
+  // layouts which cannot be rendered expire once their tasks are dropped.
+  std::vector<std::weak_ptr<SharedRenderer>> shared_renderers_;
+  std::vector<LayoutTask> tasks_;
+
+  // Worker threads, kept from `Initialize()` to
+  // `FinalizePushingTemporalUnits()` so they are not recreated for every
+  // temporal unit.
+  std::vector<std::thread> workers_;
+  absl::Mutex pool_mutex_;
+  // Signaled when a batch of jobs is started or the pool is shutting down.
+  absl::CondVar job_available_;
+  // Signaled when the last job of a batch is finished.
+  absl::CondVar batch_finished_;
+  // Batch of jobs being run. `run_job_` is only dereferenced while the batch
+  // has unfinished jobs.
+  const absl::FunctionRef<absl::Status(size_t)>* run_job_
+      ABSL_GUARDED_BY(pool_mutex_) = nullptr;
+  size_t num_jobs_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  size_t next_job_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  size_t num_finished_jobs_ ABSL_GUARDED_BY(pool_mutex_) = 0;
+  std::vector<absl::Status> job_statuses_ ABSL_GUARDED_BY(pool_mutex_);
+  bool shutting_down_ ABSL_GUARDED_BY(pool_mutex_) = false;
 };
 
 }  // namespace iamf_tools
@@ -163,7 +163,7 @@ absl::Status AccumulateNumSamples(const TemporalUnit& temporal_unit,
   }
 
   num_samples +=
-      (temporal_unit.audio_frames[0]->raw_samples.size() -
+      (temporal_unit.audio_frames[0]->num_ticks -
        (temporal_unit.audio_frames[0]
             ->obu.header_.num_samples_to_trim_at_start +
         temporal_unit.audio_frames[0]->obu.header_.num_samples_to_trim_at_end));
@@ -12,8 +12,10 @@
 #include "iamf/cli/parameters_manager.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <variant>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
@@ -30,6 +32,34 @@
 
 namespace iamf_tools {
 
+namespace {
+
+// Gets the index of the parameter block with `parameter_id`. Unknown IDs are
+// given a new index, whose parameter block is null until one is added.
+size_t GetOrAddParameterBlockIndex(
+    DecodedUleb128 parameter_id,
+    absl::flat_hash_map<DecodedUleb128, size_t>& parameter_block_indices,
+    std::vector<const ParameterBlockWithData*>& parameter_blocks) {
+  const auto [iter, inserted] =
+      parameter_block_indices.insert({parameter_id, parameter_blocks.size()});
+  if (inserted) {
+    parameter_blocks.push_back(nullptr);
+  }
+  return iter->second;
+}
+
+// Returns the state at the index of `audio_element_id`, or `nullptr` if the
+// audio element has no state.
+template <typename State>
+State* FindState(DecodedUleb128 audio_element_id,
+                 const absl::flat_hash_map<DecodedUleb128, size_t>& indices,
+                 std::vector<State>& states) {
+  const auto iter = indices.find(audio_element_id);
+  return iter == indices.end() ? nullptr : &states[iter->second];
+}
+
+}  // namespace
+
 ParametersManager::ParametersManager(
     const absl::flat_hash_map<DecodedUleb128, AudioElementWithData>&
         audio_elements)
@@ -72,25 +102,31 @@ absl::Status ParametersManager::Initialize() {
       // Insert a `nullptr` for a parameter ID. If no parameter blocks have
       // this parameter ID, then it will remain null and default values will
       // be used.
-      demixing_parameter_blocks_.insert(
-          {demixing_param_definition->parameter_id_, nullptr});
-      demixing_states_[audio_element_id] = {
+      const size_t parameter_block_index = GetOrAddParameterBlockIndex(
+          demixing_param_definition->parameter_id_,
+          demixing_parameter_block_indices_, demixing_parameter_blocks_);
+      demixing_state_indices_[audio_element_id] = demixing_states_.size();
+      demixing_states_.push_back({
           .param_definition = demixing_param_definition,
+          .parameter_block_index = parameter_block_index,
           .previous_w_idx = 0,
           .next_timestamp = 0,
           .update_rule = DemixingInfoParameterData::kFirstFrame,
-      };
+      });
     }
     if (recon_gain_param_definition != nullptr) {
       // Insert a `nullptr` for a parameter ID. If no parameter blocks have
       // this parameter ID, then it will remain null and default values will
       // be used.
-      recon_gain_parameter_blocks_.insert(
-          {recon_gain_param_definition->parameter_id_, nullptr});
-      recon_gain_states_[audio_element_id] = {
+      const size_t parameter_block_index = GetOrAddParameterBlockIndex(
+          recon_gain_param_definition->parameter_id_,
+          recon_gain_parameter_block_indices_, recon_gain_parameter_blocks_);
+      recon_gain_state_indices_[audio_element_id] = recon_gain_states_.size();
+      recon_gain_states_.push_back({
           .param_definition = recon_gain_param_definition,
+          .parameter_block_index = parameter_block_index,
           .next_timestamp = 0,
-      };
+      });
     }
   }
 
@@ -99,7 +135,7 @@ absl::Status ParametersManager::Initialize() {
 
 bool ParametersManager::DemixingParamDefinitionAvailable(
     const DecodedUleb128 audio_element_id) {
-  return demixing_states_.find(audio_element_id) != demixing_states_.end();
+  return demixing_state_indices_.contains(audio_element_id);
 }
 
 // This function will populate `down_mixing_params` as follows:
@@ -112,8 +148,9 @@ bool ParametersManager::DemixingParamDefinitionAvailable(
 absl::Status ParametersManager::GetDownMixingParameters(
     const DecodedUleb128 audio_element_id,
     DownMixingParams& down_mixing_params) {
-  const auto demixing_states_iter = demixing_states_.find(audio_element_id);
-  if (demixing_states_iter == demixing_states_.end()) {
+  auto* demixing_state =
+      FindState(audio_element_id, demixing_state_indices_, demixing_states_);
+  if (demixing_state == nullptr) {
     LOG_FIRST_N(WARNING, 1)
         << "No demixing parameter definition found for Audio "
         << "Element with ID= " << audio_element_id
@@ -123,10 +160,9 @@ absl::Status ParametersManager::GetDownMixingParameters(
         0.707, 0.707, 0.707, 0.707, 0, 0, /*in_bitstream=*/false};
     return absl::OkStatus();
   }
-  auto& demixing_state = demixing_states_iter->second;
-  const auto* param_definition = demixing_state.param_definition;
+  const auto* param_definition = demixing_state->param_definition;
   const auto* parameter_block =
-      demixing_parameter_blocks_.at(param_definition->parameter_id_);
+      demixing_parameter_blocks_[demixing_state->parameter_block_index];
   if (parameter_block == nullptr) {
     // Failed to find a parameter block that overlaps this frame. Use the
     // default value from the parameter definition. This is OK when there are
@@ -142,11 +178,11 @@ absl::Status ParametersManager::GetDownMixingParameters(
     return absl::OkStatus();
   }
 
-  if (parameter_block->start_timestamp != demixing_state.next_timestamp) {
+  if (parameter_block->start_timestamp != demixing_state->next_timestamp) {
     return absl::InvalidArgumentError(absl::StrCat(
         "Mismatching timestamps for down-mixing parameters for "
         "audio element ID= ",
-        audio_element_id, ": expecting", demixing_state.next_timestamp,
+        audio_element_id, ": expecting", demixing_state->next_timestamp,
         " but got ", parameter_block->start_timestamp));
   }
 
@@ -154,17 +190,18 @@ absl::Status ParametersManager::GetDownMixingParameters(
       std::get<DemixingInfoParameterData>(
           parameter_block->obu->subblocks_[0].param_data)
           .dmixp_mode,
-      demixing_state.previous_w_idx, demixing_state.update_rule,
+      demixing_state->previous_w_idx, demixing_state->update_rule,
       down_mixing_params));
-  demixing_state.w_idx = down_mixing_params.w_idx_used;
+  demixing_state->w_idx = down_mixing_params.w_idx_used;
   return absl::OkStatus();
 }
 
 absl::Status ParametersManager::GetReconGainParameters(
     DecodedUleb128 audio_element_id, int32_t num_layers,
     ReconGainInfoParameterData& recon_gain_parameters) {
-  const auto recon_gain_states_iter = recon_gain_states_.find(audio_element_id);
-  if (recon_gain_states_iter == recon_gain_states_.end()) {
+  const auto* recon_gain_state = FindState(
+      audio_element_id, recon_gain_state_indices_, recon_gain_states_);
+  if (recon_gain_state == nullptr) {
     LOG_FIRST_N(WARNING, 1)
         << "No recon gain parameter definition found for Audio "
         << "Element with ID= " << audio_element_id
@@ -180,10 +217,8 @@ absl::Status ParametersManager::GetReconGainParameters(
     return absl::OkStatus();
   }
 
-  auto& recon_gain_state = recon_gain_states_iter->second;
-  const auto* param_definition = recon_gain_state.param_definition;
   const auto* recon_gain_parameter_block =
-      recon_gain_parameter_blocks_.at(param_definition->parameter_id_);
+      recon_gain_parameter_blocks_[recon_gain_state->parameter_block_index];
   if (recon_gain_parameter_block == nullptr) {
     // Failed to find a parameter block that overlaps this frame. A default
     // recon gain value of 0 dB is implied when there are no Parameter Block
@@ -207,11 +242,11 @@ absl::Status ParametersManager::GetReconGainParameters(
   }
 
   if (recon_gain_parameter_block->start_timestamp !=
-      recon_gain_state.next_timestamp) {
+      recon_gain_state->next_timestamp) {
     return absl::InvalidArgumentError(absl::StrCat(
         "Mismatching timestamps for recon gain parameters for "
         "audio element ID= ",
-        audio_element_id, ": expecting", recon_gain_state.next_timestamp,
+        audio_element_id, ": expecting", recon_gain_state->next_timestamp,
         " but got ", recon_gain_parameter_block->start_timestamp));
   }
 
@@ -230,34 +265,32 @@ absl::Status ParametersManager::GetReconGainParameters(
 
 void ParametersManager::AddDemixingParameterBlock(
     const ParameterBlockWithData* parameter_block) {
-  demixing_parameter_blocks_[parameter_block->obu->parameter_id_] =
-      parameter_block;
+  demixing_parameter_blocks_[GetOrAddParameterBlockIndex(
+      parameter_block->obu->parameter_id_, demixing_parameter_block_indices_,
+      demixing_parameter_blocks_)] = parameter_block;
 }
 
 void ParametersManager::AddReconGainParameterBlock(
     const ParameterBlockWithData* parameter_block) {
-  recon_gain_parameter_blocks_[parameter_block->obu->parameter_id_] =
-      parameter_block;
+  recon_gain_parameter_blocks_[GetOrAddParameterBlockIndex(
+      parameter_block->obu->parameter_id_, recon_gain_parameter_block_indices_,
+      recon_gain_parameter_blocks_)] = parameter_block;
 }
 
 absl::Status ParametersManager::UpdateDemixingState(
     DecodedUleb128 audio_element_id, int32_t expected_timestamp) {
-  const auto demixing_states_iter = demixing_states_.find(audio_element_id);
-  if (demixing_states_iter == demixing_states_.end()) {
+  auto* demixing_state_ptr =
+      FindState(audio_element_id, demixing_state_indices_, demixing_states_);
+  if (demixing_state_ptr == nullptr) {
     // No demixing parameter definition found for the audio element ID, so
     // nothing to update.
     return absl::OkStatus();
   }
 
   // Validate the timestamps before updating.
-  auto& demixing_state = demixing_states_iter->second;
-
-  // Using `.at()` here is safe because if the demixing state exists for the
-  // `audio_element_id`, an entry in `demixing_parameter_blocks_` with the key
-  // `demixing_state.param_definition->parameter_id_` has already been
-  // created during `Initialize()`.
-  auto& parameter_block = demixing_parameter_blocks_.at(
-      demixing_state.param_definition->parameter_id_);
+  auto& demixing_state = *demixing_state_ptr;
+  auto& parameter_block =
+      demixing_parameter_blocks_[demixing_state.parameter_block_index];
   if (parameter_block == nullptr) {
     // No parameter block found for this ID. Do not validate the timestamp
     // or update anything else.
@@ -291,22 +324,18 @@ absl::Status ParametersManager::UpdateDemixingState(
 // TODO(b/356393945): Refactor to use a template function.
 absl::Status ParametersManager::UpdateReconGainState(
     DecodedUleb128 audio_element_id, int32_t expected_timestamp) {
-  const auto recon_gain_states_iter = recon_gain_states_.find(audio_element_id);
-  if (recon_gain_states_iter == recon_gain_states_.end()) {
+  auto* recon_gain_state_ptr = FindState(
+      audio_element_id, recon_gain_state_indices_, recon_gain_states_);
+  if (recon_gain_state_ptr == nullptr) {
     // No recon gain parameter definition found for the audio element ID, so
     // nothing to update.
     return absl::OkStatus();
   }
 
   // Validate the timestamps before updating.
-  auto& recon_gain_state = recon_gain_states_iter->second;
-
-  // Using `.at()` here is safe because if the recon gain state exists for the
-  // `audio_element_id`, an entry in `recon_gain_parameter_blocks_` with the key
-  // `recon_gain_state.param_definition->parameter_id_` has already been
-  // created during `Initialize()`.
-  auto& parameter_block = recon_gain_parameter_blocks_.at(
-      recon_gain_state.param_definition->parameter_id_);
+  auto& recon_gain_state = *recon_gain_state_ptr;
+  auto& parameter_block =
+      recon_gain_parameter_blocks_[recon_gain_state.parameter_block_index];
   if (parameter_block == nullptr) {
     // No parameter block found for this ID. Do not validate the timestamp
     // or update anything else.
@@ -13,7 +13,9 @@
 #ifndef CLI_PARAMETERS_MANAGER_H_
 #define CLI_PARAMETERS_MANAGER_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
@@ -129,6 +131,9 @@ class ParametersManager {
   struct DemixingState {
     const DemixingParamDefinition* param_definition;
 
+    // Index of the parameter ID in `demixing_parameter_blocks_`.
+    size_t parameter_block_index;
+
     // `w_idx` for the frame just processed, i.e. `wIdx(k - 1)` in the Spec.
     int previous_w_idx;
 
@@ -146,6 +151,9 @@ class ParametersManager {
   struct ReconGainState {
     const ReconGainParamDefinition* param_definition;
 
+    // Index of the parameter ID in `recon_gain_parameter_blocks_`.
+    size_t parameter_block_index;
+
     // Timestamp for the next frame to be processed.
     int32_t next_timestamp;
   };
@@ -154,19 +162,26 @@ class ParametersManager {
   const absl::flat_hash_map<DecodedUleb128, AudioElementWithData>&
       audio_elements_;
 
-  // Mapping from Parameter ID to demixing parameter blocks.
-  absl::flat_hash_map<DecodedUleb128, const ParameterBlockWithData*>
-      demixing_parameter_blocks_;
+  // IDs are mapped to dense indices in `Initialize()`. The per-frame state is
+  // stored in vectors at those indices.
+
+  // Mapping from Parameter ID to the index of its demixing parameter block.
+  absl::flat_hash_map<DecodedUleb128, size_t>
+      demixing_parameter_block_indices_;
+  std::vector<const ParameterBlockWithData*> demixing_parameter_blocks_;
 
-  // Mapping from Parameter ID to recon gain parameter blocks.
-  absl::flat_hash_map<DecodedUleb128, const ParameterBlockWithData*>
-      recon_gain_parameter_blocks_;
+  // Mapping from Parameter ID to the index of its recon gain parameter block.
+  absl::flat_hash_map<DecodedUleb128, size_t>
+      recon_gain_parameter_block_indices_;
+  std::vector<const ParameterBlockWithData*> recon_gain_parameter_blocks_;
 
-  // Mapping from Audio Element ID to the demixing state.
-  absl::flat_hash_map<DecodedUleb128, DemixingState> demixing_states_;
+  // Mapping from Audio Element ID to the index of its demixing state.
+  absl::flat_hash_map<DecodedUleb128, size_t> demixing_state_indices_;
+  std::vector<DemixingState> demixing_states_;
 
-  // Mapping from Audio Element ID to the recon gain state.
-  absl::flat_hash_map<DecodedUleb128, ReconGainState> recon_gain_states_;
+  // Mapping from Audio Element ID to the index of its recon gain state.
+  absl::flat_hash_map<DecodedUleb128, size_t> recon_gain_state_indices_;
+  std::vector<ReconGainState> recon_gain_states_;
 };
 
 }  // namespace iamf_tools
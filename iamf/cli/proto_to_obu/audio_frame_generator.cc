@@ -12,11 +12,13 @@
 #include "iamf/cli/proto_to_obu/audio_frame_generator.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <deque>
+#include <limits>
 #include <list>
 #include <memory>
 #include <optional>
@@ -30,12 +32,17 @@
 #include "absl/log/log.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "iamf/cli/audio_element_with_data.h"
 #include "iamf/cli/audio_frame_with_data.h"
 #include "iamf/cli/channel_label.h"
 #include "iamf/cli/codec/aac_encoder.h"
+#include "iamf/cli/codec/async_encoder.h"
+#include "iamf/cli/codec/caching_encoder.h"
+#include "iamf/cli/codec/encoded_frame_cache.h"
 #include "iamf/cli/codec/encoder_base.h"
 #include "iamf/cli/codec/flac_encoder.h"
 #include "iamf/cli/codec/lpcm_encoder.h"
@@ -46,16 +53,58 @@
 #include "iamf/cli/proto/audio_frame.pb.h"
 #include "iamf/cli/proto/codec_config.pb.h"
 #include "iamf/cli/proto/test_vector_metadata.pb.h"
+#include "iamf/cli/sample_ring_buffer.h"
 #include "iamf/common/macros.h"
 #include "iamf/obu/audio_frame.h"
 #include "iamf/obu/codec_config.h"
 #include "iamf/obu/demixing_info_param_data.h"
 #include "iamf/obu/leb128.h"
+#include "iamf/obu/obu_header.h"
+#include "src/google/protobuf/io/coded_stream.h"
+#include "src/google/protobuf/io/zero_copy_stream_impl_lite.h"
 
 namespace iamf_tools {
 
 namespace {
 
+// Gets the serialized settings which affect the encoded frames. Settings which
+// only affect how the encoding is scheduled are left out. The serialization is
+// deterministic, so map fields always serialize in the same order.
+std::string GetSerializedEncoderSettings(
+    const iamf_tools_cli_proto::CodecConfig& codec_config_metadata) {
+  iamf_tools_cli_proto::CodecConfig settings = codec_config_metadata;
+  settings.clear_use_async_encoder();
+  settings.clear_encoded_frame_cache_directory();
+  if (settings.has_decoder_config_flac()) {
+    auto* flac_encoder_metadata =
+        settings.mutable_decoder_config_flac()->mutable_flac_encoder_metadata();
+    flac_encoder_metadata->clear_num_threads();
+    flac_encoder_metadata->clear_verify_frames();
+  }
+
+  std::string serialized_settings;
+  {
+    google::protobuf::io::StringOutputStream string_stream(
+        &serialized_settings);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    settings.SerializeToCodedStream(&coded_stream);
+  }
+  return serialized_settings;
+}
+
+// Gets a key of every setting which affects the encoded frames. Some settings,
+// e.g. Opus bitrate overrides, apply to specific substreams.
+uint64_t GetEncodedFrameCacheStreamKey(
+    const iamf_tools_cli_proto::CodecConfig& codec_config_metadata,
+    int num_channels, int substream_id) {
+  return CacheKeyBuilder()
+      .Add(GetSerializedEncoderSettings(codec_config_metadata))
+      .Add(static_cast<uint64_t>(num_channels))
+      .Add(static_cast<uint64_t>(substream_id))
+      .Build();
+}
+
 absl::Status InitializeEncoder(
     const iamf_tools_cli_proto::CodecConfig& codec_config_metadata,
     const CodecConfigObu& codec_config, int num_channels,
@@ -84,21 +133,37 @@ absl::Status InitializeEncoder(
       return absl::InvalidArgumentError(absl::StrCat(
           "Unknown codec_id= ", codec_config.GetCodecConfig().codec_id));
   }
+  if (codec_config_metadata.use_async_encoder()) {
+    encoder = std::make_unique<AsyncEncoder>(codec_config, std::move(encoder));
+  }
+  if (!codec_config_metadata.encoded_frame_cache_directory().empty()) {
+    // Only LPCM frames can be reused without the codec state of the frames
+    // before them.
+    encoder = std::make_unique<CachingEncoder>(
+        codec_config, std::move(encoder),
+        codec_config_metadata.encoded_frame_cache_directory(),
+        GetEncodedFrameCacheStreamKey(codec_config_metadata, num_channels,
+                                      substream_id),
+        /*frames_are_independent=*/codec_config.GetCodecConfig().codec_id ==
+            CodecConfig::kCodecIdLpcm);
+  }
   RETURN_IF_NOT_OK(encoder->Initialize());
   return absl::OkStatus();
 }
 
 // Gets data relevant to encoding (Codec Config OBU and AudioElementWithData)
-// and initializes encoders.
+// and initializes encoders, which reveals their delay. Encoders and delays are
+// appended in the order of `substream_ids`.
 absl::Status GetEncodingDataAndInitializeEncoders(
-    const absl::flat_hash_map<DecodedUleb128, iamf_tools_cli_proto::CodecConfig>
-        codec_config_metadata,
     const AudioElementWithData& audio_element_with_data,
-    absl::flat_hash_map<uint32_t, std::unique_ptr<EncoderBase>>&
-        substream_id_to_encoder) {
-  for (const auto& [substream_id, labels] :
-       audio_element_with_data.substream_id_to_labels) {
-    const int num_channels = static_cast<int>(labels.size());
+    absl::Span<const uint32_t> substream_ids,
+    AudioFrameGenerator::EncoderVariant& encoder_variant,
+    std::vector<uint32_t>& substream_delays) {
+  const auto& codec_config_metadata = encoder_variant.codec_config_metadata;
+  for (const uint32_t substream_id : substream_ids) {
+    const int num_channels = static_cast<int>(
+        audio_element_with_data.substream_id_to_labels.at(substream_id)
+            .size());
     const CodecConfigObu& codec_config_obu =
         *audio_element_with_data.codec_config;
     auto codec_config_metadata_iter =
@@ -109,9 +174,11 @@ absl::Status GetEncodingDataAndInitializeEncoders(
           codec_config_obu.GetCodecConfigId()));
     }
 
-    RETURN_IF_NOT_OK(InitializeEncoder(
-        codec_config_metadata_iter->second, codec_config_obu, num_channels,
-        substream_id_to_encoder[substream_id], substream_id));
+    auto& encoder = encoder_variant.encoders.emplace_back();
+    RETURN_IF_NOT_OK(InitializeEncoder(codec_config_metadata_iter->second,
+                                       codec_config_obu, num_channels, encoder,
+                                       substream_id));
+    substream_delays.push_back(encoder->GetNumberOfSamplesToDelayAtStart());
   }
 
   return absl::OkStatus();
@@ -154,59 +221,39 @@ absl::Status GetNumSamplesToPadAtEndAndValidate(
   return absl::OkStatus();
 }
 
-void PadSamples(const size_t num_samples_to_pad, const size_t num_channels,
-                std::deque<std::vector<int32_t>>& samples) {
-  samples.insert(samples.end(), num_samples_to_pad,
-                 std::vector<int32_t>(num_channels, 0));
-}
-
-void MoveSamples(const size_t num_samples,
-                 std::deque<std::vector<int32_t>>& source_samples,
-                 std::vector<std::vector<int32_t>>& destination_samples) {
-  CHECK_GE(source_samples.size(), num_samples);
-  std::copy(source_samples.begin(), source_samples.begin() + num_samples,
-            destination_samples.begin());
-  source_samples.erase(source_samples.begin(),
-                       source_samples.begin() + num_samples);
-}
-
 absl::Status InitializeSubstreamData(
     const SubstreamIdLabelsMap& substream_id_to_labels,
-    const absl::flat_hash_map<uint32_t, std::unique_ptr<EncoderBase>>&
-        substream_id_to_encoder,
+    absl::Span<const uint32_t> substream_ids,
+    absl::Span<const uint32_t> substream_delays,
+    const uint32_t num_samples_per_frame,
     const uint32_t user_samples_to_trim_at_start,
-    absl::flat_hash_map<uint32_t, SubstreamData>&
-        substream_id_to_substream_data) {
+    std::vector<SubstreamData>& substream_data) {
   // Validate user start trim is correct; it depends on the encoder. Insert
   // the "virtual samples" at the start up to the amount required by the codec
   // and encoder into the `samples_obu` queue. Trimming of additional optional
   // samples will occur later to keep trimming logic in one place as much as
   // possible.
-  for (const auto& [substream_id, labels] : substream_id_to_labels) {
-    const auto encoder_iter = substream_id_to_encoder.find(substream_id);
-    if (encoder_iter == substream_id_to_encoder.end()) {
-      return absl::InvalidArgumentError(absl::StrCat(
-          "Failed to find encoder for substream ID= ", substream_id));
-    }
-
-    uint32_t encoder_required_samples_to_delay =
-        encoder_iter->second->GetNumberOfSamplesToDelayAtStart();
+  for (size_t i = 0; i < substream_ids.size(); ++i) {
+    const uint32_t substream_id = substream_ids[i];
+    const size_t num_channels = substream_id_to_labels.at(substream_id).size();
+    uint32_t encoder_required_samples_to_delay = substream_delays[i];
     RETURN_IF_NOT_OK(ValidateUserStartTrim(user_samples_to_trim_at_start,
                                            encoder_required_samples_to_delay));
 
     // Initialize a `SubstreamData` with virtual samples for any delay
-    // introduced by the encoder.
-    auto& substream_data_for_id = substream_id_to_substream_data[substream_id];
-    substream_data_for_id = {
-        substream_id,
-        /*samples_obu=*/{},
-        /*samples_encode=*/{},
-        /*output_gains_linear=*/{},
-        /*num_samples_to_trim_at_end=*/0,
-        /*num_samples_to_trim_at_start=*/encoder_required_samples_to_delay};
-
-    PadSamples(encoder_required_samples_to_delay, labels.size(),
-               substream_data_for_id.samples_obu);
+    // introduced by the encoder. The queues hold at most the delay, the frame
+    // being encoded and the next frame.
+    const size_t queue_capacity =
+        encoder_required_samples_to_delay + 2 * num_samples_per_frame;
+    auto& substream_data_for_id = substream_data.emplace_back(SubstreamData{
+        .substream_id = substream_id,
+        .samples_obu = SampleRingBuffer(num_channels, queue_capacity),
+        .samples_encode = SampleRingBuffer(num_channels, queue_capacity),
+        .num_samples_to_trim_at_end = 0,
+        .num_samples_to_trim_at_start = encoder_required_samples_to_delay});
+
+    substream_data_for_id.samples_obu.PushZeros(
+        encoder_required_samples_to_delay);
   }
 
   return absl::OkStatus();
@@ -243,8 +290,7 @@ absl::Status DownMixSamples(const DecodedUleb128 audio_element_id,
                             const DemixingModule& demixing_module,
                             LabelSamplesMap& label_to_samples,
                             ParametersManager& parameters_manager,
-                            absl::flat_hash_map<uint32_t, SubstreamData>&
-                                substream_id_to_substream_data,
+                            absl::Span<SubstreamData> substream_data,
                             DownMixingParams& down_mixing_params) {
   RETURN_IF_NOT_OK(parameters_manager.GetDownMixingParameters(
       audio_element_id, down_mixing_params));
@@ -260,57 +306,49 @@ absl::Status DownMixSamples(const DecodedUleb128 audio_element_id,
   // generate intermediate channels (e.g. L3 on the way of down-mixing L7 to L2)
   // and expand `label_to_samples`.
   RETURN_IF_NOT_OK(demixing_module.DownMixSamplesToSubstreams(
-      audio_element_id, down_mixing_params, label_to_samples,
-      substream_id_to_substream_data));
+      audio_element_id, down_mixing_params, label_to_samples, substream_data));
 
   return absl::OkStatus();
 }
 
-// Gets the next frame of samples for all streams, either from "real" samples
-// read from a file or from padding.
+// Gets the next frame of samples for all streams of an audio element, either
+// from "real" samples read from a file or from padding. `trimming_states`
+// holds the trimming state of each substream in `substreams_data`.
 absl::Status GetNextFrameSubstreamData(
     const DecodedUleb128 audio_element_id,
     const DemixingModule& demixing_module, const size_t num_samples_per_frame,
-    const SubstreamIdLabelsMap& substream_id_to_labels,
-    const absl::flat_hash_map<uint32_t, AudioFrameGenerator::TrimmingState>&
-        substream_id_to_trimming_state,
+    absl::Span<const AudioFrameGenerator::TrimmingState> trimming_states,
     LabelSamplesMap& label_to_samples, ParametersManager& parameters_manager,
-    absl::flat_hash_map<uint32_t, SubstreamData>&
-        substream_id_to_substream_data,
+    absl::Span<SubstreamData> substreams_data,
     DownMixingParams& down_mixing_params) {
   const bool no_sample_added =
       (label_to_samples.empty() ||
        std::all_of(label_to_samples.begin(), label_to_samples.end(),
                    [](const auto& entry) { return entry.second.empty(); }));
   if (no_sample_added &&
-      (substream_id_to_substream_data.empty() ||
-       std::all_of(substream_id_to_substream_data.begin(),
-                   substream_id_to_substream_data.end(), [](const auto& entry) {
-                     return entry.second.samples_obu.empty();
-                   }))) {
+      std::all_of(substreams_data.begin(), substreams_data.end(),
+                  [](const SubstreamData& substream_data) {
+                    return substream_data.samples_obu.empty();
+                  })) {
     return absl::OkStatus();
   }
 
-  RETURN_IF_NOT_OK(DownMixSamples(
-      audio_element_id, demixing_module, label_to_samples, parameters_manager,
-      substream_id_to_substream_data, down_mixing_params));
+  RETURN_IF_NOT_OK(DownMixSamples(audio_element_id, demixing_module,
+                                  label_to_samples, parameters_manager,
+                                  substreams_data, down_mixing_params));
 
   // Padding.
-  for (const auto& [substream_id, unused_labels] : substream_id_to_labels) {
-    auto& substream_data = substream_id_to_substream_data.at(substream_id);
-    const int num_channels = substream_data.samples_obu.front().size();
+  for (size_t i = 0; i < substreams_data.size(); ++i) {
+    auto& substream_data = substreams_data[i];
     if (substream_data.samples_obu.size() < num_samples_per_frame) {
       uint32_t num_samples_to_pad_at_end;
       RETURN_IF_NOT_OK(GetNumSamplesToPadAtEndAndValidate(
           num_samples_per_frame - substream_data.samples_obu.size(),
-          substream_id_to_trimming_state.at(substream_id)
-              .user_samples_left_to_trim_at_end,
+          trimming_states[i].user_samples_left_to_trim_at_end,
           num_samples_to_pad_at_end));
 
-      PadSamples(num_samples_to_pad_at_end, num_channels,
-                 substream_data.samples_obu);
-      PadSamples(num_samples_to_pad_at_end, num_channels,
-                 substream_data.samples_encode);
+      substream_data.samples_obu.PushZeros(num_samples_to_pad_at_end);
+      substream_data.samples_encode.PushZeros(num_samples_to_pad_at_end);
 
       // Record the number of padded samples to be trimmed later.
       substream_data.num_samples_to_trim_at_end = num_samples_to_pad_at_end;
@@ -326,8 +364,7 @@ absl::Status GetNextFrameSubstreamData(
       // need to be added. These samples will be "left in" the decoder
       // after all OBUs are processed, but they should not count as being
       // trimmed.
-      PadSamples(num_samples_to_pad, num_channels,
-                 substream_data.samples_encode);
+      substream_data.samples_encode.PushZeros(num_samples_to_pad);
     }
   }
 
@@ -351,17 +388,26 @@ std::pair<uint32_t, uint32_t> GetNumSamplesToTrimForFrame(
 }
 
 absl::Status EncodeFramesForAudioElement(
-    const DecodedUleb128 audio_element_id,
-    const AudioElementWithData& audio_element_with_data,
-    const DemixingModule& demixing_module, LabelSamplesMap& label_to_samples,
-    const absl::flat_hash_map<uint32_t, AudioFrameGenerator::TrimmingState>&
-        substream_id_to_trimming_state,
+    AudioFrameGenerator::AudioElementState& audio_element_state,
+    const DemixingModule& demixing_module,
     ParametersManager& parameters_manager,
-    absl::flat_hash_map<uint32_t, std::unique_ptr<EncoderBase>>&
-        substream_id_to_encoder,
-    absl::flat_hash_map<uint32_t, SubstreamData>&
-        substream_id_to_substream_data,
+    std::vector<AudioFrameGenerator::EncoderVariant>& encoder_variants,
+    std::vector<SubstreamData>& substream_data_by_index,
+    const std::vector<bool>& substreams_taking_samples,
+    const std::vector<size_t>& substream_timing_indices,
     GlobalTimingModule& global_timing_module) {
+  const DecodedUleb128 audio_element_id = audio_element_state.audio_element_id;
+  const AudioElementWithData& audio_element_with_data =
+      *audio_element_state.audio_element_with_data;
+  LabelSamplesMap& label_to_samples = audio_element_state.labeled_samples;
+  const size_t first_substream_index =
+      audio_element_state.first_substream_index;
+  const auto audio_element_substream_data =
+      absl::MakeSpan(substream_data_by_index)
+          .subspan(first_substream_index, audio_element_state.num_substreams);
+  const auto trimming_states =
+      absl::MakeConstSpan(encoder_variants.front().trimming_states)
+          .subspan(first_substream_index, audio_element_state.num_substreams);
   const CodecConfigObu& codec_config = *audio_element_with_data.codec_config;
 
   // Get some common information about this stream.
@@ -401,16 +447,17 @@ absl::Status EncodeFramesForAudioElement(
   do {
     RETURN_IF_NOT_OK(GetNextFrameSubstreamData(
         audio_element_id, demixing_module, num_samples_per_frame,
-        audio_element_with_data.substream_id_to_labels,
-        substream_id_to_trimming_state, label_to_samples, parameters_manager,
-        substream_id_to_substream_data, down_mixing_params));
+        trimming_states, label_to_samples, parameters_manager,
+        audio_element_substream_data, down_mixing_params));
 
     more_samples_to_encode = false;
-    for (const auto& [substream_id, labels] :
-         audio_element_with_data.substream_id_to_labels) {
-      auto substream_data_iter =
-          substream_id_to_substream_data.find(substream_id);
-      if (substream_data_iter == substream_id_to_substream_data.end()) {
+    for (size_t substream_index = first_substream_index;
+         substream_index <
+         first_substream_index + audio_element_state.num_substreams;
+         ++substream_index) {
+      auto& substream_data = substream_data_by_index[substream_index];
+      const uint32_t substream_id = substream_data.substream_id;
+      if (!substreams_taking_samples[substream_index]) {
         if (more_samples_to_encode) {
           return absl::InvalidArgumentError(
               absl::StrCat("Within Audio Element ID= ", audio_element_id,
@@ -421,11 +468,12 @@ absl::Status EncodeFramesForAudioElement(
       }
       more_samples_to_encode = true;
 
-      auto& substream_data = substream_data_iter->second;
-      // Encode.
-      auto& encoder = substream_id_to_encoder.at(substream_id);
+      // Encode. All variants use the same codec, so they agree on whether
+      // partial frames are supported.
       if (substream_data.samples_encode.size() < num_samples_per_frame &&
-          !encoder->supports_partial_frames_) {
+          !encoder_variants.front()
+               .encoders[substream_index]
+               ->supports_partial_frames_) {
         // To support negative test-cases technically some encoders (such as
         // LPCM) can encode partial frames. For other encoders wait until there
         // is a whole frame of samples to encode.
@@ -445,13 +493,20 @@ absl::Status EncodeFramesForAudioElement(
       const size_t num_samples_to_encode =
           std::min(static_cast<size_t>(num_samples_per_frame),
                    substream_data.samples_encode.size());
-      std::vector<std::vector<int32_t>> samples_encode(num_samples_to_encode);
-      std::vector<std::vector<int32_t>> samples_obu(num_samples_to_encode);
-
-      MoveSamples(num_samples_to_encode, substream_data.samples_obu,
-                  samples_obu);
-      MoveSamples(num_samples_to_encode, substream_data.samples_encode,
-                  samples_encode);
+      auto& samples_obu = substream_data.frame_for_obu;
+      if (samples_obu == nullptr || samples_obu.use_count() > 1) {
+        // Audio frames still refer to the previous samples.
+        samples_obu = std::make_shared<std::vector<std::vector<int32_t>>>();
+      } else {
+        // Pairs with the release of the last reference held by an audio frame,
+        // which may have been on another thread.
+        std::atomic_thread_fence(std::memory_order_acquire);
+      }
+      RETURN_IF_NOT_OK(substream_data.samples_obu.PopTicks(
+          num_samples_to_encode, *samples_obu));
+      auto& samples_encode = substream_data.frame_to_encode;
+      RETURN_IF_NOT_OK(substream_data.samples_encode.PopTicks(
+          num_samples_to_encode, samples_encode));
       const auto [frame_samples_to_trim_at_start,
                   frame_samples_to_trim_at_end] =
           GetNumSamplesToTrimForFrame(
@@ -462,8 +517,9 @@ absl::Status EncodeFramesForAudioElement(
       // Both timestamps cover trimmed and regular samples.
       int32_t start_timestamp;
       int32_t end_timestamp;
-      RETURN_IF_NOT_OK(global_timing_module.GetNextAudioFrameTimestamps(
-          substream_id, samples_obu.size(), start_timestamp, end_timestamp));
+      RETURN_IF_NOT_OK(global_timing_module.GetNextAudioFrameTimestampsForIndex(
+          substream_timing_indices[substream_index], num_samples_to_encode,
+          start_timestamp, end_timestamp));
 
       if (encoded_timestamp.has_value()) {
         // All frames corresponding to the same Audio Element should have
@@ -471,28 +527,32 @@ absl::Status EncodeFramesForAudioElement(
         CHECK_EQ(*encoded_timestamp, start_timestamp);
       }
 
-      auto partial_audio_frame_with_data =
-          absl::WrapUnique(new AudioFrameWithData{
-              .obu = AudioFrameObu(
-                  {
-                      .obu_trimming_status_flag =
-                          (frame_samples_to_trim_at_end != 0 ||
-                           frame_samples_to_trim_at_start != 0),
-                      .num_samples_to_trim_at_end =
-                          frame_samples_to_trim_at_end,
-                      .num_samples_to_trim_at_start =
-                          frame_samples_to_trim_at_start,
-                  },
-                  substream_id, {}),
-              .start_timestamp = start_timestamp,
-              .end_timestamp = end_timestamp,
-              .raw_samples = samples_obu,
-              .down_mixing_params = down_mixing_params,
-              .audio_element_with_data = &audio_element_with_data});
-
-      RETURN_IF_NOT_OK(
-          encoder->EncodeAudioFrame(encoder_input_pcm_bit_depth, samples_encode,
-                                    std::move(partial_audio_frame_with_data)));
+      const ObuHeader obu_header = {
+          .obu_trimming_status_flag = (frame_samples_to_trim_at_end != 0 ||
+                                       frame_samples_to_trim_at_start != 0),
+          .num_samples_to_trim_at_end = frame_samples_to_trim_at_end,
+          .num_samples_to_trim_at_start = frame_samples_to_trim_at_start,
+      };
+
+      // Every variant encodes the same samples into its own frame. The frames
+      // share one copy of the samples.
+      const uint32_t num_ticks = samples_obu->size();
+      for (size_t i = 0; i < encoder_variants.size(); ++i) {
+        auto partial_audio_frame_with_data =
+            absl::WrapUnique(new AudioFrameWithData{
+                .obu = AudioFrameObu(obu_header, substream_id, {}),
+                .start_timestamp = start_timestamp,
+                .end_timestamp = end_timestamp,
+                .raw_samples = samples_obu,
+                .num_ticks = num_ticks,
+                .down_mixing_params = down_mixing_params,
+                .audio_element_with_data = &audio_element_with_data});
+        RETURN_IF_NOT_OK(
+            encoder_variants[i]
+                .encoders[substream_index]
+                ->EncodeAudioFrame(encoder_input_pcm_bit_depth, samples_encode,
+                                   std::move(partial_audio_frame_with_data)));
+      }
       encoded_timestamp = start_timestamp;
     }
 
@@ -589,14 +649,14 @@ absl::Status ValidateAndApplyUserTrimming(
     AudioFrameGenerator::TrimmingState& trimming_state,
     AudioFrameWithData& audio_frame) {
   RETURN_IF_NOT_OK(ApplyUserTrimForFrame(
-      /*from_start=*/true, audio_frame.raw_samples.size(),
+      /*from_start=*/true, audio_frame.num_ticks,
       trimming_state.user_samples_left_to_trim_at_start,
       audio_frame.obu.header_.num_samples_to_trim_at_start,
       audio_frame.obu.header_.obu_trimming_status_flag));
 
   if (is_last_frame) {
     RETURN_IF_NOT_OK(ApplyUserTrimForFrame(
-        /*from_start=*/false, audio_frame.raw_samples.size(),
+        /*from_start=*/false, audio_frame.num_ticks,
         trimming_state.user_samples_left_to_trim_at_end,
         audio_frame.obu.header_.num_samples_to_trim_at_end,
         audio_frame.obu.header_.obu_trimming_status_flag));
@@ -625,11 +685,13 @@ absl::Status AudioFrameGenerator::Initialize() {
   for (const auto& [audio_element_id, audio_frame_metadata] :
        audio_frame_metadata_) {
     absl::MutexLock lock(&mutex_);
+    AudioElementState audio_element_state = {
+        .audio_element_id = audio_element_id,
+        .first_substream_index = substream_data_.size()};
 
     // Precompute the `ChannelLabel::Label` for each channel label string.
     RETURN_IF_NOT_OK(ChannelLabel::FillLabelsFromStrings(
-        audio_frame_metadata.channel_labels(),
-        audio_element_id_to_labels_[audio_element_id]));
+        audio_frame_metadata.channel_labels(), audio_element_state.labels));
 
     // Find the Codec Config OBU for this mono or coupled stereo substream.
     const auto audio_elements_iter = audio_elements_.find(audio_element_id);
@@ -637,20 +699,55 @@ absl::Status AudioFrameGenerator::Initialize() {
       return absl::InvalidArgumentError(absl::StrCat(
           "Audio Element with ID= ", audio_element_id, " not found"));
     }
-
-    // Create an encoder for each substream.
     const AudioElementWithData& audio_element_with_data =
         audio_elements_iter->second;
-    RETURN_IF_NOT_OK(GetEncodingDataAndInitializeEncoders(
-        codec_config_metadata_, audio_element_with_data,
-        substream_id_to_encoder_));
+    audio_element_state.audio_element_with_data = &audio_element_with_data;
+
+    // The substreams of this audio element take the next indices.
+    std::vector<uint32_t> substream_ids;
+    substream_ids.reserve(
+        audio_element_with_data.substream_id_to_labels.size());
+    for (const auto& [substream_id, unused_labels] :
+         audio_element_with_data.substream_id_to_labels) {
+      substream_ids.push_back(substream_id);
+    }
+    audio_element_state.num_substreams = substream_ids.size();
+
+    // Create an encoder for each substream and each variant.
+    std::vector<uint32_t> substream_delays;
+    for (auto& encoder_variant : encoder_variants_) {
+      std::vector<uint32_t> variant_substream_delays;
+      RETURN_IF_NOT_OK(GetEncodingDataAndInitializeEncoders(
+          audio_element_with_data, substream_ids, encoder_variant,
+          variant_substream_delays));
+
+      // The samples are padded for the delay once and shared by all variants.
+      if (&encoder_variant == &encoder_variants_.front()) {
+        substream_delays = std::move(variant_substream_delays);
+      } else if (variant_substream_delays != substream_delays) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Encoder variants must delay the same number of samples as the "
+            "main encoders for Audio Element ID= ",
+            audio_element_id));
+      }
+    }
 
     // Intermediate data for all substreams belonging to an Audio Element.
-    RETURN_IF_NOT_OK(
-        InitializeSubstreamData(audio_element_with_data.substream_id_to_labels,
-                                substream_id_to_encoder_,
-                                audio_frame_metadata.samples_to_trim_at_start(),
-                                substream_id_to_substream_data_));
+    RETURN_IF_NOT_OK(InitializeSubstreamData(
+        audio_element_with_data.substream_id_to_labels, substream_ids,
+        substream_delays,
+        audio_element_with_data.codec_config->GetNumSamplesPerFrame(),
+        audio_frame_metadata.samples_to_trim_at_start(), substream_data_));
+    for (const uint32_t substream_id : substream_ids) {
+      // Unknown substreams are reported when their first frame is timed.
+      const auto timing_index =
+          global_timing_module_.GetAudioSubstreamIndex(substream_id);
+      substream_timing_indices_.push_back(
+          timing_index.ok() ? *timing_index
+                            : std::numeric_limits<size_t>::max());
+      substreams_taking_samples_.push_back(true);
+      ++num_substreams_taking_samples_;
+    }
 
     // Validate that a `DemixingParamDefinition` is available if down-mixing
     // is needed.
@@ -670,52 +767,51 @@ absl::Status AudioFrameGenerator::Initialize() {
         audio_frame_metadata, common_samples_to_trim_at_start,
         common_samples_to_trim_at_end));
 
-    // Populate the map of trimming states with all substream ID.
-    for (const auto& [substream_id, labels] :
-         audio_element_with_data.substream_id_to_labels) {
-      substream_id_to_trimming_state_[substream_id] = {
-          .user_samples_left_to_trim_at_end = common_samples_to_trim_at_end,
-          .user_samples_left_to_trim_at_start = common_samples_to_trim_at_start,
-      };
+    // Populate the trimming states of all substreams.
+    for (auto& encoder_variant : encoder_variants_) {
+      encoder_variant.trimming_states.insert(
+          encoder_variant.trimming_states.end(), substream_ids.size(),
+          {.user_samples_left_to_trim_at_end = common_samples_to_trim_at_end,
+           .user_samples_left_to_trim_at_start =
+               common_samples_to_trim_at_start});
+      encoder_variant.num_unfinished_encoders += substream_ids.size();
     }
+
+    audio_element_indices_[audio_element_id] = audio_element_states_.size();
+    audio_element_states_.push_back(std::move(audio_element_state));
   }
 
   return absl::OkStatus();
 }
 
 bool AudioFrameGenerator::TakingSamples() const {
-  return !substream_id_to_substream_data_.empty();
+  absl::MutexLock lock(&mutex_);
+  return num_substreams_taking_samples_ > 0;
 }
 
 absl::Status AudioFrameGenerator::AddSamples(
     const DecodedUleb128 audio_element_id, ChannelLabel::Label label,
     const std::vector<int32_t>& samples) {
-  const auto& audio_element_labels =
-      audio_element_id_to_labels_.find(audio_element_id);
-  if (audio_element_labels == audio_element_id_to_labels_.end()) {
+  const auto audio_element_index_iter =
+      audio_element_indices_.find(audio_element_id);
+  if (audio_element_index_iter == audio_element_indices_.end()) {
     return absl::InvalidArgumentError(
         absl::StrCat("No audio frame metadata found for Audio Element ID= ",
                      audio_element_id));
   }
+  auto& audio_element_state =
+      audio_element_states_[audio_element_index_iter->second];
 
-  auto& labeled_samples = id_to_labeled_samples_[audio_element_id];
+  auto& labeled_samples = audio_element_state.labeled_samples;
   labeled_samples[label] = samples;
 
-  const auto audio_element_iter = audio_elements_.find(audio_element_id);
-  if (audio_element_iter == audio_elements_.end()) {
-    return absl::InvalidArgumentError(
-        absl::StrCat("No Audio Element found for ID= ", audio_element_id));
-  }
-  const auto& audio_element_with_data = audio_element_iter->second;
-
   if (SamplesReadyForAudioElement(labeled_samples,
-                                  audio_element_labels->second)) {
+                                  audio_element_state.labels)) {
     absl::MutexLock lock(&mutex_);
     RETURN_IF_NOT_OK(EncodeFramesForAudioElement(
-        audio_element_id, audio_element_with_data, demixing_module_,
-        labeled_samples, substream_id_to_trimming_state_, parameters_manager_,
-        substream_id_to_encoder_, substream_id_to_substream_data_,
-        global_timing_module_));
+        audio_element_state, demixing_module_, parameters_manager_,
+        encoder_variants_, substream_data_, substreams_taking_samples_,
+        substream_timing_indices_, global_timing_module_));
 
     labeled_samples.clear();
   }
@@ -725,19 +821,20 @@ absl::Status AudioFrameGenerator::AddSamples(
 
 absl::Status AudioFrameGenerator::Finalize() {
   absl::MutexLock lock(&mutex_);
-  for (auto& [substream_id, encoder] : substream_id_to_encoder_) {
-    auto substream_data_iter =
-        substream_id_to_substream_data_.find(substream_id);
-    if (substream_data_iter == substream_id_to_substream_data_.end()) {
+  for (size_t substream_index = 0; substream_index < substream_data_.size();
+       ++substream_index) {
+    // Stop taking samples when there is no more sample to come, and the
+    // encoders can be finalized.
+    if (!substreams_taking_samples_[substream_index] ||
+        !substream_data_[substream_index].samples_obu.empty()) {
       continue;
     }
 
-    // Remove the substream data when there is no more sample to come, and the
-    // encoder can be finalized.
-    if (substream_data_iter->second.samples_obu.empty()) {
-      RETURN_IF_NOT_OK(encoder->Finalize());
-      substream_id_to_substream_data_.erase(substream_data_iter);
+    for (auto& encoder_variant : encoder_variants_) {
+      RETURN_IF_NOT_OK(encoder_variant.encoders[substream_index]->Finalize());
     }
+    substreams_taking_samples_[substream_index] = false;
+    --num_substreams_taking_samples_;
   }
 
   return absl::OkStatus();
@@ -745,29 +842,81 @@ absl::Status AudioFrameGenerator::Finalize() {
 
 bool AudioFrameGenerator::GeneratingFrames() const {
   absl::MutexLock lock(&mutex_);
-  return !substream_id_to_encoder_.empty();
+  return std::any_of(encoder_variants_.begin(), encoder_variants_.end(),
+                     [](const EncoderVariant& encoder_variant) {
+                       return encoder_variant.num_unfinished_encoders > 0;
+                     });
 }
 
 absl::Status AudioFrameGenerator::OutputFrames(
     std::list<AudioFrameWithData>& audio_frames) {
+  RETURN_IF_NOT_OK(WaitUntilEncodersAreIdle(0));
   absl::MutexLock lock(&mutex_);
+  return OutputFramesForEncoderVariant(0, audio_frames);
+}
+
+absl::Status AudioFrameGenerator::OutputVariantFrames(
+    int variant_index, std::list<AudioFrameWithData>& audio_frames) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (variant_index < 0 ||
+        static_cast<size_t>(variant_index) + 1 >= encoder_variants_.size()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unknown encoder variant index= ", variant_index));
+    }
+  }
+  RETURN_IF_NOT_OK(WaitUntilEncodersAreIdle(variant_index + 1));
+  absl::MutexLock lock(&mutex_);
+  return OutputFramesForEncoderVariant(variant_index + 1, audio_frames);
+}
+
+absl::Status AudioFrameGenerator::WaitUntilEncodersAreIdle(
+    size_t encoder_variant_index) {
+  for (size_t substream_index = 0;; ++substream_index) {
+    EncoderBase* encoder;
+    {
+      absl::MutexLock lock(&mutex_);
+      const auto& encoders = encoder_variants_[encoder_variant_index].encoders;
+      if (substream_index >= encoders.size()) {
+        return absl::OkStatus();
+      }
+      encoder = encoders[substream_index].get();
+    }
+
+    // Asynchronous encoders may still be working on the latest frame. Wait
+    // without holding the lock, so a slow encoder does not block other
+    // substreams from being fed. Encoders are only released when outputting
+    // frames for this variant, which is not done concurrently.
+    if (encoder != nullptr) {
+      RETURN_IF_NOT_OK(encoder->WaitUntilIdle());
+    }
+  }
+}
+
+absl::Status AudioFrameGenerator::OutputFramesForEncoderVariant(
+    size_t encoder_variant_index, std::list<AudioFrameWithData>& audio_frames) {
+  auto& encoder_variant = encoder_variants_[encoder_variant_index];
+  for (size_t substream_index = 0;
+       substream_index < encoder_variant.encoders.size(); ++substream_index) {
+    auto& encoder = encoder_variant.encoders[substream_index];
+    if (encoder == nullptr) {
+      // Already finished, so there is nothing to output.
+      continue;
+    }
 
-  for (auto substream_id_to_encoder_iter = substream_id_to_encoder_.begin();
-       substream_id_to_encoder_iter != substream_id_to_encoder_.end();) {
-    auto& [substream_id, encoder] = *substream_id_to_encoder_iter;
     if (encoder->FramesAvailable()) {
       RETURN_IF_NOT_OK(encoder->Pop(audio_frames));
       RETURN_IF_NOT_OK(ValidateAndApplyUserTrimming(
-          substream_id, /*is_last_frame=*/encoder->Finished(),
-          substream_id_to_trimming_state_.at(substream_id),
+          substream_data_[substream_index].substream_id,
+          /*is_last_frame=*/encoder->Finished(),
+          encoder_variant.trimming_states[substream_index],
           audio_frames.back()));
     }
 
-    // Remove finished encoder or advance the iterator.
+    // Release the finished encoder.
     if (encoder->Finished()) {
-      substream_id_to_encoder_.erase(substream_id_to_encoder_iter++);
-    } else {
-      ++substream_id_to_encoder_iter;
+      encoder.reset();
+      --encoder_variant.num_unfinished_encoders;
     }
   }
 
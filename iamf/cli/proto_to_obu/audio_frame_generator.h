@@ -13,6 +13,7 @@
 #ifndef CLI_PROTO_TO_OBU_AUDIO_FRAME_GENERATOR_H_
 #define CLI_PROTO_TO_OBU_AUDIO_FRAME_GENERATOR_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -68,6 +69,43 @@ class AudioFrameGenerator {
     int64_t user_samples_left_to_trim_at_start;
   };
 
+  /*!\brief State of an audio element which has audio frame metadata. */
+  struct AudioElementState {
+    DecodedUleb128 audio_element_id;
+    const AudioElementWithData* audio_element_with_data;
+
+    // Labels of the input channels.
+    absl::flat_hash_set<ChannelLabel::Label> labels;
+
+    // Samples added since the last frame was encoded.
+    LabelSamplesMap labeled_samples;
+
+    // The substreams of the audio element have contiguous indices.
+    size_t first_substream_index;
+    size_t num_substreams;
+  };
+
+  /*!\brief Encoders for one set of encoder settings and their output state.
+   *
+   * Per-substream state is stored at the dense substream indices assigned in
+   * `Initialize()`.
+   */
+  struct EncoderVariant {
+    // Mapping from Codec Config ID to additional codec config metadata used
+    // to configure encoders.
+    absl::flat_hash_map<DecodedUleb128, iamf_tools_cli_proto::CodecConfig>
+        codec_config_metadata;
+
+    // Encoder of each substream. Finished encoders are released.
+    std::vector<std::unique_ptr<EncoderBase>> encoders;
+
+    // Trimming state of each substream.
+    std::vector<TrimmingState> trimming_states;
+
+    // Number of encoders which have not finished.
+    size_t num_unfinished_encoders = 0;
+  };
+
   /*!\brief Constructor.
    *
    * \param audio_frame_metadata Input audio frame metadata.
@@ -76,6 +114,8 @@ class AudioFrameGenerator {
    * \param demixing_module Demixng module.
    * \param parameters_manager Manager of parameters.
    * \param global_timing_module Global Timing Module.
+   * \param encoder_variant_metadata Alternative encoder settings. Each variant
+   *     encodes the same down-mixed samples and outputs its own frames.
    */
   AudioFrameGenerator(
       const ::google::protobuf::RepeatedPtrField<
@@ -86,7 +126,10 @@ class AudioFrameGenerator {
           audio_elements,
       const DemixingModule& demixing_module,
       ParametersManager& parameters_manager,
-      GlobalTimingModule& global_timing_module)
+      GlobalTimingModule& global_timing_module,
+      const ::google::protobuf::RepeatedPtrField<
+          iamf_tools_cli_proto::EncoderVariantMetadata>&
+          encoder_variant_metadata = {})
       : audio_elements_(audio_elements),
         demixing_module_(demixing_module),
         parameters_manager_(parameters_manager),
@@ -96,13 +139,32 @@ class AudioFrameGenerator {
           audio_frame_obu_metadata;
     }
 
+    absl::MutexLock lock(&mutex_);
+    encoder_variants_.resize(1 + encoder_variant_metadata.size());
     for (const auto& codec_config_obu_metadata : codec_config_metadata) {
-      codec_config_metadata_[codec_config_obu_metadata.codec_config_id()] =
+      encoder_variants_.front()
+          .codec_config_metadata[codec_config_obu_metadata.codec_config_id()] =
           codec_config_obu_metadata.codec_config();
     }
+
+    // Variants start from the main settings and replace some of them.
+    for (int i = 0; i < encoder_variant_metadata.size(); ++i) {
+      auto& variant_codec_config_metadata =
+          encoder_variants_[i + 1].codec_config_metadata;
+      variant_codec_config_metadata =
+          encoder_variants_.front().codec_config_metadata;
+      for (const auto& codec_config_obu_metadata :
+           encoder_variant_metadata[i].codec_config_metadata()) {
+        variant_codec_config_metadata[codec_config_obu_metadata
+                                          .codec_config_id()] =
+            codec_config_obu_metadata.codec_config();
+      }
+    }
   }
 
   /*!\brief Returns the number of samples to delay based on the codec config.
+   *
+   * Initializes a bare single-channel encoder to find the delay.
    *
    * \param codec_config_metadata Codec config metadata.
    * \param codec_config Codec config.
@@ -114,6 +176,9 @@ class AudioFrameGenerator {
       const CodecConfigObu& codec_config);
 
   /*!\brief Initializes encoders and relevant data structures.
+   *
+   * The encoders of every variant must delay the same number of samples as the
+   * main encoders.
    *
    * \return `absl::OkStatus()` on success. A specific status on failure.
    */
@@ -159,45 +224,74 @@ class AudioFrameGenerator {
   /*!\brief Outputs a list of generated Audio Frame OBUs (and associated data).
    *
    * The output frames all belong to the same temporal unit, sharing the same
-   * start and end timestamps.
+   * start and end timestamps. Waits for asynchronous encoders to finish the
+   * frames they were given. This must not be called concurrently with itself.
    *
    * \param audio_frames Output list of audio frames.
    * \return `absl::OkStatus()` on success. A specific status on failure.
    */
   absl::Status OutputFrames(std::list<AudioFrameWithData>& audio_frames);
 
+  /*!\brief Outputs a list of Audio Frame OBUs generated by a variant.
+   *
+   * Behaves like `OutputFrames()`, for the encoders of one of the variants.
+   * This must not be called concurrently for the same variant.
+   *
+   * \param variant_index Index of the variant in `encoder_variant_metadata`.
+   * \param audio_frames Output list of audio frames.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status OutputVariantFrames(int variant_index,
+                                   std::list<AudioFrameWithData>& audio_frames);
+
  private:
+  /*!\brief Outputs the frames of the encoders at an index.
+   *
+   * \param encoder_variant_index Index in `encoder_variants_`.
+   * \param audio_frames Output list of audio frames.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status OutputFramesForEncoderVariant(
+      size_t encoder_variant_index, std::list<AudioFrameWithData>& audio_frames)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /*!\brief Waits until the encoders at an index have processed their input.
+   *
+   * \param encoder_variant_index Index in `encoder_variants_`.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status WaitUntilEncodersAreIdle(size_t encoder_variant_index)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
   // Mapping from Audio Element ID to audio frame metadata.
   absl::flat_hash_map<DecodedUleb128,
                       iamf_tools_cli_proto::AudioFrameObuMetadata>
       audio_frame_metadata_;
 
-  // Mapping from Audio Element ID to labels.
-  absl::flat_hash_map<DecodedUleb128, absl::flat_hash_set<ChannelLabel::Label>>
-      audio_element_id_to_labels_;
-
   // Mapping from Audio Element ID to audio element data.
   const absl::flat_hash_map<DecodedUleb128, AudioElementWithData>&
       audio_elements_;
 
-  // Mapping from Codec Config ID to additional codec config metadata used
-  // to configure encoders.
-  absl::flat_hash_map<DecodedUleb128, iamf_tools_cli_proto::CodecConfig>
-      codec_config_metadata_;
+  // IDs are mapped to dense indices in `Initialize()`, so the state used for
+  // every frame is stored in vectors rather than looked up by ID.
+
+  // Mapping from Audio Element ID to its index in `audio_element_states_`.
+  absl::flat_hash_map<DecodedUleb128, size_t> audio_element_indices_;
+  std::vector<AudioElementState> audio_element_states_;
 
-  // Mapping from audio substream IDs to encoders.
-  absl::flat_hash_map<uint32_t, std::unique_ptr<EncoderBase>>
-      substream_id_to_encoder_ ABSL_GUARDED_BY(mutex_);
+  // Encoders for the main settings, followed by those of each variant.
+  std::vector<EncoderVariant> encoder_variants_ ABSL_GUARDED_BY(mutex_);
 
-  // Mapping from Audio Element ID to labeled samples.
-  absl::flat_hash_map<DecodedUleb128, LabelSamplesMap> id_to_labeled_samples_;
+  // Data of each substream.
+  std::vector<SubstreamData> substream_data_ ABSL_GUARDED_BY(mutex_);
 
-  // Mapping from substream IDs to substream data.
-  absl::flat_hash_map<uint32_t, SubstreamData> substream_id_to_substream_data_;
+  // Index of each substream in the Global Timing Module.
+  std::vector<size_t> substream_timing_indices_;
 
-  // Mapping from substream IDs to trimming states.
-  absl::flat_hash_map<uint32_t, TrimmingState> substream_id_to_trimming_state_
-      ABSL_GUARDED_BY(mutex_);
+  // Whether each substream is still taking samples. Cleared once all of its
+  // samples have been passed to the encoders.
+  std::vector<bool> substreams_taking_samples_ ABSL_GUARDED_BY(mutex_);
+  size_t num_substreams_taking_samples_ ABSL_GUARDED_BY(mutex_) = 0;
 
   const DemixingModule& demixing_module_;
   ParametersManager& parameters_manager_;
@@ -12,6 +12,7 @@
 #include "iamf/cli/proto_to_obu/audio_frame_generator.h"
 
 #include <cstdint>
+#include <filesystem>
 #include <list>
 #include <string>
 #include <utility>
@@ -484,6 +485,128 @@ TEST(AudioFrameGenerator, OneStereoSubstreamTwoFrames) {
   ValidateAudioFrames(audio_frames, expected_audio_frames);
 }
 
+TEST(AudioFrameGenerator, AsyncEncoderOutputsTheSameFrames) {
+  iamf_tools_cli_proto::UserMetadata user_metadata = {};
+  ConfigureOneStereoSubstreamLittleEndian(user_metadata);
+  auto& codec_config =
+      *user_metadata.mutable_codec_config_metadata(0)->mutable_codec_config();
+  codec_config.set_num_samples_per_frame(4);
+  codec_config.set_use_async_encoder(true);
+
+  std::list<AudioFrameWithData> expected_audio_frames = {};
+  expected_audio_frames.push_back(
+      {.obu = AudioFrameObu(
+           ObuHeader(), 0,
+           {1, 0, 255, 255, 2, 0, 254, 255, 3, 0, 253, 255, 4, 0, 252, 255}),
+       .start_timestamp = 0,
+       .end_timestamp = 4,
+       .down_mixing_params = {.in_bitstream = false}});
+  expected_audio_frames.push_back(
+      {.obu = AudioFrameObu(
+           ObuHeader(), 0,
+           {5, 0, 251, 255, 6, 0, 250, 255, 7, 0, 249, 255, 8, 0, 248, 255}),
+       .start_timestamp = 4,
+       .end_timestamp = 8,
+       .down_mixing_params = {.in_bitstream = false}});
+
+  std::list<AudioFrameWithData> audio_frames;
+  GenerateAudioFrameWithEightSamples(user_metadata, audio_frames);
+  ValidateAudioFrames(audio_frames, expected_audio_frames);
+}
+
+TEST(AudioFrameGenerator, EncodedFrameCacheOutputsTheSameFrames) {
+  iamf_tools_cli_proto::UserMetadata user_metadata = {};
+  ConfigureOneStereoSubstreamLittleEndian(user_metadata);
+  auto& codec_config =
+      *user_metadata.mutable_codec_config_metadata(0)->mutable_codec_config();
+  codec_config.set_num_samples_per_frame(4);
+  const auto cache_directory = std::filesystem::path(::testing::TempDir()) /
+                               "audio_frame_generator_encoded_frame_cache";
+  std::filesystem::remove_all(cache_directory);
+  codec_config.set_encoded_frame_cache_directory(cache_directory.string());
+
+  std::list<AudioFrameWithData> expected_audio_frames = {};
+  expected_audio_frames.push_back(
+      {.obu = AudioFrameObu(
+           ObuHeader(), 0,
+           {1, 0, 255, 255, 2, 0, 254, 255, 3, 0, 253, 255, 4, 0, 252, 255}),
+       .start_timestamp = 0,
+       .end_timestamp = 4,
+       .down_mixing_params = {.in_bitstream = false}});
+  expected_audio_frames.push_back(
+      {.obu = AudioFrameObu(
+           ObuHeader(), 0,
+           {5, 0, 251, 255, 6, 0, 250, 255, 7, 0, 249, 255, 8, 0, 248, 255}),
+       .start_timestamp = 4,
+       .end_timestamp = 8,
+       .down_mixing_params = {.in_bitstream = false}});
+
+  // The first run fills the cache. The second run reuses the frames.
+  for (int run = 0; run < 2; ++run) {
+    std::list<AudioFrameWithData> audio_frames;
+    GenerateAudioFrameWithEightSamples(user_metadata, audio_frames);
+    ValidateAudioFrames(audio_frames, expected_audio_frames);
+  }
+}
+
+TEST(AudioFrameGenerator,
+     EncodedFrameCacheSeparatesSubstreamsWithDifferentBitrateOverrides) {
+  iamf_tools_cli_proto::UserMetadata user_metadata = {};
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
+      R"pb(
+        codec_config_id: 200
+        codec_config {
+          codec_id: CODEC_ID_OPUS
+          num_samples_per_frame: 960
+          audio_roll_distance: -4
+          decoder_config_opus {
+            version: 1
+            pre_skip: 312
+            input_sample_rate: 48000
+            opus_encoder_metadata {
+              target_bitrate_per_channel: 48000
+              application: APPLICATION_AUDIO
+              substream_id_to_bitrate_override { key: 0 value: 6000 }
+              substream_id_to_bitrate_override { key: 1 value: 256000 }
+            }
+          }
+        }
+      )pb",
+      user_metadata.add_codec_config_metadata()));
+  AddStereoAudioElementAndAudioFrameMetadata(
+      user_metadata, kFirstAudioElementId, kFirstSubstreamId);
+  AddStereoAudioElementAndAudioFrameMetadata(
+      user_metadata, kSecondAudioElementId, kSecondSubstreamId);
+  for (auto& audio_frame_metadata :
+       *user_metadata.mutable_audio_frame_metadata()) {
+    // Trim the encoder delay and the padding in the only frame.
+    audio_frame_metadata.set_samples_to_trim_at_start(312);
+    audio_frame_metadata.set_samples_to_trim_at_end(640);
+  }
+
+  // Both substreams have the same input, but different bitrates.
+  std::list<AudioFrameWithData> expected_audio_frames;
+  GenerateAudioFrameWithEightSamples(user_metadata, expected_audio_frames);
+  ASSERT_EQ(expected_audio_frames.size(), 2);
+  EXPECT_NE(expected_audio_frames.front().obu.audio_frame_,
+            expected_audio_frames.back().obu.audio_frame_);
+
+  const auto cache_directory =
+      std::filesystem::path(::testing::TempDir()) /
+      "audio_frame_generator_encoded_frame_cache_bitrate_overrides";
+  std::filesystem::remove_all(cache_directory);
+  user_metadata.mutable_codec_config_metadata(0)
+      ->mutable_codec_config()
+      ->set_encoded_frame_cache_directory(cache_directory.string());
+
+  // The first run fills the cache. The second run reuses the frames.
+  for (int run = 0; run < 2; ++run) {
+    std::list<AudioFrameWithData> audio_frames;
+    GenerateAudioFrameWithEightSamples(user_metadata, audio_frames);
+    ValidateAudioFrames(audio_frames, expected_audio_frames);
+  }
+}
+
 TEST(AudioFrameGenerator, AllAudioElementsHaveMatchingTrimmingInformation) {
   iamf_tools_cli_proto::UserMetadata user_metadata = {};
   ConfigureOneStereoSubstreamLittleEndian(user_metadata);
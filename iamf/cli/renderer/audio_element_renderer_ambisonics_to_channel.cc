@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#include "iamf/cli/renderer/audio_element_renderer_ambisonics_to_channel.h"
+
+#include <cstddef>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "iamf/cli/audio_element_with_data.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/renderer/precomputed_gains.h"
+#include "iamf/cli/renderer/renderer_utils.h"
+#include "iamf/common/macros.h"
+#include "iamf/obu/audio_element.h"
+#include "iamf/obu/leb128.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+namespace {
+
+// Scale of the Q15 coefficients in `demixing_matrix`.
+constexpr double kDemixingMatrixScale = 32768.0;
+
+absl::StatusOr<PrecomputedGainsLayout> LookupAmbisonicsLayout(
+    int num_channels) {
+  using enum PrecomputedGainsLayout;
+  switch (num_channels) {
+    case 1:
+      return kA0;
+    case 4:
+      return kA1;
+    case 9:
+      return kA2;
+    case 16:
+      return kA3;
+    case 25:
+      return kA4;
+    default:
+      return absl::UnimplementedError(
+          absl::StrCat("Rendering ambisonics with output_channel_count= ",
+                       num_channels, " is not supported."));
+  }
+}
+
+// Gets the matrix with one row per ambisonics channel number (ACN) and one
+// column per loudspeaker.
+absl::StatusOr<GainMatrixView> LookupDecodeMatrix(
+    int output_channel_count, const Layout& playback_layout) {
+  const auto input_layout = LookupAmbisonicsLayout(output_channel_count);
+  RETURN_IF_NOT_OK(input_layout.status());
+  const auto output_key =
+      renderer_utils::LookupOutputKeyFromPlaybackLayout(playback_layout);
+  RETURN_IF_NOT_OK(output_key.status());
+  const auto output_layout = LookupPrecomputedGainsLayout(*output_key);
+  RETURN_IF_NOT_OK(output_layout.status());
+
+  const auto decode_matrix =
+      LookupPrecomputedGains(*input_layout, *output_layout);
+  if (!decode_matrix.has_value()) {
+    return absl::NotFoundError(absl::StrCat(
+        "Ambisonics decode matrix not found for output_key= ", *output_key));
+  }
+  return *decode_matrix;
+}
+
+absl::Status GetMonoChannelsAndGains(
+    const AmbisonicsMonoConfig& mono_config,
+    const GainMatrixView& decode_matrix,
+    std::vector<ChannelLabel::Label>& channel_order,
+    std::vector<double>& gains) {
+  for (int ambisonics_channel_number = 0;
+       ambisonics_channel_number < mono_config.channel_mapping.size();
+       ++ambisonics_channel_number) {
+    if (mono_config.channel_mapping[ambisonics_channel_number] ==
+        AmbisonicsMonoConfig::kInactiveAmbisonicsChannelNumber) {
+      // Drop the row instead of rendering a channel of zeros.
+      continue;
+    }
+    const auto label =
+        ChannelLabel::AmbisonicsChannelNumberToLabel(ambisonics_channel_number);
+    RETURN_IF_NOT_OK(label.status());
+    channel_order.push_back(*label);
+    const auto row = decode_matrix.Row(ambisonics_channel_number);
+    gains.insert(gains.end(), row.begin(), row.end());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status GetProjectionChannelsAndGains(
+    const AmbisonicsProjectionConfig& projection_config,
+    const std::vector<DecodedUleb128>& audio_substream_ids,
+    const SubstreamIdLabelsMap& substream_id_to_labels,
+    const GainMatrixView& decode_matrix,
+    std::vector<ChannelLabel::Label>& channel_order,
+    std::vector<double>& gains) {
+  // Decoded channels are ordered by substream, with both channels of the
+  // coupled substreams first.
+  for (const auto substream_id : audio_substream_ids) {
+    const auto labels_iter = substream_id_to_labels.find(substream_id);
+    if (labels_iter == substream_id_to_labels.end()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Labels not found for substream_id= ", substream_id));
+    }
+    channel_order.insert(channel_order.end(), labels_iter->second.begin(),
+                         labels_iter->second.end());
+  }
+
+  const size_t num_ambisonics_channels = projection_config.output_channel_count;
+  const size_t num_decoded_channels = projection_config.substream_count +
+                                      projection_config.coupled_substream_count;
+  if (channel_order.size() != num_decoded_channels ||
+      projection_config.demixing_matrix.size() !=
+          num_decoded_channels * num_ambisonics_channels) {
+    return absl::InvalidArgumentError(
+        "Inconsistent number of channels in the projection config.");
+  }
+
+  // `demixing_matrix` is stored in column-major order, with one row per ACN
+  // and one column per decoded channel. Fold it into the decode matrix, so
+  // each decoded channel has a row of gains to every loudspeaker.
+  const size_t num_output_channels = decode_matrix.num_output_channels;
+  gains.assign(num_decoded_channels * num_output_channels, 0.0);
+  for (size_t j = 0; j < num_decoded_channels; ++j) {
+    double* const gains_row = gains.data() + j * num_output_channels;
+    for (size_t acn = 0; acn < num_ambisonics_channels; ++acn) {
+      const double demixing_gain =
+          projection_config
+              .demixing_matrix[j * num_ambisonics_channels + acn] /
+          kDemixingMatrixScale;
+      if (demixing_gain == 0.0) {
+        continue;
+      }
+      const auto decode_row = decode_matrix.Row(acn);
+      for (size_t o = 0; o < num_output_channels; ++o) {
+        gains_row[o] += demixing_gain * decode_row[o];
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+std::unique_ptr<AudioElementRendererAmbisonicsToChannel>
+AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+    const AmbisonicsConfig& ambisonics_config,
+    const std::vector<DecodedUleb128>& audio_substream_ids,
+    const SubstreamIdLabelsMap& substream_id_to_labels,
+    const Layout& playback_layout) {
+  std::vector<ChannelLabel::Label> channel_order;
+  std::vector<double> gains;
+  absl::Status status;
+  int num_output_channels = 0;
+  if (const auto* mono_config = std::get_if<AmbisonicsMonoConfig>(
+          &ambisonics_config.ambisonics_config)) {
+    const auto decode_matrix = LookupDecodeMatrix(
+        mono_config->output_channel_count, playback_layout);
+    status = decode_matrix.status();
+    if (status.ok()) {
+      num_output_channels = decode_matrix->num_output_channels;
+      status = GetMonoChannelsAndGains(*mono_config, *decode_matrix,
+                                       channel_order, gains);
+    }
+  } else if (const auto* projection_config =
+                 std::get_if<AmbisonicsProjectionConfig>(
+                     &ambisonics_config.ambisonics_config)) {
+    const auto decode_matrix = LookupDecodeMatrix(
+        projection_config->output_channel_count, playback_layout);
+    status = decode_matrix.status();
+    if (status.ok()) {
+      num_output_channels = decode_matrix->num_output_channels;
+      status = GetProjectionChannelsAndGains(
+          *projection_config, audio_substream_ids, substream_id_to_labels,
+          *decode_matrix, channel_order, gains);
+    }
+  } else {
+    status = absl::InvalidArgumentError("Unknown ambisonics config.");
+  }
+
+  if (!status.ok()) {
+    LOG(WARNING) << "Unable to render ambisonics: " << status;
+    return nullptr;
+  }
+  return absl::WrapUnique(new AudioElementRendererAmbisonicsToChannel(
+      channel_order, num_output_channels, gains));
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_RENDERER_AUDIO_ELEMENT_RENDERER_AMBISONICS_TO_CHANNEL_H_
+#define CLI_RENDERER_AUDIO_ELEMENT_RENDERER_AMBISONICS_TO_CHANNEL_H_
+#include <memory>
+#include <vector>
+
+#include "iamf/cli/audio_element_with_data.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/renderer/audio_element_renderer_matrix_base.h"
+#include "iamf/obu/audio_element.h"
+#include "iamf/obu/leb128.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+/*!\brief Renders a scene-based audio element to a loudspeaker layout.
+ *
+ * This class represents a renderer which decodes ambisonics to the playback
+ * layout, using the precomputed EAR decode matrices. On creation the decode
+ * matrix is combined with the configuration of the audio element:
+ *  - For mono-coded ambisonics, only the rows of channels which are present
+ *    are kept. Channels omitted by mixed-order ambisonics are never rendered.
+ *  - For projection-coded ambisonics, the `demixing_matrix` is folded into the
+ *    decode matrix, so the decoded substreams are rendered in one pass.
+ *
+ * Frames are rendered asynchronously as described in
+ * `AudioElementRendererMatrixBase`.
+ */
+class AudioElementRendererAmbisonicsToChannel
+    : public AudioElementRendererMatrixBase {
+ public:
+  /*!\brief Creates an ambisonics to channel renderer.
+   *
+   * \param ambisonics_config Config for the ambisonics layout.
+   * \param audio_substream_ids Audio substream IDs, in the order of the Audio
+   *     Element OBU.
+   * \param substream_id_to_labels Mapping of substream IDs to labels.
+   * \param playback_layout Layout of the audio element to be rendered.
+   * \return Render to use or `nullptr` if it would not be suitable for use.
+   */
+  static std::unique_ptr<AudioElementRendererAmbisonicsToChannel>
+  CreateFromAmbisonicsConfig(
+      const AmbisonicsConfig& ambisonics_config,
+      const std::vector<DecodedUleb128>& audio_substream_ids,
+      const SubstreamIdLabelsMap& substream_id_to_labels,
+      const Layout& playback_layout);
+
+  /*!\brief Destructor. */
+  ~AudioElementRendererAmbisonicsToChannel() override = default;
+
+ private:
+  /*!\brief Constructor. */
+  AudioElementRendererAmbisonicsToChannel(
+      const std::vector<ChannelLabel::Label>& channel_order,
+      int num_output_channels, const std::vector<double>& gains)
+      : AudioElementRendererMatrixBase(channel_order, num_output_channels,
+                                       gains) {}
+};
+
+}  // namespace iamf_tools
+#endif  // CLI_RENDERER_AUDIO_ELEMENT_RENDERER_AMBISONICS_TO_CHANNEL_H_
@@ -31,4 +31,9 @@ absl::Status AudioElementRendererBase::Flush(
   return absl::OkStatus();
 }
 
+void AudioElementRendererBase::WaitUntilFinalized() const {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(&is_finalized_));
+}
+
 }  // namespace iamf_tools
@@ -33,9 +33,9 @@ namespace iamf_tools {
  *   received by `RenderLabeledFrame()`.
  * - Call `Finalize()` to close the renderer, telling it to finish rendering
  *   any remaining frames. Afterwards `IsFinalized()` should be called until it
- *   returns true, then audio frames should be  retrieved one last time via
- *   `Flush()`. After calling `Finalize()`, any subsequent call to
- *   `RenderAudioFrame()` may fail.
+ *   returns true, or `WaitUntilFinalized()` should be called, then audio
+ *   frames should be  retrieved one last time via `Flush()`. After calling
+ *   `Finalize()`, any subsequent call to `RenderAudioFrame()` may fail.
  * - Call `IsFinalized()` to ensure the renderer is Finalized.
  */
 class AudioElementRendererBase {
@@ -81,6 +81,13 @@ class AudioElementRendererBase {
     return is_finalized_;
   }
 
+  /*!\brief Blocks until the renderer is finalized.
+   *
+   * Sub-classes which finish rendering after `Finalize()` returns should set
+   * `is_finalized_` while holding `mutex_`, which wakes up the caller.
+   */
+  void WaitUntilFinalized() const;
+
  protected:
   /*!\brief Constructor. */
   AudioElementRendererBase() = default;
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#include "iamf/cli/renderer/audio_element_renderer_binaural.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/demixing_module.h"
+#include "iamf/cli/renderer/hrir_set.h"
+#include "iamf/cli/renderer/precomputed_gains.h"
+#include "iamf/cli/renderer/renderer_utils.h"
+#include "iamf/common/macros.h"
+#include "iamf/obu/audio_element.h"
+
+namespace iamf_tools {
+
+namespace {
+
+constexpr int kBlockSize = AudioElementRendererBinaural::kBlockSize;
+constexpr int kFftSize = 2 * kBlockSize;
+
+// Looks up the row-major gains from the input layout to the virtual
+// loudspeakers.
+absl::Status LookupGainsToHrirLayout(const HrirSet& hrir_set,
+                                     PrecomputedGainsLayout input_layout,
+                                     size_t num_input_channels,
+                                     std::vector<double>& gains) {
+  const size_t num_loudspeakers = hrir_set.num_loudspeakers;
+  if (input_layout == hrir_set.layout &&
+      num_input_channels == num_loudspeakers) {
+    gains.assign(num_input_channels * num_loudspeakers, 0.0);
+    for (size_t i = 0; i < num_input_channels; ++i) {
+      gains[i * num_loudspeakers + i] = 1.0;
+    }
+    return absl::OkStatus();
+  }
+
+  const auto matrix = LookupPrecomputedGains(input_layout, hrir_set.layout);
+  if (!matrix.has_value() ||
+      matrix->num_input_channels != static_cast<int>(num_input_channels)) {
+    return absl::NotFoundError(
+        "Precomputed gains not found to the layout of the HRIRs.");
+  }
+  gains.assign(matrix->gains.begin(), matrix->gains.end());
+  return absl::OkStatus();
+}
+
+// Mixes the impulse responses of the virtual loudspeakers into the filter of
+// one input channel. The left ear is written to `left` and the right ear to
+// `right`.
+void MixImpulseResponses(const HrirSet& hrir_set,
+                         absl::Span<const double> gains_row,
+                         std::vector<float>& left, std::vector<float>& right) {
+  left.assign(hrir_set.num_taps, 0.0f);
+  right.assign(hrir_set.num_taps, 0.0f);
+  for (int v = 0; v < hrir_set.num_loudspeakers; ++v) {
+    const float gain = static_cast<float>(gains_row[v]);
+    if (gain == 0.0f) {
+      continue;
+    }
+    const float* const left_ir = hrir_set.GetImpulseResponse(v, 0);
+    const float* const right_ir = hrir_set.GetImpulseResponse(v, 1);
+    for (int t = 0; t < hrir_set.num_taps; ++t) {
+      left[t] += gain * left_ir[t];
+      right[t] += gain * right_ir[t];
+    }
+  }
+}
+
+// Computes the spectrum of one partition of a filter, with the left ear in the
+// real part and the right ear in the imaginary part.
+void TransformPartition(const Fft& fft, const std::vector<float>& left,
+                        const std::vector<float>& right, int partition,
+                        std::vector<float>& real, std::vector<float>& imag) {
+  real.assign(kFftSize, 0.0f);
+  imag.assign(kFftSize, 0.0f);
+  const int first_tap = partition * kBlockSize;
+  const int num_taps =
+      std::min(kBlockSize, static_cast<int>(left.size()) - first_tap);
+  std::copy_n(left.begin() + first_tap, num_taps, real.begin());
+  std::copy_n(right.begin() + first_tap, num_taps, imag.begin());
+  fft.Forward(absl::MakeSpan(real), absl::MakeSpan(imag));
+}
+
+}  // namespace
+
+std::unique_ptr<AudioElementRendererBinaural>
+AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+    const ScalableChannelLayoutConfig& scalable_channel_layout_config,
+    const HrirSet& hrir_set) {
+  if (scalable_channel_layout_config.channel_audio_layer_configs.empty()) {
+    return nullptr;
+  }
+  // Render from the highest layer, which has the most channels.
+  const auto loudspeaker_layout =
+      scalable_channel_layout_config.channel_audio_layer_configs.back()
+          .loudspeaker_layout;
+
+  const auto input_key =
+      renderer_utils::LookupInputKeyFromLoudspeakerLayout(loudspeaker_layout);
+  const auto channel_order =
+      ChannelLabel::LookupEarChannelOrderFromScalableLoudspeakerLayout(
+          loudspeaker_layout);
+  if (!input_key.ok() || !channel_order.ok()) {
+    return nullptr;
+  }
+  const auto input_layout = LookupPrecomputedGainsLayout(*input_key);
+  if (!input_layout.ok()) {
+    return nullptr;
+  }
+
+  std::vector<double> gains;
+  const auto status = LookupGainsToHrirLayout(hrir_set, *input_layout,
+                                              channel_order->size(), gains);
+  if (!status.ok()) {
+    LOG(WARNING) << "Unable to render binaural: " << status;
+    return nullptr;
+  }
+
+  return absl::WrapUnique(
+      new AudioElementRendererBinaural(*channel_order, gains, hrir_set));
+}
+
+AudioElementRendererBinaural::AudioElementRendererBinaural(
+    const std::vector<ChannelLabel::Label>& channel_order,
+    const std::vector<double>& gains, const HrirSet& hrir_set)
+    : channel_order_(channel_order),
+      num_channel_pairs_((static_cast<int>(channel_order.size()) + 1) / 2),
+      num_partitions_((hrir_set.num_taps + kBlockSize - 1) / kBlockSize),
+      fft_(kFftSize) {
+  const size_t num_spectra = num_channel_pairs_ * num_partitions_;
+  filter_p_real_.resize(num_spectra * kFftSize);
+  filter_p_imag_.resize(num_spectra * kFftSize);
+  filter_q_real_.resize(num_spectra * kFftSize);
+  filter_q_imag_.resize(num_spectra * kFftSize);
+  history_z_real_.assign(num_spectra * kFftSize, 0.0f);
+  history_z_imag_.assign(num_spectra * kFftSize, 0.0f);
+  history_zc_real_.assign(num_spectra * kFftSize, 0.0f);
+  history_zc_imag_.assign(num_spectra * kFftSize, 0.0f);
+  previous_input_.assign(2 * num_channel_pairs_ * kBlockSize, 0.0f);
+  current_input_.assign(2 * num_channel_pairs_ * kBlockSize, 0.0f);
+
+  // Precompute the spectra of the filters. The second channel of the last
+  // pair is silent when there is an odd number of channels.
+  const int num_channels = channel_order.size();
+  const absl::Span<const double> all_gains(gains);
+  std::vector<float> left_a, right_a, left_b, right_b;
+  std::vector<float> a_real, a_imag, b_real, b_imag;
+  for (int pair = 0; pair < num_channel_pairs_; ++pair) {
+    const int a = 2 * pair;
+    const int b = a + 1;
+    MixImpulseResponses(hrir_set,
+                        all_gains.subspan(a * hrir_set.num_loudspeakers,
+                                          hrir_set.num_loudspeakers),
+                        left_a, right_a);
+    if (b < num_channels) {
+      MixImpulseResponses(hrir_set,
+                          all_gains.subspan(b * hrir_set.num_loudspeakers,
+                                            hrir_set.num_loudspeakers),
+                          left_b, right_b);
+    } else {
+      left_b.assign(hrir_set.num_taps, 0.0f);
+      right_b.assign(hrir_set.num_taps, 0.0f);
+    }
+
+    for (int p = 0; p < num_partitions_; ++p) {
+      TransformPartition(fft_, left_a, right_a, p, a_real, a_imag);
+      TransformPartition(fft_, left_b, right_b, p, b_real, b_imag);
+      // With `Ga` and `Gb` the spectra of the filters of `a` and `b`:
+      // `P = (Ga - i * Gb) / 2` and `Q = (Ga + i * Gb) / 2`.
+      const size_t offset = (pair * num_partitions_ + p) * kFftSize;
+      for (int k = 0; k < kFftSize; ++k) {
+        filter_p_real_[offset + k] = 0.5f * (a_real[k] + b_imag[k]);
+        filter_p_imag_[offset + k] = 0.5f * (a_imag[k] - b_real[k]);
+        filter_q_real_[offset + k] = 0.5f * (a_real[k] - b_imag[k]);
+        filter_q_imag_[offset + k] = 0.5f * (a_imag[k] + b_real[k]);
+      }
+    }
+  }
+}
+
+absl::StatusOr<int> AudioElementRendererBinaural::RenderLabeledFrame(
+    const LabeledFrame& labeled_frame) {
+  std::vector<std::vector<int32_t>> samples_to_render;
+  RETURN_IF_NOT_OK(iamf_tools::renderer_utils::ArrangeSamplesToRender(
+      labeled_frame, channel_order_, samples_to_render));
+  {
+    absl::MutexLock lock(&mutex_);
+    if (is_finalized_) {
+      return absl::FailedPreconditionError(
+          "Rendering is disallowed after `Finalize()` has been called.");
+    }
+  }
+
+  std::vector<int32_t> rendered_samples;
+  const size_t num_channels = channel_order_.size();
+  for (const auto& tick : samples_to_render) {
+    for (size_t c = 0; c < num_channels; ++c) {
+      current_input_[c * kBlockSize + num_buffered_ticks_] =
+          static_cast<float>(tick[c]);
+    }
+    if (++num_buffered_ticks_ == kBlockSize) {
+      RenderBlock(kBlockSize, rendered_samples);
+      num_buffered_ticks_ = 0;
+    }
+  }
+
+  absl::MutexLock lock(&mutex_);
+  rendered_samples_.insert(rendered_samples_.end(), rendered_samples.begin(),
+                           rendered_samples.end());
+  return static_cast<int>(samples_to_render.size());
+}
+
+absl::Status AudioElementRendererBinaural::Finalize() {
+  std::vector<int32_t> rendered_samples;
+  if (num_buffered_ticks_ > 0) {
+    // Pad the last block with silence, but only output the real ticks.
+    for (size_t c = 0; c < channel_order_.size(); ++c) {
+      std::fill(current_input_.begin() + c * kBlockSize + num_buffered_ticks_,
+                current_input_.begin() + (c + 1) * kBlockSize, 0.0f);
+    }
+    RenderBlock(num_buffered_ticks_, rendered_samples);
+    num_buffered_ticks_ = 0;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  rendered_samples_.insert(rendered_samples_.end(), rendered_samples.begin(),
+                           rendered_samples.end());
+  is_finalized_ = true;
+  return absl::OkStatus();
+}
+
+void AudioElementRendererBinaural::RenderBlock(
+    int num_ticks, std::vector<int32_t>& rendered_samples) {
+  scratch_real_.resize(kFftSize);
+  scratch_imag_.resize(kFftSize);
+
+  // Shift the delay line by one block. Partition `p` of the history is at
+  // `(newest_partition_ + p) % num_partitions_`.
+  newest_partition_ =
+      (newest_partition_ + num_partitions_ - 1) % num_partitions_;
+
+  // Transform the last two blocks of each pair of channels, which is the
+  // input needed to overlap-save with partitions of `kBlockSize` taps.
+  for (int pair = 0; pair < num_channel_pairs_; ++pair) {
+    const size_t a = 2 * pair * kBlockSize;
+    const size_t b = a + kBlockSize;
+    std::copy_n(previous_input_.begin() + a, kBlockSize,
+                scratch_real_.begin());
+    std::copy_n(current_input_.begin() + a, kBlockSize,
+                scratch_real_.begin() + kBlockSize);
+    std::copy_n(previous_input_.begin() + b, kBlockSize,
+                scratch_imag_.begin());
+    std::copy_n(current_input_.begin() + b, kBlockSize,
+                scratch_imag_.begin() + kBlockSize);
+    fft_.Forward(absl::MakeSpan(scratch_real_), absl::MakeSpan(scratch_imag_));
+
+    const size_t offset =
+        (pair * num_partitions_ + newest_partition_) * kFftSize;
+    std::copy(scratch_real_.begin(), scratch_real_.end(),
+              history_z_real_.begin() + offset);
+    std::copy(scratch_imag_.begin(), scratch_imag_.end(),
+              history_z_imag_.begin() + offset);
+    for (int k = 0; k < kFftSize; ++k) {
+      const int mirrored_k = (kFftSize - k) & (kFftSize - 1);
+      history_zc_real_[offset + k] = scratch_real_[mirrored_k];
+      history_zc_imag_[offset + k] = -scratch_imag_[mirrored_k];
+    }
+  }
+  previous_input_.swap(current_input_);
+
+  // Accumulate the binaural spectrum over every pair and partition.
+  std::fill(scratch_real_.begin(), scratch_real_.end(), 0.0f);
+  std::fill(scratch_imag_.begin(), scratch_imag_.end(), 0.0f);
+  float* const out_real = scratch_real_.data();
+  float* const out_imag = scratch_imag_.data();
+  for (int pair = 0; pair < num_channel_pairs_; ++pair) {
+    for (int p = 0; p < num_partitions_; ++p) {
+      const size_t history_offset =
+          (pair * num_partitions_ + (newest_partition_ + p) % num_partitions_) *
+          kFftSize;
+      const size_t filter_offset = (pair * num_partitions_ + p) * kFftSize;
+      const float* const z_real = history_z_real_.data() + history_offset;
+      const float* const z_imag = history_z_imag_.data() + history_offset;
+      const float* const zc_real = history_zc_real_.data() + history_offset;
+      const float* const zc_imag = history_zc_imag_.data() + history_offset;
+      const float* const p_real = filter_p_real_.data() + filter_offset;
+      const float* const p_imag = filter_p_imag_.data() + filter_offset;
+      const float* const q_real = filter_q_real_.data() + filter_offset;
+      const float* const q_imag = filter_q_imag_.data() + filter_offset;
+      for (int k = 0; k < kFftSize; ++k) {
+        out_real[k] += z_real[k] * p_real[k] - z_imag[k] * p_imag[k] +
+                       zc_real[k] * q_real[k] - zc_imag[k] * q_imag[k];
+        out_imag[k] += z_real[k] * p_imag[k] + z_imag[k] * p_real[k] +
+                       zc_real[k] * q_imag[k] + zc_imag[k] * q_real[k];
+      }
+    }
+  }
+  fft_.Inverse(absl::MakeSpan(scratch_real_), absl::MakeSpan(scratch_imag_));
+
+  // The second half of the inverse transform is free of circular aliasing.
+  // Interleave it, rounding rather than truncating since the transforms add
+  // small errors of either sign.
+  constexpr double kMin = std::numeric_limits<int32_t>::min();
+  constexpr double kMax = std::numeric_limits<int32_t>::max();
+  for (int t = 0; t < num_ticks; ++t) {
+    rendered_samples.push_back(static_cast<int32_t>(
+        std::clamp(std::round(double{scratch_real_[kBlockSize + t]}), kMin,
+                   kMax)));
+    rendered_samples.push_back(static_cast<int32_t>(
+        std::clamp(std::round(double{scratch_imag_[kBlockSize + t]}), kMin,
+                   kMax)));
+  }
+}
+
+}  // namespace iamf_tools
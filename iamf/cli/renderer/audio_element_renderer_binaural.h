@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_RENDERER_AUDIO_ELEMENT_RENDERER_BINAURAL_H_
+#define CLI_RENDERER_AUDIO_ELEMENT_RENDERER_BINAURAL_H_
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/demixing_module.h"
+#include "iamf/cli/renderer/audio_element_renderer_base.h"
+#include "iamf/cli/renderer/fft.h"
+#include "iamf/cli/renderer/hrir_set.h"
+#include "iamf/obu/audio_element.h"
+
+namespace iamf_tools {
+/*!\brief Renders a channel-based audio element to binaural.
+ *
+ * This class represents a renderer which places the highest layer of a
+ * channel-based audio element on the virtual loudspeakers of an `HrirSet`,
+ * using the precomputed EAR gain matrices, and convolves each loudspeaker with
+ * its head-related impulse responses.
+ *
+ * The gain matrix is folded into the impulse responses on creation, so each
+ * input channel has one filter per ear. Filters are applied with uniformly
+ * partitioned overlap-save convolution: the filters are split into blocks of
+ * `kBlockSize` taps whose spectra are computed once, and the spectra of the
+ * most recent input blocks are kept across frames. Every block costs one FFT
+ * per pair of input channels and one inverse FFT, whatever the length of the
+ * impulse responses.
+ *
+ * Samples are rendered synchronously in whole blocks. Rendered samples are
+ * available from `Flush()` once a block is complete; `Finalize()` renders the
+ * last partial block. The output has as many ticks as the input, interleaved
+ * as left and right. `RenderLabeledFrame()` and `Finalize()` must not be
+ * called concurrently.
+ */
+class AudioElementRendererBinaural : public AudioElementRendererBase {
+ public:
+  /*!\brief Number of ticks per block and of taps per filter partition. */
+  static constexpr int kBlockSize = 256;
+
+  /*!\brief Creates a binaural renderer from a channel-based config.
+   *
+   * \param scalable_channel_layout_config Config for the scalable channel
+   *     layout.
+   * \param hrir_set HRIRs to render with. They should have the sample rate of
+   *     the audio element.
+   * \return Render to use or `nullptr` if it would not be suitable for use.
+   */
+  static std::unique_ptr<AudioElementRendererBinaural>
+  CreateFromScalableChannelLayoutConfig(
+      const ScalableChannelLayoutConfig& scalable_channel_layout_config,
+      const HrirSet& hrir_set);
+
+  /*!\brief Destructor. */
+  ~AudioElementRendererBinaural() override = default;
+
+  /*!\brief Renders samples, one block at a time.
+   *
+   * \param labeled_frame Labeled frame to render.
+   * \return Number of ticks which will be rendered. A specific status on
+   *     failure.
+   */
+  absl::StatusOr<int> RenderLabeledFrame(
+      const LabeledFrame& labeled_frame) override;
+
+  /*!\brief Renders the remaining samples and finalizes the renderer.
+   *
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status Finalize() override;
+
+ private:
+  /*!\brief Constructor.
+   *
+   * \param channel_order Labels of the input channels.
+   * \param gains Row-major gains from the input channels to the virtual
+   *     loudspeakers of `hrir_set`.
+   * \param hrir_set HRIRs of the virtual loudspeakers.
+   */
+  AudioElementRendererBinaural(
+      const std::vector<ChannelLabel::Label>& channel_order,
+      const std::vector<double>& gains, const HrirSet& hrir_set);
+
+  /*!\brief Renders the current block and appends the first ticks.
+   *
+   * \param num_ticks Number of ticks of the block to output.
+   * \param rendered_samples Vector to append rendered samples to.
+   */
+  void RenderBlock(int num_ticks, std::vector<int32_t>& rendered_samples);
+
+  const std::vector<ChannelLabel::Label> channel_order_;
+  // Input channels are transformed in pairs, as the real and imaginary parts
+  // of one complex signal.
+  const int num_channel_pairs_;
+  const int num_partitions_;
+  const Fft fft_;
+
+  // For each pair of channels `(a, b)` and each partition, the spectra `P`
+  // and `Q` such that the binaural spectrum is `Z * P + Zc * Q`. `Z` is the
+  // spectrum of the input `a + ib` and `Zc[k] = conj(Z[-k])`. The left and
+  // right ears are the real and imaginary parts of the inverse transform.
+  std::vector<float> filter_p_real_;
+  std::vector<float> filter_p_imag_;
+  std::vector<float> filter_q_real_;
+  std::vector<float> filter_q_imag_;
+
+  // Frequency-domain delay line with `Z` and `Zc` of the most recent blocks
+  // of each pair of channels. The newest block is at `newest_partition_`.
+  std::vector<float> history_z_real_;
+  std::vector<float> history_z_imag_;
+  std::vector<float> history_zc_real_;
+  std::vector<float> history_zc_imag_;
+  int newest_partition_ = 0;
+
+  // Input of the previous and current blocks, one contiguous buffer per
+  // channel.
+  std::vector<float> previous_input_;
+  std::vector<float> current_input_;
+  int num_buffered_ticks_ = 0;
+
+  // Scratch buffers, kept to avoid reallocating them for every block.
+  std::vector<float> scratch_real_;
+  std::vector<float> scratch_imag_;
+};
+
+}  // namespace iamf_tools
+#endif  // CLI_RENDERER_AUDIO_ELEMENT_RENDERER_BINAURAL_H_
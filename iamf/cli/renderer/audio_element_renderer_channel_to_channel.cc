@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#include "iamf/cli/renderer/audio_element_renderer_channel_to_channel.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/renderer/precomputed_gains.h"
+#include "iamf/cli/renderer/renderer_utils.h"
+#include "iamf/common/macros.h"
+#include "iamf/obu/audio_element.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+namespace {
+
+// Looks up the gain matrix in row-major order.
+absl::Status LookupGains(const std::string& input_key,
+                         const std::string& output_key,
+                         size_t num_input_channels, int& num_output_channels,
+                         std::vector<double>& gains) {
+  const auto input_layout = LookupPrecomputedGainsLayout(input_key);
+  const auto output_layout = LookupPrecomputedGainsLayout(output_key);
+  RETURN_IF_NOT_OK(input_layout.status());
+  RETURN_IF_NOT_OK(output_layout.status());
+
+  if (*input_layout == *output_layout) {
+    // The precomputed gains omit the identity matrices.
+    num_output_channels = static_cast<int>(num_input_channels);
+    gains.assign(num_input_channels * num_input_channels, 0.0);
+    for (size_t i = 0; i < num_input_channels; ++i) {
+      gains[i * num_input_channels + i] = 1.0;
+    }
+    return absl::OkStatus();
+  }
+
+  const auto matrix = LookupPrecomputedGains(*input_layout, *output_layout);
+  if (!matrix.has_value()) {
+    return absl::NotFoundError(
+        absl::StrCat("Precomputed gains not found for input_key= ", input_key,
+                     " and output_key= ", output_key));
+  }
+  if (matrix->num_input_channels != static_cast<int>(num_input_channels)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unexpected shape of the gains for input_key= ",
+                     input_key, " and output_key= ", output_key));
+  }
+  num_output_channels = matrix->num_output_channels;
+  gains.assign(matrix->gains.begin(), matrix->gains.end());
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+std::unique_ptr<AudioElementRendererChannelToChannel>
+AudioElementRendererChannelToChannel::CreateFromScalableChannelLayoutConfig(
+    const ScalableChannelLayoutConfig& scalable_channel_layout_config,
+    const Layout& playback_layout) {
+  if (scalable_channel_layout_config.channel_audio_layer_configs.empty()) {
+    return nullptr;
+  }
+  // Render from the highest layer, which has the most channels.
+  const auto loudspeaker_layout =
+      scalable_channel_layout_config.channel_audio_layer_configs.back()
+          .loudspeaker_layout;
+
+  const auto input_key =
+      renderer_utils::LookupInputKeyFromLoudspeakerLayout(loudspeaker_layout);
+  const auto output_key =
+      renderer_utils::LookupOutputKeyFromPlaybackLayout(playback_layout);
+  const auto channel_order =
+      ChannelLabel::LookupEarChannelOrderFromScalableLoudspeakerLayout(
+          loudspeaker_layout);
+  if (!input_key.ok() || !output_key.ok() || !channel_order.ok()) {
+    return nullptr;
+  }
+
+  int num_output_channels;
+  std::vector<double> gains;
+  if (!LookupGains(*input_key, *output_key, channel_order->size(),
+                   num_output_channels, gains)
+           .ok()) {
+    return nullptr;
+  }
+
+  return absl::WrapUnique(new AudioElementRendererChannelToChannel(
+      *channel_order, num_output_channels, gains));
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_RENDERER_AUDIO_ELEMENT_RENDERER_CHANNEL_TO_CHANNEL_H_
+#define CLI_RENDERER_AUDIO_ELEMENT_RENDERER_CHANNEL_TO_CHANNEL_H_
+#include <memory>
+#include <vector>
+
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/renderer/audio_element_renderer_matrix_base.h"
+#include "iamf/obu/audio_element.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+/*!\brief Renders a channel-based audio element to another loudspeaker layout.
+ *
+ * This class represents a renderer which down-mixes or up-mixes the highest
+ * layer of a channel-based audio element to the playback layout, using the
+ * precomputed EAR gain matrices. The matrix is looked up once on creation.
+ * Frames are rendered asynchronously as described in
+ * `AudioElementRendererMatrixBase`.
+ */
+class AudioElementRendererChannelToChannel
+    : public AudioElementRendererMatrixBase {
+ public:
+  /*!\brief Creates a channel to channel renderer from a channel-based config.
+   *
+   * \param scalable_channel_layout_config Config for the scalable channel
+   *     layout.
+   * \param playback_layout Layout of the audio element to be rendered.
+   * \return Render to use or `nullptr` if it would not be suitable for use.
+   */
+  static std::unique_ptr<AudioElementRendererChannelToChannel>
+  CreateFromScalableChannelLayoutConfig(
+      const ScalableChannelLayoutConfig& scalable_channel_layout_config,
+      const Layout& playback_layout);
+
+  /*!\brief Destructor. */
+  ~AudioElementRendererChannelToChannel() override = default;
+
+ private:
+  /*!\brief Constructor. */
+  AudioElementRendererChannelToChannel(
+      const std::vector<ChannelLabel::Label>& channel_order,
+      int num_output_channels, const std::vector<double>& gains)
+      : AudioElementRendererMatrixBase(channel_order, num_output_channels,
+                                       gains) {}
+};
+
+}  // namespace iamf_tools
+#endif  // CLI_RENDERER_AUDIO_ELEMENT_RENDERER_CHANNEL_TO_CHANNEL_H_
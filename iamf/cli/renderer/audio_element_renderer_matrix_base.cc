@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#include "iamf/cli/renderer/audio_element_renderer_matrix_base.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/demixing_module.h"
+#include "iamf/cli/renderer/renderer_utils.h"
+#include "iamf/common/macros.h"
+
+namespace iamf_tools {
+
+AudioElementRendererMatrixBase::AudioElementRendererMatrixBase(
+    const std::vector<ChannelLabel::Label>& channel_order,
+    int num_output_channels, const std::vector<double>& gains)
+    : channel_order_(channel_order),
+      num_output_channels_(num_output_channels),
+      gains_(gains) {}
+
+absl::StatusOr<int> AudioElementRendererMatrixBase::RenderLabeledFrame(
+    const LabeledFrame& labeled_frame) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (is_finalized_) {
+      return absl::FailedPreconditionError(
+          "Rendering is disallowed after `Finalize()` has been called.");
+    }
+  }
+  RETURN_IF_NOT_OK(iamf_tools::renderer_utils::ArrangeSamplesToRender(
+      labeled_frame, channel_order_, samples_to_render_));
+  RenderSamples(samples_to_render_, rendered_samples_scratch_);
+
+  absl::MutexLock lock(&mutex_);
+  rendered_samples_.insert(rendered_samples_.end(),
+                           rendered_samples_scratch_.begin(),
+                           rendered_samples_scratch_.end());
+  return static_cast<int>(samples_to_render_.size());
+}
+
+void AudioElementRendererMatrixBase::RenderSamples(
+    const std::vector<std::vector<int32_t>>& samples_to_render,
+    std::vector<int32_t>& rendered_samples) {
+  const size_t num_ticks = samples_to_render.size();
+  const size_t num_input_channels = channel_order_.size();
+  const size_t num_output_channels = num_output_channels_;
+
+  // Transpose to one contiguous buffer per channel, so the inner loop of the
+  // matrix multiplication runs over consecutive samples and can be vectorized.
+  input_channels_.resize(num_input_channels * num_ticks);
+  for (size_t t = 0; t < num_ticks; ++t) {
+    for (size_t i = 0; i < num_input_channels; ++i) {
+      input_channels_[i * num_ticks + t] = samples_to_render[t][i];
+    }
+  }
+
+  output_channels_.assign(num_output_channels * num_ticks, 0.0);
+  for (size_t i = 0; i < num_input_channels; ++i) {
+    const double* const input = input_channels_.data() + i * num_ticks;
+    for (size_t o = 0; o < num_output_channels; ++o) {
+      const double gain = gains_[i * num_output_channels + o];
+      if (gain == 0.0) {
+        // Most matrices are sparse.
+        continue;
+      }
+      double* const output = output_channels_.data() + o * num_ticks;
+      for (size_t t = 0; t < num_ticks; ++t) {
+        output[t] += gain * input[t];
+      }
+    }
+  }
+
+  // Interleave, clipping the same way as `ClipDoubleToInt32()`.
+  constexpr double kMin = std::numeric_limits<int32_t>::min();
+  constexpr double kMax = std::numeric_limits<int32_t>::max();
+  rendered_samples.resize(num_ticks * num_output_channels);
+  for (size_t t = 0; t < num_ticks; ++t) {
+    for (size_t o = 0; o < num_output_channels; ++o) {
+      rendered_samples[t * num_output_channels + o] = static_cast<int32_t>(
+          std::clamp(output_channels_[o * num_ticks + t], kMin, kMax));
+    }
+  }
+}
+
+}  // namespace iamf_tools
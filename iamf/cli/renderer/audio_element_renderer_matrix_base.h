@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_RENDERER_AUDIO_ELEMENT_RENDERER_MATRIX_BASE_H_
+#define CLI_RENDERER_AUDIO_ELEMENT_RENDERER_MATRIX_BASE_H_
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/demixing_module.h"
+#include "iamf/cli/renderer/audio_element_renderer_base.h"
+
+namespace iamf_tools {
+/*!\brief Base class for renderers which apply a fixed gain matrix.
+ *
+ * Sub-classes work out the input channels and the gain matrix once, in their
+ * factory functions. Frames are rendered synchronously on the calling thread,
+ * so callers which render several audio elements can spread them over their
+ * own threads.
+ *
+ * - Call `RenderAudioFrame()` to render a labeled frame.
+ * - Call `Flush()` to retrieve rendered frames, in the order they were
+ *   received by `RenderLabeledFrame()`.
+ * - Call `Finalize()` to close the renderer. The renderer is finalized as soon
+ *   as it returns. After calling `Finalize()`, any subsequent call to
+ *   `RenderAudioFrame()` will fail.
+ *
+ * `RenderLabeledFrame()` and `Finalize()` must not be called concurrently.
+ */
+class AudioElementRendererMatrixBase : public AudioElementRendererBase {
+ public:
+  /*!\brief Destructor. */
+  ~AudioElementRendererMatrixBase() override = default;
+
+  /*!\brief Renders samples.
+   *
+   * \param labeled_frame Labeled frame to render.
+   * \return Number of ticks which were rendered. A specific status on
+   *     failure.
+   */
+  absl::StatusOr<int> RenderLabeledFrame(
+      const LabeledFrame& labeled_frame) override;
+
+ protected:
+  /*!\brief Constructor.
+   *
+   * \param channel_order Order of the input channels.
+   * \param num_output_channels Number of channels in the playback layout.
+   * \param gains Gain matrix in row-major order, with one row per input
+   *     channel and one column per output channel.
+   */
+  AudioElementRendererMatrixBase(
+      const std::vector<ChannelLabel::Label>& channel_order,
+      int num_output_channels, const std::vector<double>& gains);
+
+ private:
+  /*!\brief Applies the gain matrix to one frame.
+   *
+   * \param samples_to_render Samples arranged in (time, channel) axes.
+   * \param rendered_samples Output interleaved samples.
+   */
+  void RenderSamples(const std::vector<std::vector<int32_t>>& samples_to_render,
+                     std::vector<int32_t>& rendered_samples);
+
+  const std::vector<ChannelLabel::Label> channel_order_;
+  const int num_output_channels_;
+  const std::vector<double> gains_;
+
+  // Scratch buffers reused between frames.
+  std::vector<std::vector<int32_t>> samples_to_render_;
+  std::vector<double> input_channels_;
+  std::vector<double> output_channels_;
+  std::vector<int32_t> rendered_samples_scratch_;
+};
+
+}  // namespace iamf_tools
+#endif  // CLI_RENDERER_AUDIO_ELEMENT_RENDERER_MATRIX_BASE_H_
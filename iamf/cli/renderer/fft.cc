@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#include "iamf/cli/renderer/fft.h"
+
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+#include "absl/log/check.h"
+#include "absl/types/span.h"
+
+namespace iamf_tools {
+
+Fft::Fft(int size)
+    : size_(size),
+      bit_reversed_indices_(size),
+      twiddle_real_(size / 2),
+      twiddle_imag_(size / 2) {
+  CHECK(size > 0 && (size & (size - 1)) == 0)
+      << "The size of the FFT must be a power of two. size= " << size;
+
+  int num_bits = 0;
+  while ((1 << num_bits) < size_) {
+    ++num_bits;
+  }
+  for (int i = 0; i < size_; ++i) {
+    int reversed = 0;
+    for (int bit = 0; bit < num_bits; ++bit) {
+      reversed |= ((i >> bit) & 1) << (num_bits - 1 - bit);
+    }
+    bit_reversed_indices_[i] = reversed;
+  }
+
+  // Compute the twiddle factors in double precision to avoid accumulating
+  // rounding errors in the largest transforms.
+  for (int k = 0; k < size_ / 2; ++k) {
+    const double angle = -2.0 * std::numbers::pi * k / size_;
+    twiddle_real_[k] = static_cast<float>(std::cos(angle));
+    twiddle_imag_[k] = static_cast<float>(std::sin(angle));
+  }
+}
+
+void Fft::Forward(absl::Span<float> real, absl::Span<float> imag) const {
+  CHECK_EQ(real.size(), size_);
+  CHECK_EQ(imag.size(), size_);
+
+  for (int i = 0; i < size_; ++i) {
+    const int j = bit_reversed_indices_[i];
+    if (i < j) {
+      std::swap(real[i], real[j]);
+      std::swap(imag[i], imag[j]);
+    }
+  }
+
+  // Iterative decimation-in-time butterflies.
+  for (int length = 2; length <= size_; length <<= 1) {
+    const int half_length = length / 2;
+    const int twiddle_stride = size_ / length;
+    for (int start = 0; start < size_; start += length) {
+      float* const top_real = real.data() + start;
+      float* const top_imag = imag.data() + start;
+      float* const bottom_real = top_real + half_length;
+      float* const bottom_imag = top_imag + half_length;
+      for (int k = 0; k < half_length; ++k) {
+        const float w_real = twiddle_real_[k * twiddle_stride];
+        const float w_imag = twiddle_imag_[k * twiddle_stride];
+        const float t_real = bottom_real[k] * w_real - bottom_imag[k] * w_imag;
+        const float t_imag = bottom_real[k] * w_imag + bottom_imag[k] * w_real;
+        bottom_real[k] = top_real[k] - t_real;
+        bottom_imag[k] = top_imag[k] - t_imag;
+        top_real[k] += t_real;
+        top_imag[k] += t_imag;
+      }
+    }
+  }
+}
+
+void Fft::Inverse(absl::Span<float> real, absl::Span<float> imag) const {
+  // The inverse transform is the forward transform with the real and
+  // imaginary parts swapped on the way in and out.
+  Forward(imag, real);
+  const float scale = 1.0f / size_;
+  for (int i = 0; i < size_; ++i) {
+    real[i] *= scale;
+    imag[i] *= scale;
+  }
+}
+
+}  // namespace iamf_tools
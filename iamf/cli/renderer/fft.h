@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_RENDERER_FFT_H_
+#define CLI_RENDERER_FFT_H_
+#include <vector>
+
+#include "absl/types/span.h"
+
+namespace iamf_tools {
+/*!\brief Radix-2 complex fast Fourier transform of a fixed size.
+ *
+ * The twiddle factors and the bit-reversal permutation are computed once on
+ * construction, so the object can be reused for every block of a stream.
+ * Signals are stored in split format, with the real and imaginary parts in
+ * separate buffers.
+ */
+class Fft {
+ public:
+  /*!\brief Constructor.
+   *
+   * \param size Number of points of the transform. MUST be a power of two.
+   */
+  explicit Fft(int size);
+
+  /*!\brief Computes the forward transform in place.
+   *
+   * \param real Real part of the signal, with `size()` elements.
+   * \param imag Imaginary part of the signal, with `size()` elements.
+   */
+  void Forward(absl::Span<float> real, absl::Span<float> imag) const;
+
+  /*!\brief Computes the inverse transform in place, scaled by `1 / size()`.
+   *
+   * \param real Real part of the spectrum, with `size()` elements.
+   * \param imag Imaginary part of the spectrum, with `size()` elements.
+   */
+  void Inverse(absl::Span<float> real, absl::Span<float> imag) const;
+
+  /*!\brief Gets the number of points of the transform.
+   *
+   * \return Number of points of the transform.
+   */
+  int size() const { return size_; }
+
+ private:
+  const int size_;
+  std::vector<int> bit_reversed_indices_;
+  // `exp(-2 * pi * i * k / size_)` for `k` in `[0, size_ / 2)`.
+  std::vector<float> twiddle_real_;
+  std::vector<float> twiddle_imag_;
+};
+
+}  // namespace iamf_tools
+#endif  // CLI_RENDERER_FFT_H_
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+
+#include "iamf/cli/renderer/hrir_set.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "iamf/cli/renderer/precomputed_gains.h"
+#include "iamf/common/macros.h"
+#include "iamf/common/obu_util.h"
+#include "iamf/common/read_bit_buffer.h"
+
+namespace iamf_tools {
+
+namespace {
+
+constexpr uint32_t kHrirMagic = 0x48524952;  // "HRIR".
+constexpr uint8_t kHrirVersion = 1;
+
+// Generous upper bound, which rejects corrupt headers before allocating.
+constexpr uint32_t kMaxNumTaps = 1 << 16;
+
+}  // namespace
+
+absl::StatusOr<HrirSet> HrirSet::ReadFromFile(
+    const std::filesystem::path& file_path) {
+  std::vector<uint8_t> bytes;
+  RETURN_IF_NOT_OK(ReadFileToBytes(file_path, bytes));
+  ReadBitBuffer rb(static_cast<int64_t>(bytes.size()), &bytes);
+
+  uint32_t magic;
+  uint8_t version;
+  RETURN_IF_NOT_OK(rb.ReadUnsignedLiteral(32, magic));
+  RETURN_IF_NOT_OK(rb.ReadUnsignedLiteral(8, version));
+  if (magic != kHrirMagic || version != kHrirVersion) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unsupported HRIR file: ", file_path.string(), ". magic= ", magic,
+        " version= ", version));
+  }
+
+  HrirSet hrir_set;
+  std::string layout_key;
+  uint32_t num_taps;
+  RETURN_IF_NOT_OK(rb.ReadUnsignedLiteral(32, hrir_set.sample_rate));
+  RETURN_IF_NOT_OK(rb.ReadString(layout_key));
+  RETURN_IF_NOT_OK(rb.ReadUnsignedLiteral(32, num_taps));
+
+  const auto layout = LookupPrecomputedGainsLayout(layout_key);
+  RETURN_IF_NOT_OK(layout.status());
+  if (layout_key.front() == 'A') {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "HRIRs must be measured for loudspeakers. layout_key= ", layout_key));
+  }
+  if (num_taps == 0 || num_taps > kMaxNumTaps) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported number of taps: ", num_taps));
+  }
+  hrir_set.layout = *layout;
+  hrir_set.num_loudspeakers = GetNumChannels(*layout);
+  hrir_set.num_taps = static_cast<int>(num_taps);
+
+  // Magic, version, sample rate, null-terminated key and number of taps.
+  const size_t header_size = 4 + 1 + 4 + (layout_key.size() + 1) + 4;
+  const size_t num_floats = 2 * hrir_set.num_loudspeakers * num_taps;
+  if (header_size + num_floats * sizeof(float) != bytes.size()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected ", num_floats, " taps in total for layout_key= ", layout_key,
+        " and num_taps= ", num_taps, "."));
+  }
+  hrir_set.impulse_responses.resize(num_floats);
+  for (auto& tap : hrir_set.impulse_responses) {
+    uint32_t tap_bits;
+    RETURN_IF_NOT_OK(rb.ReadUnsignedLiteral(32, tap_bits));
+    tap = std::bit_cast<float>(tap_bits);
+  }
+
+  return hrir_set;
+}
+
+}  // namespace iamf_tools
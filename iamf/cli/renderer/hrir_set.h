@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_RENDERER_HRIR_SET_H_
+#define CLI_RENDERER_HRIR_SET_H_
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "iamf/cli/renderer/precomputed_gains.h"
+
+namespace iamf_tools {
+/*!\brief Head-related impulse responses of a virtual loudspeaker layout.
+ *
+ * Binaural renderers place the audio element on the virtual loudspeakers and
+ * convolve each loudspeaker with the impulse responses to the left and right
+ * ears.
+ *
+ * HRIR files are big-endian and laid out as:
+ *   - `uint32_t` magic, "HRIR".
+ *   - `uint8_t` version, which must be 1.
+ *   - `uint32_t` sample rate of the impulse responses.
+ *   - Null-terminated key of the virtual loudspeaker layout, e.g. "4+7+0".
+ *     Keys are those of `LookupPrecomputedGainsLayout()`, excluding the
+ *     ambisonics layouts.
+ *   - `uint32_t` number of taps of each impulse response.
+ *   - For each loudspeaker, in the EAR channel order of the layout, the taps of
+ *     the left ear followed by the taps of the right ear. Each tap is an
+ *     IEEE-754 `float`.
+ */
+struct HrirSet {
+  /*!\brief Reads an HRIR set from a file.
+   *
+   * \param file_path Path of the file to read.
+   * \return HRIR set on success. A specific status on failure.
+   */
+  static absl::StatusOr<HrirSet> ReadFromFile(
+      const std::filesystem::path& file_path);
+
+  /*!\brief Gets an impulse response.
+   *
+   * \param loudspeaker Index of the loudspeaker in the EAR channel order.
+   * \param ear 0 for the left ear, 1 for the right ear.
+   * \return Taps of the impulse response.
+   */
+  const float* GetImpulseResponse(int loudspeaker, int ear) const {
+    return impulse_responses.data() + (2 * loudspeaker + ear) * num_taps;
+  }
+
+  PrecomputedGainsLayout layout;
+  uint32_t sample_rate;
+  int num_loudspeakers;
+  int num_taps;
+  // Taps, ordered by loudspeaker, then by ear.
+  std::vector<float> impulse_responses;
+};
+
+}  // namespace iamf_tools
+#endif  // CLI_RENDERER_HRIR_SET_H_
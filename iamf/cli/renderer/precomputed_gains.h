@@ -12,24 +12,93 @@
 
 #ifndef CLI_RENDERER_PRECOMPUTED_GAINS_H_
 #define CLI_RENDERER_PRECOMPUTED_GAINS_H_
-#include <string>
-#include <vector>
+#include <cstdint>
+#include <optional>
 
-#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 namespace iamf_tools {
 
-typedef absl::flat_hash_map<
-    std::string,
-    absl::flat_hash_map<std::string, std::vector<std::vector<double>>>>
-    PrecomputedGains;
+/*!\brief Layouts which have precomputed gains.
+ *
+ * Named after the keys of the layouts, e.g. `k4_7_0` is "4+7+0" and `k7_1_2_ch`
+ * is "7.1.2". `kA0` to `kA4` are ambisonics of order zero to four.
+ */
+enum class PrecomputedGainsLayout : uint8_t {
+  k0_1_0,
+  k0_2_0,
+  k0_5_0,
+  k2_5_0,
+  k4_5_0,
+  k4_5_1,
+  k3_7_0,
+  k4_9_0,
+  k9_10_3,
+  k0_7_0,
+  k4_7_0,
+  k3_1_2_ch,
+  k7_1_2_ch,
+  k9_1_6_ch,
+  kA0,
+  kA1,
+  kA2,
+  kA3,
+  kA4,
+};
+
+inline constexpr int kNumPrecomputedGainsLayouts = 19;
+
+/*!\brief View of a precomputed gain matrix.
+ *
+ * The gains are in row-major order, with one row per input channel and one
+ * column per output channel. The view refers to static storage, so it is
+ * cheap to copy and never dangles.
+ */
+struct GainMatrixView {
+  /*!\brief Gets the gains from one input channel to every output channel.
+   *
+   * \param input_channel Index of the input channel.
+   * \return Gains of the input channel.
+   */
+  absl::Span<const double> Row(int input_channel) const {
+    return gains.subspan(input_channel * num_output_channels,
+                         num_output_channels);
+  }
+
+  int num_input_channels = 0;
+  int num_output_channels = 0;
+  absl::Span<const double> gains;
+};
 
-/*!\brief Fills precomputed gains matrices.
+/*!\brief Gets the layout associated with a key.
+ *
+ * \param key Key of the layout, e.g. "0+2+0" or "7.1.2".
+ * \return Layout on success. A specific status if the key is not known.
+ */
+absl::StatusOr<PrecomputedGainsLayout> LookupPrecomputedGainsLayout(
+    absl::string_view key);
+
+/*!\brief Gets the number of channels in a layout.
+ *
+ * \param layout Layout to query.
+ * \return Number of channels in the layout.
+ */
+int GetNumChannels(PrecomputedGainsLayout layout);
+
+/*!\brief Gets the precomputed gains to render between two layouts.
+ *
+ * The gains are stored in constant tables, so this does not allocate.
  *
- * \return Map from input layout name to output layout name to precomputed
- *     gains.
+ * \param input_layout Layout to render from.
+ * \param output_layout Layout to render to.
+ * \return View of the gains. `std::nullopt` if they are not known. Identity
+ *     matrices are not stored, so this is also the case when both layouts are
+ *     the same.
  */
-PrecomputedGains InitPrecomputedGains();
+std::optional<GainMatrixView> LookupPrecomputedGains(
+    PrecomputedGainsLayout input_layout, PrecomputedGainsLayout output_layout);
 
 }  // namespace iamf_tools
 
@@ -22,6 +22,7 @@
 #include "iamf/cli/channel_label.h"
 #include "iamf/cli/demixing_module.h"
 #include "iamf/common/macros.h"
+#include "iamf/obu/audio_element.h"
 #include "iamf/obu/mix_presentation.h"
 
 namespace iamf_tools {
@@ -167,6 +168,31 @@ absl::StatusOr<std::string> LookupOutputKeyFromPlaybackLayout(
   return absl::OkStatus();
 }
 
+absl::StatusOr<std::string> LookupInputKeyFromLoudspeakerLayout(
+    ChannelAudioLayerConfig::LoudspeakerLayout loudspeaker_layout) {
+  using enum ChannelAudioLayerConfig::LoudspeakerLayout;
+  static const absl::NoDestructor<absl::flat_hash_map<
+      ChannelAudioLayerConfig::LoudspeakerLayout, std::string>>
+      kLoudspeakerLayoutToInputKey({
+          {kLayoutMono, "0+1+0"},
+          {kLayoutStereo, "0+2+0"},
+          {kLayout5_1_ch, "0+5+0"},
+          {kLayout5_1_2_ch, "2+5+0"},
+          {kLayout5_1_4_ch, "4+5+0"},
+          {kLayout7_1_ch, "0+7+0"},
+          {kLayout7_1_2_ch, "7.1.2"},
+          {kLayout7_1_4_ch, "4+7+0"},
+          {kLayout3_1_2_ch, "3.1.2"},
+      });
+
+  auto it = kLoudspeakerLayoutToInputKey->find(loudspeaker_layout);
+  if (it == kLoudspeakerLayoutToInputKey->end()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Input key not found for loudspeaker_layout= ", loudspeaker_layout));
+  }
+  return it->second;
+}
+
 }  // namespace renderer_utils
 
 }  // namespace iamf_tools
@@ -19,6 +19,7 @@
 #include "absl/status/statusor.h"
 #include "iamf/cli/channel_label.h"
 #include "iamf/cli/demixing_module.h"
+#include "iamf/obu/audio_element.h"
 #include "iamf/obu/mix_presentation.h"
 
 namespace iamf_tools {
@@ -52,6 +53,17 @@ absl::Status ArrangeSamplesToRender(
 absl::StatusOr<std::string> LookupOutputKeyFromPlaybackLayout(
     const Layout& output_layout);
 
+/*!\brief Gets a key associated with the loudspeaker layout of an audio element.
+ *
+ * The input key uses the same naming as
+ * `LookupOutputKeyFromPlaybackLayout()`, e.g. "0+2+0", "7.1.2".
+ *
+ * \param loudspeaker_layout Layout to get key from.
+ * \return Key associated with the layout. Or a specific status on failure.
+ */
+absl::StatusOr<std::string> LookupInputKeyFromLoudspeakerLayout(
+    ChannelAudioLayerConfig::LoudspeakerLayout loudspeaker_layout);
+
 }  // namespace renderer_utils
 
 }  // namespace iamf_tools
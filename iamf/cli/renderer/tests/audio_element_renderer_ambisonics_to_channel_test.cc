@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/renderer/audio_element_renderer_ambisonics_to_channel.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/cli/audio_element_with_data.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/demixing_module.h"
+#include "iamf/obu/audio_element.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+using enum ChannelLabel::Label;
+
+using enum LoudspeakersSsConventionLayout::SoundSystem;
+
+constexpr uint8_t kInactiveAcn =
+    AmbisonicsMonoConfig::kInactiveAmbisonicsChannelNumber;
+
+const Layout kStereoLayout = {
+    .layout_type = Layout::kLayoutTypeLoudspeakersSsConvention,
+    .specific_layout =
+        LoudspeakersSsConventionLayout{.sound_system = kSoundSystemA_0_2_0}};
+const Layout kBinauralLayout = {.layout_type = Layout::kLayoutTypeBinaural};
+
+AmbisonicsConfig GetMonoConfig(const std::vector<uint8_t>& channel_mapping,
+                               uint8_t substream_count) {
+  return {.ambisonics_mode = AmbisonicsConfig::kAmbisonicsModeMono,
+          .ambisonics_config = AmbisonicsMonoConfig{
+              .output_channel_count =
+                  static_cast<uint8_t>(channel_mapping.size()),
+              .substream_count = substream_count,
+              .channel_mapping = channel_mapping}};
+}
+
+AmbisonicsConfig GetFirstOrderProjectionConfig(
+    uint8_t substream_count, uint8_t coupled_substream_count,
+    const std::vector<int16_t>& demixing_matrix) {
+  return {.ambisonics_mode = AmbisonicsConfig::kAmbisonicsModeProjection,
+          .ambisonics_config = AmbisonicsProjectionConfig{
+              .output_channel_count = 4,
+              .substream_count = substream_count,
+              .coupled_substream_count = coupled_substream_count,
+              .demixing_matrix = demixing_matrix}};
+}
+
+// Finalizes the renderer and returns all samples.
+std::vector<int32_t> FinalizeAndFlush(AudioElementRendererBase& renderer) {
+  EXPECT_THAT(renderer.Finalize(), IsOk());
+  EXPECT_TRUE(renderer.IsFinalized());
+  std::vector<int32_t> rendered_samples;
+  EXPECT_THAT(renderer.Flush(rendered_samples), IsOk());
+  return rendered_samples;
+}
+
+TEST(CreateFromAmbisonicsConfig, SupportsZerothOrderToStereo) {
+  EXPECT_NE(
+      AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+          GetMonoConfig({0}, 1), {0}, {{0, {kA0}}}, kStereoLayout),
+      nullptr);
+}
+
+TEST(CreateFromAmbisonicsConfig, DoesNotSupportBinaural) {
+  EXPECT_EQ(
+      AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+          GetMonoConfig({0}, 1), {0}, {{0, {kA0}}}, kBinauralLayout),
+      nullptr);
+}
+
+TEST(CreateFromAmbisonicsConfig, DoesNotSupportFifthOrder) {
+  std::vector<uint8_t> channel_mapping(36, kInactiveAcn);
+  channel_mapping[0] = 0;
+
+  EXPECT_EQ(
+      AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+          GetMonoConfig(channel_mapping, 1), {0}, {{0, {kA0}}}, kStereoLayout),
+      nullptr);
+}
+
+TEST(CreateFromAmbisonicsConfig,
+     DoesNotSupportProjectionWithInconsistentLabels) {
+  const std::vector<int16_t> kDemixingMatrix(16, 0);
+
+  EXPECT_EQ(
+      AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+          GetFirstOrderProjectionConfig(4, 0, kDemixingMatrix), {0, 1, 2, 3},
+          {{0, {kA0}}, {1, {kA1}}, {2, {kA2}}, {3, {kA3, kA4}}}, kStereoLayout),
+      nullptr);
+}
+
+TEST(RenderLabeledFrame, RendersZerothOrderToStereo) {
+  auto renderer =
+      AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+          GetMonoConfig({0}, 1), {0}, {{0, {kA0}}}, kStereoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(renderer->RenderLabeledFrame(
+                  {.label_to_samples = {{kA0, {1000000}}}}),
+              IsOk());
+
+  EXPECT_EQ(FinalizeAndFlush(*renderer),
+            std::vector<int32_t>({707100, 707112}));
+}
+
+TEST(RenderLabeledFrame, SkipsChannelsOmittedByMixedOrderAmbisonics) {
+  // A1 is omitted, so there are no samples for it.
+  auto renderer =
+      AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+          GetMonoConfig({0, kInactiveAcn, 1, 2}, 3), {0, 1, 2},
+          {{0, {kA0}}, {1, {kA2}}, {2, {kA3}}}, kStereoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(renderer->RenderLabeledFrame({.label_to_samples = {
+                                                {kA0, {1000000}},
+                                                {kA2, {1000000}},
+                                                {kA3, {1000000}},
+                                            }}),
+              IsOk());
+
+  EXPECT_EQ(FinalizeAndFlush(*renderer),
+            std::vector<int32_t>({697765, 697805}));
+}
+
+TEST(RenderLabeledFrame, AppliesTheDemixingMatrixOfProjectionConfigs) {
+  // The first decoded channel is mapped to half of A1. The others are unused.
+  std::vector<int16_t> demixing_matrix(16, 0);
+  demixing_matrix[1] = 16384;
+  auto renderer =
+      AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+          GetFirstOrderProjectionConfig(4, 0, demixing_matrix), {0, 1, 2, 3},
+          {{0, {kA0}}, {1, {kA1}}, {2, {kA2}}, {3, {kA3}}}, kStereoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(renderer->RenderLabeledFrame({.label_to_samples = {
+                                                {kA0, {1000000}},
+                                                {kA1, {1000000}},
+                                                {kA2, {1000000}},
+                                                {kA3, {1000000}},
+                                            }}),
+              IsOk());
+
+  EXPECT_EQ(FinalizeAndFlush(*renderer),
+            std::vector<int32_t>({286051, -286047}));
+}
+
+TEST(RenderLabeledFrame, OrdersDecodedChannelsBySubstream) {
+  // The first substream is coupled, so it holds the first two channels.
+  std::vector<int16_t> demixing_matrix(16, 0);
+  demixing_matrix[1] = 16384;
+  auto renderer =
+      AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+          GetFirstOrderProjectionConfig(3, 1, demixing_matrix), {20, 10, 30},
+          {{10, {kA2}}, {20, {kA0, kA1}}, {30, {kA3}}}, kStereoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(renderer->RenderLabeledFrame({.label_to_samples = {
+                                                {kA0, {1000000}},
+                                                {kA1, {0}},
+                                                {kA2, {0}},
+                                                {kA3, {0}},
+                                            }}),
+              IsOk());
+
+  EXPECT_EQ(FinalizeAndFlush(*renderer),
+            std::vector<int32_t>({286051, -286047}));
+}
+
+}  // namespace
+}  // namespace iamf_tools
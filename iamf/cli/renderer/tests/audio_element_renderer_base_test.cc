@@ -13,6 +13,7 @@
 #include "iamf/cli/renderer/audio_element_renderer_base.h"
 
 #include <cstdint>
+#include <thread>
 #include <vector>
 
 #include "absl/status/status_matchers.h"
@@ -55,6 +56,36 @@ TEST(AudioElementRendererBase, BaseImmediatelyAfterFinalizeIsFinalized) {
   EXPECT_TRUE(renderer.IsFinalized());
 }
 
+// Mock renderer which finishes finalizing on another thread.
+class MockAsynchronousAudioElementRenderer : public MockAudioElementRenderer {
+ public:
+  ~MockAsynchronousAudioElementRenderer() override {
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+  }
+
+  absl::Status Finalize() override {
+    worker_ = std::thread([this]() {
+      absl::MutexLock lock(&mutex_);
+      is_finalized_ = true;
+    });
+    return absl::OkStatus();
+  }
+
+ private:
+  std::thread worker_;
+};
+
+TEST(AudioElementRendererBase, WaitUntilFinalizedReturnsAfterFinalizing) {
+  MockAsynchronousAudioElementRenderer renderer;
+  EXPECT_THAT(renderer.Finalize(), IsOk());
+
+  renderer.WaitUntilFinalized();
+
+  EXPECT_TRUE(renderer.IsFinalized());
+}
+
 TEST(AudioElementRendererBase, FinalizeAndFlushWithOutRenderingSucceeds) {
   MockAudioElementRenderer renderer;
   EXPECT_THAT(renderer.Finalize(), IsOk());
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/renderer/audio_element_renderer_binaural.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/demixing_module.h"
+#include "iamf/cli/renderer/hrir_set.h"
+#include "iamf/cli/renderer/precomputed_gains.h"
+#include "iamf/obu/audio_element.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::testing::ElementsAre;
+using enum ChannelLabel::Label;
+
+using enum ChannelAudioLayerConfig::LoudspeakerLayout;
+
+constexpr int kBlockSize = AudioElementRendererBinaural::kBlockSize;
+
+const ScalableChannelLayoutConfig kMonoScalableChannelLayoutConfig = {
+    .num_layers = 1,
+    .channel_audio_layer_configs = {{.loudspeaker_layout = kLayoutMono}}};
+const ScalableChannelLayoutConfig kStereoScalableChannelLayoutConfig = {
+    .num_layers = 1,
+    .channel_audio_layer_configs = {{.loudspeaker_layout = kLayoutStereo}}};
+const ScalableChannelLayoutConfig k7_1_4ScalableChannelLayoutConfig = {
+    .num_layers = 1,
+    .channel_audio_layer_configs = {{.loudspeaker_layout = kLayout7_1_4_ch}}};
+const ScalableChannelLayoutConfig kBinauralScalableChannelLayoutConfig = {
+    .num_layers = 1,
+    .channel_audio_layer_configs = {{.loudspeaker_layout = kLayoutBinaural}}};
+
+// Gets stereo HRIRs where each loudspeaker is only heard by the ear on its
+// side, with unity gain.
+HrirSet GetIdealStereoHrirSet() {
+  return {.layout = PrecomputedGainsLayout::k0_2_0,
+          .sample_rate = 48000,
+          .num_loudspeakers = 2,
+          .num_taps = 1,
+          .impulse_responses = {1.0f, 0.0f, 0.0f, 1.0f}};
+}
+
+// Gets stereo HRIRs which span several partitions, with a different decaying
+// response for each loudspeaker and ear.
+HrirSet GetLongStereoHrirSet() {
+  constexpr int kNumTaps = 2 * kBlockSize + 37;
+  HrirSet hrir_set = {.layout = PrecomputedGainsLayout::k0_2_0,
+                      .sample_rate = 48000,
+                      .num_loudspeakers = 2,
+                      .num_taps = kNumTaps};
+  for (int ir = 0; ir < 4; ++ir) {
+    for (int t = 0; t < kNumTaps; ++t) {
+      hrir_set.impulse_responses.push_back(
+          std::cos(0.1 * (ir + 1) * t) * std::exp(-0.01 * t) / (ir + 1));
+    }
+  }
+  return hrir_set;
+}
+
+// Renders the frames, finalizes the renderer and returns all samples.
+std::vector<int32_t> RenderAndFlush(
+    AudioElementRendererBinaural& renderer,
+    const std::vector<LabeledFrame>& labeled_frames) {
+  for (const auto& labeled_frame : labeled_frames) {
+    EXPECT_THAT(renderer.RenderLabeledFrame(labeled_frame), IsOk());
+  }
+  EXPECT_THAT(renderer.Finalize(), IsOk());
+  EXPECT_TRUE(renderer.IsFinalized());
+  std::vector<int32_t> rendered_samples;
+  EXPECT_THAT(renderer.Flush(rendered_samples), IsOk());
+  return rendered_samples;
+}
+
+TEST(CreateFromScalableChannelLayoutConfig, SupportsTheLayoutOfTheHrirs) {
+  EXPECT_NE(AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+                kStereoScalableChannelLayoutConfig, GetIdealStereoHrirSet()),
+            nullptr);
+}
+
+TEST(CreateFromScalableChannelLayoutConfig, SupportsUpMixingToTheHrirs) {
+  EXPECT_NE(AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+                kMonoScalableChannelLayoutConfig, GetIdealStereoHrirSet()),
+            nullptr);
+}
+
+TEST(CreateFromScalableChannelLayoutConfig, SupportsDownMixingToTheHrirs) {
+  EXPECT_NE(AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+                k7_1_4ScalableChannelLayoutConfig, GetIdealStereoHrirSet()),
+            nullptr);
+}
+
+TEST(CreateFromScalableChannelLayoutConfig, DoesNotSupportBinauralInput) {
+  EXPECT_EQ(AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+                kBinauralScalableChannelLayoutConfig, GetIdealStereoHrirSet()),
+            nullptr);
+}
+
+TEST(RenderLabeledFrame, RendersWithIdealHrirs) {
+  auto renderer =
+      AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+          kStereoScalableChannelLayoutConfig, GetIdealStereoHrirSet());
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(RenderAndFlush(*renderer,
+                             {{.label_to_samples = {{kL2, {1000, 2000, 3000}},
+                                                    {kR2, {-1, -2, -3}}}}}),
+              ElementsAre(1000, -1, 2000, -2, 3000, -3));
+}
+
+TEST(RenderLabeledFrame, RendersOnlyCompleteBlocksBeforeFinalize) {
+  auto renderer =
+      AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+          kMonoScalableChannelLayoutConfig, GetIdealStereoHrirSet());
+  ASSERT_NE(renderer, nullptr);
+  const std::vector<int32_t> samples(kBlockSize + 1, 1000);
+
+  EXPECT_THAT(renderer->RenderLabeledFrame({.label_to_samples = {
+                                                {kMono, samples}}}),
+              IsOk());
+  std::vector<int32_t> rendered_samples;
+  EXPECT_THAT(renderer->Flush(rendered_samples), IsOk());
+  EXPECT_EQ(rendered_samples.size(), 2 * kBlockSize);
+
+  EXPECT_THAT(renderer->Finalize(), IsOk());
+  EXPECT_THAT(renderer->Flush(rendered_samples), IsOk());
+  EXPECT_EQ(rendered_samples.size(), 2 * (kBlockSize + 1));
+}
+
+TEST(RenderLabeledFrame, MatchesDirectConvolutionAcrossFrames) {
+  const HrirSet hrir_set = GetLongStereoHrirSet();
+  auto renderer =
+      AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+          kStereoScalableChannelLayoutConfig, hrir_set);
+  ASSERT_NE(renderer, nullptr);
+  // Frames which are not aligned with the blocks.
+  constexpr int kNumFrames = 5;
+  constexpr int kNumTicksPerFrame = 240;
+  constexpr int kNumTicks = kNumFrames * kNumTicksPerFrame;
+  std::vector<std::vector<int32_t>> input(2, std::vector<int32_t>(kNumTicks));
+  for (int t = 0; t < kNumTicks; ++t) {
+    input[0][t] = static_cast<int32_t>(10000 * std::sin(0.05 * t));
+    input[1][t] = static_cast<int32_t>(5000 * std::cos(0.21 * t));
+  }
+  std::vector<LabeledFrame> labeled_frames;
+  for (int f = 0; f < kNumFrames; ++f) {
+    const auto first = f * kNumTicksPerFrame;
+    const auto last = first + kNumTicksPerFrame;
+    labeled_frames.push_back(
+        {.label_to_samples = {
+             {kL2, std::vector<int32_t>(input[0].begin() + first,
+                                        input[0].begin() + last)},
+             {kR2, std::vector<int32_t>(input[1].begin() + first,
+                                        input[1].begin() + last)}}});
+  }
+
+  const auto rendered_samples = RenderAndFlush(*renderer, labeled_frames);
+
+  ASSERT_EQ(rendered_samples.size(), 2 * kNumTicks);
+  for (int t = 0; t < kNumTicks; ++t) {
+    for (int ear = 0; ear < 2; ++ear) {
+      double expected = 0.0;
+      for (int loudspeaker = 0; loudspeaker < 2; ++loudspeaker) {
+        const float* ir = hrir_set.GetImpulseResponse(loudspeaker, ear);
+        for (int k = 0; k < hrir_set.num_taps && k <= t; ++k) {
+          expected += ir[k] * input[loudspeaker][t - k];
+        }
+      }
+      EXPECT_NEAR(rendered_samples[2 * t + ear], expected, 2.0);
+    }
+  }
+}
+
+TEST(RenderLabeledFrame, FailsAfterFinalize) {
+  auto renderer =
+      AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+          kStereoScalableChannelLayoutConfig, GetIdealStereoHrirSet());
+  ASSERT_NE(renderer, nullptr);
+  EXPECT_THAT(renderer->Finalize(), IsOk());
+
+  EXPECT_FALSE(renderer
+                   ->RenderLabeledFrame({.label_to_samples = {{kL2, {1}},
+                                                              {kR2, {1}}}})
+                   .ok());
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/renderer/audio_element_renderer_channel_to_channel.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/demixing_module.h"
+#include "iamf/obu/audio_element.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+using enum ChannelLabel::Label;
+
+using enum LoudspeakersSsConventionLayout::SoundSystem;
+using enum ChannelAudioLayerConfig::LoudspeakerLayout;
+
+constexpr int32_t kMaxInt32 = std::numeric_limits<int32_t>::max();
+
+const Layout kMonoLayout = {
+    .layout_type = Layout::kLayoutTypeLoudspeakersSsConvention,
+    .specific_layout =
+        LoudspeakersSsConventionLayout{.sound_system = kSoundSystem12_0_1_0}};
+const Layout kStereoLayout = {
+    .layout_type = Layout::kLayoutTypeLoudspeakersSsConvention,
+    .specific_layout =
+        LoudspeakersSsConventionLayout{.sound_system = kSoundSystemA_0_2_0}};
+const Layout kBinauralLayout = {.layout_type = Layout::kLayoutTypeBinaural};
+
+const ScalableChannelLayoutConfig kMonoScalableChannelLayoutConfig = {
+    .num_layers = 1,
+    .channel_audio_layer_configs = {{.loudspeaker_layout = kLayoutMono}}};
+const ScalableChannelLayoutConfig kStereoScalableChannelLayoutConfig = {
+    .num_layers = 1,
+    .channel_audio_layer_configs = {{.loudspeaker_layout = kLayoutStereo}}};
+const ScalableChannelLayoutConfig kStereoChannelConfigWithTwoLayers = {
+    .num_layers = 2,
+    .channel_audio_layer_configs = {{.loudspeaker_layout = kLayoutMono},
+                                    {.loudspeaker_layout = kLayoutStereo}}};
+const ScalableChannelLayoutConfig k5_1ScalableChannelLayoutConfig = {
+    .num_layers = 1,
+    .channel_audio_layer_configs = {{.loudspeaker_layout = kLayout5_1_ch}}};
+const ScalableChannelLayoutConfig kBinauralScalableChannelLayoutConfig = {
+    .num_layers = 1,
+    .channel_audio_layer_configs = {{.loudspeaker_layout = kLayoutBinaural}}};
+
+// Finalizes the renderer and returns all samples.
+std::vector<int32_t> FinalizeAndFlush(AudioElementRendererBase& renderer) {
+  EXPECT_THAT(renderer.Finalize(), IsOk());
+  EXPECT_TRUE(renderer.IsFinalized());
+  std::vector<int32_t> rendered_samples;
+  EXPECT_THAT(renderer.Flush(rendered_samples), IsOk());
+  return rendered_samples;
+}
+
+TEST(CreateFromScalableChannelLayoutConfig, SupportsDownMixingStereoToMono) {
+  EXPECT_NE(AudioElementRendererChannelToChannel::
+                CreateFromScalableChannelLayoutConfig(
+                    kStereoScalableChannelLayoutConfig, kMonoLayout),
+            nullptr);
+}
+
+TEST(CreateFromScalableChannelLayoutConfig, SupportsUpMixingMonoToStereo) {
+  EXPECT_NE(AudioElementRendererChannelToChannel::
+                CreateFromScalableChannelLayoutConfig(
+                    kMonoScalableChannelLayoutConfig, kStereoLayout),
+            nullptr);
+}
+
+TEST(CreateFromScalableChannelLayoutConfig, DoesNotSupportBinauralInput) {
+  EXPECT_EQ(AudioElementRendererChannelToChannel::
+                CreateFromScalableChannelLayoutConfig(
+                    kBinauralScalableChannelLayoutConfig, kStereoLayout),
+            nullptr);
+}
+
+TEST(CreateFromScalableChannelLayoutConfig, DoesNotSupportBinauralOutput) {
+  EXPECT_EQ(AudioElementRendererChannelToChannel::
+                CreateFromScalableChannelLayoutConfig(
+                    kStereoScalableChannelLayoutConfig, kBinauralLayout),
+            nullptr);
+}
+
+TEST(CreateFromScalableChannelLayoutConfig, DoesNotSupportEmptyConfig) {
+  EXPECT_EQ(AudioElementRendererChannelToChannel::
+                CreateFromScalableChannelLayoutConfig(
+                    {.num_layers = 0, .channel_audio_layer_configs = {}},
+                    kStereoLayout),
+            nullptr);
+}
+
+TEST(RenderLabeledFrame, DownMixesStereoToMono) {
+  auto renderer = AudioElementRendererChannelToChannel::
+      CreateFromScalableChannelLayoutConfig(kStereoScalableChannelLayoutConfig,
+                                            kMonoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(
+      renderer->RenderLabeledFrame(
+          {.label_to_samples = {{kL2, {100, 300}}, {kR2, {200, -100}}}}),
+      IsOk());
+
+  EXPECT_EQ(FinalizeAndFlush(*renderer), std::vector<int32_t>({150, 100}));
+}
+
+TEST(RenderLabeledFrame, UpMixesMonoToStereo) {
+  auto renderer = AudioElementRendererChannelToChannel::
+      CreateFromScalableChannelLayoutConfig(kMonoScalableChannelLayoutConfig,
+                                            kStereoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(
+      renderer->RenderLabeledFrame({.label_to_samples = {{kMono, {1000}}}}),
+      IsOk());
+
+  EXPECT_EQ(FinalizeAndFlush(*renderer), std::vector<int32_t>({707, 707}));
+}
+
+TEST(RenderLabeledFrame, DownMixes5_1ToStereo) {
+  auto renderer = AudioElementRendererChannelToChannel::
+      CreateFromScalableChannelLayoutConfig(k5_1ScalableChannelLayoutConfig,
+                                            kStereoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(renderer->RenderLabeledFrame({.label_to_samples = {
+                                                {kL5, {10}},
+                                                {kR5, {20}},
+                                                {kCentre, {100}},
+                                                {kLFE, {1000}},
+                                                {kLs5, {200}},
+                                                {kRs5, {0}},
+                                            }}),
+              IsOk());
+
+  // The LFE is dropped and the centre is split between both outputs.
+  EXPECT_EQ(FinalizeAndFlush(*renderer), std::vector<int32_t>({222, 90}));
+}
+
+TEST(RenderLabeledFrame, RendersFromTheHighestLayer) {
+  auto renderer = AudioElementRendererChannelToChannel::
+      CreateFromScalableChannelLayoutConfig(kStereoChannelConfigWithTwoLayers,
+                                            kMonoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(renderer->RenderLabeledFrame(
+                  {.label_to_samples = {{kL2, {100}}, {kR2, {300}}}}),
+              IsOk());
+
+  EXPECT_EQ(FinalizeAndFlush(*renderer), std::vector<int32_t>({200}));
+}
+
+TEST(RenderLabeledFrame, ClipsToTheRangeOfInt32) {
+  auto renderer = AudioElementRendererChannelToChannel::
+      CreateFromScalableChannelLayoutConfig(k5_1ScalableChannelLayoutConfig,
+                                            kStereoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  EXPECT_THAT(renderer->RenderLabeledFrame({.label_to_samples = {
+                                                {kL5, {kMaxInt32}},
+                                                {kR5, {0}},
+                                                {kCentre, {kMaxInt32}},
+                                                {kLFE, {0}},
+                                                {kLs5, {0}},
+                                                {kRs5, {0}},
+                                            }}),
+              IsOk());
+
+  const auto rendered_samples = FinalizeAndFlush(*renderer);
+  ASSERT_EQ(rendered_samples.size(), 2);
+  EXPECT_EQ(rendered_samples[0], kMaxInt32);
+}
+
+TEST(RenderLabeledFrame, OutputsFramesInTheOrderTheyWereReceived) {
+  auto renderer = AudioElementRendererChannelToChannel::
+      CreateFromScalableChannelLayoutConfig(kStereoScalableChannelLayoutConfig,
+                                            kMonoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  for (int32_t i = 0; i < 100; ++i) {
+    EXPECT_THAT(renderer->RenderLabeledFrame(
+                    {.label_to_samples = {{kL2, {i}}, {kR2, {i}}}}),
+                IsOk());
+  }
+
+  std::vector<int32_t> expected_samples;
+  for (int32_t i = 0; i < 100; ++i) {
+    expected_samples.push_back(i);
+  }
+  EXPECT_EQ(FinalizeAndFlush(*renderer), expected_samples);
+}
+
+TEST(RenderLabeledFrame, ReturnsNumberOfTicks) {
+  auto renderer = AudioElementRendererChannelToChannel::
+      CreateFromScalableChannelLayoutConfig(kStereoScalableChannelLayoutConfig,
+                                            kMonoLayout);
+  ASSERT_NE(renderer, nullptr);
+
+  const auto num_ticks = renderer->RenderLabeledFrame(
+      {.label_to_samples = {{kL2, {1, 2, 3}}, {kR2, {4, 5, 6}}}});
+
+  ASSERT_THAT(num_ticks, IsOk());
+  EXPECT_EQ(*num_ticks, 3);
+}
+
+TEST(RenderLabeledFrame, FailsAfterFinalize) {
+  auto renderer = AudioElementRendererChannelToChannel::
+      CreateFromScalableChannelLayoutConfig(kStereoScalableChannelLayoutConfig,
+                                            kMonoLayout);
+  ASSERT_NE(renderer, nullptr);
+  EXPECT_THAT(renderer->Finalize(), IsOk());
+
+  EXPECT_FALSE(renderer
+                   ->RenderLabeledFrame(
+                       {.label_to_samples = {{kL2, {1}}, {kR2, {1}}}})
+                   .ok());
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/renderer/fft.h"
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace iamf_tools {
+namespace {
+
+constexpr float kTolerance = 1e-4;
+
+// Gets an arbitrary signal without any symmetry.
+void GetSignal(int size, std::vector<float>& real, std::vector<float>& imag) {
+  real.resize(size);
+  imag.resize(size);
+  for (int n = 0; n < size; ++n) {
+    real[n] = std::sin(0.3 * n) + 0.25 * n / size;
+    imag[n] = std::cos(1.7 * n) - 0.5;
+  }
+}
+
+TEST(Fft, SizeIsConfigured) { EXPECT_EQ(Fft(64).size(), 64); }
+
+TEST(Forward, TransformsAnImpulseToAFlatSpectrum) {
+  std::vector<float> real(8, 0.0f);
+  std::vector<float> imag(8, 0.0f);
+  real[0] = 1.0f;
+
+  Fft(8).Forward(absl::MakeSpan(real), absl::MakeSpan(imag));
+
+  EXPECT_EQ(real, std::vector<float>(8, 1.0f));
+  EXPECT_EQ(imag, std::vector<float>(8, 0.0f));
+}
+
+TEST(Forward, MatchesTheDiscreteFourierTransform) {
+  constexpr int kSize = 32;
+  std::vector<float> real, imag;
+  GetSignal(kSize, real, imag);
+  const std::vector<float> input_real = real;
+  const std::vector<float> input_imag = imag;
+
+  Fft(kSize).Forward(absl::MakeSpan(real), absl::MakeSpan(imag));
+
+  for (int k = 0; k < kSize; ++k) {
+    double expected_real = 0.0;
+    double expected_imag = 0.0;
+    for (int n = 0; n < kSize; ++n) {
+      const double angle = -2.0 * std::numbers::pi * k * n / kSize;
+      expected_real +=
+          input_real[n] * std::cos(angle) - input_imag[n] * std::sin(angle);
+      expected_imag +=
+          input_real[n] * std::sin(angle) + input_imag[n] * std::cos(angle);
+    }
+    EXPECT_NEAR(real[k], expected_real, kTolerance);
+    EXPECT_NEAR(imag[k], expected_imag, kTolerance);
+  }
+}
+
+TEST(Inverse, UndoesTheForwardTransform) {
+  constexpr int kSize = 512;
+  std::vector<float> real, imag;
+  GetSignal(kSize, real, imag);
+  const std::vector<float> input_real = real;
+  const std::vector<float> input_imag = imag;
+  const Fft fft(kSize);
+
+  fft.Forward(absl::MakeSpan(real), absl::MakeSpan(imag));
+  fft.Inverse(absl::MakeSpan(real), absl::MakeSpan(imag));
+
+  for (int n = 0; n < kSize; ++n) {
+    EXPECT_NEAR(real[n], input_real[n], kTolerance);
+    EXPECT_NEAR(imag[n], input_imag[n], kTolerance);
+  }
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/renderer/hrir_set.h"
+
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/cli/renderer/precomputed_gains.h"
+#include "iamf/cli/tests/cli_test_utils.h"
+#include "iamf/common/write_bit_buffer.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::testing::ElementsAre;
+
+constexpr uint32_t kMagic = 0x48524952;
+constexpr uint8_t kVersion = 1;
+constexpr uint32_t kSampleRate = 48000;
+
+// Writes an HRIR file and returns its path.
+std::filesystem::path WriteHrirFile(uint32_t magic, const std::string& key,
+                                    uint32_t num_taps,
+                                    const std::vector<float>& taps) {
+  const std::filesystem::path file_path(GetAndCleanupOutputFileName(".hrir"));
+  WriteBitBuffer wb(0);
+  EXPECT_THAT(wb.WriteUnsignedLiteral(magic, 32), IsOk());
+  EXPECT_THAT(wb.WriteUnsignedLiteral(kVersion, 8), IsOk());
+  EXPECT_THAT(wb.WriteUnsignedLiteral(kSampleRate, 32), IsOk());
+  EXPECT_THAT(wb.WriteString(key), IsOk());
+  EXPECT_THAT(wb.WriteUnsignedLiteral(num_taps, 32), IsOk());
+  for (const float tap : taps) {
+    EXPECT_THAT(wb.WriteUnsignedLiteral(std::bit_cast<uint32_t>(tap), 32),
+                IsOk());
+  }
+  std::fstream output_file(file_path.string(),
+                           std::fstream::out | std::fstream::binary);
+  EXPECT_THAT(wb.FlushAndWriteToFile(output_file), IsOk());
+  output_file.close();
+  return file_path;
+}
+
+TEST(ReadFromFile, ReadsStereoHrirs) {
+  // Left and right loudspeakers, each with two taps per ear.
+  const auto file_path = WriteHrirFile(
+      kMagic, "0+2+0", 2, {1.0f, 0.5f, 0.25f, 0.0f, -0.25f, 0.0f, 0.5f, 1.0f});
+
+  const auto hrir_set = HrirSet::ReadFromFile(file_path);
+  ASSERT_THAT(hrir_set, IsOk());
+
+  EXPECT_EQ(hrir_set->layout, PrecomputedGainsLayout::k0_2_0);
+  EXPECT_EQ(hrir_set->sample_rate, kSampleRate);
+  EXPECT_EQ(hrir_set->num_loudspeakers, 2);
+  EXPECT_EQ(hrir_set->num_taps, 2);
+  const float* right_speaker_to_left_ear = hrir_set->GetImpulseResponse(1, 0);
+  EXPECT_THAT(std::vector<float>(right_speaker_to_left_ear,
+                                 right_speaker_to_left_ear + 2),
+              ElementsAre(-0.25f, 0.0f));
+}
+
+TEST(ReadFromFile, FailsIfFileDoesNotExist) {
+  const std::filesystem::path file_path(GetAndCleanupOutputFileName(".hrir"));
+
+  EXPECT_FALSE(HrirSet::ReadFromFile(file_path).ok());
+}
+
+TEST(ReadFromFile, FailsForUnknownMagic) {
+  const auto file_path = WriteHrirFile(0x52494646, "0+1+0", 1, {1.0f, 1.0f});
+
+  EXPECT_FALSE(HrirSet::ReadFromFile(file_path).ok());
+}
+
+TEST(ReadFromFile, FailsForAmbisonicsLayouts) {
+  const auto file_path = WriteHrirFile(kMagic, "A0", 1, {1.0f, 1.0f});
+
+  EXPECT_FALSE(HrirSet::ReadFromFile(file_path).ok());
+}
+
+TEST(ReadFromFile, FailsIfTapsAreMissing) {
+  // Stereo needs four impulse responses.
+  const auto file_path = WriteHrirFile(kMagic, "0+2+0", 1, {1.0f, 1.0f});
+
+  EXPECT_FALSE(HrirSet::ReadFromFile(file_path).ok());
+}
+
+}  // namespace
+}  // namespace iamf_tools
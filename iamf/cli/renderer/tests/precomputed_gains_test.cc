@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/renderer/precomputed_gains.h"
+
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::testing::ElementsAre;
+using enum PrecomputedGainsLayout;
+
+TEST(LookupPrecomputedGainsLayout, FindsLoudspeakerLayouts) {
+  const auto layout = LookupPrecomputedGainsLayout("4+7+0");
+  ASSERT_THAT(layout, IsOk());
+  EXPECT_EQ(*layout, k4_7_0);
+
+  const auto layout_with_dots = LookupPrecomputedGainsLayout("7.1.2");
+  ASSERT_THAT(layout_with_dots, IsOk());
+  EXPECT_EQ(*layout_with_dots, k7_1_2_ch);
+}
+
+TEST(LookupPrecomputedGainsLayout, FindsAmbisonicsLayouts) {
+  const auto layout = LookupPrecomputedGainsLayout("A2");
+  ASSERT_THAT(layout, IsOk());
+  EXPECT_EQ(*layout, kA2);
+  EXPECT_EQ(GetNumChannels(kA2), 9);
+}
+
+TEST(LookupPrecomputedGainsLayout, FailsForUnknownKey) {
+  EXPECT_FALSE(LookupPrecomputedGainsLayout("1+1+1").ok());
+}
+
+TEST(LookupPrecomputedGains, GetsMonoToStereo) {
+  const auto gains = LookupPrecomputedGains(k0_1_0, k0_2_0);
+  ASSERT_TRUE(gains.has_value());
+
+  EXPECT_EQ(gains->num_input_channels, 1);
+  EXPECT_EQ(gains->num_output_channels, 2);
+  EXPECT_THAT(gains->gains,
+              ElementsAre(0.7071067811865476, 0.7071067811865476));
+}
+
+TEST(LookupPrecomputedGains, GetsRowsOfTheInputChannels) {
+  const auto gains = LookupPrecomputedGains(k0_5_0, k0_2_0);
+  ASSERT_TRUE(gains.has_value());
+
+  EXPECT_EQ(gains->num_input_channels, 6);
+  EXPECT_THAT(gains->Row(0), ElementsAre(1, 0));
+  EXPECT_THAT(gains->Row(2),
+              ElementsAre(0.7071067811865476, 0.7071067811865476));
+  EXPECT_THAT(gains->Row(5), ElementsAre(0, 0.7071067811865476));
+}
+
+TEST(LookupPrecomputedGains, DoesNotStoreIdentityMatrices) {
+  EXPECT_FALSE(LookupPrecomputedGains(k0_2_0, k0_2_0).has_value());
+}
+
+TEST(LookupPrecomputedGains, DoesNotStoreGainsToAmbisonics) {
+  EXPECT_FALSE(LookupPrecomputedGains(k0_2_0, kA1).has_value());
+}
+
+TEST(LookupPrecomputedGains, EveryMatrixHasTheShapeOfItsLayouts) {
+  int num_matrices = 0;
+  for (int input = 0; input < kNumPrecomputedGainsLayouts; ++input) {
+    for (int output = 0; output < kNumPrecomputedGainsLayouts; ++output) {
+      const auto input_layout = static_cast<PrecomputedGainsLayout>(input);
+      const auto output_layout = static_cast<PrecomputedGainsLayout>(output);
+      const auto gains = LookupPrecomputedGains(input_layout, output_layout);
+      if (!gains.has_value()) {
+        continue;
+      }
+      num_matrices++;
+      EXPECT_EQ(gains->num_input_channels, GetNumChannels(input_layout));
+      EXPECT_EQ(gains->num_output_channels, GetNumChannels(output_layout));
+      EXPECT_EQ(gains->gains.size(),
+                gains->num_input_channels * gains->num_output_channels);
+    }
+  }
+
+  EXPECT_EQ(num_matrices, 200);
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -20,6 +20,7 @@
 #include "gtest/gtest.h"
 #include "iamf/cli/channel_label.h"
 #include "iamf/cli/demixing_module.h"
+#include "iamf/obu/audio_element.h"
 #include "iamf/obu/mix_presentation.h"
 
 namespace iamf_tools {
@@ -192,6 +193,19 @@ TEST(LookupOutputKeyFromPlaybackLayout, FailsOnReservedLayout) {
                    .ok());
 }
 
+TEST(LookupInputKeyFromLoudspeakerLayout, SucceedsForChannelBasedLayout) {
+  const auto input_key = LookupInputKeyFromLoudspeakerLayout(
+      ChannelAudioLayerConfig::kLayout7_1_4_ch);
+  EXPECT_THAT(input_key, IsOk());
+  EXPECT_EQ(*input_key, "4+7+0");
+}
+
+TEST(LookupInputKeyFromLoudspeakerLayout, FailsOnBinauralLayout) {
+  EXPECT_FALSE(LookupInputKeyFromLoudspeakerLayout(
+                   ChannelAudioLayerConfig::kLayoutBinaural)
+                   .ok());
+}
+
 }  // namespace
 }  // namespace renderer_utils
 }  // namespace iamf_tools
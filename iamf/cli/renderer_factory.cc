@@ -11,11 +11,19 @@
  */
 #include "iamf/cli/renderer_factory.h"
 
+#include <cstdint>
 #include <memory>
+#include <variant>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "iamf/cli/audio_element_with_data.h"
+#include "iamf/cli/renderer/audio_element_renderer_ambisonics_to_channel.h"
 #include "iamf/cli/renderer/audio_element_renderer_base.h"
+#include "iamf/cli/renderer/audio_element_renderer_binaural.h"
+#include "iamf/cli/renderer/audio_element_renderer_channel_to_channel.h"
+#include "iamf/cli/renderer/audio_element_renderer_passthrough.h"
 #include "iamf/obu/audio_element.h"
 #include "iamf/obu/leb128.h"
 #include "iamf/obu/mix_presentation.h"
@@ -31,10 +39,55 @@ RendererFactory::CreateRendererForLayout(
     AudioElementObu::AudioElementType audio_element_type,
     const AudioElementObu::AudioElementConfig& config,
     const Layout& loudness_layout) const {
-  // TODO(b/332567539): Implement and return renderers depending on the input
-  //                    audio element and output layout.
+  // TODO(b/332567539): Implement and return renderers for scene-based audio
+  //                     elements to binaural layouts.
+  if (audio_element_type == AudioElementObu::kAudioElementSceneBased) {
+    const auto* ambisonics_config = std::get_if<AmbisonicsConfig>(&config);
+    if (ambisonics_config == nullptr) {
+      return nullptr;
+    }
+    return AudioElementRendererAmbisonicsToChannel::CreateFromAmbisonicsConfig(
+        *ambisonics_config, audio_substream_ids, substream_id_to_labels,
+        loudness_layout);
+  }
 
-  return nullptr;
+  if (audio_element_type != AudioElementObu::kAudioElementChannelBased) {
+    return nullptr;
+  }
+  const auto* scalable_channel_layout_config =
+      std::get_if<ScalableChannelLayoutConfig>(&config);
+  if (scalable_channel_layout_config == nullptr) {
+    return nullptr;
+  }
+
+  // Prefer passing through a matching layer over down-mixing or up-mixing.
+  auto pass_through_renderer =
+      AudioElementRendererPassThrough::CreateFromScalableChannelLayoutConfig(
+          *scalable_channel_layout_config, loudness_layout);
+  if (pass_through_renderer != nullptr) {
+    return pass_through_renderer;
+  }
+  if (loudness_layout.layout_type == Layout::kLayoutTypeBinaural) {
+    if (hrir_set_ == nullptr) {
+      return nullptr;
+    }
+    return AudioElementRendererBinaural::CreateFromScalableChannelLayoutConfig(
+        *scalable_channel_layout_config, *hrir_set_);
+  }
+  return AudioElementRendererChannelToChannel::
+      CreateFromScalableChannelLayoutConfig(*scalable_channel_layout_config,
+                                            loudness_layout);
+}
+
+absl::Status RendererFactory::ValidateSampleRate(const Layout& loudness_layout,
+                                                 uint32_t sample_rate) const {
+  if (loudness_layout.layout_type == Layout::kLayoutTypeBinaural &&
+      hrir_set_ != nullptr && hrir_set_->sample_rate != sample_rate) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "HRIRs have a sample rate of ", hrir_set_->sample_rate,
+        ", but binaural layouts are rendered at ", sample_rate, "."));
+  }
+  return absl::OkStatus();
 }
 
 }  // namespace iamf_tools
@@ -12,11 +12,15 @@
 #ifndef CLI_RENDERER_FACTORY_H_
 #define CLI_RENDERER_FACTORY_H_
 
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "iamf/cli/audio_element_with_data.h"
 #include "iamf/cli/renderer/audio_element_renderer_base.h"
+#include "iamf/cli/renderer/hrir_set.h"
 #include "iamf/obu/audio_element.h"
 #include "iamf/obu/leb128.h"
 #include "iamf/obu/mix_presentation.h"
@@ -50,6 +54,18 @@ class RendererFactoryBase {
       const AudioElementObu::AudioElementConfig& config,
       const Layout& loudness_layout) const = 0;
 
+  /*!\brief Checks that renderers for a layout can run at a sample rate.
+   *
+   * \param loudness_layout Layout to render to.
+   * \param sample_rate Sample rate of the audio elements to render.
+   * \return `absl::OkStatus()` on success. A specific status if the renderers
+   *     for the layout would be created for a different sample rate.
+   */
+  virtual absl::Status ValidateSampleRate(const Layout& loudness_layout,
+                                          uint32_t sample_rate) const {
+    return absl::OkStatus();
+  }
+
   /*!\brief Destructor. */
   virtual ~RendererFactoryBase() = 0;
 };
@@ -63,6 +79,14 @@ class RendererFactoryBase {
  */
 class RendererFactory : public RendererFactoryBase {
  public:
+  /*!\brief Constructor.
+   *
+   * \param hrir_set HRIRs to render binaural layouts with or `nullptr` to not
+   *     render binaural layouts.
+   */
+  explicit RendererFactory(std::shared_ptr<const HrirSet> hrir_set = nullptr)
+      : hrir_set_(std::move(hrir_set)) {}
+
   /*!\brief Creates a renderer based on the audio element and layout.
    *
    * \param audio_substream_ids Audio susbtream IDs.
@@ -80,8 +104,24 @@ class RendererFactory : public RendererFactoryBase {
       const AudioElementObu::AudioElementConfig& config,
       const Layout& loudness_layout) const override;
 
+  /*!\brief Checks that renderers for a layout can run at a sample rate.
+   *
+   * Binaural layouts are rendered with the HRIRs as they are, so their sample
+   * rate must match that of the audio elements.
+   *
+   * \param loudness_layout Layout to render to.
+   * \param sample_rate Sample rate of the audio elements to render.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     the HRIRs to render a binaural layout have a different sample rate.
+   */
+  absl::Status ValidateSampleRate(const Layout& loudness_layout,
+                                  uint32_t sample_rate) const override;
+
   /*!\brief Destructor. */
   ~RendererFactory() override = default;
+
+ private:
+  const std::shared_ptr<const HrirSet> hrir_set_;
 };
 
 }  // namespace iamf_tools
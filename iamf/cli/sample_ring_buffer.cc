@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/sample_ring_buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "iamf/common/macros.h"
+#include "iamf/common/obu_util.h"
+
+namespace iamf_tools {
+
+namespace {
+
+absl::Status ValidateNumTicksQueued(size_t num_ticks, size_t num_queued_ticks) {
+  if (num_ticks > num_queued_ticks) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Requested ", num_ticks, " ticks, but only ",
+                     num_queued_ticks, " are queued."));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+SampleRingBuffer::SampleRingBuffer(int num_channels, size_t capacity)
+    : num_channels_(num_channels),
+      capacity_(capacity),
+      samples_(capacity * num_channels) {}
+
+void SampleRingBuffer::ReserveForPush(size_t num_ticks) {
+  if (size_ + num_ticks <= capacity_) {
+    return;
+  }
+  // Unroll the queue into a bigger ring.
+  const size_t new_capacity = std::max(2 * capacity_, size_ + num_ticks);
+  std::vector<int32_t> new_samples(new_capacity * num_channels_);
+  const size_t num_ticks_before_wrap = std::min(size_, capacity_ - head_);
+  std::copy_n(samples_.begin() + head_ * num_channels_,
+              num_ticks_before_wrap * num_channels_, new_samples.begin());
+  std::copy_n(samples_.begin(), (size_ - num_ticks_before_wrap) * num_channels_,
+              new_samples.begin() + num_ticks_before_wrap * num_channels_);
+  samples_ = std::move(new_samples);
+  capacity_ = new_capacity;
+  head_ = 0;
+}
+
+absl::Status SampleRingBuffer::PushTick(absl::Span<const int32_t> tick) {
+  RETURN_IF_NOT_OK(ValidateEqual(tick.size(),
+                                 static_cast<size_t>(num_channels_),
+                                 "number of samples in the tick"));
+  ReserveForPush(1);
+  const size_t tail = (head_ + size_) % capacity_;
+  std::copy(tick.begin(), tick.end(), samples_.begin() + tail * num_channels_);
+  ++size_;
+  return absl::OkStatus();
+}
+
+void SampleRingBuffer::PushZeros(size_t num_ticks) {
+  ReserveForPush(num_ticks);
+  // Fill up to the end of the ring, then from its start.
+  const size_t tail = (head_ + size_) % std::max<size_t>(capacity_, 1);
+  const size_t num_ticks_before_wrap = std::min(num_ticks, capacity_ - tail);
+  std::fill_n(samples_.begin() + tail * num_channels_,
+              num_ticks_before_wrap * num_channels_, 0);
+  std::fill_n(samples_.begin(),
+              (num_ticks - num_ticks_before_wrap) * num_channels_, 0);
+  size_ += num_ticks;
+}
+
+absl::StatusOr<absl::Span<const int32_t>> SampleRingBuffer::PeekTicks(
+    size_t num_ticks) {
+  RETURN_IF_NOT_OK(ValidateNumTicksQueued(num_ticks, size_));
+  if (head_ + num_ticks > capacity_) {
+    // Rotate the oldest tick to the start of the ring.
+    std::rotate(samples_.begin(), samples_.begin() + head_ * num_channels_,
+                samples_.end());
+    head_ = 0;
+  }
+  return absl::MakeConstSpan(samples_).subspan(head_ * num_channels_,
+                                               num_ticks * num_channels_);
+}
+
+absl::Status SampleRingBuffer::PopTicks(size_t num_ticks) {
+  RETURN_IF_NOT_OK(ValidateNumTicksQueued(num_ticks, size_));
+  head_ = size_ == num_ticks ? 0 : (head_ + num_ticks) % capacity_;
+  size_ -= num_ticks;
+  return absl::OkStatus();
+}
+
+absl::Status SampleRingBuffer::PopTicks(
+    size_t num_ticks, std::vector<std::vector<int32_t>>& ticks) {
+  const auto samples = PeekTicks(num_ticks);
+  if (!samples.ok()) {
+    return samples.status();
+  }
+  ticks.resize(num_ticks);
+  for (size_t t = 0; t < num_ticks; ++t) {
+    ticks[t].assign(samples->begin() + t * num_channels_,
+                    samples->begin() + (t + 1) * num_channels_);
+  }
+  return PopTicks(num_ticks);
+}
+
+}  // namespace iamf_tools
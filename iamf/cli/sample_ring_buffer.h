@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_SAMPLE_RING_BUFFER_H_
+#define CLI_SAMPLE_RING_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+
+namespace iamf_tools {
+
+/*!\brief FIFO queue of interleaved samples in one contiguous ring.
+ *
+ * Ticks are pushed and popped without allocating as long as the queue holds
+ * at most `capacity()` ticks. Pushing beyond the capacity grows the ring, so
+ * the capacity should be sized for the expected number of queued ticks, e.g.
+ * the delay of the encoder and two frames.
+ *
+ * `PeekTicks()` returns a contiguous view of the oldest ticks. When they wrap
+ * around the end of the ring, it is rotated first so the view is contiguous.
+ */
+class SampleRingBuffer {
+ public:
+  /*!\brief Constructor.
+   *
+   * \param num_channels Number of channels of each tick.
+   * \param capacity Number of ticks to reserve space for.
+   */
+  SampleRingBuffer(int num_channels, size_t capacity);
+
+  /*!\brief Pushes a tick to the back of the queue.
+   *
+   * \param tick Samples of each channel.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     the tick does not have `num_channels()` samples.
+   */
+  absl::Status PushTick(absl::Span<const int32_t> tick);
+
+  /*!\brief Pushes ticks of silence to the back of the queue.
+   *
+   * \param num_ticks Number of ticks to push.
+   */
+  void PushZeros(size_t num_ticks);
+
+  /*!\brief Gets a contiguous view of the oldest ticks.
+   *
+   * The view is invalidated by any other call which modifies the queue.
+   *
+   * \param num_ticks Number of ticks to view.
+   * \return Interleaved samples of the oldest ticks on success.
+   *     `absl::InvalidArgumentError()` if fewer than `num_ticks` ticks are
+   *     queued.
+   */
+  absl::StatusOr<absl::Span<const int32_t>> PeekTicks(size_t num_ticks);
+
+  /*!\brief Pops the oldest ticks.
+   *
+   * \param num_ticks Number of ticks to pop.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     fewer than `num_ticks` ticks are queued.
+   */
+  absl::Status PopTicks(size_t num_ticks);
+
+  /*!\brief Pops the oldest ticks into a vector of ticks.
+   *
+   * \param num_ticks Number of ticks to pop.
+   * \param ticks Output argument resized to `num_ticks` ticks of
+   *     `num_channels()` samples. Existing allocations are reused.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     fewer than `num_ticks` ticks are queued.
+   */
+  absl::Status PopTicks(size_t num_ticks,
+                        std::vector<std::vector<int32_t>>& ticks);
+
+  /*!\brief Gets the number of channels of each tick.
+   *
+   * \return Number of channels of each tick.
+   */
+  int num_channels() const { return num_channels_; }
+
+  /*!\brief Gets the number of queued ticks.
+   *
+   * \return Number of queued ticks.
+   */
+  size_t size() const { return size_; }
+
+  /*!\brief Checks whether the queue is empty.
+   *
+   * \return `true` if no tick is queued.
+   */
+  bool empty() const { return size_ == 0; }
+
+  /*!\brief Gets the number of ticks which fit without growing.
+   *
+   * \return Capacity in ticks.
+   */
+  size_t capacity() const { return capacity_; }
+
+ private:
+  /*!\brief Makes room for more ticks, growing the ring when it is full.
+   *
+   * \param num_ticks Number of ticks which will be pushed.
+   */
+  void ReserveForPush(size_t num_ticks);
+
+  const int num_channels_;
+  size_t capacity_;
+  // Index of the oldest tick and number of queued ticks.
+  size_t head_ = 0;
+  size_t size_ = 0;
+  std::vector<int32_t> samples_;
+};
+
+}  // namespace iamf_tools
+
+#endif  // CLI_SAMPLE_RING_BUFFER_H_
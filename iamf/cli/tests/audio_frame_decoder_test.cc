@@ -151,6 +151,67 @@ TEST(Decode, AppendsToOutputList) {
   EXPECT_EQ(decoded_audio_frames.size(), 2);
 }
 
+TEST(Recycle, EmptiesTheInputList) {
+  AudioFrameDecoder decoder;
+  absl::flat_hash_map<uint32_t, CodecConfigObu> codec_config_obus;
+  absl::flat_hash_map<DecodedUleb128, AudioElementWithData> audio_elements;
+  std::list<AudioFrameWithData> encoded_audio_frames =
+      PrepareEncodedAudioFrames(codec_config_obus, audio_elements);
+  InitAllAudioElements(audio_elements, decoder);
+  std::list<DecodedAudioFrame> decoded_audio_frames;
+  EXPECT_THAT(decoder.Decode(encoded_audio_frames, decoded_audio_frames),
+              IsOk());
+
+  decoder.Recycle(decoded_audio_frames);
+
+  EXPECT_TRUE(decoded_audio_frames.empty());
+}
+
+TEST(Decode, RecycledFramesHoldOnlyNewlyDecodedSamples) {
+  AudioFrameDecoder decoder;
+  absl::flat_hash_map<uint32_t, CodecConfigObu> codec_config_obus;
+  absl::flat_hash_map<DecodedUleb128, AudioElementWithData> audio_elements;
+  std::list<AudioFrameWithData> encoded_audio_frames =
+      PrepareEncodedAudioFrames(codec_config_obus, audio_elements);
+  InitAllAudioElements(audio_elements, decoder);
+  std::list<DecodedAudioFrame> decoded_audio_frames;
+  EXPECT_THAT(decoder.Decode(encoded_audio_frames, decoded_audio_frames),
+              IsOk());
+  decoder.Recycle(decoded_audio_frames);
+
+  // Decoding again reuses the recycled frame.
+  EXPECT_THAT(decoder.Decode(encoded_audio_frames, decoded_audio_frames),
+              IsOk());
+
+  ASSERT_EQ(decoded_audio_frames.size(), 1);
+  EXPECT_EQ(decoded_audio_frames.front().decoded_samples.size(),
+            kNumSamplesPerFrame);
+}
+
+TEST(Decode, RecycledFramesReuseTheStorageOfEachTimeTick) {
+  AudioFrameDecoder decoder;
+  absl::flat_hash_map<uint32_t, CodecConfigObu> codec_config_obus;
+  absl::flat_hash_map<DecodedUleb128, AudioElementWithData> audio_elements;
+  std::list<AudioFrameWithData> encoded_audio_frames =
+      PrepareEncodedAudioFrames(codec_config_obus, audio_elements);
+  InitAllAudioElements(audio_elements, decoder);
+  std::list<DecodedAudioFrame> decoded_audio_frames;
+  EXPECT_THAT(decoder.Decode(encoded_audio_frames, decoded_audio_frames),
+              IsOk());
+  ASSERT_EQ(decoded_audio_frames.size(), 1);
+  ASSERT_FALSE(decoded_audio_frames.front().decoded_samples.empty());
+  const int32_t* const first_tick_storage =
+      decoded_audio_frames.front().decoded_samples.front().data();
+  decoder.Recycle(decoded_audio_frames);
+
+  EXPECT_THAT(decoder.Decode(encoded_audio_frames, decoded_audio_frames),
+              IsOk());
+
+  ASSERT_EQ(decoded_audio_frames.size(), 1);
+  EXPECT_EQ(decoded_audio_frames.front().decoded_samples.front().data(),
+            first_tick_storage);
+}
+
 TEST(Decode, DecodesLpcmFrame) {
   AudioFrameDecoder decoder;
 
@@ -11,10 +11,9 @@
  */
 #include "iamf/cli/demixing_module.h"
 
-#include <algorithm>
 #include <cstdint>
-#include <iterator>
 #include <list>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -22,6 +21,7 @@
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "iamf/cli/audio_element_with_data.h"
@@ -29,6 +29,7 @@
 #include "iamf/cli/audio_frame_with_data.h"
 #include "iamf/cli/channel_label.h"
 #include "iamf/cli/proto/user_metadata.pb.h"
+#include "iamf/cli/sample_ring_buffer.h"
 #include "iamf/cli/tests/cli_test_utils.h"
 #include "iamf/obu/audio_element.h"
 #include "iamf/obu/audio_frame.h"
@@ -515,18 +516,17 @@ class DownMixingModuleTest : public DemixingModuleTestBase,
 
     EXPECT_THAT(demixing_module_.DownMixSamplesToSubstreams(
                     kAudioElementId, down_mixing_params,
-                    input_label_to_samples_, substream_id_to_substream_data_),
+                    input_label_to_samples_, absl::MakeSpan(substream_data_)),
                 IsOk());
 
-    for (const auto& [substream_id, substream_data] :
-         substream_id_to_substream_data_) {
+    for (auto& substream_data : substream_data_) {
       // Copy the output queue to a vector for comparison.
       std::vector<std::vector<int32_t>> output_samples;
-      std::copy(substream_data.samples_obu.begin(),
-                substream_data.samples_obu.end(),
-                std::back_inserter(output_samples));
+      EXPECT_THAT(substream_data.samples_obu.PopTicks(
+                      substream_data.samples_obu.size(), output_samples),
+                  IsOk());
       EXPECT_EQ(output_samples,
-                substream_id_to_expected_samples_[substream_id]);
+                substream_id_to_expected_samples_[substream_data.substream_id]);
     }
   }
 
@@ -550,15 +550,18 @@ class DownMixingModuleTest : public DemixingModuleTestBase,
     const uint32_t substream_id = substream_id_to_labels_.size();
 
     substream_id_to_labels_[substream_id] = requested_output_labels;
-    substream_id_to_substream_data_[substream_id] = {.substream_id =
-                                                         substream_id};
+    const int num_channels = static_cast<int>(requested_output_labels.size());
+    substream_data_.push_back(
+        {.substream_id = substream_id,
+         .samples_obu = SampleRingBuffer(num_channels, /*capacity=*/0),
+         .samples_encode = SampleRingBuffer(num_channels, /*capacity=*/0)});
 
     substream_id_to_expected_samples_[substream_id] = expected_output_smples;
   }
 
   LabelSamplesMap input_label_to_samples_;
 
-  absl::flat_hash_map<uint32_t, SubstreamData> substream_id_to_substream_data_;
+  std::vector<SubstreamData> substream_data_;
 
   absl::flat_hash_map<uint32_t, std::vector<std::vector<int32_t>>>
       substream_id_to_expected_samples_;
@@ -887,7 +890,10 @@ class DemixingModuleTest : public DemixingModuleTestBase,
         .obu = AudioFrameObu(ObuHeader(), substream_id, {}),
         .start_timestamp = kStartTimestamp,
         .end_timestamp = kEndTimestamp,
-        .raw_samples = raw_samples,
+        .raw_samples =
+            std::make_shared<const std::vector<std::vector<int32_t>>>(
+                raw_samples),
+        .num_ticks = static_cast<uint32_t>(raw_samples.size()),
         .down_mixing_params = down_mixing_params,
     });
 
@@ -971,6 +977,22 @@ TEST_F(DemixingModuleTest, DemixingAudioSamplesSucceedsWithEmptyInputs) {
   EXPECT_TRUE(id_to_labeled_decoded_frame.empty());
 }
 
+TEST_F(DemixingModuleTest, DemixingAudioSamplesFailsWhenSamplesWereReleased) {
+  ConfigureAudioFrameMetadata("L2");
+  ConfigureAudioFrameMetadata("R2");
+  ConfigureLosslessAudioFrameAndDecodedAudioFrame({kMono}, {{750}, {1500}});
+  ConfigureLosslessAudioFrameAndDecodedAudioFrame({kL2}, {{1000}, {2000}});
+  TestCreateDemixingModule(1);
+  audio_frames_.back().raw_samples.reset();
+
+  IdLabeledFrameMap id_to_labeled_frame, id_to_labeled_decoded_frame;
+  EXPECT_FALSE(demixing_module_
+                   .DemixAudioSamples(audio_frames_, decoded_audio_frames_,
+                                      id_to_labeled_frame,
+                                      id_to_labeled_decoded_frame)
+                   .ok());
+}
+
 TEST_F(DemixingModuleTest, AmbisonicsHasNoDemixers) {
   ConfigureAudioFrameMetadata("A0");
   ConfigureAudioFrameMetadata("A1");
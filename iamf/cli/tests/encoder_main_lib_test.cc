@@ -13,7 +13,11 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
@@ -23,6 +27,9 @@
 #include "iamf/cli/proto/ia_sequence_header.pb.h"
 #include "iamf/cli/proto/test_vector_metadata.pb.h"
 #include "iamf/cli/proto/user_metadata.pb.h"
+#include "iamf/common/read_bit_buffer.h"
+#include "iamf/obu/mix_presentation.h"
+#include "iamf/obu/obu_header.h"
 #include "src/google/protobuf/text_format.h"
 
 namespace iamf_tools {
@@ -57,6 +64,121 @@ void AddCodecConfig(iamf_tools_cli_proto::UserMetadata& user_metadata) {
       user_metadata.add_codec_config_metadata()));
 }
 
+// Adds a stereo LPCM audio element which reads a sawtooth wav file and a mix
+// presentation which renders it to stereo. The user provided loudness is far
+// from the loudness of the input.
+void AddStereoAudioElementAndMixPresentation(
+    iamf_tools_cli_proto::UserMetadata& user_metadata) {
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
+      R"pb(
+        audio_element_id: 300
+        audio_element_type: AUDIO_ELEMENT_CHANNEL_BASED
+        codec_config_id: 200
+        num_substreams: 1
+        audio_substream_ids: [ 0 ]
+        num_parameters: 0
+        scalable_channel_layout_config {
+          num_layers: 1
+          channel_audio_layer_configs: [ {
+            loudspeaker_layout: LOUDSPEAKER_LAYOUT_STEREO
+            substream_count: 1
+            coupled_substream_count: 1
+          } ]
+        }
+      )pb",
+      user_metadata.add_audio_element_metadata()));
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
+      R"pb(
+        mix_presentation_id: 42
+        count_label: 0
+        num_sub_mixes: 1
+        sub_mixes {
+          num_audio_elements: 1
+          audio_elements {
+            audio_element_id: 300
+            rendering_config {
+              headphones_rendering_mode: HEADPHONES_RENDERING_MODE_STEREO
+            }
+            element_mix_config {
+              mix_gain {
+                param_definition {
+                  parameter_id: 100
+                  parameter_rate: 48000
+                  param_definition_mode: 1
+                }
+                default_mix_gain: 0
+              }
+            }
+          }
+          output_mix_config {
+            output_mix_gain {
+              param_definition {
+                parameter_id: 100
+                parameter_rate: 48000
+                param_definition_mode: 1
+              }
+              default_mix_gain: 0
+            }
+          }
+          num_layouts: 1
+          layouts {
+            loudness_layout {
+              layout_type: LAYOUT_TYPE_LOUDSPEAKERS_SS_CONVENTION
+              ss_layout { sound_system: SOUND_SYSTEM_A_0_2_0 }
+            }
+            loudness {
+              info_type_bit_masks: []
+              integrated_loudness: 0
+              digital_peak: 0
+            }
+          }
+        }
+      )pb",
+      user_metadata.add_mix_presentation_metadata()));
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
+      R"pb(
+        wav_filename: "sawtooth_10000_stereo_48khz.wav"
+        samples_to_trim_at_end: 0
+        samples_to_trim_at_start: 0
+        audio_element_id: 300
+        channel_ids: [ 0, 1 ]
+        channel_labels: [ "L2", "R2" ]
+      )pb",
+      user_metadata.add_audio_frame_metadata()));
+}
+
+// Gets the first Mix Presentation OBU in an IAMF file.
+std::optional<MixPresentationObu> ReadFirstMixPresentationObu(
+    const std::filesystem::path& iamf_filename) {
+  std::ifstream iamf_file(iamf_filename, std::ios::binary);
+  std::vector<uint8_t> source((std::istreambuf_iterator<char>(iamf_file)),
+                              std::istreambuf_iterator<char>());
+  ReadBitBuffer rb(1024, &source);
+  // Descriptor OBUs come first, so the Mix Presentation OBU is within the
+  // first few OBUs.
+  for (int i = 0; i < 8; ++i) {
+    ObuHeader header;
+    int64_t payload_size;
+    if (!header.ReadAndValidate(rb, payload_size).ok()) {
+      return std::nullopt;
+    }
+    if (header.obu_type == kObuIaMixPresentation) {
+      auto mix_presentation_obu =
+          MixPresentationObu::CreateFromBuffer(header, rb);
+      if (!mix_presentation_obu.ok()) {
+        return std::nullopt;
+      }
+      return *std::move(mix_presentation_obu);
+    }
+    std::vector<uint8_t> unused_payload;
+    if (!rb.ReadUint8Vector(static_cast<int>(payload_size), unused_payload)
+             .ok()) {
+      return std::nullopt;
+    }
+  }
+  return std::nullopt;
+}
+
 TEST(EncoderMainLibTest, EmptyUserMetadataTestMainFails) {
   EXPECT_FALSE(TestMain(iamf_tools_cli_proto::UserMetadata(), "", "").ok());
 }
@@ -140,6 +262,57 @@ TEST(EncoderMainLibTest, SettingPrefixOutputsFile) {
   EXPECT_TRUE(std::filesystem::exists(output_iamf_directory / "empty.iamf"));
 }
 
+TEST(EncoderMainLibTest, EncoderVariantOutputsAnotherFile) {
+  iamf_tools_cli_proto::UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  user_metadata.mutable_test_vector_metadata()->set_file_name_prefix("ladder");
+  auto* encoder_variant_metadata = user_metadata.add_encoder_variant_metadata();
+  encoder_variant_metadata->set_file_name_suffix("_variant");
+  *encoder_variant_metadata->add_codec_config_metadata() =
+      user_metadata.codec_config_metadata(0);
+
+  const auto output_iamf_directory = std::filesystem::temp_directory_path();
+
+  EXPECT_THAT(TestMain(user_metadata, "", output_iamf_directory.string()),
+              IsOk());
+
+  EXPECT_TRUE(std::filesystem::exists(output_iamf_directory / "ladder.iamf"));
+  EXPECT_TRUE(
+      std::filesystem::exists(output_iamf_directory / "ladder_variant.iamf"));
+}
+
+TEST(EncoderMainLibTest, InvalidWhenEncoderVariantHasNoFileNameSuffix) {
+  iamf_tools_cli_proto::UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  user_metadata.mutable_test_vector_metadata()->set_file_name_prefix("ladder");
+  *user_metadata.add_encoder_variant_metadata()->add_codec_config_metadata() =
+      user_metadata.codec_config_metadata(0);
+
+  EXPECT_FALSE(TestMain(user_metadata, "",
+                        std::filesystem::temp_directory_path().string())
+                   .ok());
+}
+
+TEST(EncoderMainLibTest, InvalidWhenEncoderVariantsShareAFileNameSuffix) {
+  iamf_tools_cli_proto::UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  user_metadata.mutable_test_vector_metadata()->set_file_name_prefix("ladder");
+  for (int i = 0; i < 2; ++i) {
+    auto* encoder_variant_metadata =
+        user_metadata.add_encoder_variant_metadata();
+    encoder_variant_metadata->set_file_name_suffix("_variant");
+    *encoder_variant_metadata->add_codec_config_metadata() =
+        user_metadata.codec_config_metadata(0);
+  }
+
+  EXPECT_FALSE(TestMain(user_metadata, "",
+                        std::filesystem::temp_directory_path().string())
+                   .ok());
+}
+
 TEST(EncoderMainLibTest, CreatesAndWritesToOutputIamfDirectory) {
   iamf_tools_cli_proto::UserMetadata user_metadata;
   AddIaSequenceHeader(user_metadata);
@@ -168,6 +341,50 @@ TEST(EncoderMainLibTest, CreatesAndWritesToOutputIamfDirectory) {
 
   EXPECT_TRUE(std::filesystem::exists(output_iamf_directory / "empty.iamf"));
 }
+TEST(EncoderMainLibTest, WritesMeasuredLoudnessToMixPresentationObus) {
+  iamf_tools_cli_proto::UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  AddStereoAudioElementAndMixPresentation(user_metadata);
+  user_metadata.mutable_test_vector_metadata()
+      ->set_partition_mix_gain_parameter_blocks(false);
+  user_metadata.mutable_test_vector_metadata()->set_file_name_prefix(
+      "measured_loudness");
+  const auto input_wav_directory =
+      std::filesystem::current_path() / std::string("iamf/cli/testdata");
+  const auto output_iamf_directory = std::filesystem::temp_directory_path();
+
+  ASSERT_THAT(TestMain(user_metadata, input_wav_directory.string(),
+                       output_iamf_directory.string()),
+              IsOk());
+
+  const auto mix_presentation_obu = ReadFirstMixPresentationObu(
+      output_iamf_directory / "measured_loudness.iamf");
+  ASSERT_TRUE(mix_presentation_obu.has_value());
+  const LoudnessInfo& loudness =
+      mix_presentation_obu->sub_mixes_[0].layouts[0].loudness;
+  // The sawtooth peaks well below the user provided full-scale loudness.
+  EXPECT_LT(loudness.integrated_loudness, 0);
+  EXPECT_LT(loudness.digital_peak, 0);
+}
+
+TEST(EncoderMainLibTest, FailsWhenValidatedLoudnessDoesNotMatch) {
+  iamf_tools_cli_proto::UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  AddStereoAudioElementAndMixPresentation(user_metadata);
+  user_metadata.mutable_test_vector_metadata()
+      ->set_partition_mix_gain_parameter_blocks(false);
+  user_metadata.mutable_test_vector_metadata()->set_validate_user_loudness(
+      true);
+  const auto input_wav_directory =
+      std::filesystem::current_path() / std::string("iamf/cli/testdata");
+
+  EXPECT_FALSE(TestMain(user_metadata, input_wav_directory.string(),
+                        std::filesystem::temp_directory_path().string())
+                   .ok());
+}
+
 // TODO(b/308385831): Add more tests.
 
 }  // namespace
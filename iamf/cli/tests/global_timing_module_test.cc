@@ -173,6 +173,50 @@ TEST_F(GlobalTimingModuleTest, TwoAudioElements) {
   TestGetNextAudioFrameStamps(2000, 256, 256, 512);
 }
 
+TEST_F(GlobalTimingModuleTest, SubstreamIndicesShareTimestampsWithIds) {
+  AddLpcmCodecConfigWithIdAndSampleRate(kCodecConfigId, kSampleRate,
+                                        codec_config_obus_);
+  AddAmbisonicsMonoAudioElementWithSubstreamIds(
+      kFirstAudioElementId, kCodecConfigId, {kFirstAudioFrameId, 2000},
+      codec_config_obus_, audio_elements_);
+  EXPECT_THAT(Initialize(), IsOk());
+  const auto first_index =
+      global_timing_module_->GetAudioSubstreamIndex(kFirstAudioFrameId);
+  const auto second_index = global_timing_module_->GetAudioSubstreamIndex(2000);
+  ASSERT_THAT(first_index, IsOk());
+  ASSERT_THAT(second_index, IsOk());
+  EXPECT_NE(*first_index, *second_index);
+
+  int32_t start_timestamp;
+  int32_t end_timestamp;
+  EXPECT_THAT(global_timing_module_->GetNextAudioFrameTimestampsForIndex(
+                  *first_index, 128, start_timestamp, end_timestamp),
+              IsOk());
+  EXPECT_EQ(start_timestamp, 0);
+  EXPECT_EQ(end_timestamp, 128);
+
+  // Timestamps advanced through the index are seen through the ID.
+  TestGetNextAudioFrameStamps(kFirstAudioFrameId, 128, 128, 256);
+  TestGetNextAudioFrameStamps(2000, 256, 0, 256);
+}
+
+TEST_F(GlobalTimingModuleTest, InvalidUnknownSubstreamIndex) {
+  AddLpcmCodecConfigWithIdAndSampleRate(kCodecConfigId, kSampleRate,
+                                        codec_config_obus_);
+  AddAmbisonicsMonoAudioElementWithSubstreamIds(
+      kFirstAudioElementId, kCodecConfigId, {kFirstAudioFrameId},
+      codec_config_obus_, audio_elements_);
+  EXPECT_THAT(Initialize(), IsOk());
+
+  EXPECT_FALSE(global_timing_module_->GetAudioSubstreamIndex(9999).ok());
+  int32_t start_timestamp;
+  int32_t end_timestamp;
+  EXPECT_FALSE(global_timing_module_
+                   ->GetNextAudioFrameTimestampsForIndex(
+                       1, 128, start_timestamp, end_timestamp)
+                   .ok());
+}
+
 TEST_F(GlobalTimingModuleTest, OneParameterId) {
   AddLpcmCodecConfigWithIdAndSampleRate(kCodecConfigId, kSampleRate,
                                         codec_config_obus_);
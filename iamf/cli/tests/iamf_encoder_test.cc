@@ -180,6 +180,17 @@ void AddParameterBlockAtTimestamp(const int32_t start_timestamp,
   metadata->set_start_timestamp(start_timestamp);
 }
 
+// Adds an encoder variant which only changes settings that are not written to
+// the Codec Config OBU.
+void AddEncoderVariant(UserMetadata& user_metadata) {
+  auto* encoder_variant_metadata = user_metadata.add_encoder_variant_metadata();
+  encoder_variant_metadata->set_file_name_suffix("_variant");
+  auto* codec_config_metadata =
+      encoder_variant_metadata->add_codec_config_metadata();
+  *codec_config_metadata = user_metadata.codec_config_metadata(0);
+  codec_config_metadata->mutable_codec_config()->set_use_async_encoder(true);
+}
+
 TEST(IamfEncoderTest, EmptyUserMetadataFails) {
   UserMetadata user_metadata;
   IamfEncoder iamf_encoder(user_metadata);
@@ -273,6 +284,191 @@ TEST(IamfEncoderTest, GenerateDataObusTwoIterationsSucceeds) {
 
   EXPECT_EQ(iteration, 2);
 }
+
+TEST(IamfEncoderTest, OutputTemporalUnitReleasesRawSamples) {
+  UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  AddAudioElement(user_metadata);
+  AddMixPresentation(user_metadata);
+  AddAudioFrame(user_metadata);
+  AddParameterBlockAtTimestamp(0, user_metadata);
+  IamfEncoder iamf_encoder(user_metadata);
+  std::optional<IASequenceHeaderObu> ia_sequence_header_obu;
+  absl::flat_hash_map<uint32_t, CodecConfigObu> codec_config_obus;
+  absl::flat_hash_map<DecodedUleb128, AudioElementWithData> audio_elements;
+  std::list<MixPresentationObu> mix_presentation_obus;
+  ASSERT_THAT(iamf_encoder.GenerateDescriptorObus(
+                  ia_sequence_header_obu, codec_config_obus, audio_elements,
+                  mix_presentation_obus),
+              IsOk());
+  const std::vector<int32_t> zero_samples(kNumSamplesPerFrame, 0);
+  iamf_encoder.AddSamples(kAudioElementId, ChannelLabel::kL2, zero_samples);
+  iamf_encoder.AddSamples(kAudioElementId, ChannelLabel::kR2, zero_samples);
+  iamf_encoder.FinalizeAddSamples();
+  ASSERT_THAT(iamf_encoder.AddParameterBlockMetadata(
+                  user_metadata.parameter_block_metadata(0)),
+              IsOk());
+
+  std::list<AudioFrameWithData> audio_frames;
+  std::list<ParameterBlockWithData> parameter_blocks;
+  IdLabeledFrameMap id_to_labeled_frame;
+  int32_t output_timestamp;
+  EXPECT_THAT(
+      iamf_encoder.OutputTemporalUnit(audio_frames, parameter_blocks,
+                                      id_to_labeled_frame, output_timestamp),
+      IsOk());
+
+  ASSERT_EQ(audio_frames.size(), 1);
+  EXPECT_EQ(audio_frames.front().raw_samples, nullptr);
+  // The number of ticks outlives the samples.
+  EXPECT_EQ(audio_frames.front().num_ticks, kNumSamplesPerFrame);
+}
+
+TEST(IamfEncoderTest,
+     GenerateDescriptorObusFailsWhenAVariantChangesACodecConfigObu) {
+  UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  AddAudioElement(user_metadata);
+  AddMixPresentation(user_metadata);
+  AddEncoderVariant(user_metadata);
+  user_metadata.mutable_encoder_variant_metadata(0)
+      ->mutable_codec_config_metadata(0)
+      ->mutable_codec_config()
+      ->set_num_samples_per_frame(16);
+  IamfEncoder iamf_encoder(user_metadata);
+
+  std::optional<IASequenceHeaderObu> ia_sequence_header_obu;
+  absl::flat_hash_map<uint32_t, CodecConfigObu> codec_config_obus;
+  absl::flat_hash_map<DecodedUleb128, AudioElementWithData> audio_elements;
+  std::list<MixPresentationObu> mix_presentation_obus;
+  EXPECT_FALSE(iamf_encoder
+                   .GenerateDescriptorObus(ia_sequence_header_obu,
+                                           codec_config_obus, audio_elements,
+                                           mix_presentation_obus)
+                   .ok());
+}
+
+TEST(IamfEncoderTest,
+     GenerateDescriptorObusFailsWhenAVariantHasAnUnknownCodecConfigId) {
+  UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  AddAudioElement(user_metadata);
+  AddMixPresentation(user_metadata);
+  AddEncoderVariant(user_metadata);
+  user_metadata.mutable_encoder_variant_metadata(0)
+      ->mutable_codec_config_metadata(0)
+      ->set_codec_config_id(201);
+  IamfEncoder iamf_encoder(user_metadata);
+
+  std::optional<IASequenceHeaderObu> ia_sequence_header_obu;
+  absl::flat_hash_map<uint32_t, CodecConfigObu> codec_config_obus;
+  absl::flat_hash_map<DecodedUleb128, AudioElementWithData> audio_elements;
+  std::list<MixPresentationObu> mix_presentation_obus;
+  EXPECT_FALSE(iamf_encoder
+                   .GenerateDescriptorObus(ia_sequence_header_obu,
+                                           codec_config_obus, audio_elements,
+                                           mix_presentation_obus)
+                   .ok());
+}
+
+TEST(IamfEncoderTest, GenerateDataObusForAnEncoderVariantSucceeds) {
+  UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  AddAudioElement(user_metadata);
+  AddMixPresentation(user_metadata);
+  AddAudioFrame(user_metadata);
+  AddParameterBlockAtTimestamp(0, user_metadata);
+  AddParameterBlockAtTimestamp(8, user_metadata);
+  AddEncoderVariant(user_metadata);
+  IamfEncoder iamf_encoder(user_metadata);
+
+  std::optional<IASequenceHeaderObu> ia_sequence_header_obu;
+  absl::flat_hash_map<uint32_t, CodecConfigObu> codec_config_obus;
+  absl::flat_hash_map<DecodedUleb128, AudioElementWithData> audio_elements;
+  std::list<MixPresentationObu> mix_presentation_obus;
+  ASSERT_THAT(iamf_encoder.GenerateDescriptorObus(
+                  ia_sequence_header_obu, codec_config_obus, audio_elements,
+                  mix_presentation_obus),
+              IsOk());
+
+  // Temporary variables for one iteration.
+  const std::vector<int32_t> samples(kNumSamplesPerFrame, 1 << 16);
+  std::list<AudioFrameWithData> temp_audio_frames;
+  std::list<ParameterBlockWithData> temp_parameter_blocks;
+  IdLabeledFrameMap id_to_labeled_frame;
+  int32_t output_timestamp = 0;
+  std::list<AudioFrameWithData> variant_audio_frames;
+  std::list<ParameterBlockWithData> variant_parameter_blocks;
+  IdLabeledFrameMap variant_id_to_labeled_frame;
+  int32_t variant_output_timestamp = 0;
+  int iteration = 0;
+  while (iamf_encoder.GeneratingDataObus()) {
+    iamf_encoder.AddSamples(kAudioElementId, ChannelLabel::kL2, samples);
+    iamf_encoder.AddSamples(kAudioElementId, ChannelLabel::kR2, samples);
+    if (iteration == 1) {
+      iamf_encoder.FinalizeAddSamples();
+    }
+    EXPECT_THAT(iamf_encoder.AddParameterBlockMetadata(
+                    user_metadata.parameter_block_metadata(iteration)),
+                IsOk());
+
+    EXPECT_THAT(iamf_encoder.OutputTemporalUnit(
+                    temp_audio_frames, temp_parameter_blocks,
+                    id_to_labeled_frame, output_timestamp),
+                IsOk());
+    EXPECT_THAT(iamf_encoder.OutputVariantTemporalUnit(
+                    0, variant_audio_frames, variant_parameter_blocks,
+                    variant_id_to_labeled_frame, variant_output_timestamp),
+                IsOk());
+
+    // The variant only changes how the frames are scheduled, so its data OBUs
+    // are the same as the main ones.
+    ASSERT_EQ(variant_audio_frames.size(), 1);
+    EXPECT_EQ(variant_audio_frames.front().obu.audio_frame_,
+              temp_audio_frames.front().obu.audio_frame_);
+    ASSERT_EQ(variant_parameter_blocks.size(), 1);
+    EXPECT_EQ(variant_parameter_blocks.front().start_timestamp,
+              temp_parameter_blocks.front().start_timestamp);
+    EXPECT_EQ(variant_output_timestamp, output_timestamp);
+
+    iteration++;
+  }
+
+  EXPECT_EQ(iteration, 2);
+}
+
+TEST(IamfEncoderTest, OutputVariantTemporalUnitFailsForAnUnknownVariant) {
+  UserMetadata user_metadata;
+  AddIaSequenceHeader(user_metadata);
+  AddCodecConfig(user_metadata);
+  AddAudioElement(user_metadata);
+  AddMixPresentation(user_metadata);
+  AddAudioFrame(user_metadata);
+  IamfEncoder iamf_encoder(user_metadata);
+  std::optional<IASequenceHeaderObu> ia_sequence_header_obu;
+  absl::flat_hash_map<uint32_t, CodecConfigObu> codec_config_obus;
+  absl::flat_hash_map<DecodedUleb128, AudioElementWithData> audio_elements;
+  std::list<MixPresentationObu> mix_presentation_obus;
+  ASSERT_THAT(iamf_encoder.GenerateDescriptorObus(
+                  ia_sequence_header_obu, codec_config_obus, audio_elements,
+                  mix_presentation_obus),
+              IsOk());
+
+  std::list<AudioFrameWithData> audio_frames;
+  std::list<ParameterBlockWithData> parameter_blocks;
+  IdLabeledFrameMap id_to_labeled_frame;
+  int32_t output_timestamp = 0;
+  EXPECT_FALSE(iamf_encoder
+                   .OutputVariantTemporalUnit(0, audio_frames, parameter_blocks,
+                                              id_to_labeled_frame,
+                                              output_timestamp)
+                   .ok());
+}
+
 // TODO(b/349321277): Add more tests.
 
 }  // namespace
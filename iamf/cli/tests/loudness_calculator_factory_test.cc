@@ -35,5 +35,14 @@ TEST(CreatePrimaryLoudnessCalculator, NeverReturnsNull) {
             nullptr);
 }
 
+TEST(CreateItuRBs1770LoudnessCalculator, NeverReturnsNull) {
+  const LoudnessCalculatorFactoryItuRBs1770 factory;
+  const MixPresentationLayout layout = {};
+
+  EXPECT_NE(factory.CreateLoudnessCalculator(layout, kUnusedRenderedSampleRate,
+                                             kUnusedRenderedBitDepth),
+            nullptr);
+}
+
 }  // namespace
 }  // namespace iamf_tools
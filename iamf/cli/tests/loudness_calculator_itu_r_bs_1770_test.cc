@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/loudness_calculator_itu_r_bs_1770.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+
+using enum LoudspeakersSsConventionLayout::SoundSystem;
+
+constexpr int32_t kSampleRate = 48000;
+constexpr int16_t kMinQ7_8 = std::numeric_limits<int16_t>::min();
+// Tolerance of 0.1 dB in Q7.8.
+constexpr int16_t kToleranceQ7_8 = 26;
+
+MixPresentationLayout GetLayout(
+    LoudspeakersSsConventionLayout::SoundSystem sound_system,
+    uint8_t info_type = 0) {
+  return {.loudness_layout =
+              {.layout_type = Layout::kLayoutTypeLoudspeakersSsConvention,
+               .specific_layout = LoudspeakersSsConventionLayout{
+                   .sound_system = sound_system}},
+          .loudness = {.info_type = info_type}};
+}
+
+// Gets an interleaved sine wave with the same samples in every channel.
+std::vector<int32_t> GetSine(int num_channels, double frequency,
+                             double amplitude, double duration_seconds,
+                             double phase = 0.0) {
+  const int num_ticks = static_cast<int>(duration_seconds * kSampleRate);
+  std::vector<int32_t> samples;
+  samples.reserve(num_ticks * num_channels);
+  for (int t = 0; t < num_ticks; ++t) {
+    const double sample = amplitude * std::numeric_limits<int32_t>::max() *
+                          std::sin(2.0 * std::numbers::pi * frequency * t /
+                                       kSampleRate +
+                                   phase);
+    for (int c = 0; c < num_channels; ++c) {
+      samples.push_back(static_cast<int32_t>(sample));
+    }
+  }
+  return samples;
+}
+
+TEST(Create, SupportsLoudspeakerLayouts) {
+  EXPECT_NE(LoudnessCalculatorItuRBs1770::Create(
+                GetLayout(kSoundSystemJ_4_7_0), kSampleRate),
+            nullptr);
+}
+
+TEST(Create, SupportsBinauralLayouts) {
+  const MixPresentationLayout kBinauralLayout = {
+      .loudness_layout = {.layout_type = Layout::kLayoutTypeBinaural}};
+
+  EXPECT_NE(LoudnessCalculatorItuRBs1770::Create(kBinauralLayout, kSampleRate),
+            nullptr);
+}
+
+TEST(Create, DoesNotSupportReservedLayouts) {
+  const MixPresentationLayout kReservedLayout = {
+      .loudness_layout = {.layout_type = Layout::kLayoutTypeReserved0}};
+
+  EXPECT_EQ(LoudnessCalculatorItuRBs1770::Create(kReservedLayout, kSampleRate),
+            nullptr);
+}
+
+TEST(AccumulateLoudnessForSamples, FailsForPartialTicks) {
+  auto calculator = LoudnessCalculatorItuRBs1770::Create(
+      GetLayout(kSoundSystemA_0_2_0), kSampleRate);
+  ASSERT_NE(calculator, nullptr);
+
+  EXPECT_FALSE(calculator->AccumulateLoudnessForSamples({1, 2, 3}).ok());
+}
+
+TEST(QueryLoudness, MeasuresSilenceAsTheMinimumValue) {
+  auto calculator = LoudnessCalculatorItuRBs1770::Create(
+      GetLayout(kSoundSystemA_0_2_0), kSampleRate);
+  ASSERT_NE(calculator, nullptr);
+  EXPECT_THAT(calculator->AccumulateLoudnessForSamples(
+                  std::vector<int32_t>(2 * kSampleRate, 0)),
+              IsOk());
+
+  const auto loudness = calculator->QueryLoudness();
+  ASSERT_THAT(loudness, IsOk());
+
+  EXPECT_EQ(loudness->integrated_loudness, kMinQ7_8);
+  EXPECT_EQ(loudness->digital_peak, kMinQ7_8);
+}
+
+TEST(QueryLoudness, MeasuresTheReferenceSineWave) {
+  // A 0 dBFS 997 Hz sine wave in one channel measures -3.01 LKFS. With the
+  // same wave in both channels it measures 0 LKFS.
+  auto calculator = LoudnessCalculatorItuRBs1770::Create(
+      GetLayout(kSoundSystemA_0_2_0), kSampleRate);
+  ASSERT_NE(calculator, nullptr);
+  EXPECT_THAT(
+      calculator->AccumulateLoudnessForSamples(GetSine(2, 997.0, 0.1, 3.0)),
+      IsOk());
+
+  const auto loudness = calculator->QueryLoudness();
+  ASSERT_THAT(loudness, IsOk());
+
+  EXPECT_NEAR(loudness->integrated_loudness, -20 * 256, kToleranceQ7_8);
+  EXPECT_NEAR(loudness->digital_peak, -20 * 256, kToleranceQ7_8);
+}
+
+TEST(QueryLoudness, ExcludesTheLfe) {
+  // Only the LFE of 5.1 has samples.
+  std::vector<int32_t> samples;
+  const auto sine = GetSine(1, 50.0, 0.5, 1.0);
+  for (const auto sample : sine) {
+    samples.insert(samples.end(), {0, 0, 0, sample, 0, 0});
+  }
+  auto calculator = LoudnessCalculatorItuRBs1770::Create(
+      GetLayout(kSoundSystemB_0_5_0), kSampleRate);
+  ASSERT_NE(calculator, nullptr);
+  EXPECT_THAT(calculator->AccumulateLoudnessForSamples(samples), IsOk());
+
+  const auto loudness = calculator->QueryLoudness();
+  ASSERT_THAT(loudness, IsOk());
+
+  EXPECT_EQ(loudness->integrated_loudness, kMinQ7_8);
+  EXPECT_NEAR(loudness->digital_peak, -6 * 256, kToleranceQ7_8);
+}
+
+TEST(QueryLoudness, GatesQuietPassages) {
+  // The quiet passage is 40 dB below the loud one, so its blocks are excluded
+  // by the relative gate.
+  auto loud_calculator = LoudnessCalculatorItuRBs1770::Create(
+      GetLayout(kSoundSystem12_0_1_0), kSampleRate);
+  auto mixed_calculator = LoudnessCalculatorItuRBs1770::Create(
+      GetLayout(kSoundSystem12_0_1_0), kSampleRate);
+  ASSERT_NE(loud_calculator, nullptr);
+  ASSERT_NE(mixed_calculator, nullptr);
+  const auto loud = GetSine(1, 440.0, 0.5, 2.0);
+  const auto quiet = GetSine(1, 440.0, 0.005, 6.0);
+  EXPECT_THAT(loud_calculator->AccumulateLoudnessForSamples(loud), IsOk());
+  EXPECT_THAT(mixed_calculator->AccumulateLoudnessForSamples(loud), IsOk());
+  EXPECT_THAT(mixed_calculator->AccumulateLoudnessForSamples(quiet), IsOk());
+
+  const auto loud_loudness = loud_calculator->QueryLoudness();
+  const auto mixed_loudness = mixed_calculator->QueryLoudness();
+  ASSERT_THAT(loud_loudness, IsOk());
+  ASSERT_THAT(mixed_loudness, IsOk());
+
+  // The loud passage has 17 gating blocks. Three more blocks overlap the end
+  // of the loud passage by 75%, 50% and 25% and still pass the gates.
+  const double kTransitionGain = 10.0 * std::log10((17 + 1.5) / 20.0);
+  EXPECT_NEAR(mixed_loudness->integrated_loudness,
+              loud_loudness->integrated_loudness + 256 * kTransitionGain,
+              kToleranceQ7_8);
+}
+
+TEST(QueryLoudness, IsIndependentOfHowSamplesAreSplit) {
+  const auto samples = GetSine(2, 1000.0, 0.3, 1.5);
+  auto whole_calculator = LoudnessCalculatorItuRBs1770::Create(
+      GetLayout(kSoundSystemA_0_2_0, LoudnessInfo::kTruePeak), kSampleRate);
+  auto split_calculator = LoudnessCalculatorItuRBs1770::Create(
+      GetLayout(kSoundSystemA_0_2_0, LoudnessInfo::kTruePeak), kSampleRate);
+  ASSERT_NE(whole_calculator, nullptr);
+  ASSERT_NE(split_calculator, nullptr);
+  EXPECT_THAT(whole_calculator->AccumulateLoudnessForSamples(samples), IsOk());
+  // Split in frames of 1021 ticks, which do not line up with the steps.
+  constexpr int kFrameSize = 2 * 1021;
+  for (size_t i = 0; i < samples.size(); i += kFrameSize) {
+    const size_t end = std::min(samples.size(), i + kFrameSize);
+    EXPECT_THAT(split_calculator->AccumulateLoudnessForSamples(
+                    std::vector<int32_t>(samples.begin() + i,
+                                         samples.begin() + end)),
+                IsOk());
+  }
+
+  EXPECT_EQ(*whole_calculator->QueryLoudness(),
+            *split_calculator->QueryLoudness());
+}
+
+TEST(QueryLoudness, MeasuresTruePeakBetweenSamples) {
+  // A quarter of the sample rate, with every sample at 45 degrees from the
+  // peaks. The samples are 3 dB below the peaks.
+  auto calculator = LoudnessCalculatorItuRBs1770::Create(
+      GetLayout(kSoundSystem12_0_1_0, LoudnessInfo::kTruePeak), kSampleRate);
+  ASSERT_NE(calculator, nullptr);
+  EXPECT_THAT(calculator->AccumulateLoudnessForSamples(
+                  GetSine(1, kSampleRate / 4, 0.5, 1.0, std::numbers::pi / 4)),
+              IsOk());
+
+  const auto loudness = calculator->QueryLoudness();
+  ASSERT_THAT(loudness, IsOk());
+
+  EXPECT_NEAR(loudness->digital_peak, -9.03 * 256, kToleranceQ7_8);
+  EXPECT_NEAR(loudness->true_peak, -6.02 * 256, 2 * kToleranceQ7_8);
+}
+
+TEST(QueryLoudness, EchoesOtherUserProvidedFields) {
+  MixPresentationLayout layout = GetLayout(kSoundSystemA_0_2_0);
+  layout.loudness.info_type = LoudnessInfo::kAnchoredLoudness;
+  layout.loudness.true_peak = 123;
+  layout.loudness.anchored_loudness = {
+      .num_anchored_loudness = 1,
+      .anchor_elements = {
+          {AnchoredLoudnessElement::kAnchorElementDialogue, 400}}};
+  auto calculator = LoudnessCalculatorItuRBs1770::Create(layout, kSampleRate);
+  ASSERT_NE(calculator, nullptr);
+
+  const auto loudness = calculator->QueryLoudness();
+  ASSERT_THAT(loudness, IsOk());
+
+  EXPECT_EQ(loudness->info_type, layout.loudness.info_type);
+  EXPECT_EQ(loudness->true_peak, 123);
+  EXPECT_EQ(loudness->anchored_loudness, layout.loudness.anchored_loudness);
+}
+
+}  // namespace
+}  // namespace iamf_tools
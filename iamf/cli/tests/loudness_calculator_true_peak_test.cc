@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/loudness_calculator_true_peak.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/cli/loudness_calculator.h"
+#include "iamf/obu/mix_presentation.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+
+const LoudnessInfo kLoudnessInfo = {
+    .info_type = LoudnessInfo::kTruePeak | LoudnessInfo::kAnchoredLoudness,
+    .integrated_loudness = 100,
+    .digital_peak = 200,
+    .true_peak = 300,
+    .anchored_loudness = {
+        .num_anchored_loudness = 1,
+        .anchor_elements = {
+            {AnchoredLoudnessElement::kAnchorElementDialogue, 400}}}};
+
+LoudnessCalculatorTruePeak CreateCalculator(int num_channels,
+                                            const LoudnessInfo& loudness) {
+  return LoudnessCalculatorTruePeak(
+      num_channels,
+      std::make_unique<LoudnessCalculatorUserProvidedLoudness>(loudness));
+}
+
+// Gets a stereo sine wave at a quarter of the sample rate, whose samples are
+// 3 dB below the peaks.
+std::vector<int32_t> GetStereoQuarterRateSine(double amplitude) {
+  std::vector<int32_t> samples;
+  for (int t = 0; t < 4800; ++t) {
+    const auto sample = static_cast<int32_t>(
+        amplitude * std::numeric_limits<int32_t>::max() *
+        std::sin(std::numbers::pi / 2 * t + std::numbers::pi / 4));
+    samples.insert(samples.end(), {sample, sample});
+  }
+  return samples;
+}
+
+TEST(AccumulateLoudnessForSamples, FailsForPartialTicks) {
+  auto calculator = CreateCalculator(2, kLoudnessInfo);
+
+  EXPECT_FALSE(calculator.AccumulateLoudnessForSamples({1, 2, 3}).ok());
+}
+
+TEST(QueryLoudness, ReplacesTheTruePeak) {
+  auto calculator = CreateCalculator(2, kLoudnessInfo);
+  EXPECT_THAT(calculator.AccumulateLoudnessForSamples(
+                  GetStereoQuarterRateSine(0.5)),
+              IsOk());
+
+  const auto loudness = calculator.QueryLoudness();
+  ASSERT_THAT(loudness, IsOk());
+
+  // -6.02 dBTP, within 0.2 dB.
+  EXPECT_NEAR(loudness->true_peak, -6.02 * 256, 52);
+}
+
+TEST(QueryLoudness, EchoesTheWrappedCalculator) {
+  auto calculator = CreateCalculator(2, kLoudnessInfo);
+  EXPECT_THAT(calculator.AccumulateLoudnessForSamples(
+                  GetStereoQuarterRateSine(0.5)),
+              IsOk());
+
+  const auto loudness = calculator.QueryLoudness();
+  ASSERT_THAT(loudness, IsOk());
+
+  LoudnessInfo expected_loudness = kLoudnessInfo;
+  expected_loudness.true_peak = loudness->true_peak;
+  EXPECT_EQ(*loudness, expected_loudness);
+}
+
+TEST(QueryLoudness, KeepsTheTruePeakWhenItIsNotPresent) {
+  LoudnessInfo loudness_without_true_peak = kLoudnessInfo;
+  loudness_without_true_peak.info_type = LoudnessInfo::kAnchoredLoudness;
+  auto calculator = CreateCalculator(2, loudness_without_true_peak);
+  EXPECT_THAT(calculator.AccumulateLoudnessForSamples(
+                  GetStereoQuarterRateSine(0.5)),
+              IsOk());
+
+  EXPECT_EQ(*calculator.QueryLoudness(), loudness_without_true_peak);
+}
+
+}  // namespace
+}  // namespace iamf_tools
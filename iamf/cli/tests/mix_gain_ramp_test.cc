@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/mix_gain_ramp.h"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status_matchers.h"
+#include "absl/types/span.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/cli/parameter_block_with_data.h"
+#include "iamf/obu/leb128.h"
+#include "iamf/obu/obu_header.h"
+#include "iamf/obu/param_definitions.h"
+#include "iamf/obu/parameter_block.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::testing::Each;
+using ::testing::FloatEq;
+using ::testing::Pointwise;
+
+constexpr DecodedUleb128 kParameterId = 100;
+constexpr DecodedUleb128 kOtherParameterId = 200;
+constexpr int16_t kDefaultMixGain = -6 * 256;
+constexpr int32_t kDuration = 64;
+
+// Q7.8 rounding error, with some margin for single-precision arithmetic.
+constexpr float kMaxErrorDb = 1.0f / 256 + 1e-4f;
+
+float DbToLinear(float gain_db) { return std::pow(10.0f, gain_db / 20.0f); }
+
+MixGainParamDefinition CreateParamDefinition(DecodedUleb128 parameter_id) {
+  MixGainParamDefinition param_definition;
+  param_definition.parameter_id_ = parameter_id;
+  param_definition.parameter_rate_ = 48000;
+  param_definition.param_definition_mode_ = 0;
+  param_definition.duration_ = kDuration;
+  param_definition.constant_subblock_duration_ = kDuration;
+  param_definition.default_mix_gain_ = kDefaultMixGain;
+  return param_definition;
+}
+
+class MixGainRampTest : public ::testing::Test {
+ protected:
+  MixGainRampTest() {
+    for (const auto parameter_id : {kParameterId, kOtherParameterId}) {
+      per_id_metadata_[parameter_id] = {
+          .param_definition_type = ParamDefinition::kParameterDefinitionMixGain,
+          .param_definition = CreateParamDefinition(parameter_id),
+      };
+    }
+  }
+
+  ParameterBlockWithData CreateParameterBlock(
+      DecodedUleb128 parameter_id, int32_t start_timestamp,
+      const MixGainParameterData& mix_gain_parameter_data) {
+    auto obu = std::make_unique<ParameterBlockObu>(
+        ObuHeader(), parameter_id, per_id_metadata_.at(parameter_id));
+    EXPECT_THAT(obu->InitializeSubblocks(), IsOk());
+    obu->subblocks_[0].param_data = mix_gain_parameter_data;
+    return {.obu = std::move(obu),
+            .start_timestamp = start_timestamp,
+            .end_timestamp = start_timestamp + kDuration};
+  }
+
+  std::vector<float> GetLinearGains(int32_t start_timestamp, int num_ticks) {
+    std::vector<float> linear_gains(num_ticks);
+    ramp_.GetLinearGains(start_timestamp, absl::MakeSpan(linear_gains));
+    return linear_gains;
+  }
+
+  absl::flat_hash_map<DecodedUleb128, PerIdParameterMetadata> per_id_metadata_;
+  MixGainRamp ramp_ = MixGainRamp(CreateParamDefinition(kParameterId));
+};
+
+const MixGainParameterData kLinear = {
+    .animation_type = MixGainParameterData::kAnimateLinear,
+    .param_data = AnimationLinearInt16{.start_point_value = 0,
+                                       .end_point_value = -12 * 256}};
+
+void ExpectExpansionMatchesInterpolation(
+    const MixGainParameterData& mix_gain_parameter_data, int32_t duration) {
+  std::vector<float> mix_gains_db;
+  EXPECT_THAT(ExpandMixGainParameterData(mix_gain_parameter_data, duration,
+                                         mix_gains_db),
+              IsOk());
+
+  ASSERT_EQ(mix_gains_db.size(), duration);
+  for (int32_t n = 0; n < duration; ++n) {
+    int16_t expected_mix_gain;
+    EXPECT_THAT(ParameterBlockObu::InterpolateMixGainParameterData(
+                    mix_gain_parameter_data, 0, duration, n, expected_mix_gain),
+                IsOk());
+    EXPECT_NEAR(mix_gains_db[n], expected_mix_gain / 256.0f, kMaxErrorDb);
+  }
+}
+
+TEST(ExpandMixGainParameterData, MatchesInterpolatedStep) {
+  ExpectExpansionMatchesInterpolation(
+      {.animation_type = MixGainParameterData::kAnimateStep,
+       .param_data = AnimationStepInt16{.start_point_value = -3 * 256}},
+      kDuration);
+}
+
+TEST(ExpandMixGainParameterData, MatchesInterpolatedLinear) {
+  ExpectExpansionMatchesInterpolation(kLinear, kDuration);
+}
+
+TEST(ExpandMixGainParameterData, MatchesInterpolatedBezier) {
+  for (const uint8_t control_point_relative_time : {0, 64, 128, 200, 255}) {
+    ExpectExpansionMatchesInterpolation(
+        {.animation_type = MixGainParameterData::kAnimateBezier,
+         .param_data = AnimationBezierInt16{
+             .start_point_value = 6 * 256,
+             .end_point_value = -20 * 256,
+             .control_point_value = -2 * 256,
+             .control_point_relative_time = control_point_relative_time}},
+        kDuration);
+  }
+}
+
+TEST(ExpandMixGainParameterData, FailsWhenDataDoesNotMatchAnimationType) {
+  std::vector<float> mix_gains_db;
+
+  EXPECT_FALSE(
+      ExpandMixGainParameterData(
+          {.animation_type = MixGainParameterData::kAnimateBezier,
+           .param_data = AnimationStepInt16{.start_point_value = 0}},
+          kDuration, mix_gains_db)
+          .ok());
+}
+
+TEST_F(MixGainRampTest, UsesDefaultMixGainWithoutParameterBlocks) {
+  EXPECT_THAT(GetLinearGains(0, 16), Each(FloatEq(DbToLinear(-6.0f))));
+}
+
+TEST_F(MixGainRampTest, ConvertsParameterBlocksToLinearGains) {
+  EXPECT_THAT(
+      ramp_.AddParameterBlock(CreateParameterBlock(kParameterId, 0, kLinear)),
+      IsOk());
+
+  const auto linear_gains = GetLinearGains(0, kDuration);
+
+  std::vector<float> mix_gains_db;
+  EXPECT_THAT(ExpandMixGainParameterData(kLinear, kDuration, mix_gains_db),
+              IsOk());
+  for (int32_t n = 0; n < kDuration; ++n) {
+    EXPECT_NEAR(linear_gains[n], DbToLinear(mix_gains_db[n]), 1e-5f);
+  }
+}
+
+TEST_F(MixGainRampTest, GainsDoNotDependOnHowTicksAreQueried) {
+  EXPECT_THAT(
+      ramp_.AddParameterBlock(CreateParameterBlock(kParameterId, 0, kLinear)),
+      IsOk());
+  MixGainRamp other_ramp(CreateParamDefinition(kParameterId));
+  EXPECT_THAT(other_ramp.AddParameterBlock(
+                  CreateParameterBlock(kParameterId, 0, kLinear)),
+              IsOk());
+  std::vector<float> expected_linear_gains(kDuration);
+  other_ramp.GetLinearGains(0, absl::MakeSpan(expected_linear_gains));
+
+  // Query the block in frames which do not line up with it.
+  std::vector<float> linear_gains;
+  for (int32_t start_timestamp = 0; start_timestamp < kDuration;
+       start_timestamp += 24) {
+    const auto frame = GetLinearGains(start_timestamp, 24);
+    linear_gains.insert(linear_gains.end(), frame.begin(), frame.end());
+  }
+  linear_gains.resize(kDuration);
+
+  EXPECT_THAT(linear_gains, Pointwise(FloatEq(), expected_linear_gains));
+}
+
+TEST_F(MixGainRampTest, UsesDefaultMixGainBetweenParameterBlocks) {
+  EXPECT_THAT(ramp_.AddParameterBlock(
+                  CreateParameterBlock(kParameterId, kDuration, kLinear)),
+              IsOk());
+
+  const auto linear_gains = GetLinearGains(kDuration - 8, 16);
+
+  for (int n = 0; n < 8; ++n) {
+    EXPECT_FLOAT_EQ(linear_gains[n], DbToLinear(-6.0f));
+  }
+  // The linear animation starts at 0 dB.
+  EXPECT_FLOAT_EQ(linear_gains[8], 1.0f);
+}
+
+TEST_F(MixGainRampTest, IgnoresOtherParameterIds) {
+  EXPECT_THAT(ramp_.AddParameterBlock(
+                  CreateParameterBlock(kOtherParameterId, 0, kLinear)),
+              IsOk());
+
+  EXPECT_THAT(GetLinearGains(0, kDuration), Each(FloatEq(DbToLinear(-6.0f))));
+}
+
+TEST_F(MixGainRampTest, FailsForOverlappingParameterBlocks) {
+  EXPECT_THAT(
+      ramp_.AddParameterBlock(CreateParameterBlock(kParameterId, 0, kLinear)),
+      IsOk());
+
+  EXPECT_FALSE(
+      ramp_.AddParameterBlock(CreateParameterBlock(kParameterId, 32, kLinear))
+          .ok());
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -11,23 +11,48 @@
  */
 #include "iamf/cli/mix_presentation_finalizer.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <list>
 #include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "iamf/cli/audio_element_with_data.h"
+#include "iamf/cli/channel_label.h"
+#include "iamf/cli/demixing_module.h"
+#include "iamf/cli/loudness_calculator.h"
+#include "iamf/cli/loudness_calculator_factory.h"
+#include "iamf/cli/parameter_block_with_data.h"
+#include "iamf/cli/renderer/audio_element_renderer_base.h"
+#include "iamf/cli/renderer_factory.h"
 #include "iamf/cli/tests/cli_test_utils.h"
+#include "iamf/cli/wav_reader.h"
 #include "iamf/cli/wav_writer.h"
+#include "iamf/obu/audio_element.h"
+#include "iamf/obu/codec_config.h"
 #include "iamf/obu/leb128.h"
 #include "iamf/obu/mix_presentation.h"
+#include "iamf/obu/obu_header.h"
+#include "iamf/obu/param_definitions.h"
+#include "iamf/obu/parameter_block.h"
 
 namespace iamf_tools {
 namespace {
 
 using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
 
 constexpr DecodedUleb128 kMixPresentationId = 42;
 constexpr DecodedUleb128 kAudioElementId = 300;
@@ -156,5 +181,589 @@ TEST_F(MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizerTest,
             kLoudnessInfo);
 }
 
+constexpr uint32_t kCodecConfigId = 1;
+constexpr uint32_t kSampleRate = 48000;
+constexpr DecodedUleb128 kSecondAudioElementId = 301;
+constexpr int kNumSamplesPerFrame = 8;
+
+const Layout kStereoLayout = {
+    .layout_type = Layout::kLayoutTypeLoudspeakersSsConvention,
+    .specific_layout = LoudspeakersSsConventionLayout{
+        .sound_system = LoudspeakersSsConventionLayout::kSoundSystemA_0_2_0}};
+const Layout k5_1Layout = {
+    .layout_type = Layout::kLayoutTypeLoudspeakersSsConvention,
+    .specific_layout = LoudspeakersSsConventionLayout{
+        .sound_system = LoudspeakersSsConventionLayout::kSoundSystemB_0_5_0}};
+
+// Renders the `kL2` and `kR2` channels of each frame to stereo.
+class StereoRenderer : public AudioElementRendererBase {
+ public:
+  absl::StatusOr<int> RenderLabeledFrame(
+      const LabeledFrame& labeled_frame) override {
+    const auto& left = labeled_frame.label_to_samples.at(ChannelLabel::kL2);
+    const auto& right = labeled_frame.label_to_samples.at(ChannelLabel::kR2);
+    absl::MutexLock lock(&mutex_);
+    for (int t = 0; t < left.size(); ++t) {
+      rendered_samples_.push_back(left[t]);
+      rendered_samples_.push_back(right[t]);
+    }
+    return left.size();
+  }
+};
+
+// Creates `StereoRenderer`s for stereo layouts and nothing else.
+class StereoRendererFactory : public RendererFactoryBase {
+ public:
+  /*!\brief Constructor.
+   *
+   * \param num_renderers_created Counter to increment for every renderer
+   *     created, or `nullptr`.
+   */
+  explicit StereoRendererFactory(int* num_renderers_created = nullptr)
+      : num_renderers_created_(num_renderers_created) {}
+
+  std::unique_ptr<AudioElementRendererBase> CreateRendererForLayout(
+      const std::vector<DecodedUleb128>&, const SubstreamIdLabelsMap&,
+      AudioElementObu::AudioElementType,
+      const AudioElementObu::AudioElementConfig&,
+      const Layout& loudness_layout) const override {
+    if (loudness_layout != kStereoLayout) {
+      return nullptr;
+    }
+    if (num_renderers_created_ != nullptr) {
+      ++*num_renderers_created_;
+    }
+    return std::make_unique<StereoRenderer>();
+  }
+
+ private:
+  int* const num_renderers_created_;
+};
+
+// Measures the highest absolute sample as the digital peak, in units of
+// 2^16.
+class PeakLoudnessCalculator : public LoudnessCalculatorBase {
+ public:
+  explicit PeakLoudnessCalculator(const LoudnessInfo& user_provided_loudness)
+      : loudness_(user_provided_loudness) {
+    loudness_.digital_peak = 0;
+  }
+
+  absl::Status AccumulateLoudnessForSamples(
+      const std::vector<int32_t>& rendered_samples) override {
+    for (const auto sample : rendered_samples) {
+      loudness_.digital_peak = std::max(
+          loudness_.digital_peak, static_cast<int16_t>(std::abs(sample >> 16)));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<LoudnessInfo> QueryLoudness() const override {
+    return loudness_;
+  }
+
+ private:
+  LoudnessInfo loudness_;
+};
+
+class PeakLoudnessCalculatorFactory : public LoudnessCalculatorFactoryBase {
+ public:
+  std::unique_ptr<LoudnessCalculatorBase> CreateLoudnessCalculator(
+      const MixPresentationLayout& layout, int32_t, int32_t) const override {
+    return std::make_unique<PeakLoudnessCalculator>(layout.loudness);
+  }
+};
+
+class MeasureLoudnessWithRendererTest : public ::testing::Test {
+ public:
+  MeasureLoudnessWithRendererTest() {
+    AddLpcmCodecConfigWithIdAndSampleRate(kCodecConfigId, kSampleRate,
+                                          codec_config_obus_);
+    for (const auto audio_element_id :
+         {kAudioElementId, kSecondAudioElementId}) {
+      AddScalableAudioElementWithSubstreamIds(
+          audio_element_id, kCodecConfigId, {audio_element_id},
+          codec_config_obus_, audio_elements_);
+    }
+  }
+
+  // Adds frames where every sample of the audio element is `value`, in units
+  // of 2^16.
+  void AddFrames(DecodedUleb128 audio_element_id, int32_t value,
+                 int num_frames) {
+    auto& time_to_labeled_frame =
+        id_to_time_to_labeled_frame_[audio_element_id];
+    for (int i = 0; i < num_frames; ++i) {
+      const std::vector<int32_t> samples(kNumSamplesPerFrame, value << 16);
+      time_to_labeled_frame[i * kNumSamplesPerFrame] = {
+          .end_timestamp = (i + 1) * kNumSamplesPerFrame,
+          .label_to_samples = {{ChannelLabel::kL2, samples},
+                               {ChannelLabel::kR2, samples}}};
+    }
+  }
+
+  absl::Status Finalize(int num_threads) {
+    MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer finalizer(
+        "", std::make_unique<StereoRendererFactory>(),
+        std::make_unique<PeakLoudnessCalculatorFactory>(), num_threads);
+    return finalizer.Finalize(audio_elements_, id_to_time_to_labeled_frame_,
+                              parameter_blocks_, wav_writer_factory_,
+                              obus_to_finalize_);
+  }
+
+  void AddStepParameterBlock(DecodedUleb128 parameter_id,
+                             int32_t start_timestamp, int32_t duration,
+                             int16_t mix_gain) {
+    MixGainParamDefinition param_definition;
+    param_definition.parameter_id_ = parameter_id;
+    param_definition.parameter_rate_ = kSampleRate;
+    param_definition.param_definition_mode_ = 0;
+    param_definition.duration_ = duration;
+    param_definition.constant_subblock_duration_ = duration;
+    auto& per_id_metadata = per_id_metadata_.emplace_back(
+        PerIdParameterMetadata{
+            .param_definition_type =
+                ParamDefinition::kParameterDefinitionMixGain,
+            .param_definition = param_definition});
+    auto obu = std::make_unique<ParameterBlockObu>(ObuHeader(), parameter_id,
+                                                   per_id_metadata);
+    ASSERT_THAT(obu->InitializeSubblocks(), IsOk());
+    obu->subblocks_[0].param_data = MixGainParameterData{
+        .animation_type = MixGainParameterData::kAnimateStep,
+        .param_data = AnimationStepInt16{.start_point_value = mix_gain}};
+    parameter_blocks_.push_back({.obu = std::move(obu),
+                                 .start_timestamp = start_timestamp,
+                                 .end_timestamp = start_timestamp + duration});
+  }
+
+ protected:
+  absl::flat_hash_map<uint32_t, CodecConfigObu> codec_config_obus_;
+  absl::flat_hash_map<uint32_t, AudioElementWithData> audio_elements_;
+  IdTimeLabeledFrameMap id_to_time_to_labeled_frame_;
+  // Parameter blocks refer to their metadata, which must outlive them.
+  std::list<PerIdParameterMetadata> per_id_metadata_;
+  std::list<ParameterBlockWithData> parameter_blocks_;
+  std::list<MixPresentationObu> obus_to_finalize_;
+  MixPresentationFinalizerBase::WavWriterFactory wav_writer_factory_ =
+      ProduceNoWavWriters;
+};
+
+TEST_F(MeasureLoudnessWithRendererTest, MeasuresRenderedLayouts) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+  AddFrames(kAudioElementId, 100, 4);
+
+  EXPECT_THAT(Finalize(1), IsOk());
+
+  EXPECT_EQ(
+      obus_to_finalize_.front().sub_mixes_[0].layouts[0].loudness.digital_peak,
+      100);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest, MixesAudioElementsWithDefaultGains) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId, kSecondAudioElementId},
+      kCommonParameterId, kCommonParameterRate, obus_to_finalize_);
+  // -6.02 dB halves the second audio element.
+  obus_to_finalize_.front()
+      .sub_mixes_[0]
+      .audio_elements[1]
+      .element_mix_gain.default_mix_gain_ = -1541;
+  AddFrames(kAudioElementId, 100, 4);
+  AddFrames(kSecondAudioElementId, 200, 4);
+
+  EXPECT_THAT(Finalize(1), IsOk());
+
+  EXPECT_NEAR(
+      obus_to_finalize_.front().sub_mixes_[0].layouts[0].loudness.digital_peak,
+      200, 1);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest, AppliesElementMixGainParameterBlocks) {
+  constexpr DecodedUleb128 kElementParameterId = 1000;
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId, kSecondAudioElementId},
+      kCommonParameterId, kCommonParameterRate, obus_to_finalize_);
+  obus_to_finalize_.front()
+      .sub_mixes_[0]
+      .audio_elements[1]
+      .element_mix_gain.parameter_id_ = kElementParameterId;
+  AddFrames(kAudioElementId, 100, 4);
+  AddFrames(kSecondAudioElementId, 200, 4);
+  // +6.02 dB doubles the second audio element in the last two frames.
+  AddStepParameterBlock(kElementParameterId, 2 * kNumSamplesPerFrame,
+                        2 * kNumSamplesPerFrame, 1541);
+
+  EXPECT_THAT(Finalize(1), IsOk());
+
+  EXPECT_NEAR(
+      obus_to_finalize_.front().sub_mixes_[0].layouts[0].loudness.digital_peak,
+      500, 1);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest, AppliesOutputMixGainParameterBlocks) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+  // Only animate the output mix gain.
+  obus_to_finalize_.front()
+      .sub_mixes_[0]
+      .audio_elements[0]
+      .element_mix_gain.parameter_id_ = kCommonParameterId + 2;
+  AddFrames(kAudioElementId, 100, 4);
+  // Blocks of other parameters do not change the mix.
+  AddStepParameterBlock(kCommonParameterId + 1, 0, 4 * kNumSamplesPerFrame,
+                        1541);
+  // -6.02 dB halves the mix in the first frame only.
+  AddStepParameterBlock(kCommonParameterId, 0, kNumSamplesPerFrame, -1541);
+  const std::string wav_filename = GetAndCleanupOutputFileName(".wav");
+  wav_writer_factory_ = [&wav_filename](DecodedUleb128, int, int,
+                                        const Layout&,
+                                        const std::filesystem::path&,
+                                        int num_channels, int sample_rate,
+                                        int bit_depth) {
+    return std::make_unique<WavWriter>(wav_filename, num_channels, sample_rate,
+                                       bit_depth);
+  };
+  EXPECT_THAT(Finalize(1), IsOk());
+
+  auto wav_reader = CreateWavReaderExpectOk(wav_filename, kNumSamplesPerFrame);
+  std::vector<int32_t> left_channel;
+  while (wav_reader.ReadFrame() > 0) {
+    for (const auto& tick : wav_reader.buffers_) {
+      left_channel.push_back(tick[0] >> 16);
+    }
+  }
+  ASSERT_EQ(left_channel.size(), 4 * kNumSamplesPerFrame);
+  for (int t = 0; t < left_channel.size(); ++t) {
+    EXPECT_NEAR(left_channel[t], t < kNumSamplesPerFrame ? 50 : 100, 1);
+  }
+}
+
+TEST_F(MeasureLoudnessWithRendererTest,
+       SharesRenderersBetweenMixPresentations) {
+  // Both mix presentations render both audio elements to stereo with the
+  // same rendering config.
+  for (const auto mix_presentation_id :
+       {kMixPresentationId, kMixPresentationId + 1}) {
+    AddMixPresentationObuWithAudioElementIds(
+        mix_presentation_id, {kAudioElementId, kSecondAudioElementId},
+        kCommonParameterId, kCommonParameterRate, obus_to_finalize_);
+  }
+  obus_to_finalize_.back()
+      .sub_mixes_[0]
+      .audio_elements[1]
+      .element_mix_gain.default_mix_gain_ = -1541;
+  AddFrames(kAudioElementId, 100, 4);
+  AddFrames(kSecondAudioElementId, 200, 4);
+  int num_renderers_created = 0;
+  MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer finalizer(
+      "", std::make_unique<StereoRendererFactory>(&num_renderers_created),
+      std::make_unique<PeakLoudnessCalculatorFactory>(), 2);
+
+  EXPECT_THAT(finalizer.Finalize(audio_elements_, id_to_time_to_labeled_frame_,
+                                 {}, ProduceNoWavWriters, obus_to_finalize_),
+              IsOk());
+
+  EXPECT_EQ(num_renderers_created, 2);
+  // Each mix presentation still applies its own mix gains.
+  EXPECT_EQ(
+      obus_to_finalize_.front().sub_mixes_[0].layouts[0].loudness.digital_peak,
+      300);
+  EXPECT_NEAR(
+      obus_to_finalize_.back().sub_mixes_[0].layouts[0].loudness.digital_peak,
+      200, 1);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest,
+       DoesNotShareRenderersBetweenRenderingConfigs) {
+  for (const auto mix_presentation_id :
+       {kMixPresentationId, kMixPresentationId + 1}) {
+    AddMixPresentationObuWithAudioElementIds(
+        mix_presentation_id, {kAudioElementId}, kCommonParameterId,
+        kCommonParameterRate, obus_to_finalize_);
+  }
+  obus_to_finalize_.back()
+      .sub_mixes_[0]
+      .audio_elements[0]
+      .rendering_config.headphones_rendering_mode =
+      RenderingConfig::kHeadphonesRenderingModeBinaural;
+  AddFrames(kAudioElementId, 100, 4);
+  int num_renderers_created = 0;
+  MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer finalizer(
+      "", std::make_unique<StereoRendererFactory>(&num_renderers_created),
+      std::make_unique<PeakLoudnessCalculatorFactory>(), 1);
+
+  EXPECT_THAT(finalizer.Finalize(audio_elements_, id_to_time_to_labeled_frame_,
+                                 {}, ProduceNoWavWriters, obus_to_finalize_),
+              IsOk());
+
+  EXPECT_EQ(num_renderers_created, 2);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest,
+       KeepsUserLoudnessForLayoutsWhichCannotBeRendered) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+  auto& layouts = obus_to_finalize_.front().sub_mixes_[0].layouts;
+  layouts.push_back({.loudness_layout = k5_1Layout,
+                     .loudness = {.integrated_loudness = 99,
+                                  .digital_peak = 100}});
+  const auto kUserLoudness = layouts[1].loudness;
+  AddFrames(kAudioElementId, 50, 4);
+
+  EXPECT_THAT(Finalize(2), IsOk());
+
+  EXPECT_EQ(layouts[0].loudness.digital_peak, 50);
+  EXPECT_EQ(layouts[1].loudness, kUserLoudness);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest, WritesRenderedSamplesToWavFiles) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+  AddFrames(kAudioElementId, 100, 4);
+  const std::string wav_filename = GetAndCleanupOutputFileName(".wav");
+  wav_writer_factory_ = [&wav_filename](DecodedUleb128, int, int,
+                                        const Layout&,
+                                        const std::filesystem::path&,
+                                        int num_channels, int sample_rate,
+                                        int bit_depth) {
+    return std::make_unique<WavWriter>(wav_filename, num_channels, sample_rate,
+                                       bit_depth);
+  };
+
+  EXPECT_THAT(Finalize(1), IsOk());
+
+  const auto wav_reader =
+      CreateWavReaderExpectOk(wav_filename, kNumSamplesPerFrame);
+  EXPECT_EQ(wav_reader.num_channels(), 2);
+  EXPECT_EQ(wav_reader.remaining_samples(), 2 * 4 * kNumSamplesPerFrame);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest, IsIndependentOfTheNumberOfThreads) {
+  // Several mix presentations with several layouts each, where every layout
+  // measures differently.
+  const auto add_mix_presentation_obus = [this]() {
+    obus_to_finalize_.clear();
+    for (int i = 0; i < 4; ++i) {
+      AddMixPresentationObuWithAudioElementIds(
+          kMixPresentationId + i, {kAudioElementId, kSecondAudioElementId},
+          kCommonParameterId, kCommonParameterRate, obus_to_finalize_);
+      auto& sub_mix = obus_to_finalize_.back().sub_mixes_[0];
+      sub_mix.output_mix_gain.default_mix_gain_ = -256 * i;
+      sub_mix.layouts.push_back(sub_mix.layouts[0]);
+      sub_mix.layouts.push_back({.loudness_layout = k5_1Layout});
+    }
+  };
+  const auto get_sub_mixes = [this]() {
+    std::vector<MixPresentationSubMix> sub_mixes;
+    for (const auto& obu : obus_to_finalize_) {
+      sub_mixes.insert(sub_mixes.end(), obu.sub_mixes_.begin(),
+                       obu.sub_mixes_.end());
+    }
+    return sub_mixes;
+  };
+  AddFrames(kAudioElementId, 100, 20);
+  AddFrames(kSecondAudioElementId, 200, 20);
+
+  // Record the order in which the wav writers are requested.
+  std::vector<std::tuple<DecodedUleb128, int, int>> wav_writer_requests;
+  wav_writer_factory_ = [&wav_writer_requests](
+                            DecodedUleb128 mix_presentation_id,
+                            int sub_mix_index, int layout_index,
+                            const Layout&, const std::filesystem::path&, int,
+                            int, int) -> std::unique_ptr<WavWriter> {
+    wav_writer_requests.push_back(
+        {mix_presentation_id, sub_mix_index, layout_index});
+    return nullptr;
+  };
+  add_mix_presentation_obus();
+  EXPECT_THAT(Finalize(1), IsOk());
+  const auto single_threaded_sub_mixes = get_sub_mixes();
+  const auto single_threaded_wav_writer_requests = wav_writer_requests;
+
+  add_mix_presentation_obus();
+  wav_writer_requests.clear();
+  EXPECT_THAT(Finalize(8), IsOk());
+
+  EXPECT_EQ(get_sub_mixes(), single_threaded_sub_mixes);
+  EXPECT_EQ(wav_writer_requests, single_threaded_wav_writer_requests);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest, StreamingMatchesFinalizingAtOnce) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId, kSecondAudioElementId},
+      kCommonParameterId, kCommonParameterRate, obus_to_finalize_);
+  AddFrames(kAudioElementId, 100, 10);
+  AddFrames(kSecondAudioElementId, -300, 10);
+  EXPECT_THAT(Finalize(2), IsOk());
+  const auto expected_loudness =
+      obus_to_finalize_.front().sub_mixes_[0].layouts[0].loudness;
+
+  // Push the same frames one temporal unit at a time.
+  std::list<MixPresentationObu> streamed_obus;
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId, kSecondAudioElementId},
+      kCommonParameterId, kCommonParameterRate, streamed_obus);
+  MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer finalizer(
+      "", std::make_unique<StereoRendererFactory>(),
+      std::make_unique<PeakLoudnessCalculatorFactory>(), 2);
+  EXPECT_THAT(finalizer.Initialize(audio_elements_, ProduceNoWavWriters,
+                                   streamed_obus),
+              IsOk());
+  for (int i = 0; i < 10; ++i) {
+    const int32_t start_timestamp = i * kNumSamplesPerFrame;
+    IdLabeledFrameMap id_to_labeled_frame;
+    for (const auto audio_element_id :
+         {kAudioElementId, kSecondAudioElementId}) {
+      id_to_labeled_frame[audio_element_id] =
+          id_to_time_to_labeled_frame_[audio_element_id][start_timestamp];
+    }
+    EXPECT_THAT(
+        finalizer.PushTemporalUnit(id_to_labeled_frame, start_timestamp, {}),
+        IsOk());
+  }
+  EXPECT_THAT(finalizer.FinalizePushingTemporalUnits(streamed_obus), IsOk());
+
+  EXPECT_EQ(streamed_obus.front().sub_mixes_[0].layouts[0].loudness,
+            expected_loudness);
+  EXPECT_EQ(expected_loudness.digital_peak, 200);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest, WritesPushedTemporalUnitsToWavFiles) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+  AddFrames(kAudioElementId, 100, 1);
+  const std::string wav_filename = GetAndCleanupOutputFileName(".wav");
+  MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer finalizer(
+      "", std::make_unique<StereoRendererFactory>(), nullptr, 1);
+  EXPECT_THAT(
+      finalizer.Initialize(
+          audio_elements_,
+          [&wav_filename](DecodedUleb128, int, int, const Layout&,
+                          const std::filesystem::path&, int num_channels,
+                          int sample_rate, int bit_depth) {
+            return std::make_unique<WavWriter>(wav_filename, num_channels,
+                                               sample_rate, bit_depth);
+          },
+          obus_to_finalize_),
+      IsOk());
+
+  EXPECT_THAT(finalizer.PushTemporalUnit(
+                  {{kAudioElementId, id_to_time_to_labeled_frame_
+                                         [kAudioElementId][0]}},
+                  0, {}),
+              IsOk());
+  EXPECT_THAT(finalizer.FinalizePushingTemporalUnits(obus_to_finalize_),
+              IsOk());
+  EXPECT_EQ(CreateWavReaderExpectOk(wav_filename, kNumSamplesPerFrame)
+                .remaining_samples(),
+            2 * kNumSamplesPerFrame);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest, FailsWhenAnAudioElementIsMissing) {
+  constexpr DecodedUleb128 kMissingAudioElementId = 999;
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kMissingAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+
+  EXPECT_FALSE(Finalize(1).ok());
+}
+
+TEST_F(MeasureLoudnessWithRendererTest,
+       WritesWavFilesWithTheOutputWavFileBitDepthOverride) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+  AddFrames(kAudioElementId, 100, 4);
+  int wav_file_bit_depth = 0;
+  const auto wav_writer_factory =
+      [&wav_file_bit_depth](DecodedUleb128, int, int, const Layout&,
+                            const std::filesystem::path&, int, int,
+                            int bit_depth) -> std::unique_ptr<WavWriter> {
+    wav_file_bit_depth = bit_depth;
+    return nullptr;
+  };
+  const uint8_t kOutputWavFileBitDepthOverride = 32;
+  MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer finalizer(
+      "", std::make_unique<StereoRendererFactory>(),
+      std::make_unique<PeakLoudnessCalculatorFactory>(), /*num_threads=*/1,
+      kOutputWavFileBitDepthOverride);
+
+  EXPECT_THAT(finalizer.Finalize(audio_elements_, id_to_time_to_labeled_frame_,
+                                 parameter_blocks_, wav_writer_factory,
+                                 obus_to_finalize_),
+              IsOk());
+
+  EXPECT_EQ(wav_file_bit_depth, kOutputWavFileBitDepthOverride);
+}
+
+TEST_F(MeasureLoudnessWithRendererTest,
+       ValidatingLoudnessFailsWhenTheMeasuredLoudnessDiffers) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+  obus_to_finalize_.front().sub_mixes_[0].layouts[0].loudness.digital_peak =
+      99;
+  AddFrames(kAudioElementId, 100, 4);
+  MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer finalizer(
+      "", std::make_unique<StereoRendererFactory>(),
+      std::make_unique<PeakLoudnessCalculatorFactory>(), /*num_threads=*/1,
+      /*output_wav_file_bit_depth_override=*/std::nullopt,
+      /*validate_loudness=*/true);
+
+  EXPECT_THAT(finalizer.Finalize(audio_elements_, id_to_time_to_labeled_frame_,
+                                 parameter_blocks_, wav_writer_factory_,
+                                 obus_to_finalize_),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(MeasureLoudnessWithRendererTest,
+       ValidatingLoudnessSucceedsWhenTheMeasuredLoudnessMatches) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+  obus_to_finalize_.front().sub_mixes_[0].layouts[0].loudness.digital_peak =
+      100;
+  AddFrames(kAudioElementId, 100, 4);
+  MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer finalizer(
+      "", std::make_unique<StereoRendererFactory>(),
+      std::make_unique<PeakLoudnessCalculatorFactory>(), /*num_threads=*/1,
+      /*output_wav_file_bit_depth_override=*/std::nullopt,
+      /*validate_loudness=*/true);
+
+  EXPECT_THAT(finalizer.Finalize(audio_elements_, id_to_time_to_labeled_frame_,
+                                 parameter_blocks_, wav_writer_factory_,
+                                 obus_to_finalize_),
+              IsOk());
+}
+
+// Rejects every sample rate.
+class InvalidSampleRateRendererFactory : public StereoRendererFactory {
+ public:
+  absl::Status ValidateSampleRate(const Layout&, uint32_t) const override {
+    return absl::InvalidArgumentError("");
+  }
+};
+
+TEST_F(MeasureLoudnessWithRendererTest,
+       InitializeFailsWhenTheRendererFactoryRejectsTheSampleRate) {
+  AddMixPresentationObuWithAudioElementIds(
+      kMixPresentationId, {kAudioElementId}, kCommonParameterId,
+      kCommonParameterRate, obus_to_finalize_);
+  MeasureLoudnessOrFallbackToUserLoudnessMixPresentationFinalizer finalizer(
+      "", std::make_unique<InvalidSampleRateRendererFactory>(),
+      std::make_unique<PeakLoudnessCalculatorFactory>());
+
+  EXPECT_FALSE(
+      finalizer
+          .Initialize(audio_elements_, ProduceNoWavWriters, obus_to_finalize_)
+          .ok());
+}
+
 }  // namespace
 }  // namespace iamf_tools
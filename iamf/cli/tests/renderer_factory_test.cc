@@ -11,18 +11,26 @@
  */
 #include "iamf/cli/renderer_factory.h"
 
+#include <cstdint>
+#include <memory>
+
+#include "absl/status/status_matchers.h"
 #include "gtest/gtest.h"
 #include "iamf/cli/channel_label.h"
 #include "iamf/cli/proto/obu_header.pb.h"
 #include "iamf/cli/proto/parameter_data.pb.h"
 #include "iamf/cli/proto/temporal_delimiter.pb.h"
 #include "iamf/cli/proto/user_metadata.pb.h"
+#include "iamf/cli/renderer/hrir_set.h"
+#include "iamf/cli/renderer/precomputed_gains.h"
 #include "iamf/obu/audio_element.h"
 #include "iamf/obu/mix_presentation.h"
 
 namespace iamf_tools {
 namespace {
 
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
 using enum LoudspeakersSsConventionLayout::SoundSystem;
 using enum ChannelAudioLayerConfig::LoudspeakerLayout;
 using enum ChannelLabel::Label;
@@ -47,16 +55,28 @@ const AmbisonicsConfig kFullZerothOrderAmbisonicsConfig = {
                                               .substream_count = 1,
                                               .channel_mapping = {0}}};
 
-TEST(CreateRendererForLayout, ReturnsNullPtrForPassThroughRenderer) {
+constexpr uint32_t kHrirSampleRate = 48000;
+
+std::shared_ptr<const HrirSet> MakeStereoHrirSet() {
+  return std::make_shared<const HrirSet>(
+      HrirSet{.layout = PrecomputedGainsLayout::k0_2_0,
+              .sample_rate = kHrirSampleRate,
+              .num_loudspeakers = 2,
+              .num_taps = 1,
+              .impulse_responses = {1.0f, 0.0f, 0.0f, 1.0f}});
+}
+
+TEST(CreateRendererForLayout, SupportsPassThroughRenderer) {
   const RendererFactory factory;
 
-  EXPECT_EQ(factory.CreateRendererForLayout(
+  EXPECT_NE(factory.CreateRendererForLayout(
                 {0}, {{0, {kMono}}}, AudioElementObu::kAudioElementChannelBased,
                 kMonoScalableChannelLayoutConfig, kMonoLayout),
             nullptr);
 }
 
-TEST(CreateRendererForLayout, ReturnsNullPtrForChannelToBinauralRenderer) {
+TEST(CreateRendererForLayout,
+     ReturnsNullPtrForChannelToBinauralRendererWithoutHrirs) {
   const RendererFactory factory;
 
   EXPECT_EQ(factory.CreateRendererForLayout(
@@ -65,20 +85,29 @@ TEST(CreateRendererForLayout, ReturnsNullPtrForChannelToBinauralRenderer) {
             nullptr);
 }
 
-TEST(CreateRendererForLayout, ReturnsNullPtrForChannelToChannelRenderer) {
+TEST(CreateRendererForLayout, SupportsChannelToBinauralRendererWithHrirs) {
+  const RendererFactory factory(MakeStereoHrirSet());
+
+  EXPECT_NE(factory.CreateRendererForLayout(
+                {0}, {{0, {kMono}}}, AudioElementObu::kAudioElementChannelBased,
+                kMonoScalableChannelLayoutConfig, kBinauralLayout),
+            nullptr);
+}
+
+TEST(CreateRendererForLayout, SupportsChannelToChannelRenderer) {
   const RendererFactory factory;
 
-  EXPECT_EQ(
+  EXPECT_NE(
       factory.CreateRendererForLayout(
           {0}, {{0, {kL2, kR2}}}, AudioElementObu::kAudioElementChannelBased,
           kStereoScalableChannelLayoutConfig, kMonoLayout),
       nullptr);
 }
 
-TEST(CreateRendererForLayout, ReturnsNullPtrForAmbisonicsToChannelRenderer) {
+TEST(CreateRendererForLayout, SupportsAmbisonicsToChannelRenderer) {
   const RendererFactory factory;
 
-  EXPECT_EQ(factory.CreateRendererForLayout(
+  EXPECT_NE(factory.CreateRendererForLayout(
                 {0}, {{0, {kA0}}}, AudioElementObu::kAudioElementSceneBased,
                 kFullZerothOrderAmbisonicsConfig, kMonoLayout),
             nullptr);
@@ -93,5 +122,31 @@ TEST(CreateRendererForLayout, ReturnsNullPtrForAmbisonicsToBinauralRenderer) {
             nullptr);
 }
 
+TEST(ValidateSampleRate, AcceptsHrirsWithTheSameSampleRate) {
+  const RendererFactory factory(MakeStereoHrirSet());
+
+  EXPECT_THAT(factory.ValidateSampleRate(kBinauralLayout, kHrirSampleRate),
+              IsOk());
+}
+
+TEST(ValidateSampleRate, RejectsHrirsWithADifferentSampleRate) {
+  const RendererFactory factory(MakeStereoHrirSet());
+
+  EXPECT_THAT(factory.ValidateSampleRate(kBinauralLayout, 44100),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ValidateSampleRate, IgnoresTheHrirsForLoudspeakerLayouts) {
+  const RendererFactory factory(MakeStereoHrirSet());
+
+  EXPECT_THAT(factory.ValidateSampleRate(kMonoLayout, 44100), IsOk());
+}
+
+TEST(ValidateSampleRate, AcceptsBinauralLayoutsWithoutHrirs) {
+  const RendererFactory factory;
+
+  EXPECT_THAT(factory.ValidateSampleRate(kBinauralLayout, 44100), IsOk());
+}
+
 }  // namespace
 }  // namespace iamf_tools
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/sample_ring_buffer.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+TEST(SampleRingBuffer, IsEmptyOnConstruction) {
+  const SampleRingBuffer ring(2, 8);
+
+  EXPECT_TRUE(ring.empty());
+  EXPECT_EQ(ring.num_channels(), 2);
+  EXPECT_EQ(ring.capacity(), 8);
+}
+
+TEST(SampleRingBuffer, PopsTicksInTheOrderTheyWerePushed) {
+  SampleRingBuffer ring(2, 8);
+  EXPECT_THAT(ring.PushTick({1, 2}), IsOk());
+  EXPECT_THAT(ring.PushTick({3, 4}), IsOk());
+  EXPECT_THAT(ring.PushTick({5, 6}), IsOk());
+
+  EXPECT_THAT(ring.PeekTicks(2), IsOkAndHolds(ElementsAre(1, 2, 3, 4)));
+  EXPECT_THAT(ring.PopTicks(2), IsOk());
+
+  EXPECT_EQ(ring.size(), 1);
+  EXPECT_THAT(ring.PeekTicks(1), IsOkAndHolds(ElementsAre(5, 6)));
+}
+
+TEST(SampleRingBuffer, PushesZeros) {
+  SampleRingBuffer ring(2, 8);
+  EXPECT_THAT(ring.PushTick({1, 2}), IsOk());
+  ring.PushZeros(2);
+
+  EXPECT_THAT(ring.PeekTicks(3),
+              IsOkAndHolds(ElementsAre(1, 2, 0, 0, 0, 0)));
+}
+
+TEST(SampleRingBuffer, InvalidWhenPushingTickWithWrongNumberOfChannels) {
+  SampleRingBuffer ring(2, 8);
+
+  EXPECT_THAT(ring.PushTick({1, 2, 3}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(SampleRingBuffer, InvalidWhenPeekingMoreTicksThanQueued) {
+  SampleRingBuffer ring(2, 8);
+  EXPECT_THAT(ring.PushTick({1, 2}), IsOk());
+
+  EXPECT_THAT(ring.PeekTicks(2).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(SampleRingBuffer, InvalidWhenPoppingMoreTicksThanQueued) {
+  SampleRingBuffer ring(2, 8);
+  EXPECT_THAT(ring.PushTick({1, 2}), IsOk());
+  std::vector<std::vector<int32_t>> ticks;
+
+  EXPECT_THAT(ring.PopTicks(2), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ring.PopTicks(2, ticks),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(ring.size(), 1);
+}
+
+TEST(SampleRingBuffer, WrapsAroundWithoutGrowing) {
+  SampleRingBuffer ring(1, 4);
+  std::vector<int32_t> popped;
+  int32_t next_value = 0;
+  // Push three ticks and pop two, so the queue moves around the ring.
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 3 && ring.size() < 4; ++j) {
+      EXPECT_THAT(ring.PushTick({next_value++}), IsOk());
+    }
+    const auto ticks = ring.PeekTicks(2);
+    ASSERT_THAT(ticks, IsOk());
+    popped.insert(popped.end(), ticks->begin(), ticks->end());
+    EXPECT_THAT(ring.PopTicks(2), IsOk());
+  }
+
+  EXPECT_EQ(ring.capacity(), 4);
+  std::vector<int32_t> expected_popped(popped.size());
+  for (int i = 0; i < expected_popped.size(); ++i) {
+    expected_popped[i] = i;
+  }
+  EXPECT_EQ(popped, expected_popped);
+}
+
+TEST(SampleRingBuffer, PeekingWrappedTicksKeepsTheirOrder) {
+  SampleRingBuffer ring(2, 3);
+  EXPECT_THAT(ring.PushTick({1, 1}), IsOk());
+  EXPECT_THAT(ring.PushTick({2, 2}), IsOk());
+  EXPECT_THAT(ring.PopTicks(1), IsOk());
+  EXPECT_THAT(ring.PushTick({3, 3}), IsOk());
+  ring.PushZeros(1);
+
+  // The last two ticks wrapped around the end of the ring.
+  EXPECT_THAT(ring.PeekTicks(3),
+              IsOkAndHolds(ElementsAre(2, 2, 3, 3, 0, 0)));
+}
+
+TEST(SampleRingBuffer, GrowsWhenPushingBeyondCapacity) {
+  SampleRingBuffer ring(1, 2);
+  EXPECT_THAT(ring.PushTick({1}), IsOk());
+  EXPECT_THAT(ring.PushTick({2}), IsOk());
+  EXPECT_THAT(ring.PopTicks(1), IsOk());
+  EXPECT_THAT(ring.PushTick({3}), IsOk());
+  ring.PushZeros(3);
+
+  EXPECT_GE(ring.capacity(), 5);
+  EXPECT_THAT(ring.PeekTicks(5),
+              IsOkAndHolds(ElementsAre(2, 3, 0, 0, 0)));
+}
+
+TEST(SampleRingBuffer, PopsIntoVectorOfTicks) {
+  SampleRingBuffer ring(2, 4);
+  EXPECT_THAT(ring.PushTick({1, 2}), IsOk());
+  EXPECT_THAT(ring.PushTick({3, 4}), IsOk());
+  EXPECT_THAT(ring.PushTick({5, 6}), IsOk());
+  std::vector<std::vector<int32_t>> ticks = {{9, 9}, {9, 9}, {9, 9}, {9, 9}};
+
+  EXPECT_THAT(ring.PopTicks(2, ticks), IsOk());
+
+  EXPECT_THAT(ticks, ElementsAreArray<std::vector<int32_t>>({{1, 2}, {3, 4}}));
+  EXPECT_EQ(ring.size(), 1);
+}
+
+}  // namespace
+}  // namespace iamf_tools
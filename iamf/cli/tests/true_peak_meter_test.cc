@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/true_peak_meter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "absl/types/span.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+
+constexpr double kFullScale = 2147483648.0;
+
+// Gets a sine wave at a quarter of the sample rate, with every sample at 45
+// degrees from the peaks. The samples are 3 dB below the peaks.
+std::vector<int32_t> GetQuarterRateSine(double amplitude, int num_ticks) {
+  std::vector<int32_t> samples(num_ticks);
+  for (int t = 0; t < num_ticks; ++t) {
+    samples[t] = static_cast<int32_t>(
+        amplitude * std::numeric_limits<int32_t>::max() *
+        std::sin(std::numbers::pi / 2 * t + std::numbers::pi / 4));
+  }
+  return samples;
+}
+
+TEST(AccumulateSamples, FailsForPartialTicks) {
+  TruePeakMeter meter(2);
+
+  EXPECT_FALSE(meter.AccumulateSamples({1, 2, 3}).ok());
+}
+
+TEST(GetTruePeak, IsZeroForSilence) {
+  TruePeakMeter meter(2);
+  EXPECT_THAT(meter.AccumulateSamples(std::vector<int32_t>(2000, 0)), IsOk());
+
+  EXPECT_EQ(meter.GetTruePeak(), 0.0);
+}
+
+TEST(GetTruePeak, MeasuresPeaksBetweenSamples) {
+  TruePeakMeter meter(1);
+  EXPECT_THAT(meter.AccumulateSamples(GetQuarterRateSine(0.5, 4800)), IsOk());
+
+  EXPECT_NEAR(meter.GetTruePeak(), 0.5, 0.01);
+}
+
+TEST(GetChannelTruePeak, MeasuresEachChannel) {
+  const auto loud = GetQuarterRateSine(0.5, 1000);
+  const auto quiet = GetQuarterRateSine(0.1, 1000);
+  std::vector<int32_t> samples;
+  for (int t = 0; t < 1000; ++t) {
+    samples.insert(samples.end(), {quiet[t], 0, loud[t]});
+  }
+  TruePeakMeter meter(3);
+  EXPECT_THAT(meter.AccumulateSamples(samples), IsOk());
+
+  EXPECT_NEAR(meter.GetChannelTruePeak(0), 0.1, 0.01);
+  EXPECT_EQ(meter.GetChannelTruePeak(1), 0.0);
+  EXPECT_NEAR(meter.GetChannelTruePeak(2), 0.5, 0.01);
+  EXPECT_EQ(meter.GetTruePeak(), meter.GetChannelTruePeak(2));
+}
+
+TEST(GetTruePeak, MatchesTheAnnex2Interpolator) {
+  // Coefficients of the first two phases of ITU-R BS.1770-4 Annex 2. The
+  // others are the same coefficients reversed.
+  constexpr double kPhases[2][12] = {
+      {0.0017089843750, 0.0109863281250, -0.0196533203125, 0.0332031250000,
+       -0.0594482421875, 0.1373291015625, 0.9721679687500, -0.1022949218750,
+       0.0476074218750, -0.0266113281250, 0.0148925781250, -0.0083007812500},
+      {-0.0291748046875, 0.0292968750000, -0.0517578125000, 0.0891113281250,
+       -0.1665039062500, 0.4650878906250, 0.7797851562500, -0.2003173828125,
+       0.1015625000000, -0.0582275390625, 0.0330810546875, -0.0189208984375}};
+  std::mt19937 random(1234);
+  std::uniform_int_distribution<int32_t> distribution(-(1 << 30), 1 << 30);
+  constexpr int kNumTicks = 1000;
+  std::vector<int32_t> samples(kNumTicks);
+  for (auto& sample : samples) {
+    sample = distribution(random);
+  }
+  // Interpolate every sample directly, with silence before the first one.
+  double expected_true_peak = 0.0;
+  for (int t = 0; t < kNumTicks; ++t) {
+    for (const auto& phase : kPhases) {
+      double forward = 0.0;
+      double reversed = 0.0;
+      for (int k = 0; k < 12 && k <= t; ++k) {
+        forward += phase[k] * samples[t - k];
+        reversed += phase[11 - k] * samples[t - k];
+      }
+      expected_true_peak = std::max(
+          {expected_true_peak, std::abs(forward), std::abs(reversed)});
+    }
+  }
+  TruePeakMeter meter(1);
+  EXPECT_THAT(meter.AccumulateSamples(samples), IsOk());
+
+  EXPECT_NEAR(meter.GetTruePeak(), expected_true_peak / kFullScale, 1e-6);
+}
+
+TEST(GetTruePeak, IsIndependentOfHowSamplesAreSplit) {
+  std::mt19937 random(5678);
+  std::uniform_int_distribution<int32_t> distribution;
+  std::vector<int32_t> samples(2 * 3000);
+  for (auto& sample : samples) {
+    sample = distribution(random);
+  }
+  TruePeakMeter whole_meter(2);
+  TruePeakMeter split_meter(2);
+  EXPECT_THAT(whole_meter.AccumulateSamples(samples), IsOk());
+  // Frames shorter than the interpolator and longer than the internal runs.
+  size_t begin = 0;
+  for (const int num_ticks : {1, 5, 300, 11, 2000, 683}) {
+    EXPECT_THAT(split_meter.AccumulateSamples(
+                    absl::MakeConstSpan(samples).subspan(begin, 2 * num_ticks)),
+                IsOk());
+    begin += 2 * num_ticks;
+  }
+  ASSERT_EQ(begin, samples.size());
+
+  EXPECT_EQ(whole_meter.GetChannelTruePeak(0),
+            split_meter.GetChannelTruePeak(0));
+  EXPECT_EQ(whole_meter.GetChannelTruePeak(1),
+            split_meter.GetChannelTruePeak(1));
+}
+
+TEST(QueryTruePeak, MeasuresSilenceAsTheMinimumValue) {
+  TruePeakMeter meter(1);
+  EXPECT_THAT(meter.AccumulateSamples(std::vector<int32_t>(100, 0)), IsOk());
+
+  int16_t true_peak;
+  EXPECT_THAT(meter.QueryTruePeak(true_peak), IsOk());
+
+  EXPECT_EQ(true_peak, std::numeric_limits<int16_t>::min());
+}
+
+TEST(QueryTruePeak, OutputsDecibelsAsQ7_8) {
+  TruePeakMeter meter(1);
+  EXPECT_THAT(meter.AccumulateSamples(GetQuarterRateSine(0.5, 4800)), IsOk());
+
+  int16_t true_peak;
+  EXPECT_THAT(meter.QueryTruePeak(true_peak), IsOk());
+
+  // -6.02 dBTP, within 0.2 dB.
+  EXPECT_NEAR(true_peak, -6.02 * 256, 52);
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/cli/true_peak_meter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "iamf/common/obu_util.h"
+
+namespace iamf_tools {
+
+namespace {
+
+// Scale from `int32_t` samples to the range [-1, 1].
+constexpr float kSampleScale = 1.0f / 2147483648.0f;
+
+// Polyphase coefficients of the 4x oversampling filter of ITU-R BS.1770-4
+// Annex 2, one row per phase. Tap `k` applies to the sample `k` ticks before
+// the newest one.
+constexpr int kNumTaps = 12;
+constexpr float kFilter[TruePeakMeter::kOversamplingFactor][kNumTaps] = {
+    {0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f,
+     -0.0594482421875f, 0.1373291015625f, 0.9721679687500f, -0.1022949218750f,
+     0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f},
+    {-0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f,
+     -0.1665039062500f, 0.4650878906250f, 0.7797851562500f, -0.2003173828125f,
+     0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f},
+    {-0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f,
+     -0.2003173828125f, 0.7797851562500f, 0.4650878906250f, -0.1665039062500f,
+     0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f},
+    {-0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f,
+     -0.1022949218750f, 0.9721679687500f, 0.1373291015625f, -0.0594482421875f,
+     0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f}};
+constexpr int kHistorySize = kNumTaps - 1;
+
+// Number of ticks of each channel which are interpolated at once. Small enough
+// for the scratch buffers to stay in the L1 cache.
+constexpr int kMaxTicksPerRun = 256;
+
+}  // namespace
+
+TruePeakMeter::TruePeakMeter(int num_channels)
+    : num_channels_(num_channels),
+      history_(num_channels * kHistorySize, 0.0f),
+      channel_true_peaks_(num_channels, 0.0f),
+      channel_samples_(kHistorySize + kMaxTicksPerRun),
+      interpolated_(kMaxTicksPerRun),
+      peaks_(kMaxTicksPerRun) {}
+
+absl::Status TruePeakMeter::AccumulateSamples(
+    absl::Span<const int32_t> rendered_samples) {
+  if (num_channels_ <= 0 || rendered_samples.size() % num_channels_ != 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected a multiple of ", num_channels_, " samples. Got ",
+        rendered_samples.size(), "."));
+  }
+
+  const size_t num_ticks = rendered_samples.size() / num_channels_;
+  float* const samples = channel_samples_.data();
+  float* const interpolated = interpolated_.data();
+  float* const peaks = peaks_.data();
+  for (size_t first_tick = 0; first_tick < num_ticks;
+       first_tick += kMaxTicksPerRun) {
+    const int num_run_ticks = static_cast<int>(
+        std::min<size_t>(kMaxTicksPerRun, num_ticks - first_tick));
+    const int32_t* const run =
+        rendered_samples.data() + first_tick * num_channels_;
+    for (int c = 0; c < num_channels_; ++c) {
+      // Prepend the history, so every output only reads from `samples`.
+      float* const history = history_.data() + c * kHistorySize;
+      std::copy(history, history + kHistorySize, samples);
+      for (int t = 0; t < num_run_ticks; ++t) {
+        samples[kHistorySize + t] = run[t * num_channels_ + c] * kSampleScale;
+      }
+
+      std::fill(peaks, peaks + num_run_ticks, 0.0f);
+      for (const auto& phase : kFilter) {
+        std::fill(interpolated, interpolated + num_run_ticks, 0.0f);
+        for (int k = 0; k < kNumTaps; ++k) {
+          const float tap = phase[k];
+          const float* const delayed = samples + kHistorySize - k;
+          for (int t = 0; t < num_run_ticks; ++t) {
+            interpolated[t] += tap * delayed[t];
+          }
+        }
+        for (int t = 0; t < num_run_ticks; ++t) {
+          peaks[t] = std::max(peaks[t], std::abs(interpolated[t]));
+        }
+      }
+      channel_true_peaks_[c] =
+          std::max(channel_true_peaks_[c],
+                   *std::max_element(peaks, peaks + num_run_ticks));
+
+      std::copy(samples + num_run_ticks,
+                samples + num_run_ticks + kHistorySize, history);
+    }
+  }
+  return absl::OkStatus();
+}
+
+double TruePeakMeter::GetTruePeak() const {
+  double true_peak = 0.0;
+  for (const float channel_true_peak : channel_true_peaks_) {
+    true_peak = std::max(true_peak, static_cast<double>(channel_true_peak));
+  }
+  return true_peak;
+}
+
+absl::Status TruePeakMeter::QueryTruePeak(int16_t& true_peak) const {
+  constexpr double kMinQ7_8 = -128.0;
+  constexpr double kMaxQ7_8 = 128.0 - 1.0 / 256.0;
+  const double true_peak_db = 20.0 * std::log10(GetTruePeak());
+  return FloatToQ7_8(
+      static_cast<float>(std::clamp(true_peak_db, kMinQ7_8, kMaxQ7_8)),
+      true_peak);
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef CLI_TRUE_PEAK_METER_H_
+#define CLI_TRUE_PEAK_METER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+
+namespace iamf_tools {
+
+/*!\brief Measures the true peak of interleaved samples.
+ *
+ * The true peak is measured as in Annex 2 of ITU-R BS.1770-4: each channel is
+ * oversampled 4x by a polyphase FIR interpolator and the highest absolute
+ * interpolated sample is kept for each channel.
+ *
+ * Samples are deinterleaved into short contiguous runs, so each phase of the
+ * interpolator is a loop over consecutive ticks of one channel which the
+ * compiler vectorizes. The tail of each channel is kept across calls, so the
+ * measurement does not depend on how the samples are split.
+ */
+class TruePeakMeter {
+ public:
+  /*!\brief Number of interpolated samples per input sample. */
+  static constexpr int kOversamplingFactor = 4;
+
+  /*!\brief Constructor.
+   *
+   * \param num_channels Number of interleaved channels to measure.
+   */
+  explicit TruePeakMeter(int num_channels);
+
+  /*!\brief Accumulates samples to be measured.
+   *
+   * \param rendered_samples Interleaved samples to measure.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     the samples do not hold a whole number of ticks.
+   */
+  absl::Status AccumulateSamples(absl::Span<const int32_t> rendered_samples);
+
+  /*!\brief Gets the true peak of a channel.
+   *
+   * \param channel Index of the channel.
+   * \return True peak relative to the full scale of `int32_t`.
+   */
+  double GetChannelTruePeak(int channel) const {
+    return channel_true_peaks_[channel];
+  }
+
+  /*!\brief Gets the highest true peak of all channels.
+   *
+   * \return True peak relative to the full scale of `int32_t`.
+   */
+  double GetTruePeak() const;
+
+  /*!\brief Outputs the highest true peak of all channels.
+   *
+   * Peaks below the range of Q7.8, including that of silence, are clamped to
+   * -128 dB.
+   *
+   * \param true_peak True peak in dBTP as Q7.8.
+   * \return `absl::OkStatus()` on success. A specific status on failure.
+   */
+  absl::Status QueryTruePeak(int16_t& true_peak) const;
+
+ private:
+  const int num_channels_;
+
+  // Last samples of each channel, oldest first, which the interpolator needs
+  // to continue with the next call.
+  std::vector<float> history_;
+  std::vector<float> channel_true_peaks_;
+
+  // Scratch buffers, kept to avoid reallocating them on every call.
+  std::vector<float> channel_samples_;
+  std::vector<float> interpolated_;
+  std::vector<float> peaks_;
+};
+
+}  // namespace iamf_tools
+
+#endif  // CLI_TRUE_PEAK_METER_H_
@@ -20,6 +20,8 @@
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/types/span.h"
+#include "iamf/common/pcm_conversion.h"
 #include "src/dsp/write_wav_file.h"
 
 namespace iamf_tools {
@@ -107,38 +109,36 @@ bool WavWriter::WriteSamples(const std::vector<uint8_t>& buffer) {
   const int bytes_per_sample = bit_depth_ / 8;
   const size_t num_total_samples = (buffer_size) / bytes_per_sample;
 
+  // The scratch buffers keep their capacity between calls.
+  samples_int32_.resize(num_total_samples);
   int result = 0;
   if (bit_depth_ == 16) {
     // Arrange the input samples into an int16_t to match the expected input of
     // `WriteWavSamples`.
-    std::vector<int16_t> samples(num_total_samples, 0);
-    for (int i = 0; i < num_total_samples * bytes_per_sample;
-         i += bytes_per_sample) {
-      samples[i / bytes_per_sample] = (buffer[i + 1] << 8) | buffer[i];
+    UnpackPcmSamples<16, /*kBigEndian=*/false>(buffer.data(),
+                                               absl::MakeSpan(samples_int32_));
+    samples_int16_.resize(num_total_samples);
+    if (!RightJustifyFromInt32(absl::MakeConstSpan(samples_int32_),
+                               absl::MakeSpan(samples_int16_))
+             .ok()) {
+      return false;
     }
-
-    result = WriteWavSamples(file_, samples.data(), samples.size());
+    result =
+        WriteWavSamples(file_, samples_int16_.data(), samples_int16_.size());
   } else if (bit_depth_ == 24) {
     // Arrange the input samples into an int32_t to match the expected input of
     // `WriteWavSamples24Bit` with the lowest byte unused.
-    std::vector<int32_t> samples(num_total_samples, 0);
-    for (int i = 0; i < num_total_samples * bytes_per_sample;
-         i += bytes_per_sample) {
-      samples[i / bytes_per_sample] =
-          (buffer[i + 2] << 24) | buffer[i + 1] << 16 | buffer[i] << 8;
-    }
-    result = WriteWavSamples24Bit(file_, samples.data(), samples.size());
+    UnpackPcmSamples<24, /*kBigEndian=*/false>(buffer.data(),
+                                               absl::MakeSpan(samples_int32_));
+    result = WriteWavSamples24Bit(file_, samples_int32_.data(),
+                                  samples_int32_.size());
   } else if (bit_depth_ == 32) {
     // Arrange the input samples into an int32_t to match the expected input of
     // `WriteWavSamples32Bit`.
-    std::vector<int32_t> samples(num_total_samples, 0);
-    for (int i = 0; i < num_total_samples * bytes_per_sample;
-         i += bytes_per_sample) {
-      samples[i / bytes_per_sample] = buffer[i + 3] << 24 |
-                                      buffer[i + 2] << 16 | buffer[i + 1] << 8 |
-                                      buffer[i];
-    }
-    result = WriteWavSamples32Bit(file_, samples.data(), samples.size());
+    UnpackPcmSamples<32, /*kBigEndian=*/false>(buffer.data(),
+                                               absl::MakeSpan(samples_int32_));
+    result = WriteWavSamples32Bit(file_, samples_int32_.data(),
+                                  samples_int32_.size());
   } else {
     LOG(ERROR) << "WavWriter only supports 16, 24, and 32-bit samples."
                << bit_depth_;
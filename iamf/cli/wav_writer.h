@@ -72,6 +72,10 @@ class WavWriter {
   size_t total_samples_written_;
   FILE* file_;
   const std::string filename_;
+
+  // Scratch buffers reused by every call to `WriteSamples()`.
+  std::vector<int32_t> samples_int32_;
+  std::vector<int16_t> samples_int16_;
 };
 }  // namespace iamf_tools
 
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/common/pcm_conversion.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+
+namespace iamf_tools {
+
+namespace {
+
+// 2^31 is exactly representable as a `float`, so scaling by it is lossless.
+constexpr float kMaxInt32PlusOneAsFloat = 2147483648.0f;
+
+constexpr uint32_t kFloatExponentMask = 0x7f800000;
+
+// Scaling by a power of two is exact, so converting to `float` first and then
+// scaling rounds exactly once, the same as dividing in `double`.
+constexpr float kInverseMaxInt32PlusOne = 1.0f / kMaxInt32PlusOneAsFloat;
+
+}  // namespace
+
+absl::Status Int32ToNormalizedFloats(absl::Span<const int32_t> input,
+                                     absl::Span<float> output) {
+  if (input.size() != output.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Mismatched sizes: ", input.size(), " and ",
+                     output.size(), "."));
+  }
+
+  for (size_t i = 0; i < input.size(); ++i) {
+    output[i] = static_cast<float>(input[i]) * kInverseMaxInt32PlusOne;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status NormalizedFloatsToInt32(absl::Span<const float> input,
+                                     absl::Span<int32_t> output) {
+  if (input.size() != output.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Mismatched sizes: ", input.size(), " and ",
+                     output.size(), "."));
+  }
+
+  // Reject NaN and infinity up front. Both have all exponent bits set.
+  uint32_t any_non_finite = 0;
+  for (const float value : input) {
+    any_non_finite |= static_cast<uint32_t>(
+        (std::bit_cast<uint32_t>(value) & kFloatExponentMask) ==
+        kFloatExponentMask);
+  }
+  if (any_non_finite != 0) {
+    return absl::InvalidArgumentError("Input is NaN or infinity.");
+  }
+
+  for (size_t i = 0; i < input.size(); ++i) {
+    // Only exactly +1 scales out of range. Saturate it to the maximum value.
+    const float scaled =
+        std::clamp(input[i], -1.0f, 1.0f) * kMaxInt32PlusOneAsFloat;
+    output[i] = scaled >= kMaxInt32PlusOneAsFloat
+                    ? std::numeric_limits<int32_t>::max()
+                    : static_cast<int32_t>(scaled);
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<PcmPacker> GetPcmPacker(int bit_depth, bool big_endian) {
+  switch (bit_depth) {
+    case 16:
+      return big_endian ? &PackPcmSamples<16, true> : &PackPcmSamples<16, false>;
+    case 24:
+      return big_endian ? &PackPcmSamples<24, true> : &PackPcmSamples<24, false>;
+    case 32:
+      return big_endian ? &PackPcmSamples<32, true> : &PackPcmSamples<32, false>;
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unsupported bit depth: ", bit_depth));
+  }
+}
+
+absl::StatusOr<PcmUnpacker> GetPcmUnpacker(int bit_depth, bool big_endian) {
+  switch (bit_depth) {
+    case 16:
+      return big_endian ? &UnpackPcmSamples<16, true>
+                        : &UnpackPcmSamples<16, false>;
+    case 24:
+      return big_endian ? &UnpackPcmSamples<24, true>
+                        : &UnpackPcmSamples<24, false>;
+    case 32:
+      return big_endian ? &UnpackPcmSamples<32, true>
+                        : &UnpackPcmSamples<32, false>;
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unsupported bit depth: ", bit_depth));
+  }
+}
+
+absl::Status InterleaveSamples(
+    const std::vector<std::vector<int32_t>>& samples,
+    absl::Span<int32_t> interleaved) {
+  const size_t num_channels = samples.empty() ? 0 : samples[0].size();
+  if (samples.size() * num_channels > interleaved.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected room for ", samples.size() * num_channels,
+                     " samples. Got: ", interleaved.size(), "."));
+  }
+
+  auto write_position = interleaved.begin();
+  for (const auto& tick : samples) {
+    if (tick.size() != num_channels) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Expected ", num_channels,
+                       " channels in every time tick. Got: ", tick.size(), "."));
+    }
+    write_position = std::copy(tick.begin(), tick.end(), write_position);
+  }
+  std::fill(write_position, interleaved.end(), 0);
+  return absl::OkStatus();
+}
+
+absl::Status DeinterleaveSamples(
+    absl::Span<const int32_t> interleaved, int num_channels,
+    std::vector<std::vector<int32_t>>& samples) {
+  if (num_channels <= 0 || interleaved.size() % num_channels != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected a multiple of ", num_channels,
+                     " samples. Got: ", interleaved.size(), "."));
+  }
+
+  // `assign()` reuses the capacity of any existing time ticks.
+  samples.resize(interleaved.size() / num_channels);
+  auto tick_begin = interleaved.begin();
+  for (auto& tick : samples) {
+    tick.assign(tick_begin, tick_begin + num_channels);
+    tick_begin += num_channels;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace iamf_tools
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef COMMON_PCM_CONVERSION_H_
+#define COMMON_PCM_CONVERSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+
+namespace iamf_tools {
+
+// Conversions which process whole frames at once. The inner loops are free of
+// branches and status checks so the compiler can vectorize them.
+
+/*!\brief Converts `int32_t` samples to normalized `float` samples.
+ *
+ * Equivalent to calling `Int32ToNormalizedFloat()` on each sample.
+ *
+ * \param input Samples to convert.
+ * \param output Output buffer. Must be the same size as `input`.
+ * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if the
+ *     sizes do not match.
+ */
+absl::Status Int32ToNormalizedFloats(absl::Span<const int32_t> input,
+                                     absl::Span<float> output);
+
+/*!\brief Converts normalized `float` samples to `int32_t` samples.
+ *
+ * Equivalent to calling `NormalizedFloatToInt32()` on each sample.
+ *
+ * \param input Normalized floats to convert.
+ * \param output Output buffer. Must be the same size as `input`.
+ * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if the
+ *     sizes do not match or any input is NaN or infinity. The output is not
+ *     modified on failure.
+ */
+absl::Status NormalizedFloatsToInt32(absl::Span<const float> input,
+                                     absl::Span<int32_t> output);
+
+/*!\brief Left-justifies narrower signed integer samples in `int32_t`.
+ *
+ * \param input Right-justified samples to convert.
+ * \param bit_depth Number of significant bits in each input sample.
+ * \param output Output buffer. Must be the same size as `input`.
+ * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if the
+ *     sizes do not match or `bit_depth` is not in the range [1, 32].
+ */
+template <typename T>
+absl::Status LeftJustifyToInt32(absl::Span<const T> input, int bit_depth,
+                                absl::Span<int32_t> output) {
+  static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(int32_t));
+  if (input.size() != output.size() || bit_depth < 1 || bit_depth > 32) {
+    return absl::InvalidArgumentError(
+        "Invalid arguments to `LeftJustifyToInt32()`.");
+  }
+  const int shift = 32 - bit_depth;
+  for (size_t i = 0; i < input.size(); ++i) {
+    output[i] = static_cast<int32_t>(static_cast<uint32_t>(input[i]) << shift);
+  }
+  return absl::OkStatus();
+}
+
+/*!\brief Keeps the upper bits of `int32_t` samples in a narrower type.
+ *
+ * The inverse of `LeftJustifyToInt32()`. The lower bits are truncated, which
+ * matches writing the samples with `WritePcmSample()`. The result always fits
+ * in `T`, so no clipping is needed.
+ *
+ * \param input Left-justified samples to convert.
+ * \param output Output buffer. Must be the same size as `input`.
+ * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if the
+ *     sizes do not match.
+ */
+template <typename T>
+absl::Status RightJustifyFromInt32(absl::Span<const int32_t> input,
+                                   absl::Span<T> output) {
+  static_assert(std::is_integral_v<T> && std::is_signed_v<T> &&
+                sizeof(T) <= sizeof(int32_t));
+  if (input.size() != output.size()) {
+    return absl::InvalidArgumentError(
+        "Invalid arguments to `RightJustifyFromInt32()`.");
+  }
+  constexpr int kShift = 32 - 8 * static_cast<int>(sizeof(T));
+  for (size_t i = 0; i < input.size(); ++i) {
+    output[i] = static_cast<T>(input[i] >> kShift);
+  }
+  return absl::OkStatus();
+}
+
+/*!\brief Packs left-justified samples into PCM bytes.
+ *
+ * Specialized at compile time for the bit depth and endianness, so the inner
+ * loop has no branches. Produces the same bytes as calling `WritePcmSample()`
+ * on each sample.
+ *
+ * \tparam kBitDepth Number of bits per output sample. One of 16, 24 or 32.
+ * \tparam kBigEndian Whether to write big-endian or little-endian samples.
+ * \param samples Samples to pack.
+ * \param output Output buffer. Must have room for `kBitDepth / 8` bytes per
+ *     sample.
+ */
+template <int kBitDepth, bool kBigEndian>
+void PackPcmSamples(absl::Span<const int32_t> samples, uint8_t* output) {
+  static_assert(kBitDepth == 16 || kBitDepth == 24 || kBitDepth == 32);
+  constexpr int kBytesPerSample = kBitDepth / 8;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const auto sample = static_cast<uint32_t>(samples[i]);
+    for (int b = 0; b < kBytesPerSample; ++b) {
+      const int shift = kBigEndian ? 24 - 8 * b : 32 - kBitDepth + 8 * b;
+      output[i * kBytesPerSample + b] = static_cast<uint8_t>(sample >> shift);
+    }
+  }
+}
+
+/*!\brief Unpacks PCM bytes into left-justified samples.
+ *
+ * The inverse of `PackPcmSamples()`.
+ *
+ * \tparam kBitDepth Number of bits per input sample. One of 16, 24 or 32.
+ * \tparam kBigEndian Whether to read big-endian or little-endian samples.
+ * \param input Bytes to unpack. Must hold `kBitDepth / 8` bytes per sample.
+ * \param samples Output samples.
+ */
+template <int kBitDepth, bool kBigEndian>
+void UnpackPcmSamples(const uint8_t* input, absl::Span<int32_t> samples) {
+  static_assert(kBitDepth == 16 || kBitDepth == 24 || kBitDepth == 32);
+  constexpr int kBytesPerSample = kBitDepth / 8;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    uint32_t sample = 0;
+    for (int b = 0; b < kBytesPerSample; ++b) {
+      const int shift = kBigEndian ? 24 - 8 * b : 32 - kBitDepth + 8 * b;
+      sample |= static_cast<uint32_t>(input[i * kBytesPerSample + b]) << shift;
+    }
+    samples[i] = static_cast<int32_t>(sample);
+  }
+}
+
+// Signatures of the specializations of `PackPcmSamples()` and
+// `UnpackPcmSamples()`, so one can be selected at runtime.
+using PcmPacker = void (*)(absl::Span<const int32_t> samples, uint8_t* output);
+using PcmUnpacker = void (*)(const uint8_t* input,
+                             absl::Span<int32_t> samples);
+
+/*!\brief Gets the specialization of `PackPcmSamples()` for a format.
+ *
+ * \param bit_depth Number of bits per sample.
+ * \param big_endian Whether to write big-endian or little-endian samples.
+ * \return Function to pack samples on success. `absl::InvalidArgumentError()`
+ *     if the bit depth is not 16, 24 or 32.
+ */
+absl::StatusOr<PcmPacker> GetPcmPacker(int bit_depth, bool big_endian);
+
+/*!\brief Gets the specialization of `UnpackPcmSamples()` for a format.
+ *
+ * \param bit_depth Number of bits per sample.
+ * \param big_endian Whether to read big-endian or little-endian samples.
+ * \return Function to unpack samples on success.
+ *     `absl::InvalidArgumentError()` if the bit depth is not 16, 24 or 32.
+ */
+absl::StatusOr<PcmUnpacker> GetPcmUnpacker(int bit_depth, bool big_endian);
+
+/*!\brief Interleaves samples arranged in (time, channel) axes.
+ *
+ * \param samples Samples to interleave. Each time tick must have the same
+ *     number of channels.
+ * \param interleaved Output buffer. Must be large enough to hold all samples.
+ *     Any remaining samples are set to zero.
+ * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if the
+ *     output is too small or the number of channels varies.
+ */
+absl::Status InterleaveSamples(
+    const std::vector<std::vector<int32_t>>& samples,
+    absl::Span<int32_t> interleaved);
+
+/*!\brief Deinterleaves samples into (time, channel) axes.
+ *
+ * Overwrites `samples` in place. Inner vectors which are already present keep
+ * their allocations, so a buffer which is reused across frames of the same
+ * shape is not reallocated.
+ *
+ * \param interleaved Interleaved samples. The size must be a multiple of
+ *     `num_channels`.
+ * \param num_channels Number of channels.
+ * \param samples Output samples arranged in (time, channel) axes. Resized to
+ *     the number of time ticks in `interleaved`.
+ * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if the
+ *     input does not contain a whole number of time ticks.
+ */
+absl::Status DeinterleaveSamples(
+    absl::Span<const int32_t> interleaved, int num_channels,
+    std::vector<std::vector<int32_t>>& samples);
+
+}  // namespace iamf_tools
+
+#endif  // COMMON_PCM_CONVERSION_H_
@@ -12,12 +12,14 @@
 
 #include "iamf/common/read_bit_buffer.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "iamf/common/bit_buffer_util.h"
 #include "iamf/common/macros.h"
 #include "iamf/obu/leb128.h"
@@ -254,11 +256,58 @@ absl::Status ReadBitBuffer::ReadULeb128(DecodedUleb128& uleb128,
 
 absl::Status ReadBitBuffer::ReadUint8Vector(const int& count,
                                             std::vector<uint8_t>& output) {
-  output.reserve(count);
-  for (size_t i = 0; i < count; ++i) {
+  if (count < 0) {
+    return absl::InvalidArgumentError("count must be >= 0.");
+  }
+  const size_t original_size = output.size();
+  output.resize(original_size + count);
+  const absl::Status status =
+      ReadUint8Span(absl::MakeSpan(output).subspan(original_size));
+  if (!status.ok()) {
+    output.resize(original_size);
+  }
+  return status;
+}
+
+absl::Status ReadBitBuffer::ReadUint8Span(absl::Span<uint8_t> output) {
+  if (buffer_bit_offset_ < 0) {
+    return absl::UnknownError("buffer_bit_offset_ must be >= 0.");
+  }
+  const int64_t count = static_cast<int64_t>(output.size());
+  if (buffer_bit_offset_ % 8 == 0 && buffer_size_ % 8 == 0 &&
+      source_bit_offset_ % 8 == 0) {
+    // Fast path. Drain any whole bytes which are already buffered, then copy
+    // the rest straight out of the source.
+    const int64_t num_buffered_bytes = (buffer_size_ - buffer_bit_offset_) / 8;
+    const int64_t num_source_bytes =
+        static_cast<int64_t>(source_->size()) - source_bit_offset_ / 8;
+    if (num_buffered_bytes + num_source_bytes < count) {
+      return absl::ResourceExhaustedError("Not enough bits in source.");
+    }
+
+    const int64_t num_bytes_from_buffer = std::min(count, num_buffered_bytes);
+    const auto buffer_start = bit_buffer_.begin() + buffer_bit_offset_ / 8;
+    std::copy(buffer_start, buffer_start + num_bytes_from_buffer,
+              output.begin());
+    buffer_bit_offset_ += num_bytes_from_buffer * 8;
+
+    const int64_t num_bytes_from_source = count - num_bytes_from_buffer;
+    if (num_bytes_from_source > 0) {
+      // The buffer was fully consumed; skip it and read the source directly.
+      const auto source_start = source_->begin() + source_bit_offset_ / 8;
+      std::copy(source_start, source_start + num_bytes_from_source,
+                output.begin() + num_bytes_from_buffer);
+      source_bit_offset_ += num_bytes_from_source * 8;
+      DiscardAllBits();
+    }
+    return absl::OkStatus();
+  }
+
+  // Slow path. The data is mis-aligned; read it one byte at a time.
+  for (uint8_t& value : output) {
     uint64_t byte;
     RETURN_IF_NOT_OK(ReadUnsignedLiteral(8, byte));
-    output.push_back(static_cast<uint8_t>(byte));
+    value = static_cast<uint8_t>(byte);
   }
   return absl::OkStatus();
 }
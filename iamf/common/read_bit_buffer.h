@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "iamf/obu/leb128.h"
 
 namespace iamf_tools {
@@ -146,11 +147,25 @@ class ReadBitBuffer {
    * \param output uint8 vector from buffer is written here.
    * \return `absl::OkStatus()` on success. `absl::ResourceExhaustedError()` if
    *     the buffer runs out of data and cannot get more from source before the
-   *     desired `count` uint8s are read. `absl::UnknownError()` if the
-   *     `rb->bit_offset` is negative.
+   *     desired `count` uint8s are read. `absl::InvalidArgumentError()` if
+   *     `count` is negative. `absl::UnknownError()` if the `rb->bit_offset` is
+   *     negative.
    */
   absl::Status ReadUint8Vector(const int& count, std::vector<uint8_t>& output);
 
+  /*!\brief Reads `output.size()` uint8s from buffer into `output`.
+   *
+   * When the buffer and source are byte-aligned the data is copied in bulk
+   * instead of one literal at a time.
+   *
+   * \param output Span to write the uint8s to. The caller owns the storage.
+   * \return `absl::OkStatus()` on success. `absl::ResourceExhaustedError()` if
+   *     the buffer runs out of data and cannot get more from source before the
+   *     span is filled. `absl::UnknownError()` if the `rb->bit_offset` is
+   *     negative.
+   */
+  absl::Status ReadUint8Span(absl::Span<uint8_t> output);
+
   /*!\brief Reads a boolean from buffer into `output`.
    *
    * \param output Boolean bit from buffer will be written here.
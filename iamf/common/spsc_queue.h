@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#ifndef COMMON_SPSC_QUEUE_H_
+#define COMMON_SPSC_QUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace iamf_tools {
+
+/*!\brief An unbounded lock-free single-producer/single-consumer queue.
+ *
+ * Exactly one thread may call `Push()` and exactly one thread may call
+ * `TryPop()`; they may be the same thread. `Empty()` and `Size()` may be called
+ * from either side, but the result is only a snapshot when the other side is
+ * running concurrently.
+ *
+ * Elements are stored in a linked list of small fixed-size blocks. The producer
+ * links in a new block when the last one is full and the consumer releases
+ * blocks once it has popped all of their elements, so pushing never fails and
+ * the memory held is proportional to the number of queued elements. The most
+ * recently released block is kept to be reused by the producer.
+ */
+template <typename T>
+class SpscQueue {
+ public:
+  /*!\brief Constructor. */
+  SpscQueue() : head_block_(new Block), tail_block_(head_block_) {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /*!\brief Destructor. */
+  ~SpscQueue() {
+    while (head_block_ != nullptr) {
+      Block* next = head_block_->next;
+      delete head_block_;
+      head_block_ = next;
+    }
+    delete spare_block_.load(std::memory_order_acquire);
+  }
+
+  /*!\brief Pushes an element onto the back of the queue.
+   *
+   * Must only be called by the producer.
+   *
+   * \param value Element to move into the queue.
+   */
+  void Push(T&& value) {
+    if (tail_index_ == kBlockSize) {
+      Block* block = spare_block_.exchange(nullptr, std::memory_order_acquire);
+      if (block == nullptr) {
+        block = new Block;
+      }
+      block->next = nullptr;
+      // Published to the consumer by the release store to `num_pushed_` below.
+      tail_block_->next = block;
+      tail_block_ = block;
+      tail_index_ = 0;
+    }
+    tail_block_->slots[tail_index_++].emplace(std::move(value));
+    num_pushed_.store(num_pushed_.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_release);
+  }
+
+  /*!\brief Pops the element at the front of the queue.
+   *
+   * Must only be called by the consumer.
+   *
+   * \return The front element or `std::nullopt` if the queue is empty.
+   */
+  std::optional<T> TryPop() {
+    const size_t num_popped = num_popped_.load(std::memory_order_relaxed);
+    if (num_popped == num_pushed_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    if (head_index_ == kBlockSize) {
+      // The producer already moved on to a later block, because there is an
+      // element after the last one in this block.
+      Block* finished_block = head_block_;
+      head_block_ = finished_block->next;
+      head_index_ = 0;
+      delete spare_block_.exchange(finished_block, std::memory_order_acq_rel);
+    }
+    std::optional<T>& slot = head_block_->slots[head_index_++];
+    std::optional<T> value = std::move(slot);
+    slot.reset();
+    num_popped_.store(num_popped + 1, std::memory_order_release);
+    return value;
+  }
+
+  /*!\brief Checks whether the queue is empty.
+   *
+   * \return `true` if there are no elements in the queue.
+   */
+  bool Empty() const { return Size() == 0; }
+
+  /*!\brief Gets the number of elements in the queue.
+   *
+   * \return Number of elements in the queue.
+   */
+  size_t Size() const {
+    const size_t num_popped = num_popped_.load(std::memory_order_acquire);
+    return num_pushed_.load(std::memory_order_acquire) - num_popped;
+  }
+
+ private:
+  static constexpr size_t kBlockSize = 16;
+
+  struct Block {
+    std::array<std::optional<T>, kBlockSize> slots;
+    Block* next = nullptr;
+  };
+
+  // Block holding the next element to pop and the index within it. Only used
+  // by the consumer.
+  Block* head_block_;
+  size_t head_index_ = 0;
+
+  // Block to push the next element to and the index within it. Only used by
+  // the producer.
+  Block* tail_block_;
+  size_t tail_index_ = 0;
+
+  // A released block which the producer may reuse instead of allocating.
+  std::atomic<Block*> spare_block_ = nullptr;
+
+  // Total number of elements popped. Only written by the consumer. Kept on a
+  // separate cache line from `num_pushed_` to avoid false sharing.
+  alignas(64) std::atomic<size_t> num_popped_ = 0;
+
+  // Total number of elements pushed. Only written by the producer.
+  alignas(64) std::atomic<size_t> num_pushed_ = 0;
+};
+
+}  // namespace iamf_tools
+
+#endif  // COMMON_SPSC_QUEUE_H_
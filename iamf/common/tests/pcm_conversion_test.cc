@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/common/pcm_conversion.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "absl/types/span.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "iamf/common/obu_util.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::absl_testing::IsOk;
+
+TEST(Int32ToNormalizedFloats, MatchesInt32ToNormalizedFloat) {
+  const std::vector<int32_t> kInput = {std::numeric_limits<int32_t>::min(),
+                                       -0x40000000,
+                                       -1,
+                                       0,
+                                       1,
+                                       0x00ffffff,
+                                       0x01000001,
+                                       0x7fffffc0,
+                                       std::numeric_limits<int32_t>::max()};
+  std::vector<float> output(kInput.size());
+
+  EXPECT_THAT(Int32ToNormalizedFloats(kInput, absl::MakeSpan(output)), IsOk());
+
+  for (int i = 0; i < kInput.size(); ++i) {
+    EXPECT_EQ(output[i], Int32ToNormalizedFloat(kInput[i]));
+  }
+}
+
+TEST(Int32ToNormalizedFloats, InvalidForMismatchedSizes) {
+  const std::vector<int32_t> kInput = {0, 0};
+  std::vector<float> output(1);
+
+  EXPECT_FALSE(Int32ToNormalizedFloats(kInput, absl::MakeSpan(output)).ok());
+}
+
+TEST(NormalizedFloatsToInt32, MatchesNormalizedFloatToInt32) {
+  const std::vector<float> kInput = {-2.0f,  -1.0f, -0.5f,     0.0f, 1e-10f,
+                                     0.25f, 0.999f, 1.0f, 1.5f, -1e-10f};
+  std::vector<int32_t> output(kInput.size());
+
+  EXPECT_THAT(NormalizedFloatsToInt32(kInput, absl::MakeSpan(output)), IsOk());
+
+  for (int i = 0; i < kInput.size(); ++i) {
+    int32_t expected;
+    ASSERT_THAT(NormalizedFloatToInt32(kInput[i], expected), IsOk());
+    EXPECT_EQ(output[i], expected);
+  }
+}
+
+TEST(NormalizedFloatsToInt32, SaturatesAtTheLimits) {
+  const std::vector<float> kInput = {-1.0f, 1.0f};
+  std::vector<int32_t> output(kInput.size());
+
+  EXPECT_THAT(NormalizedFloatsToInt32(kInput, absl::MakeSpan(output)), IsOk());
+
+  EXPECT_EQ(output, std::vector<int32_t>({std::numeric_limits<int32_t>::min(),
+                                          std::numeric_limits<int32_t>::max()}));
+}
+
+TEST(NormalizedFloatsToInt32, InvalidForNanOrInfinity) {
+  for (const float kInvalid : {std::numeric_limits<float>::quiet_NaN(),
+                               std::numeric_limits<float>::infinity(),
+                               -std::numeric_limits<float>::infinity()}) {
+    const std::vector<float> kInput = {0.0f, kInvalid, 0.0f};
+    std::vector<int32_t> output(kInput.size());
+
+    EXPECT_FALSE(NormalizedFloatsToInt32(kInput, absl::MakeSpan(output)).ok());
+  }
+}
+
+TEST(NormalizedFloatsToInt32, InvalidForMismatchedSizes) {
+  const std::vector<float> kInput = {0.0f, 0.0f};
+  std::vector<int32_t> output(1);
+
+  EXPECT_FALSE(NormalizedFloatsToInt32(kInput, absl::MakeSpan(output)).ok());
+}
+
+TEST(LeftJustifyToInt32, ShiftsToTheUpperBits) {
+  const std::vector<int16_t> kInput = {0x0001, -1, 0x7fff, -0x8000};
+  std::vector<int32_t> output(kInput.size());
+
+  EXPECT_THAT(LeftJustifyToInt32(absl::MakeConstSpan(kInput), 16,
+                                 absl::MakeSpan(output)),
+              IsOk());
+
+  EXPECT_EQ(output, std::vector<int32_t>({0x00010000, -0x00010000, 0x7fff0000,
+                                          std::numeric_limits<int32_t>::min()}));
+}
+
+TEST(LeftJustifyToInt32, InvalidForBitDepthOutOfRange) {
+  const std::vector<int16_t> kInput = {0};
+  std::vector<int32_t> output(kInput.size());
+
+  EXPECT_FALSE(LeftJustifyToInt32(absl::MakeConstSpan(kInput), 0,
+                                  absl::MakeSpan(output))
+                   .ok());
+  EXPECT_FALSE(LeftJustifyToInt32(absl::MakeConstSpan(kInput), 33,
+                                  absl::MakeSpan(output))
+                   .ok());
+}
+
+TEST(RightJustifyFromInt32, KeepsTheUpperBits) {
+  const std::vector<int32_t> kInput = {0x0001ffff, -1, 0x7fff0000,
+                                       std::numeric_limits<int32_t>::min()};
+  std::vector<int16_t> output(kInput.size());
+
+  EXPECT_THAT(RightJustifyFromInt32(absl::MakeConstSpan(kInput),
+                                    absl::MakeSpan(output)),
+              IsOk());
+
+  EXPECT_EQ(output, std::vector<int16_t>({0x0001, -1, 0x7fff, -0x8000}));
+}
+
+TEST(RightJustifyFromInt32, InvalidForMismatchedSizes) {
+  const std::vector<int32_t> kInput = {0, 0};
+  std::vector<int16_t> output(1);
+
+  EXPECT_FALSE(RightJustifyFromInt32(absl::MakeConstSpan(kInput),
+                                     absl::MakeSpan(output))
+                   .ok());
+}
+
+TEST(InterleaveSamples, InterleavesAndFillsTheRemainderWithZeros) {
+  const std::vector<std::vector<int32_t>> kSamples = {{1, 2}, {3, 4}};
+  std::vector<int32_t> interleaved(6, -1);
+
+  EXPECT_THAT(InterleaveSamples(kSamples, absl::MakeSpan(interleaved)), IsOk());
+
+  EXPECT_EQ(interleaved, std::vector<int32_t>({1, 2, 3, 4, 0, 0}));
+}
+
+TEST(InterleaveSamples, InvalidWhenOutputIsTooSmall) {
+  const std::vector<std::vector<int32_t>> kSamples = {{1, 2}, {3, 4}};
+  std::vector<int32_t> interleaved(3);
+
+  EXPECT_FALSE(InterleaveSamples(kSamples, absl::MakeSpan(interleaved)).ok());
+}
+
+TEST(InterleaveSamples, InvalidWhenNumberOfChannelsVaries) {
+  const std::vector<std::vector<int32_t>> kSamples = {{1, 2}, {3}};
+  std::vector<int32_t> interleaved(4);
+
+  EXPECT_FALSE(InterleaveSamples(kSamples, absl::MakeSpan(interleaved)).ok());
+}
+
+TEST(DeinterleaveSamples, ArrangesSamplesInTimeChannelAxes) {
+  const std::vector<int32_t> kInterleaved = {1, 2, 3, 4, 5, 6};
+  std::vector<std::vector<int32_t>> samples;
+
+  EXPECT_THAT(DeinterleaveSamples(kInterleaved, 2, samples), IsOk());
+
+  EXPECT_EQ(samples,
+            std::vector<std::vector<int32_t>>({{1, 2}, {3, 4}, {5, 6}}));
+}
+
+TEST(DeinterleaveSamples, OverwritesExistingSamples) {
+  const std::vector<int32_t> kInterleaved = {1, 2, 3, 4};
+  std::vector<std::vector<int32_t>> samples = {{0, 0}, {0, 0}, {0, 0}};
+
+  EXPECT_THAT(DeinterleaveSamples(kInterleaved, 2, samples), IsOk());
+
+  EXPECT_EQ(samples, std::vector<std::vector<int32_t>>({{1, 2}, {3, 4}}));
+}
+
+TEST(DeinterleaveSamples, ReusesTheStorageOfExistingTimeTicks) {
+  const std::vector<int32_t> kInterleaved = {1, 2, 3, 4};
+  std::vector<std::vector<int32_t>> samples = {{0, 0}, {0, 0}};
+  const int32_t* const first_tick_storage = samples[0].data();
+  const int32_t* const second_tick_storage = samples[1].data();
+
+  EXPECT_THAT(DeinterleaveSamples(kInterleaved, 2, samples), IsOk());
+
+  EXPECT_EQ(samples[0].data(), first_tick_storage);
+  EXPECT_EQ(samples[1].data(), second_tick_storage);
+}
+
+TEST(DeinterleaveSamples, InvalidForPartialTimeTick) {
+  const std::vector<int32_t> kInterleaved = {1, 2, 3};
+  std::vector<std::vector<int32_t>> samples;
+
+  EXPECT_FALSE(DeinterleaveSamples(kInterleaved, 2, samples).ok());
+  EXPECT_TRUE(samples.empty());
+}
+
+const std::vector<int32_t> kPackingInput = {
+    std::numeric_limits<int32_t>::min(), -0x12345600, 0, 0x01020300,
+    std::numeric_limits<int32_t>::max()};
+
+template <int kBitDepth, bool kBigEndian>
+void ExpectPackMatchesWritePcmSample() {
+  const int kBytesPerSample = kBitDepth / 8;
+  std::vector<uint8_t> expected(kPackingInput.size() * kBytesPerSample);
+  int write_position = 0;
+  for (const int32_t sample : kPackingInput) {
+    EXPECT_THAT(WritePcmSample(static_cast<uint32_t>(sample), kBitDepth,
+                               kBigEndian, expected.data(), write_position),
+                IsOk());
+  }
+
+  std::vector<uint8_t> packed(expected.size());
+  PackPcmSamples<kBitDepth, kBigEndian>(absl::MakeConstSpan(kPackingInput),
+                                        packed.data());
+
+  EXPECT_EQ(packed, expected);
+}
+
+TEST(PackPcmSamples, MatchesWritePcmSample) {
+  ExpectPackMatchesWritePcmSample<16, false>();
+  ExpectPackMatchesWritePcmSample<16, true>();
+  ExpectPackMatchesWritePcmSample<24, false>();
+  ExpectPackMatchesWritePcmSample<24, true>();
+  ExpectPackMatchesWritePcmSample<32, false>();
+  ExpectPackMatchesWritePcmSample<32, true>();
+}
+
+TEST(UnpackPcmSamples, InvertsPackPcmSamplesForTheUpperBits) {
+  for (const int bit_depth : {16, 24, 32}) {
+    for (const bool big_endian : {false, true}) {
+      const auto packer = GetPcmPacker(bit_depth, big_endian);
+      const auto unpacker = GetPcmUnpacker(bit_depth, big_endian);
+      ASSERT_THAT(packer, IsOk());
+      ASSERT_THAT(unpacker, IsOk());
+      std::vector<uint8_t> packed(kPackingInput.size() * bit_depth / 8);
+      std::vector<int32_t> unpacked(kPackingInput.size());
+
+      (*packer)(absl::MakeConstSpan(kPackingInput), packed.data());
+      (*unpacker)(packed.data(), absl::MakeSpan(unpacked));
+
+      // Only the upper `bit_depth` bits survive the round trip.
+      const uint32_t mask = bit_depth == 32 ? 0xffffffff
+                                            : ~((uint32_t{1} << (32 - bit_depth)) - 1);
+      for (size_t i = 0; i < kPackingInput.size(); ++i) {
+        EXPECT_EQ(static_cast<uint32_t>(unpacked[i]),
+                  static_cast<uint32_t>(kPackingInput[i]) & mask);
+      }
+    }
+  }
+}
+
+TEST(GetPcmPacker, InvalidForUnsupportedBitDepths) {
+  EXPECT_FALSE(GetPcmPacker(8, false).ok());
+  EXPECT_FALSE(GetPcmPacker(23, false).ok());
+}
+
+TEST(GetPcmUnpacker, InvalidForUnsupportedBitDepths) {
+  EXPECT_FALSE(GetPcmUnpacker(8, true).ok());
+  EXPECT_FALSE(GetPcmUnpacker(23, true).ok());
+}
+
+}  // namespace
+}  // namespace iamf_tools
@@ -18,6 +18,7 @@
 
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/types/span.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "iamf/common/bit_buffer_util.h"
@@ -452,6 +453,75 @@ TEST_F(ReadBitBufferTest, ReadUint8VectorNotEnoughDataInBufferOrSource) {
   EXPECT_EQ(rb_->buffer_bit_offset(), 0);
 }
 
+TEST_F(ReadBitBufferTest, ReadUint8VectorAppendsToOutput) {
+  source_data_ = {0x01, 0x02};
+  rb_capacity_ = 1024;
+  std::unique_ptr<ReadBitBuffer> rb_ = CreateReadBitBuffer();
+  std::vector<uint8_t> output = {0xff};
+  EXPECT_THAT(rb_->ReadUint8Vector(2, output), IsOk());
+  EXPECT_THAT(output, ElementsAreArray({0xff, 0x01, 0x02}));
+}
+
+TEST_F(ReadBitBufferTest, ReadUint8VectorInvalidNegativeCount) {
+  source_data_ = {0x01, 0x02};
+  rb_capacity_ = 1024;
+  std::unique_ptr<ReadBitBuffer> rb_ = CreateReadBitBuffer();
+  std::vector<uint8_t> output = {};
+  EXPECT_EQ(rb_->ReadUint8Vector(-1, output).code(), kInvalidArgument);
+}
+
+// --- ReadUint8Span tests ---
+
+TEST_F(ReadBitBufferTest, ReadUint8SpanReadsBufferedAndUnbufferedBytes) {
+  source_data_ = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+  rb_capacity_ = 2;
+  std::unique_ptr<ReadBitBuffer> rb_ = CreateReadBitBuffer();
+  uint64_t literal = 0;
+  EXPECT_THAT(rb_->ReadUnsignedLiteral(8, literal), IsOk());
+  EXPECT_EQ(literal, 0x01);
+
+  // One byte is left in the internal buffer. The rest come from the source.
+  std::vector<uint8_t> output(4);
+  EXPECT_THAT(rb_->ReadUint8Span(absl::MakeSpan(output)), IsOk());
+  EXPECT_THAT(output, ElementsAreArray({0x02, 0x03, 0x04, 0x05}));
+
+  // Subsequent reads continue after the span.
+  EXPECT_THAT(rb_->ReadUnsignedLiteral(8, literal), IsOk());
+  EXPECT_EQ(literal, 0x06);
+}
+
+TEST_F(ReadBitBufferTest, ReadUint8SpanMisalignedBuffer) {
+  source_data_ = {0b10000001, 0b10000011, 0b10000001};
+  rb_capacity_ = 1024;
+  std::unique_ptr<ReadBitBuffer> rb_ = CreateReadBitBuffer();
+  uint64_t literal = 0;
+  EXPECT_THAT(rb_->ReadUnsignedLiteral(2, literal), IsOk());
+  std::vector<uint8_t> output(2);
+  EXPECT_THAT(rb_->ReadUint8Span(absl::MakeSpan(output)), IsOk());
+  EXPECT_THAT(output, ElementsAreArray({0b00000110, 0b00001110}));
+}
+
+TEST_F(ReadBitBufferTest, ReadUint8SpanEmptyIsOk) {
+  source_data_ = {};
+  rb_capacity_ = 1024;
+  std::unique_ptr<ReadBitBuffer> rb_ = CreateReadBitBuffer();
+  std::vector<uint8_t> output = {};
+  EXPECT_THAT(rb_->ReadUint8Span(absl::MakeSpan(output)), IsOk());
+}
+
+TEST_F(ReadBitBufferTest, ReadUint8SpanNotEnoughDataDoesNotConsume) {
+  source_data_ = {0x01, 0x02, 0x03};
+  rb_capacity_ = 1024;
+  std::unique_ptr<ReadBitBuffer> rb_ = CreateReadBitBuffer();
+  std::vector<uint8_t> output(4);
+  EXPECT_EQ(rb_->ReadUint8Span(absl::MakeSpan(output)).code(),
+            kResourceExhausted);
+
+  std::vector<uint8_t> smaller_output(3);
+  EXPECT_THAT(rb_->ReadUint8Span(absl::MakeSpan(smaller_output)), IsOk());
+  EXPECT_THAT(smaller_output, ElementsAreArray(source_data_));
+}
+
 // --- ReadBoolean tests ---
 
 // Successful ReadBoolean reads
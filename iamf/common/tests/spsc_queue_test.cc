@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 3-Clause Clear License
+ * and the Alliance for Open Media Patent License 1.0. If the BSD 3-Clause Clear
+ * License was not distributed with this source code in the LICENSE file, you
+ * can obtain it at www.aomedia.org/license/software-license/bsd-3-c-c. If the
+ * Alliance for Open Media Patent License 1.0 was not distributed with this
+ * source code in the PATENTS file, you can obtain it at
+ * www.aomedia.org/license/patent.
+ */
+#include "iamf/common/spsc_queue.h"
+
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace iamf_tools {
+namespace {
+
+using ::testing::Optional;
+
+TEST(SpscQueue, IsEmptyAfterConstruction) {
+  SpscQueue<int> queue;
+
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(queue.Size(), 0);
+  EXPECT_EQ(queue.TryPop(), std::nullopt);
+}
+
+TEST(SpscQueue, PopsInFifoOrder) {
+  SpscQueue<int> queue;
+  queue.Push(1);
+  queue.Push(2);
+  queue.Push(3);
+  EXPECT_EQ(queue.Size(), 3);
+
+  EXPECT_THAT(queue.TryPop(), Optional(1));
+  EXPECT_THAT(queue.TryPop(), Optional(2));
+  EXPECT_THAT(queue.TryPop(), Optional(3));
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(SpscQueue, GrowsToHoldManyElements) {
+  constexpr int kNumElements = 1000;
+  SpscQueue<int> queue;
+  for (int i = 0; i < kNumElements; ++i) {
+    queue.Push(int{i});
+  }
+  EXPECT_EQ(queue.Size(), kNumElements);
+
+  for (int i = 0; i < kNumElements; ++i) {
+    EXPECT_THAT(queue.TryPop(), Optional(i));
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(SpscQueue, InterleavesPushesAndPopsManyTimes) {
+  SpscQueue<int> queue;
+  for (int i = 0; i < 100; ++i) {
+    queue.Push(int{i});
+    queue.Push(i + 1000);
+    EXPECT_THAT(queue.TryPop(), Optional(i));
+    EXPECT_THAT(queue.TryPop(), Optional(i + 1000));
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(SpscQueue, HoldsMoveOnlyTypes) {
+  SpscQueue<std::unique_ptr<int>> queue;
+  queue.Push(std::make_unique<int>(7));
+
+  const auto popped = queue.TryPop();
+  ASSERT_TRUE(popped.has_value());
+  EXPECT_EQ(**popped, 7);
+}
+
+TEST(SpscQueue, DestroysElementsWhichWereNotPopped) {
+  auto value = std::make_shared<int>(7);
+  {
+    SpscQueue<std::shared_ptr<int>> queue;
+    for (int i = 0; i < 100; ++i) {
+      queue.Push(std::shared_ptr<int>(value));
+    }
+    EXPECT_EQ(value.use_count(), 101);
+  }
+
+  EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST(SpscQueue, TransfersAllElementsBetweenThreads) {
+  constexpr int kNumElements = 100000;
+  SpscQueue<int> queue;
+
+  std::thread producer([&queue]() {
+    for (int i = 0; i < kNumElements; ++i) {
+      queue.Push(int{i});
+    }
+  });
+
+  std::vector<int> popped;
+  popped.reserve(kNumElements);
+  while (popped.size() < kNumElements) {
+    if (auto value = queue.TryPop(); value.has_value()) {
+      popped.push_back(*value);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  for (int i = 0; i < kNumElements; ++i) {
+    ASSERT_EQ(popped[i], i);
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+}  // namespace
+}  // namespace iamf_tools
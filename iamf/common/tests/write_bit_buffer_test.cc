@@ -20,6 +20,7 @@
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "iamf/cli/leb_generator.h"
@@ -266,6 +267,80 @@ TEST_F(WriteBitBufferTest, Uint8ArrayNotByteAligned) {
   ValidateWriteResults(*wb_, {0x7f, 0x80});
 }
 
+TEST_F(WriteBitBufferTest, Uint8SpanByteAligned) {
+  const std::vector<uint8_t> input = {0, 10, 20, 30, 255};
+
+  EXPECT_THAT(wb_->WriteUint8Span(absl::MakeConstSpan(input)), IsOk());
+  ValidateWriteResults(*wb_, input);
+}
+
+TEST_F(WriteBitBufferTest, Uint8SpanNotByteAligned) {
+  const std::vector<uint8_t> input = {0xff};
+
+  EXPECT_THAT(wb_->WriteUnsignedLiteral(0, 1), IsOk());
+  EXPECT_THAT(wb_->WriteUint8Span(absl::MakeConstSpan(input)), IsOk());
+  EXPECT_THAT(wb_->WriteUnsignedLiteral(0, 7), IsOk());
+  ValidateWriteResults(*wb_, {0x7f, 0x80});
+}
+
+TEST_F(WriteBitBufferTest, SpliceUint8SpanOverwritesSameSize) {
+  EXPECT_THAT(wb_->WriteUint8Vector({1, 2, 3, 4}), IsOk());
+
+  EXPECT_THAT(wb_->SpliceUint8Span(1, 2, {20, 30}), IsOk());
+  ValidateWriteResults(*wb_, {1, 20, 30, 4});
+}
+
+TEST_F(WriteBitBufferTest, SpliceUint8SpanShiftsLaterBytes) {
+  EXPECT_THAT(wb_->WriteUint8Vector({1, 2, 3}), IsOk());
+
+  EXPECT_THAT(wb_->SpliceUint8Span(1, 1, {20, 21}), IsOk());
+  ValidateWriteResults(*wb_, {1, 20, 21, 3});
+
+  EXPECT_THAT(wb_->SpliceUint8Span(0, 2, {10}), IsOk());
+  ValidateWriteResults(*wb_, {10, 21, 3});
+
+  // Later writes continue after the shifted bytes.
+  EXPECT_THAT(wb_->WriteUnsignedLiteral(4, 8), IsOk());
+  ValidateWriteResults(*wb_, {10, 21, 3, 4});
+}
+
+TEST_F(WriteBitBufferTest, SpliceUint8SpanInvalidWhenRangeWasNotWritten) {
+  EXPECT_THAT(wb_->WriteUint8Vector({1, 2}), IsOk());
+
+  EXPECT_FALSE(wb_->SpliceUint8Span(1, 2, {0, 0}).ok());
+  EXPECT_FALSE(wb_->SpliceUint8Span(-1, 1, {0}).ok());
+}
+
+TEST_F(WriteBitBufferTest, SpliceUint8SpanInvalidWhenNotByteAligned) {
+  EXPECT_THAT(wb_->WriteUnsignedLiteral(0, 9), IsOk());
+
+  EXPECT_FALSE(wb_->SpliceUint8Span(0, 1, {0}).ok());
+}
+
+TEST_F(WriteBitBufferTest, RewindDiscardsLaterBytes) {
+  EXPECT_THAT(wb_->WriteUint8Span({1, 2, 3}), IsOk());
+
+  EXPECT_THAT(wb_->Rewind(1), IsOk());
+
+  ValidateWriteResults(*wb_, {1});
+}
+
+TEST_F(WriteBitBufferTest, RewindDiscardsAPartialByte) {
+  EXPECT_THAT(wb_->WriteUnsignedLiteral(0xff, 8), IsOk());
+  EXPECT_THAT(wb_->WriteUnsignedLiteral(1, 1), IsOk());
+
+  EXPECT_THAT(wb_->Rewind(1), IsOk());
+
+  ValidateWriteResults(*wb_, {0xff});
+}
+
+TEST_F(WriteBitBufferTest, RewindInvalidPastTheWrittenBytes) {
+  EXPECT_THAT(wb_->WriteUint8Span({1}), IsOk());
+
+  EXPECT_FALSE(wb_->Rewind(2).ok());
+  EXPECT_FALSE(wb_->Rewind(-1).ok());
+}
+
 TEST_F(WriteBitBufferTest, WriteUleb128Min) {
   EXPECT_THAT(wb_->WriteUleb128(0), IsOk());
   ValidateWriteResults(*wb_, {0x00});
@@ -14,13 +14,13 @@
 #include <algorithm>
 #include <cstdint>
 #include <fstream>
-#include <iterator>
 #include <string>
 #include <vector>
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "iamf/cli/leb_generator.h"
 #include "iamf/common/bit_buffer_util.h"
 #include "iamf/common/macros.h"
@@ -206,11 +206,14 @@ absl::Status WriteBitBuffer::WriteUleb128(const DecodedUleb128 data) {
 
 absl::Status WriteBitBuffer::WriteUint8Vector(
     const std::vector<uint8_t>& data) {
+  return WriteUint8Span(absl::MakeConstSpan(data));
+}
+
+absl::Status WriteBitBuffer::WriteUint8Span(absl::Span<const uint8_t> data) {
   if (IsByteAligned()) {
     // In the common case we can just copy all of the data over and update
     // `bit_offset_`.
-    bit_buffer_.reserve(bit_buffer_.size() + data.size());
-    std::copy(data.begin(), data.end(), std::back_inserter(bit_buffer_));
+    bit_buffer_.insert(bit_buffer_.end(), data.begin(), data.end());
     bit_offset_ += 8 * data.size();
     return absl::OkStatus();
   }
@@ -226,6 +229,47 @@ absl::Status WriteBitBuffer::WriteUint8Vector(
   return absl::OkStatus();
 }
 
+absl::Status WriteBitBuffer::SpliceUint8Span(int64_t byte_offset,
+                                             int64_t num_bytes_to_replace,
+                                             absl::Span<const uint8_t> data) {
+  if (!IsByteAligned()) {
+    return absl::InvalidArgumentError("Write buffer not byte-aligned");
+  }
+  const int64_t num_bytes_written = bit_offset_ / 8;
+  if (byte_offset < 0 || num_bytes_to_replace < 0 ||
+      byte_offset + num_bytes_to_replace > num_bytes_written) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cannot replace ", num_bytes_to_replace, " bytes at byte_offset= ",
+        byte_offset, " in a buffer with ", num_bytes_written,
+        " bytes written."));
+  }
+
+  const int64_t num_bytes = static_cast<int64_t>(data.size());
+  const auto replace_begin = bit_buffer_.begin() + byte_offset;
+  if (num_bytes > num_bytes_to_replace) {
+    bit_buffer_.insert(replace_begin + num_bytes_to_replace,
+                       num_bytes - num_bytes_to_replace, 0);
+  } else if (num_bytes < num_bytes_to_replace) {
+    bit_buffer_.erase(replace_begin + num_bytes,
+                      replace_begin + num_bytes_to_replace);
+  }
+  std::copy(data.begin(), data.end(), bit_buffer_.begin() + byte_offset);
+  bit_offset_ += 8 * (num_bytes - num_bytes_to_replace);
+
+  return absl::OkStatus();
+}
+
+absl::Status WriteBitBuffer::Rewind(int64_t byte_offset) {
+  if (byte_offset < 0 || 8 * byte_offset > bit_offset_) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot rewind to byte_offset= ", byte_offset,
+                     " in a buffer with ", bit_offset_, " bits written."));
+  }
+  bit_buffer_.resize(byte_offset);
+  bit_offset_ = 8 * byte_offset;
+  return absl::OkStatus();
+}
+
 absl::Status WriteBitBuffer::FlushAndWriteToFile(std::fstream& output_file) {
   if (!IsByteAligned()) {
     return absl::InvalidArgumentError("Write buffer not byte-aligned");
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "iamf/cli/leb_generator.h"
 #include "iamf/obu/leb128.h"
 
@@ -100,6 +101,44 @@ class WriteBitBuffer {
    */
   absl::Status WriteUint8Vector(const std::vector<uint8_t>& data);
 
+  /*!\brief Writes a span of `uint8_t`s to the write buffer.
+   *
+   * The bytes are copied directly when the buffer is byte-aligned, which lets
+   * callers write data they do not own without building a temporary vector.
+   *
+   * \param data Data to write.
+   * \return `absl::OkStatus()` on success. `absl::Status::kResourceExhausted`
+   *     if there is not enough room in the write buffer.
+   *     `absl::UnknownError()` if the `wb->bit_offset` is negative.
+   */
+  absl::Status WriteUint8Span(absl::Span<const uint8_t> data);
+
+  /*!\brief Replaces bytes which were already written to the buffer.
+   *
+   * Replaces the `num_bytes_to_replace` bytes starting at `byte_offset` with
+   * `data`. The bytes are overwritten in place when the sizes match, otherwise
+   * the bytes after the replaced range are shifted. This lets callers reserve
+   * space for a field which can only be generated after later data is written.
+   *
+   * \param byte_offset Offset in bytes of the first byte to replace.
+   * \param num_bytes_to_replace Number of bytes to replace.
+   * \param data Data to write in place of the replaced bytes.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     the buffer is not byte-aligned or if the range to replace was not
+   *     already written.
+   */
+  absl::Status SpliceUint8Span(int64_t byte_offset,
+                               int64_t num_bytes_to_replace,
+                               absl::Span<const uint8_t> data);
+
+  /*!\brief Discards the bytes written after an offset.
+   *
+   * \param byte_offset Offset in bytes to rewind the buffer to.
+   * \return `absl::OkStatus()` on success. `absl::InvalidArgumentError()` if
+   *     the offset was not already written.
+   */
+  absl::Status Rewind(int64_t byte_offset);
+
   /*!\brief Writes a ULEB128 to the buffer using an implicit generator.
    *
    * \param data Data to write using the member `leb_generator_`.
@@ -12,10 +12,12 @@
 #include "iamf/obu/audio_frame.h"
 
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "iamf/common/macros.h"
 #include "iamf/common/read_bit_buffer.h"
 #include "iamf/common/write_bit_buffer.h"
@@ -42,9 +44,9 @@ ObuType GetObuType(uint32_t substream_id) {
 
 AudioFrameObu::AudioFrameObu(const ObuHeader& header,
                              DecodedUleb128 substream_id,
-                             const std::vector<uint8_t>& audio_frame)
+                             std::vector<uint8_t> audio_frame)
     : ObuBase(header, GetObuType(substream_id)),
-      audio_frame_(audio_frame),
+      audio_frame_(std::move(audio_frame)),
       audio_substream_id_(substream_id) {}
 
 absl::StatusOr<AudioFrameObu> AudioFrameObu::CreateFromBuffer(
@@ -62,7 +64,7 @@ absl::Status AudioFrameObu::ValidateAndWritePayload(WriteBitBuffer& wb) const {
     // it is implied by `obu_type`.
     RETURN_IF_NOT_OK(wb.WriteUleb128(audio_substream_id_));
   }
-  RETURN_IF_NOT_OK(wb.WriteUint8Vector(audio_frame_));
+  RETURN_IF_NOT_OK(wb.WriteUint8Span(absl::MakeConstSpan(audio_frame_)));
 
   return absl::OkStatus();
 }
@@ -76,8 +78,16 @@ absl::Status AudioFrameObu::ReadAndValidatePayload(ReadBitBuffer& rb) {
   } else {
     audio_substream_id_ = header_.obu_type - kObuIaAudioFrameId0;
   }
-  RETURN_IF_NOT_OK(rb.ReadUint8Vector(
-      payload_serialized_size_ - encoded_uleb128_size, audio_frame_));
+  const int64_t audio_frame_size =
+      payload_serialized_size_ - encoded_uleb128_size;
+  if (audio_frame_size < 0) {
+    return absl::InvalidArgumentError(
+        "OBU payload is too small to hold the audio substream ID.");
+  }
+
+  // Size the payload once and fill it in place.
+  audio_frame_.resize(audio_frame_size);
+  RETURN_IF_NOT_OK(rb.ReadUint8Span(absl::MakeSpan(audio_frame_)));
   return absl::OkStatus();
 }
 
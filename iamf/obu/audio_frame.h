@@ -58,9 +58,11 @@ class AudioFrameObu : public ObuBase {
    *
    * \param header `ObuHeader` of the OBU.
    * \param substream_id Substream ID.
+   * \param audio_frame Encoded payload. Pass an rvalue to move the payload into
+   *     the OBU without copying it.
    */
   AudioFrameObu(const ObuHeader& header, DecodedUleb128 substream_id,
-                const std::vector<uint8_t>& audio_frame);
+                std::vector<uint8_t> audio_frame);
 
   /*!\brief Move constructor.*/
   AudioFrameObu(AudioFrameObu&& other) = default;
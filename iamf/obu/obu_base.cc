@@ -18,6 +18,7 @@
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "iamf/cli/leb_generator.h"
 #include "iamf/common/macros.h"
 #include "iamf/common/write_bit_buffer.h"
@@ -25,9 +26,83 @@
 
 namespace iamf_tools {
 
+namespace {
+
+// Large enough to hold any OBU header without resizing.
+constexpr int64_t kMaxHeaderSize = 64;
+
+// A payload size which needs the same number of bytes to represent `obu_size`
+// as most audio frames, when using the minimal ULEB128 representation.
+constexpr int64_t kTypicalPayloadSize = 1024;
+
+// Writes a header with the same size as the final header will have in the
+// common case.
+absl::Status WriteProvisionalHeader(const ObuHeader& header,
+                                    WriteBitBuffer& header_wb) {
+  if (header.ValidateAndWrite(kTypicalPayloadSize, header_wb).ok()) {
+    return absl::OkStatus();
+  }
+
+  // `obu_size` may be too small to hold the typical size when using a fixed
+  // size ULEB128 representation. The header size does not depend on the
+  // payload size in that case.
+  header_wb.Reset();
+  return header.ValidateAndWrite(0, header_wb);
+}
+
+}  // namespace
+
 ObuBase::~ObuBase() {}
 
 absl::Status ObuBase::ValidateAndWriteObu(WriteBitBuffer& final_wb) const {
+  if (!final_wb.IsByteAligned()) {
+    return ValidateAndWriteObuViaTemporaryBuffer(final_wb);
+  }
+  const int64_t header_byte_offset = final_wb.bit_offset() / 8;
+  const absl::Status status = ValidateAndWriteObuInPlace(final_wb);
+  if (!status.ok()) {
+    // Leave the buffer as it was before the OBU.
+    final_wb.Rewind(header_byte_offset).IgnoreError();
+  }
+  return status;
+}
+
+absl::Status ObuBase::ValidateAndWriteObuInPlace(
+    WriteBitBuffer& final_wb) const {
+  const int64_t header_byte_offset = final_wb.bit_offset() / 8;
+
+  // The header depends on the size of the payload, which is not known until
+  // the payload is written. Reserve space for a header for a typical payload
+  // size, then write the payload directly after it.
+  WriteBitBuffer header_wb(kMaxHeaderSize, final_wb.leb_generator_);
+  RETURN_IF_NOT_OK(WriteProvisionalHeader(header_, header_wb));
+  const int64_t reserved_header_size = header_wb.bit_buffer().size();
+  RETURN_IF_NOT_OK(
+      final_wb.WriteUint8Span(absl::MakeConstSpan(header_wb.bit_buffer())));
+
+  // Write the payload using the virtual function.
+  const int64_t payload_start = final_wb.bit_offset();
+  RETURN_IF_NOT_OK(ValidateAndWritePayload(final_wb));
+  if (!final_wb.IsByteAligned()) {
+    // The header stores the size of the OBU in bytes.
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected the OBU payload to be byte-aligned: ",
+                     final_wb.bit_offset() - payload_start));
+  }
+  const int64_t payload_size_bytes =
+      (final_wb.bit_offset() - payload_start) / 8;
+
+  // Patch in the real header now that the payload size is known. The payload
+  // is only shifted if `obu_size` needs a different number of bytes than
+  // reserved.
+  header_wb.Reset();
+  RETURN_IF_NOT_OK(header_.ValidateAndWrite(payload_size_bytes, header_wb));
+  return final_wb.SpliceUint8Span(header_byte_offset, reserved_header_size,
+                                  absl::MakeConstSpan(header_wb.bit_buffer()));
+}
+
+absl::Status ObuBase::ValidateAndWriteObuViaTemporaryBuffer(
+    WriteBitBuffer& final_wb) const {
   // Allocate a temporary buffer big enough for most OBUs to assist writing, but
   // make it resizable so it can be expanded for large OBUs.
   static const int64_t kBufferSize = 1024;
@@ -41,26 +116,11 @@ absl::Status ObuBase::ValidateAndWriteObu(WriteBitBuffer& final_wb) const {
         "Expected the OBU payload to be byte-aligned: ", temp_wb.bit_offset()));
   }
 
-  // Write the header now that the payload size is known.
+  // Write the header now that the payload size is known, then copy over the
+  // payload.
   const int64_t payload_size_bytes = temp_wb.bit_buffer().size();
-
   RETURN_IF_NOT_OK(header_.ValidateAndWrite(payload_size_bytes, final_wb));
-
-  const int64_t expected_end_payload =
-      final_wb.bit_offset() + payload_size_bytes * 8;
-
-  // Copy over the payload into the final write buffer.
-  RETURN_IF_NOT_OK(final_wb.WriteUint8Vector(temp_wb.bit_buffer()));
-
-  // Validate the write buffer is at the expected location expected after
-  // writing the payload.
-  if (expected_end_payload != final_wb.bit_offset()) {
-    return absl::InvalidArgumentError(absl::StrCat(
-        "Expected end_payload: ", expected_end_payload,
-        " to be equal to write buffer bit offset: ", final_wb.bit_offset()));
-  }
-
-  return absl::OkStatus();
+  return final_wb.WriteUint8Span(absl::MakeConstSpan(temp_wb.bit_buffer()));
 }
 
 void ObuBase::PrintHeader(int64_t payload_size_bytes) const {
@@ -49,6 +49,10 @@ class ObuBase {
   friend bool operator==(const ObuBase& lhs, const ObuBase& rhs) = default;
 
   /*!\brief Validates and writes an entire OBU to the buffer.
+   *
+   * When the buffer is byte-aligned the payload is written directly into it.
+   * Otherwise the payload is written to a temporary buffer and copied. The
+   * buffer is left as it was if the OBU is invalid and it was byte-aligned.
    *
    * \param final_wb Buffer to write to.
    * \return `absl::OkStatus()` if the OBU is valid. A specific status on
@@ -83,6 +87,24 @@ class ObuBase {
    * \param payload_size Payload size of the header.
    */
   void PrintHeader(int64_t payload_size) const;
+
+ private:
+  /*!\brief Writes the OBU to a byte-aligned buffer without copying it.
+   *
+   * \param final_wb Buffer to write to.
+   * \return `absl::OkStatus()` if the OBU is valid. A specific status on
+   *     failure.
+   */
+  absl::Status ValidateAndWriteObuInPlace(WriteBitBuffer& final_wb) const;
+
+  /*!\brief Writes the OBU via a temporary buffer.
+   *
+   * \param final_wb Buffer to write to.
+   * \return `absl::OkStatus()` if the OBU is valid. A specific status on
+   *     failure.
+   */
+  absl::Status ValidateAndWriteObuViaTemporaryBuffer(
+      WriteBitBuffer& final_wb) const;
 };
 
 }  // namespace iamf_tools
@@ -333,5 +333,17 @@ TEST(CreateFromBuffer, FailsWithPayloadSizeTooLarge) {
   EXPECT_FALSE(obu.ok());
 }
 
+TEST(CreateFromBuffer, FailsWithPayloadSizeTooSmallForExplicitId) {
+  std::vector<uint8_t> source = {// `explicit_audio_substream_id`
+                                 0x80, 0x01,
+                                 // `audio_frame`.
+                                 8, 6, 24, 55, 11};
+  ReadBitBuffer buffer(1024, &source);
+  ObuHeader header = {.obu_type = kObuIaAudioFrame};
+  int64_t obu_payload_size = 1;
+  auto obu = AudioFrameObu::CreateFromBuffer(header, obu_payload_size, buffer);
+  EXPECT_FALSE(obu.ok());
+}
+
 }  // namespace
 }  // namespace iamf_tools
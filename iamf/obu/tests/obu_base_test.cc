@@ -11,10 +11,14 @@
  */
 #include "iamf/obu/obu_base.h"
 
+#include <cstdint>
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "iamf/cli/leb_generator.h"
 #include "iamf/common/read_bit_buffer.h"
 #include "iamf/common/tests/test_utils.h"
 #include "iamf/common/write_bit_buffer.h"
@@ -100,5 +104,100 @@ TEST(ObuBaseTest, OneByteObuExtensionHeader) {
                           {255});
 }
 
+TEST(ObuBaseTest, WritesWhenBufferIsNotByteAligned) {
+  const OneByteObu obu;
+
+  WriteBitBuffer wb(1024);
+  EXPECT_THAT(wb.WriteUnsignedLiteral(1, 1), IsOk());
+  EXPECT_THAT(obu.ValidateAndWriteObu(wb), IsOk());
+
+  // The same bytes as when aligned, shifted by one bit.
+  WriteBitBuffer expected_wb(1024);
+  EXPECT_THAT(expected_wb.WriteUnsignedLiteral(1, 1), IsOk());
+  for (const uint8_t byte : {kObuIaReserved24 << 3, 1, 255}) {
+    EXPECT_THAT(expected_wb.WriteUnsignedLiteral(byte, 8), IsOk());
+  }
+  EXPECT_EQ(wb.bit_offset(), expected_wb.bit_offset());
+  EXPECT_EQ(wb.bit_buffer(), expected_wb.bit_buffer());
+}
+
+TEST(ObuBaseTest, LeavesTheBufferUnchangedWhenThePayloadIsInvalid) {
+  const ImaginaryObuNonIntegerBytes obu;
+
+  WriteBitBuffer wb(1024);
+  EXPECT_THAT(wb.WriteUnsignedLiteral(7, 8), IsOk());
+  EXPECT_FALSE(obu.ValidateAndWriteObu(wb).ok());
+
+  EXPECT_EQ(wb.bit_offset(), 8);
+  EXPECT_EQ(wb.bit_buffer(), std::vector<uint8_t>({7}));
+}
+
+TEST(ObuBaseTest, WritesAfterExistingData) {
+  const OneByteObu obu;
+
+  WriteBitBuffer wb(1024);
+  EXPECT_THAT(wb.WriteUnsignedLiteral(7, 8), IsOk());
+  EXPECT_THAT(obu.ValidateAndWriteObu(wb), IsOk());
+  ValidateObuWriteResults(wb, {7, kObuIaReserved24 << 3, 1}, {255});
+}
+
+// An OBU with a payload of `payload_size` bytes of a constant value.
+class ConstantPayloadObu : public ObuBase {
+ public:
+  explicit ConstantPayloadObu(int payload_size)
+      : ObuBase(kObuIaReserved24), payload_size_(payload_size) {}
+  ~ConstantPayloadObu() override = default;
+  void PrintObu() const override {}
+
+ private:
+  absl::Status ValidateAndWritePayload(WriteBitBuffer& wb) const override {
+    return wb.WriteUint8Vector(std::vector<uint8_t>(payload_size_, 1));
+  }
+
+  absl::Status ReadAndValidatePayload(ReadBitBuffer& rb) override {
+    return absl::OkStatus();
+  }
+
+  const int payload_size_;
+};
+
+TEST(ObuBaseTest, WritesObuWithOneByteObuSize) {
+  const ConstantPayloadObu obu(127);
+
+  WriteBitBuffer wb(1024);
+  EXPECT_THAT(obu.ValidateAndWriteObu(wb), IsOk());
+  ValidateObuWriteResults(wb, {kObuIaReserved24 << 3, 127},
+                          std::vector<uint8_t>(127, 1));
+}
+
+TEST(ObuBaseTest, WritesObuWithTwoByteObuSize) {
+  const ConstantPayloadObu obu(128);
+
+  WriteBitBuffer wb(1024);
+  EXPECT_THAT(obu.ValidateAndWriteObu(wb), IsOk());
+  ValidateObuWriteResults(wb, {kObuIaReserved24 << 3, 0x80, 0x01},
+                          std::vector<uint8_t>(128, 1));
+}
+
+TEST(ObuBaseTest, WritesObuWithThreeByteObuSize) {
+  const ConstantPayloadObu obu(16384);
+
+  WriteBitBuffer wb(1024);
+  EXPECT_THAT(obu.ValidateAndWriteObu(wb), IsOk());
+  ValidateObuWriteResults(wb, {kObuIaReserved24 << 3, 0x80, 0x80, 0x01},
+                          std::vector<uint8_t>(16384, 1));
+}
+
+TEST(ObuBaseTest, WritesObuSizeWithFixedSizeLebGenerator) {
+  const ConstantPayloadObu obu(2);
+  auto leb_generator =
+      LebGenerator::Create(LebGenerator::GenerationMode::kFixedSize, 1);
+  ASSERT_NE(leb_generator, nullptr);
+
+  WriteBitBuffer wb(1024, *leb_generator);
+  EXPECT_THAT(obu.ValidateAndWriteObu(wb), IsOk());
+  ValidateObuWriteResults(wb, {kObuIaReserved24 << 3, 2}, {1, 1});
+}
+
 }  // namespace
 }  // namespace iamf_tools